@@ -0,0 +1,85 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+
+#include "benchmarks/benchmark.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "ozz/base/log.h"
+
+namespace ozz {
+namespace benchmark {
+
+Runner::Runner(int _iterations, int _repetitions, const char* _filter)
+    : iterations_(std::max(_iterations, 1)),
+      repetitions_(std::max(_repetitions, 1)),
+      filter_(_filter ? _filter : "") {}
+
+bool Runner::Accept(const char* _name) const {
+  return filter_.empty() || std::strstr(_name, filter_.c_str()) != nullptr;
+}
+
+void Runner::Push(const char* _name, const char* _unit, double _units,
+                  ozz::vector<double>* _timings) {
+  std::sort(_timings->begin(), _timings->end());
+  const size_t size = _timings->size();
+  const double median =
+      size & 1 ? (*_timings)[size / 2]
+               : ((*_timings)[size / 2 - 1] + (*_timings)[size / 2]) * .5;
+
+  Result result;
+  result.name = _name;
+  result.unit = _unit;
+  result.units = _units;
+  result.ns_min = _timings->front();
+  result.ns_median = median;
+  results_.push_back(result);
+
+  ozz::log::Log() << _name << ": " << result.ns_min << " ns (min), "
+                  << result.ns_median << " ns (median), "
+                  << result.ns_min / _units << " ns/" << _unit << std::endl;
+}
+
+void Runner::Write(std::FILE* _file, const char* _config) const {
+  std::fprintf(_file, "{\n  \"config\": %s,\n  \"results\": [", _config);
+  for (size_t i = 0; i < results_.size(); ++i) {
+    const Result& result = results_[i];
+    std::fprintf(_file,
+                 "%s\n    {\"name\": \"%s\", \"unit\": \"%s\", "
+                 "\"units\": %.0f, \"ns_min\": %.3f, \"ns_median\": %.3f, "
+                 "\"ns_per_unit\": %.4f, \"units_per_second\": %.1f}",
+                 i == 0 ? "" : ",", result.name.c_str(), result.unit,
+                 result.units, result.ns_min, result.ns_median,
+                 result.ns_min / result.units,
+                 result.units * 1e9 / result.ns_min);
+  }
+  std::fprintf(_file, "\n  ]\n}\n");
+}
+}  // namespace benchmark
+}  // namespace ozz
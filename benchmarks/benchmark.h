@@ -0,0 +1,111 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+
+#ifndef OZZ_BENCHMARKS_BENCHMARK_H_
+#define OZZ_BENCHMARKS_BENCHMARK_H_
+
+#include <chrono>
+#include <cstdio>
+
+#include "ozz/base/containers/string.h"
+#include "ozz/base/containers/vector.h"
+
+namespace ozz {
+namespace benchmark {
+
+// Result of a benchmark, timings are given per iteration.
+struct Result {
+  // Benchmark name.
+  ozz::string name;
+
+  // Name of the unit processed by an iteration (joint, vertex, key...), and
+  // the number of units processed per iteration.
+  const char* unit;
+  double units;
+
+  // Minimum and median time of an iteration, in nanoseconds, over all
+  // repetitions.
+  double ns_min;
+  double ns_median;
+};
+
+// Runs benchmarks and collects their results.
+// Each benchmark function is called _iterations times per repetition, and
+// repeated _repetitions times. Minimum and median iteration time of all
+// repetitions are reported, as they are less sensitive than the mean to
+// system noise. A warm up pass is executed before measuring.
+class Runner {
+ public:
+  Runner(int _iterations, int _repetitions, const char* _filter);
+
+  // Times _fn, which processes _units _unit per call.
+  // Benchmark is skipped if its name doesn't contain filter string.
+  template <typename _Fn>
+  void Run(const char* _name, const char* _unit, double _units, _Fn _fn) {
+    if (!Accept(_name)) {
+      return;
+    }
+    const int warm_up = iterations_ / 10 + 1;
+    for (int i = 0; i < warm_up; ++i) {
+      _fn();
+    }
+    ozz::vector<double> timings(repetitions_);
+    for (int r = 0; r < repetitions_; ++r) {
+      const std::chrono::steady_clock::time_point begin =
+          std::chrono::steady_clock::now();
+      for (int i = 0; i < iterations_; ++i) {
+        _fn();
+      }
+      const std::chrono::duration<double, std::nano> elapsed =
+          std::chrono::steady_clock::now() - begin;
+      timings[r] = elapsed.count() / iterations_;
+    }
+    Push(_name, _unit, _units, &timings);
+  }
+
+  // Writes all results to _file as a json document. _config is a json object
+  // that describes benchmarks configuration.
+  void Write(std::FILE* _file, const char* _config) const;
+
+  int iterations() const { return iterations_; }
+  int repetitions() const { return repetitions_; }
+  const ozz::vector<Result>& results() const { return results_; }
+
+ private:
+  bool Accept(const char* _name) const;
+  void Push(const char* _name, const char* _unit, double _units,
+            ozz::vector<double>* _timings);
+
+  int iterations_;
+  int repetitions_;
+  ozz::string filter_;
+  ozz::vector<Result> results_;
+};
+}  // namespace benchmark
+}  // namespace ozz
+#endif  // OZZ_BENCHMARKS_BENCHMARK_H_
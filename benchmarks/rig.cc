@@ -0,0 +1,257 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+
+#include "benchmarks/rig.h"
+
+#include <cmath>
+#include <cstdio>
+
+#include "ozz/animation/offline/animation_builder.h"
+#include "ozz/animation/offline/float_curves_builder.h"
+#include "ozz/animation/offline/raw_animation.h"
+#include "ozz/animation/offline/raw_float_curves.h"
+#include "ozz/animation/offline/raw_skeleton.h"
+#include "ozz/animation/offline/raw_track.h"
+#include "ozz/animation/offline/skeleton_builder.h"
+#include "ozz/animation/offline/track_builder.h"
+#include "ozz/animation/runtime/animation.h"
+#include "ozz/animation/runtime/float_curves.h"
+#include "ozz/animation/runtime/skeleton.h"
+#include "ozz/animation/runtime/track.h"
+#include "ozz/base/maths/math_constant.h"
+#include "ozz/base/maths/math_ex.h"
+
+namespace ozz {
+namespace benchmark {
+
+namespace {
+
+// Linear congruential generator, so that generated data don't depend on the
+// platform rand() implementation.
+class Random {
+ public:
+  explicit Random(uint32_t _seed) : state_(_seed) {}
+
+  // Returns a value in range [0,1[.
+  float Next() {
+    state_ = state_ * 1664525u + 1013904223u;
+    return (state_ >> 8) * (1.f / 16777216.f);
+  }
+
+  // Returns a value in range [_min,_max[.
+  float Next(float _min, float _max) { return _min + (_max - _min) * Next(); }
+
+ private:
+  uint32_t state_;
+};
+
+void SetupJoint(int _index, Random* _random,
+                animation::offline::RawSkeleton::Joint* _joint) {
+  char name[32];
+  std::snprintf(name, sizeof(name), "joint%d", _index);
+  _joint->name = name;
+  _joint->transform = math::Transform::identity();
+  _joint->transform.translation =
+      math::Float3(_random->Next(-.1f, .1f), _random->Next(.1f, .2f), 0.f);
+}
+
+// Builds a skeleton made of chains of _depth joints, all attached to the root.
+unique_ptr<animation::Skeleton> BuildSkeleton(const RigSettings& _settings,
+                                              Random* _random) {
+  animation::offline::RawSkeleton raw;
+  if (_settings.depth <= 1) {
+    raw.roots.resize(_settings.num_joints);
+    for (int i = 0; i < _settings.num_joints; ++i) {
+      SetupJoint(i, _random, &raw.roots[i]);
+    }
+  } else {
+    raw.roots.resize(1);
+    SetupJoint(0, _random, &raw.roots[0]);
+
+    // Children vector is sized upfront, so that joint pointers remain valid.
+    const int chain_length = _settings.depth - 1;
+    const int num_chains =
+        (_settings.num_joints - 1 + chain_length - 1) / chain_length;
+    raw.roots[0].children.resize(num_chains);
+    int index = 1;
+    for (int c = 0; c < num_chains; ++c) {
+      animation::offline::RawSkeleton::Joint* joint = &raw.roots[0].children[c];
+      SetupJoint(index++, _random, joint);
+      for (int d = 1; d < chain_length && index < _settings.num_joints; ++d) {
+        joint->children.resize(1);
+        joint = &joint->children[0];
+        SetupJoint(index++, _random, joint);
+      }
+    }
+  }
+
+  animation::offline::SkeletonBuilder builder;
+  builder.level_order = _settings.level_order;
+  return builder(raw);
+}
+
+unique_ptr<animation::Animation> BuildAnimation(const RigSettings& _settings,
+                                                Random* _random) {
+  const int num_keys = math::Max(
+      2, static_cast<int>(_settings.duration * _settings.key_density));
+
+  animation::offline::RawAnimation raw;
+  raw.duration = _settings.duration;
+  raw.tracks.resize(_settings.num_joints);
+  for (int i = 0; i < _settings.num_joints; ++i) {
+    animation::offline::RawAnimation::JointTrack& track = raw.tracks[i];
+    for (int k = 0; k < num_keys; ++k) {
+      const float time = _settings.duration * k / (num_keys - 1);
+      const animation::offline::RawAnimation::TranslationKey tkey = {
+          time, math::Float3(_random->Next(-.1f, .1f),
+                             _random->Next(.1f, .2f),
+                             _random->Next(-.1f, .1f))};
+      track.translations.push_back(tkey);
+      const animation::offline::RawAnimation::RotationKey rkey = {
+          time, math::Quaternion::FromEuler(_random->Next(-1.f, 1.f),
+                                            _random->Next(-1.f, 1.f),
+                                            _random->Next(-1.f, 1.f))};
+      track.rotations.push_back(rkey);
+      const animation::offline::RawAnimation::ScaleKey skey = {
+          time, math::Float3(_random->Next(.9f, 1.1f))};
+      track.scales.push_back(skey);
+    }
+  }
+
+  animation::offline::AnimationBuilder builder;
+  return builder(raw);
+}
+
+void BuildTracks(const RigSettings& _settings, Random* _random, Rig* _rig) {
+  const int num_keys = math::Max(
+      2, static_cast<int>(_settings.duration * _settings.key_density));
+
+  animation::offline::RawFloatTrack raw;
+  for (int k = 0; k < num_keys; ++k) {
+    const animation::offline::RawFloatTrack::Keyframe key = {
+        animation::offline::RawTrackInterpolation::kLinear,
+        static_cast<float>(k) / (num_keys - 1), _random->Next()};
+    raw.keyframes.push_back(key);
+  }
+
+  animation::offline::TrackBuilder builder;
+  _rig->track = builder(raw);
+
+  // Same track, with an edge index for kTrackThreshold.
+  builder.edge_index = true;
+  builder.edge_threshold = kTrackThreshold;
+  _rig->indexed_track = builder(raw);
+}
+
+void BuildCurves(const RigSettings& _settings, Random* _random, Rig* _rig) {
+  const int num_keys = math::Max(
+      2, static_cast<int>(_settings.duration * _settings.key_density));
+
+  // Inner keys are jittered, so that curves keys aren't aligned.
+  animation::offline::RawFloatCurves raw;
+  raw.curves.resize(kNumCurves);
+  for (int c = 0; c < kNumCurves; ++c) {
+    for (int k = 0; k < num_keys; ++k) {
+      const float jitter =
+          k == 0 || k == num_keys - 1 ? 0.f : _random->Next(-.4f, .4f);
+      const animation::offline::RawFloatTrack::Keyframe key = {
+          animation::offline::RawTrackInterpolation::kLinear,
+          (k + jitter) / (num_keys - 1), _random->Next()};
+      raw.curves[c].keyframes.push_back(key);
+    }
+  }
+
+  animation::offline::TrackBuilder track_builder;
+  _rig->curve_tracks.clear();
+  for (int c = 0; c < kNumCurves; ++c) {
+    _rig->curve_tracks.push_back(track_builder(raw.curves[c]));
+  }
+  animation::offline::FloatCurvesBuilder curves_builder;
+  _rig->curves = curves_builder(raw);
+}
+
+void BuildMesh(const RigSettings& _settings, Random* _random, RigMesh* _mesh) {
+  const size_t num_vertices = static_cast<size_t>(_settings.num_vertices);
+  const size_t num_influences = static_cast<size_t>(_settings.num_influences);
+  _mesh->positions.resize(num_vertices * 3);
+  _mesh->normals.resize(num_vertices * 3);
+  _mesh->tangents.resize(num_vertices * 3);
+  _mesh->joint_indices.resize(num_vertices * num_influences);
+  _mesh->joint_weights.resize(num_vertices * (num_influences - 1));
+  for (size_t v = 0; v < num_vertices; ++v) {
+    for (size_t c = 0; c < 3; ++c) {
+      _mesh->positions[v * 3 + c] = _random->Next(-1.f, 1.f);
+    }
+    // Normals and tangents only need to be orthogonal.
+    const float angle = _random->Next(0.f, math::k2Pi);
+    _mesh->normals[v * 3 + 0] = std::cos(angle);
+    _mesh->normals[v * 3 + 1] = std::sin(angle);
+    _mesh->normals[v * 3 + 2] = 0.f;
+    _mesh->tangents[v * 3 + 0] = -std::sin(angle);
+    _mesh->tangents[v * 3 + 1] = std::cos(angle);
+    _mesh->tangents[v * 3 + 2] = 0.f;
+
+    // Weights sum is lower than 1, the last one is deduced at runtime.
+    for (size_t i = 0; i < num_influences; ++i) {
+      _mesh->joint_indices[v * num_influences + i] = static_cast<uint16_t>(
+          _random->Next() * _settings.num_joints);
+      if (i != num_influences - 1) {
+        _mesh->joint_weights[v * (num_influences - 1) + i] =
+            _random->Next() / num_influences;
+      }
+    }
+  }
+}
+}  // namespace
+
+bool BuildRig(const RigSettings& _settings, Rig* _rig) {
+  if (_settings.num_joints <= 0 ||
+      _settings.num_joints > animation::Skeleton::kMaxJoints ||
+      _settings.duration <= 0.f || _settings.key_density <= 0.f ||
+      _settings.num_vertices < 0 || _settings.num_influences <= 0) {
+    return false;
+  }
+
+  // Every data type has its own generator, so that changing a setting doesn't
+  // change data of other types.
+  Random skeleton_random(46);
+  _rig->skeleton = BuildSkeleton(_settings, &skeleton_random);
+  Random animation_random(27);
+  _rig->animation = BuildAnimation(_settings, &animation_random);
+  Random track_random(14);
+  BuildTracks(_settings, &track_random, _rig);
+  Random curves_random(83);
+  BuildCurves(_settings, &curves_random, _rig);
+  Random mesh_random(58);
+  BuildMesh(_settings, &mesh_random, &_rig->mesh);
+
+  return _rig->skeleton && _rig->animation && _rig->track &&
+         _rig->indexed_track && _rig->curves;
+}
+}  // namespace benchmark
+}  // namespace ozz
@@ -0,0 +1,105 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+
+#ifndef OZZ_BENCHMARKS_RIG_H_
+#define OZZ_BENCHMARKS_RIG_H_
+
+#include <stdint.h>
+
+#include "ozz/base/containers/vector.h"
+#include "ozz/base/memory/unique_ptr.h"
+
+namespace ozz {
+namespace animation {
+class Skeleton;
+class Animation;
+class FloatTrack;
+class FloatCurves;
+}  // namespace animation
+namespace benchmark {
+
+// Parameters of a synthetic rig.
+struct RigSettings {
+  // Number of skeleton joints.
+  int num_joints;
+
+  // Maximum depth of the joint hierarchy. The skeleton is made of chains of
+  // _depth joints, all attached to the root.
+  int depth;
+
+  // Orders skeleton joints level by level instead of depth-first.
+  bool level_order;
+
+  // Animation (and track) duration, in seconds.
+  float duration;
+
+  // Number of keys per second, for all animation and track channels.
+  float key_density;
+
+  // Number of skinned vertices.
+  int num_vertices;
+
+  // Number of joints influencing each vertex.
+  int num_influences;
+};
+
+// Skinned mesh data, with separate (non interleaved) channels.
+struct RigMesh {
+  ozz::vector<float> positions;
+  ozz::vector<float> normals;
+  ozz::vector<float> tangents;
+  ozz::vector<uint16_t> joint_indices;
+  ozz::vector<float> joint_weights;
+};
+
+// Edge detection threshold of rig tracks. Track values are in range [0,1].
+const float kTrackThreshold = .5f;
+
+// Number of float curves of the rig, as for a facial rig blend shape weights.
+const int kNumCurves = 128;
+
+// A synthetic rig, whose data are built with offline builders from
+// pseudo-random values. Data are deterministic for a given RigSettings.
+struct Rig {
+  ozz::unique_ptr<ozz::animation::Skeleton> skeleton;
+  ozz::unique_ptr<ozz::animation::Animation> animation;
+  ozz::unique_ptr<ozz::animation::FloatTrack> track;
+  // Same as track, with an edge index built for kTrackThreshold.
+  ozz::unique_ptr<ozz::animation::FloatTrack> indexed_track;
+  // kNumCurves curves, built both as separate tracks and as FloatCurves.
+  ozz::vector<ozz::unique_ptr<ozz::animation::FloatTrack>> curve_tracks;
+  ozz::unique_ptr<ozz::animation::FloatCurves> curves;
+  RigMesh mesh;
+};
+
+// Builds a rig from _settings. Returns false if settings are invalid or if a
+// builder failed.
+bool BuildRig(const RigSettings& _settings, Rig* _rig);
+}  // namespace benchmark
+}  // namespace ozz
+#endif  // OZZ_BENCHMARKS_RIG_H_
@@ -0,0 +1,691 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+
+// Benchmarks runtime jobs on synthetic rigs, whose size is parametrized from
+// the command line. Results are written as a json document, to allow tracking
+// performance regressions.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+#include "benchmarks/benchmark.h"
+#include "benchmarks/rig.h"
+#include "ozz/animation/runtime/animation.h"
+#include "ozz/animation/runtime/blending_job.h"
+#include "ozz/animation/runtime/ik_aim_job.h"
+#include "ozz/animation/runtime/ik_chain_job.h"
+#include "ozz/animation/runtime/ik_two_bone_batch_job.h"
+#include "ozz/animation/runtime/ik_two_bone_job.h"
+#include "ozz/animation/runtime/local_to_model_job.h"
+#include "ozz/animation/runtime/sampling_blending_job.h"
+#include "ozz/animation/runtime/sampling_job.h"
+#include "ozz/animation/runtime/skeleton.h"
+#include "ozz/animation/runtime/skeleton_partition.h"
+#include "ozz/animation/runtime/float_curves.h"
+#include "ozz/animation/runtime/float_curves_sampling_job.h"
+#include "ozz/animation/runtime/track.h"
+#include "ozz/animation/runtime/track_sampling_job.h"
+#include "ozz/animation/runtime/track_triggering_job.h"
+#include "ozz/base/log.h"
+#include "ozz/base/maths/simd_float3x4.h"
+#include "ozz/base/maths/simd_quaternion.h"
+#include "ozz/base/maths/soa_transform.h"
+#include "ozz/geometry/runtime/dual_quaternion_palette_job.h"
+#include "ozz/geometry/runtime/skinning_job.h"
+#include "ozz/options/options.h"
+
+OZZ_OPTIONS_DECLARE_INT(joints, "Number of skeleton joints", 128, false)
+OZZ_OPTIONS_DECLARE_INT(depth, "Maximum depth of the joint hierarchy", 8,
+                        false)
+OZZ_OPTIONS_DECLARE_BOOL(level_order,
+                         "Orders skeleton joints level by level", false, false)
+OZZ_OPTIONS_DECLARE_FLOAT(duration, "Animation duration (seconds)", 10.f, false)
+OZZ_OPTIONS_DECLARE_FLOAT(keys, "Number of keys per second", 30.f, false)
+OZZ_OPTIONS_DECLARE_INT(vertices, "Number of skinned vertices", 10000, false)
+OZZ_OPTIONS_DECLARE_INT(influences, "Number of influences per vertex", 4,
+                        false)
+OZZ_OPTIONS_DECLARE_INT(iterations, "Number of iterations per repetition",
+                        1000, false)
+OZZ_OPTIONS_DECLARE_INT(repetitions, "Number of repetitions", 5, false)
+OZZ_OPTIONS_DECLARE_STRING(filter,
+                           "Only runs benchmarks whose name contains filter",
+                           "", false)
+OZZ_OPTIONS_DECLARE_STRING(output,
+                           "Json output file, standard output if empty", "",
+                           false)
+
+namespace ozz {
+namespace benchmark {
+namespace {
+
+// Number of instances sampled by batch sampling benchmark.
+const int kBatchSize = 16;
+
+// Number of samples per iteration of track sampling benchmark.
+const int kTrackSamples = 256;
+
+// Ratio increment of a 60fps playback.
+float PlaybackStep(const animation::Animation& _animation) {
+  return 1.f / (60.f * _animation.duration());
+}
+
+// Advances _ratio by _step, looping at the end of the animation.
+float Advance(float _ratio, float _step) {
+  const float ratio = _ratio + _step;
+  return ratio > 1.f ? ratio - 1.f : ratio;
+}
+
+// Pose buffers shared by benchmarks.
+struct Pose {
+  explicit Pose(const Rig& _rig)
+      : locals(_rig.skeleton->num_soa_joints()),
+        models(_rig.skeleton->num_joints()),
+        cache(_rig.animation->num_tracks()) {}
+  ozz::vector<math::SoaTransform> locals;
+  ozz::vector<math::Float4x4> models;
+  animation::SamplingCache cache;
+};
+
+void SamplingBenchmarks(const Rig& _rig, Runner* _runner) {
+  const animation::Animation& animation = *_rig.animation;
+  const int num_joints = _rig.skeleton->num_joints();
+  Pose pose(_rig);
+
+  {  // Forward playback, which benefits from sampling cache.
+    animation::SamplingJob job;
+    job.animation = &animation;
+    job.cache = &pose.cache;
+    job.output = make_span(pose.locals);
+    job.ratio = 0.f;
+    const float step = PlaybackStep(animation);
+    _runner->Run("sampling_forward", "joint", num_joints, [&] {
+      job.ratio = Advance(job.ratio, step);
+      job.Run();
+    });
+  }
+
+  {  // Random jumps in time.
+    float ratios[64];
+    for (int i = 0; i < 64; ++i) {
+      ratios[i] = static_cast<float>((i * 37) % 64) / 63.f;
+    }
+    animation::SamplingJob job;
+    job.animation = &animation;
+    job.cache = &pose.cache;
+    job.output = make_span(pose.locals);
+    int i = 0;
+    _runner->Run("sampling_seek", "joint", num_joints, [&] {
+      job.ratio = ratios[i++ & 63];
+      job.Run();
+    });
+  }
+
+  {  // Batch of instances playing the same animation.
+    animation::SamplingCache caches[kBatchSize];
+    animation::SamplingCache* cache_ptrs[kBatchSize];
+    float ratios[kBatchSize];
+    ozz::vector<math::SoaTransform> locals(_rig.skeleton->num_soa_joints() *
+                                           kBatchSize);
+    span<math::SoaTransform> outputs[kBatchSize];
+    for (int i = 0; i < kBatchSize; ++i) {
+      caches[i].Resize(animation.num_tracks());
+      cache_ptrs[i] = &caches[i];
+      ratios[i] = static_cast<float>(i) / kBatchSize;
+      outputs[i] = span<math::SoaTransform>(
+          locals.data() + i * _rig.skeleton->num_soa_joints(),
+          _rig.skeleton->num_soa_joints());
+    }
+    animation::BatchSamplingJob job;
+    job.animation = &animation;
+    job.ratios = ratios;
+    job.caches = cache_ptrs;
+    job.outputs = outputs;
+    const float step = PlaybackStep(animation);
+    _runner->Run("batch_sampling", "joint", num_joints * kBatchSize, [&] {
+      for (int i = 0; i < kBatchSize; ++i) {
+        ratios[i] = Advance(ratios[i], step);
+      }
+      job.Run();
+    });
+  }
+}
+
+void BlendingBenchmarks(const Rig& _rig, Runner* _runner) {
+  const animation::Animation& animation = *_rig.animation;
+  const animation::Skeleton& skeleton = *_rig.skeleton;
+  const int num_joints = skeleton.num_joints();
+  Pose pose0(_rig);
+  Pose pose1(_rig);
+  Pose output(_rig);
+
+  {  // Blends 2 layers.
+    animation::SamplingJob sampling;
+    sampling.animation = &animation;
+    sampling.cache = &pose0.cache;
+    sampling.ratio = .2f;
+    sampling.output = make_span(pose0.locals);
+    sampling.Run();
+    sampling.cache = &pose1.cache;
+    sampling.ratio = .7f;
+    sampling.output = make_span(pose1.locals);
+    sampling.Run();
+
+    animation::BlendingJob::Layer layers[2];
+    layers[0].transform = make_span(pose0.locals);
+    layers[0].weight = .3f;
+    layers[1].transform = make_span(pose1.locals);
+    layers[1].weight = .7f;
+    animation::BlendingJob job;
+    job.layers = layers;
+    job.bind_pose = skeleton.joint_bind_poses();
+    job.output = make_span(output.locals);
+    _runner->Run("blending", "joint", num_joints, [&] { job.Run(); });
+  }
+
+  {  // Samples and blends 2 layers in a single job.
+    animation::SamplingBlendingJob::Layer layers[2];
+    layers[0].animation = &animation;
+    layers[0].cache = &pose0.cache;
+    layers[0].ratio = .2f;
+    layers[0].weight = .3f;
+    layers[1].animation = &animation;
+    layers[1].cache = &pose1.cache;
+    layers[1].ratio = .7f;
+    layers[1].weight = .7f;
+    animation::SamplingBlendingJob job;
+    job.layers = layers;
+    job.bind_pose = skeleton.joint_bind_poses();
+    job.output = make_span(output.locals);
+    const float step = PlaybackStep(animation);
+    _runner->Run("sampling_blending", "joint", num_joints, [&] {
+      layers[0].ratio = Advance(layers[0].ratio, step);
+      layers[1].ratio = Advance(layers[1].ratio, step);
+      job.Run();
+    });
+  }
+}
+
+void LocalToModelBenchmarks(const Rig& _rig, Runner* _runner) {
+  const animation::Skeleton& skeleton = *_rig.skeleton;
+  Pose pose(_rig);
+
+  animation::LocalToModelJob job;
+  job.skeleton = &skeleton;
+  job.input = skeleton.joint_bind_poses();
+  job.output = make_span(pose.models);
+  _runner->Run("local_to_model", "joint", skeleton.num_joints(),
+               [&] { job.Run(); });
+
+  // Affine 3x4 output.
+  ozz::vector<math::Float3x4> models_3x4(skeleton.num_joints());
+  job.output = {};
+  job.output_3x4 = make_span(models_3x4);
+  _runner->Run("local_to_model_3x4", "joint", skeleton.num_joints(),
+               [&] { job.Run(); });
+  job.output = make_span(pose.models);
+  job.output_3x4 = {};
+
+  // Only the last joint changed, like after an IK correction of a leaf.
+  bool input_dirty[animation::Skeleton::kMaxJoints] = {};
+  input_dirty[skeleton.num_joints() - 1] = true;
+  job.input_dirty = span<const bool>(input_dirty, skeleton.num_joints());
+  _runner->Run("local_to_model_incremental", "joint", skeleton.num_joints(),
+               [&] { job.Run(); });
+
+  // Partitioned hierarchy, whose tasks are run serially. This measures the
+  // overhead of partitioning, as opposed to the speedup of running partitions
+  // concurrently.
+  const animation::SkeletonPartition partition(skeleton, 4);
+  animation::ParallelLocalToModelJob parallel_job;
+  parallel_job.skeleton = &skeleton;
+  parallel_job.partition = &partition;
+  parallel_job.input = skeleton.joint_bind_poses();
+  parallel_job.output = make_span(pose.models);
+  _runner->Run("local_to_model_partitioned", "joint", skeleton.num_joints(),
+               [&] { parallel_job.Run(); });
+}
+
+// Encodes a unit vector with 16 bits octahedral encoding.
+void EncodeOctahedral(const float* _v, uint16_t* _out) {
+  const float l1 = std::abs(_v[0]) + std::abs(_v[1]) + std::abs(_v[2]);
+  float x = _v[0] / l1;
+  float y = _v[1] / l1;
+  if (_v[2] < 0.f) {
+    const float fx = (1.f - std::abs(y)) * (x >= 0.f ? 1.f : -1.f);
+    const float fy = (1.f - std::abs(x)) * (y >= 0.f ? 1.f : -1.f);
+    x = fx;
+    y = fy;
+  }
+  _out[0] = static_cast<uint16_t>(std::lround(x * 32767.f));
+  _out[1] = static_cast<uint16_t>(std::lround(y * 32767.f));
+}
+
+void SkinningBenchmarks(const Rig& _rig, Runner* _runner) {
+  const RigMesh& mesh = _rig.mesh;
+  const int num_vertices = static_cast<int>(mesh.positions.size() / 3);
+  if (num_vertices == 0) {
+    return;
+  }
+
+  // Skinning matrices are model-space bind pose matrices.
+  Pose pose(_rig);
+  animation::LocalToModelJob ltm;
+  ltm.skeleton = _rig.skeleton.get();
+  ltm.input = _rig.skeleton->joint_bind_poses();
+  ltm.output = make_span(pose.models);
+  ltm.Run();
+
+  ozz::vector<float> out_positions(mesh.positions.size());
+  ozz::vector<float> out_normals(mesh.normals.size());
+  ozz::vector<float> out_tangents(mesh.tangents.size());
+  const int influences = static_cast<int>(mesh.joint_indices.size()) /
+                         num_vertices;
+
+  geometry::SkinningJob job;
+  job.vertex_count = num_vertices;
+  job.influences_count = influences;
+  job.joint_matrices = make_span(pose.models);
+  job.joint_indices = make_span(mesh.joint_indices);
+  job.joint_indices_stride = sizeof(uint16_t) * influences;
+  job.joint_weights = make_span(mesh.joint_weights);
+  job.joint_weights_stride = sizeof(float) * (influences - 1);
+  job.in_positions = make_span(mesh.positions);
+  job.in_positions_stride = sizeof(float) * 3;
+  job.out_positions = make_span(out_positions);
+  job.out_positions_stride = sizeof(float) * 3;
+  _runner->Run("skinning_positions", "vertex", num_vertices,
+               [&] { job.Run(); });
+
+  job.in_normals = make_span(mesh.normals);
+  job.in_normals_stride = sizeof(float) * 3;
+  job.out_normals = make_span(out_normals);
+  job.out_normals_stride = sizeof(float) * 3;
+  job.in_tangents = make_span(mesh.tangents);
+  job.in_tangents_stride = sizeof(float) * 3;
+  job.out_tangents = make_span(out_tangents);
+  job.out_tangents_stride = sizeof(float) * 3;
+  _runner->Run("skinning_full", "vertex", num_vertices, [&] { job.Run(); });
+
+  // Same as skinning_full, split in ranges whose tasks are run serially. This
+  // measures the overhead of splitting, as opposed to the speedup of running
+  // ranges concurrently.
+  geometry::ParallelSkinningJob parallel_job;
+  parallel_job.job = job;
+  parallel_job.max_task_count = 4;
+  parallel_job.min_task_vertex_count = 256;
+  _runner->Run("skinning_full_split", "vertex", num_vertices,
+               [&] { parallel_job.Run(); });
+
+  // Dual quaternion palette and skinning, with normals and tangents.
+  ozz::vector<geometry::DualQuaternion> dual_quaternions(pose.models.size());
+  geometry::DualQuaternionPaletteJob palette_job;
+  palette_job.joint_matrices = make_span(pose.models);
+  palette_job.output = make_span(dual_quaternions);
+  _runner->Run("dual_quaternion_palette", "joint",
+               static_cast<int>(pose.models.size()),
+               [&] { palette_job.Run(); });
+
+  geometry::SkinningJob dq_job = job;
+  dq_job.joint_matrices = {};
+  dq_job.joint_dual_quaternions = make_span(dual_quaternions);
+  _runner->Run("skinning_dual_quaternion", "vertex", num_vertices,
+               [&] { dq_job.Run(); });
+
+  // Same as skinning_full, from half positions, octahedral normals and
+  // tangents, and unorm8 weights.
+  ozz::vector<uint16_t> half_positions(mesh.positions.size());
+  for (size_t i = 0; i < mesh.positions.size(); ++i) {
+    half_positions[i] = math::FloatToHalf(mesh.positions[i]);
+  }
+  ozz::vector<uint16_t> oct_normals(num_vertices * 2);
+  ozz::vector<uint16_t> oct_tangents(num_vertices * 2);
+  for (int i = 0; i < num_vertices; ++i) {
+    EncodeOctahedral(&mesh.normals[i * 3], &oct_normals[i * 2]);
+    EncodeOctahedral(&mesh.tangents[i * 3], &oct_tangents[i * 2]);
+  }
+  ozz::vector<uint8_t> unorm8_weights(mesh.joint_weights.size());
+  for (size_t i = 0; i < mesh.joint_weights.size(); ++i) {
+    unorm8_weights[i] =
+        static_cast<uint8_t>(std::lround(mesh.joint_weights[i] * 255.f));
+  }
+  job.format = geometry::SkinningJob::kHalfUnorm8;
+  job.joint_weights_unorm8 = make_span(unorm8_weights);
+  job.joint_weights_stride = sizeof(uint8_t) * (influences - 1);
+  job.in_positions_compact = make_span(half_positions);
+  job.in_positions_stride = sizeof(uint16_t) * 3;
+  job.in_normals_compact = make_span(oct_normals);
+  job.in_normals_stride = sizeof(uint16_t) * 2;
+  job.in_tangents_compact = make_span(oct_tangents);
+  job.in_tangents_stride = sizeof(uint16_t) * 2;
+  _runner->Run("skinning_compact", "vertex", num_vertices,
+               [&] { job.Run(); });
+}
+
+void TrackBenchmarks(const Rig& _rig, Runner* _runner) {
+  const animation::FloatTrack& track = *_rig.track;
+
+  {  // Samples the track at spread ratios.
+    float result = 0.f;
+    animation::FloatTrackSamplingJob job;
+    job.track = &track;
+    job.result = &result;
+    _runner->Run("track_sampling", "sample", kTrackSamples, [&] {
+      for (int i = 0; i < kTrackSamples; ++i) {
+        job.ratio = static_cast<float>(i) / kTrackSamples;
+        job.Run();
+      }
+    });
+
+    // Same forward sampling, with a cache.
+    animation::TrackSamplingCache cache;
+    job.cache = &cache;
+    _runner->Run("track_sampling_cached", "sample", kTrackSamples, [&] {
+      for (int i = 0; i < kTrackSamples; ++i) {
+        job.ratio = static_cast<float>(i) / kTrackSamples;
+        job.Run();
+      }
+    });
+  }
+
+  {  // Detects all edges of the track.
+    animation::TrackTriggeringJob::Iterator iterator;
+    animation::TrackTriggeringJob job;
+    job.track = &track;
+    job.from = 0.f;
+    job.to = 1.f;
+    job.threshold = kTrackThreshold;
+    job.iterator = &iterator;
+    int edges = 0;
+    _runner->Run("track_triggering", "key",
+                 static_cast<double>(track.ratios().size()), [&] {
+                   job.Run();
+                   for (; iterator != job.end(); ++iterator) {
+                     ++edges;
+                   }
+                 });
+    ozz::log::LogV() << "Triggered " << edges << " edges." << std::endl;
+
+    // Same, using track edge index.
+    job.track = _rig.indexed_track.get();
+    _runner->Run("track_triggering_indexed", "key",
+                 static_cast<double>(track.ratios().size()), [&] {
+                   job.Run();
+                   for (; iterator != job.end(); ++iterator) {
+                     ++edges;
+                   }
+                 });
+  }
+
+  {  // Triggers per frame ranges, without and with edge index.
+    const animation::FloatTrack* tracks[] = {&track, _rig.indexed_track.get()};
+    const char* names[] = {"track_triggering_frames",
+                           "track_triggering_frames_indexed"};
+    for (int t = 0; t < 2; ++t) {
+      animation::TrackTriggeringJob::Iterator iterator;
+      animation::TrackTriggeringJob job;
+      job.track = tracks[t];
+      job.threshold = kTrackThreshold;
+      job.iterator = &iterator;
+      int edges = 0;
+      _runner->Run(names[t], "sample", kTrackSamples, [&] {
+        for (int i = 0; i < kTrackSamples; ++i) {
+          job.from = static_cast<float>(i) / kTrackSamples;
+          job.to = static_cast<float>(i + 1) / kTrackSamples;
+          job.Run();
+          for (; iterator != job.end(); ++iterator) {
+            ++edges;
+          }
+        }
+      });
+      ozz::log::LogV() << "Triggered " << edges << " edges." << std::endl;
+    }
+  }
+}
+
+void CurvesBenchmarks(const Rig& _rig, Runner* _runner) {
+  // Curves have the same duration as the animation.
+  const float step = PlaybackStep(*_rig.animation);
+
+  {  // Forward playback of all curves, a cached TrackSamplingJob per curve.
+    ozz::vector<animation::TrackSamplingCache> caches(kNumCurves);
+    ozz::vector<float> output(kNumCurves);
+    animation::FloatTrackSamplingJob job;
+    job.ratio = 0.f;
+    _runner->Run("curves_track_sampling", "curve", kNumCurves, [&] {
+      job.ratio = Advance(job.ratio, step);
+      for (int c = 0; c < kNumCurves; ++c) {
+        job.track = _rig.curve_tracks[c].get();
+        job.cache = &caches[c];
+        job.result = &output[c];
+        job.Run();
+      }
+    });
+  }
+
+  {  // Same, with a single FloatCurvesSamplingJob.
+    animation::FloatCurvesSamplingCache cache(kNumCurves);
+    ozz::vector<float> output(kNumCurves);
+    animation::FloatCurvesSamplingJob job;
+    job.curves = _rig.curves.get();
+    job.cache = &cache;
+    job.output = make_span(output);
+    job.ratio = 0.f;
+    _runner->Run("curves_sampling", "curve", kNumCurves, [&] {
+      job.ratio = Advance(job.ratio, step);
+      job.Run();
+    });
+  }
+}
+
+void IKBenchmarks(const Rig& _rig, Runner* _runner) {
+  const animation::Skeleton& skeleton = *_rig.skeleton;
+  Pose pose(_rig);
+  animation::LocalToModelJob ltm;
+  ltm.skeleton = &skeleton;
+  ltm.input = skeleton.joint_bind_poses();
+  ltm.output = make_span(pose.models);
+  ltm.Run();
+
+  math::SimdQuaternion start_correction, mid_correction;
+  bool reached;
+
+  // Requires a chain of 3 joints.
+  if (skeleton.num_joints() >= 4 && skeleton.joint_parents()[3] == 2 &&
+      skeleton.joint_parents()[2] == 1) {
+    animation::IKTwoBoneJob job;
+    job.target = math::simd_float4::Load(.1f, .2f, .1f, 0.f);
+    job.pole_vector = math::simd_float4::y_axis();
+    job.mid_axis = math::simd_float4::z_axis();
+    job.start_joint = &pose.models[1];
+    job.mid_joint = &pose.models[2];
+    job.end_joint = &pose.models[3];
+    job.start_joint_correction = &start_correction;
+    job.mid_joint_correction = &mid_correction;
+    job.reached = &reached;
+    _runner->Run("ik_two_bone", "job", 1, [&] { job.Run(); });
+
+    // A crowd of chains, solved one by one, then 4 by 4.
+    const int kNumChains = 64;
+    math::SimdFloat4 targets[kNumChains];
+    math::SimdFloat4 poles[kNumChains];
+    math::Float4x4 starts[kNumChains], mids[kNumChains], ends[kNumChains];
+    for (int i = 0; i < kNumChains; ++i) {
+      targets[i] = math::simd_float4::Load(.1f, .2f + i * .01f, .1f, 0.f);
+      poles[i] = math::simd_float4::y_axis();
+      starts[i] = pose.models[1];
+      mids[i] = pose.models[2];
+      ends[i] = pose.models[3];
+    }
+    _runner->Run("ik_two_bone_chains", "chain", kNumChains, [&] {
+      for (int i = 0; i < kNumChains; ++i) {
+        job.target = targets[i];
+        job.pole_vector = poles[i];
+        job.start_joint = &starts[i];
+        job.mid_joint = &mids[i];
+        job.end_joint = &ends[i];
+        job.Run();
+      }
+    });
+
+    math::SoaQuaternion start_corrections[kNumChains / 4];
+    math::SoaQuaternion mid_corrections[kNumChains / 4];
+    bool reached_chains[kNumChains];
+    animation::IKTwoBoneBatchJob batch;
+    batch.start_joints = starts;
+    batch.mid_joints = mids;
+    batch.end_joints = ends;
+    batch.targets = targets;
+    batch.pole_vectors = poles;
+    batch.start_joint_corrections = start_corrections;
+    batch.mid_joint_corrections = mid_corrections;
+    batch.reached = reached_chains;
+    _runner->Run("ik_two_bone_batch", "chain", kNumChains,
+                 [&] { batch.Run(); });
+  }
+
+  {
+    animation::IKAimJob job;
+    job.target = math::simd_float4::Load(.1f, .2f, .1f, 0.f);
+    job.forward = math::simd_float4::x_axis();
+    job.up = math::simd_float4::y_axis();
+    job.pole_vector = math::simd_float4::y_axis();
+    job.offset = math::simd_float4::Load(0.f, .1f, 0.f, 0.f);
+    job.joint = &pose.models[0];
+    job.joint_correction = &start_correction;
+    job.reached = &reached;
+    _runner->Run("ik_aim", "job", 1, [&] { job.Run(); });
+  }
+
+  {
+    // Chain from the deepest joint up to the root, ordered from root to end.
+    const span<const int16_t> parents = skeleton.joint_parents();
+    ozz::vector<int> depths(parents.size());
+    int deepest = 0;
+    for (size_t i = 0; i < parents.size(); ++i) {
+      depths[i] = parents[i] == animation::Skeleton::kNoParent
+                      ? 0
+                      : depths[parents[i]] + 1;
+      deepest = depths[i] > depths[deepest] ? static_cast<int>(i) : deepest;
+    }
+    int16_t chain[animation::IKChainJob::kMaxJoints];
+    int num_chain_joints = 0;
+    for (int joint = deepest;
+         joint != animation::Skeleton::kNoParent &&
+         num_chain_joints < animation::IKChainJob::kMaxJoints;
+         joint = parents[joint]) {
+      chain[num_chain_joints++] = static_cast<int16_t>(joint);
+    }
+    std::reverse(chain, chain + num_chain_joints);
+
+    math::SimdQuaternion corrections[animation::IKChainJob::kMaxJoints];
+    animation::IKChainJob job;
+    if (num_chain_joints > 0) {  // A reachable target, near chain middle.
+      job.target = pose.models[chain[num_chain_joints / 2]].cols[3] +
+                   math::simd_float4::Load(.1f, .2f, .1f, 0.f);
+    }
+    job.joints = {chain, static_cast<size_t>(num_chain_joints)};
+    job.models = make_span(pose.models);
+    job.joint_corrections = corrections;
+    job.reached = &reached;
+    if (job.Validate()) {
+      _runner->Run("ik_chain_fabrik", "job", 1, [&] { job.Run(); });
+      job.solver = animation::IKChainJob::kCcd;
+      _runner->Run("ik_chain_ccd", "job", 1, [&] { job.Run(); });
+    }
+  }
+}
+}  // namespace
+}  // namespace benchmark
+}  // namespace ozz
+
+int main(int _argc, const char** _argv) {
+  // Parses arguments.
+  ozz::options::ParseResult parse_result = ozz::options::ParseCommandLine(
+      _argc, _argv, "1.0",
+      "Benchmarks ozz runtime jobs on synthetic rigs, and outputs results as a "
+      "json document.");
+  if (parse_result != ozz::options::kSuccess) {
+    return parse_result == ozz::options::kExitSuccess ? EXIT_SUCCESS
+                                                      : EXIT_FAILURE;
+  }
+
+  ozz::benchmark::RigSettings settings;
+  settings.num_joints = OPTIONS_joints;
+  settings.depth = OPTIONS_depth;
+  settings.level_order = OPTIONS_level_order;
+  settings.duration = OPTIONS_duration;
+  settings.key_density = OPTIONS_keys;
+  settings.num_vertices = OPTIONS_vertices;
+  settings.num_influences = OPTIONS_influences;
+
+  ozz::benchmark::Rig rig;
+  if (!ozz::benchmark::BuildRig(settings, &rig)) {
+    ozz::log::Err() << "Failed to build benchmark rig." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  ozz::benchmark::Runner runner(OPTIONS_iterations, OPTIONS_repetitions,
+                                OPTIONS_filter);
+  ozz::benchmark::SamplingBenchmarks(rig, &runner);
+  ozz::benchmark::BlendingBenchmarks(rig, &runner);
+  ozz::benchmark::LocalToModelBenchmarks(rig, &runner);
+  ozz::benchmark::SkinningBenchmarks(rig, &runner);
+  ozz::benchmark::TrackBenchmarks(rig, &runner);
+  ozz::benchmark::CurvesBenchmarks(rig, &runner);
+  ozz::benchmark::IKBenchmarks(rig, &runner);
+
+  // Outputs results.
+  char config[512];
+  std::snprintf(config, sizeof(config),
+                "{\"joints\": %d, \"depth\": %d, \"level_order\": %s, "
+                "\"duration\": %g, \"keys\": %g, \"vertices\": %d, "
+                "\"influences\": %d, \"iterations\": %d, "
+                "\"repetitions\": %d}",
+                settings.num_joints, settings.depth,
+                settings.level_order ? "true" : "false", settings.duration,
+                settings.key_density, settings.num_vertices,
+                settings.num_influences, runner.iterations(),
+                runner.repetitions());
+
+  const char* filename = OPTIONS_output;
+  if (*filename == 0) {
+    runner.Write(stdout, config);
+  } else {
+    std::FILE* file = std::fopen(filename, "w");
+    if (!file) {
+      ozz::log::Err() << "Failed to open output file \"" << filename << "\"."
+                      << std::endl;
+      return EXIT_FAILURE;
+    }
+    runner.Write(file, config);
+    std::fclose(file);
+  }
+  return EXIT_SUCCESS;
+}
@@ -37,6 +37,13 @@ set(CMAKE_CXX_EXTENSIONS OFF)
 # Simd math force ref
 if(ozz_build_simd_ref)
   set_property(DIRECTORY APPEND PROPERTY COMPILE_DEFINITIONS OZZ_BUILD_SIMD_REF)
+# Simd math avx2, fma and f16c instruction sets
+elseif(ozz_build_simd_avx2)
+  if(MSVC)
+    set_property(DIRECTORY APPEND PROPERTY COMPILE_OPTIONS "/arch:AVX2")
+  else()
+    set_property(DIRECTORY APPEND PROPERTY COMPILE_OPTIONS "-mavx2" "-mfma" "-mf16c")
+  endif()
 endif()
 
 #--------------------------------------
@@ -29,6 +29,7 @@
 #define OZZ_OZZ_ANIMATION_OFFLINE_ANIMATION_OPTIMIZER_H_
 
 #include "ozz/base/containers/map.h"
+#include "ozz/base/task_runner.h"
 
 namespace ozz {
 namespace animation {
@@ -96,6 +97,14 @@ class AnimationOptimizer {
   // Per joint override of optimization settings.
   typedef ozz::map<int, Setting> JointsSetting;
   JointsSetting joints_setting_override;
+
+  // Optional function used to run optimization tasks, allowing to distribute
+  // them across threads, see ozz::TaskRunner. Once hierarchical specs are
+  // computed, translation, rotation and scale tracks of every joint are
+  // decimated independently. Each task writes to its own output track, so the
+  // result is identical to a serial execution.
+  // Tasks are run serially on the calling thread if no runner is set.
+  TaskRunner task_runner;
 };
 }  // namespace offline
 }  // namespace animation
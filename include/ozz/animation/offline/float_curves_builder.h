@@ -0,0 +1,62 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+
+#ifndef OZZ_OZZ_ANIMATION_OFFLINE_FLOAT_CURVES_BUILDER_H_
+#define OZZ_OZZ_ANIMATION_OFFLINE_FLOAT_CURVES_BUILDER_H_
+
+#include "ozz/base/memory/unique_ptr.h"
+
+namespace ozz {
+namespace animation {
+
+// Forward declares the runtime float curves type.
+class FloatCurves;
+
+namespace offline {
+
+// Forward declares the offline float curves type.
+struct RawFloatCurves;
+
+// Defines the class responsible of building runtime FloatCurves instances from
+// offline RawFloatCurves. The input raw curves are first validated. Runtime
+// conversion of validated raw curves cannot fail. Note that no optimization is
+// performed on the data at all, see TrackOptimizer to optimize each curve
+// beforehand.
+class FloatCurvesBuilder {
+ public:
+  // Creates FloatCurves based on _input and *this builder parameters.
+  // Returns a FloatCurves instance on success, an empty unique_ptr on failure.
+  // See RawFloatCurves::Validate() for more details about failure reasons.
+  // The curves are returned as an unique_ptr as ownership is given back to
+  // the caller.
+  ozz::unique_ptr<FloatCurves> operator()(const RawFloatCurves& _input) const;
+};
+}  // namespace offline
+}  // namespace animation
+}  // namespace ozz
+#endif  // OZZ_OZZ_ANIMATION_OFFLINE_FLOAT_CURVES_BUILDER_H_
@@ -0,0 +1,74 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+
+#ifndef OZZ_OZZ_ANIMATION_OFFLINE_RAW_FLOAT_CURVES_H_
+#define OZZ_OZZ_ANIMATION_OFFLINE_RAW_FLOAT_CURVES_H_
+
+#include "ozz/animation/offline/raw_track.h"
+#include "ozz/base/containers/string.h"
+#include "ozz/base/containers/vector.h"
+#include "ozz/base/io/archive_traits.h"
+
+namespace ozz {
+namespace animation {
+namespace offline {
+
+// Offline float curves, a set of float user-channel tracks that are sampled
+// together at runtime (blend shape weights, material parameters...). Each
+// curve is a RawFloatTrack, with the same keyframes rules. RawFloatCurves is
+// converted to the runtime FloatCurves using the FloatCurvesBuilder. Curves
+// order is preserved: curve i values are output at index i by the
+// FloatCurvesSamplingJob.
+struct RawFloatCurves {
+  // Validates that all the following rules are respected:
+  //  1. Every curve is valid, see RawFloatTrack::Validate().
+  //  2. The number of curves is lower or equal to FloatCurves::kMaxCurves.
+  bool Validate() const;
+
+  // Returns the number of curves.
+  int num_curves() const { return static_cast<int>(curves.size()); }
+
+  // Uses intrusive serialization option.
+  void Save(io::OArchive& _archive) const;
+  void Load(io::IArchive& _archive, uint32_t _version);
+
+  // Sequence of curves. Curve names are kept in the offline data only.
+  ozz::vector<RawFloatTrack> curves;
+
+  // Name of the curves set.
+  string name;
+};
+}  // namespace offline
+}  // namespace animation
+
+namespace io {
+OZZ_IO_TYPE_VERSION(1, animation::offline::RawFloatCurves)
+OZZ_IO_TYPE_TAG("ozz-raw_float_curves", animation::offline::RawFloatCurves)
+}  // namespace io
+}  // namespace ozz
+#endif  // OZZ_OZZ_ANIMATION_OFFLINE_RAW_FLOAT_CURVES_H_
@@ -45,6 +45,9 @@ struct RawSkeleton;
 // Defines the class responsible of building Skeleton instances.
 class SkeletonBuilder {
  public:
+  // Initializes the builder with default parameters.
+  SkeletonBuilder();
+
   // Creates a Skeleton based on _raw_skeleton and *this builder parameters.
   // Returns a Skeleton instance on success, an empty unique_ptr on failure. See
   // RawSkeleton::Validate() for more details about failure reasons.
@@ -52,6 +55,17 @@ class SkeletonBuilder {
   // caller.
   ozz::unique_ptr<ozz::animation::Skeleton> operator()(
       const RawSkeleton& _raw_skeleton) const;
+
+  // Builder parameters.
+
+  // Orders runtime skeleton joints level by level (breadth-first, roots first,
+  // then all their children...) instead of depth-first. Joints of a same level
+  // don't depend on each other, which allows LocalToModelJob to process them 4
+  // by 4 with SoA maths. This mostly benefits wide hierarchies (hands, faces,
+  // creatures with many limbs...). Note that a sub-hierarchy isn't stored
+  // contiguously anymore, so iterating it requires more work.
+  // Default value is false.
+  bool level_order;
 };
 }  // namespace offline
 }  // namespace animation
@@ -55,6 +55,9 @@ struct RawQuaternionTrack;
 // the data at all.
 class TrackBuilder {
  public:
+  // Initializes the builder with default parameters.
+  TrackBuilder();
+
   // Creates a Track based on _raw_track and *this builder parameters.
   // Returns a track instance on success, an empty unique_ptr on failure. See
   // Raw*Track::Validate() for more details about failure reasons.
@@ -67,6 +70,40 @@ class TrackBuilder {
   ozz::unique_ptr<QuaternionTrack> operator()(
       const RawQuaternionTrack& _input) const;
 
+  // Builder parameters.
+
+  // Builds an edge index for FloatTrack, storing all the edges detected when
+  // looping once over the track with edge_threshold threshold. When triggered
+  // with the same threshold, TrackTriggeringJob then finds edges with binary
+  // searches in the index, instead of scanning all track keys in the triggered
+  // range. This benefits tracks that are triggered often (footsteps, sound or
+  // vfx events on many characters), at the cost of 4 bytes and a bit per edge.
+  // Ignored for other track types.
+  // Default value is false.
+  bool edge_index;
+
+  // Edge detection threshold of the edge index, see
+  // TrackTriggeringJob::threshold.
+  // Default value is 0.
+  float edge_threshold;
+
+  // Stores keyframe ratios as 16 bits unsigned normalized integers instead of
+  // floats, which moves keys by at most 1/131070. Ratios are kept as floats if
+  // 2 successive keys would have the same quantized ratio, as keys ratios must
+  // remain strictly increasing. Ignored for FloatTrack, as TrackTriggeringJob
+  // reads float ratios.
+  // Default value is false.
+  bool quantize_ratios;
+
+  // Stores keyframe values as 16 bits components instead of floats: half
+  // floats for Float2Track, Float3Track and Float4Track, and the 3 smallest
+  // components of normalized quaternions for QuaternionTrack (about 4e-5
+  // precision). Half floats have a relative precision of about 1e-3, and a
+  // [-65504,65504] range. Ignored for FloatTrack, as TrackTriggeringJob reads
+  // float values.
+  // Default value is false.
+  bool quantize_values;
+
  private:
   template <typename _RawTrack, typename _Track>
   ozz::unique_ptr<_Track> Build(const _RawTrack& _input) const;
@@ -90,6 +90,28 @@ class Animation {
   // Gets the buffer of scale keys.
   span<const Float3Key> scales() const { return scales_; }
 
+  // Gets the number of regular segments the [0,1] ratio interval is divided
+  // in, for the seeking index. Segment _i starts at ratio seek_ratio(_i).
+  // 0 means the animation has no seeking index, which is the case of
+  // animations with too few keys to benefit from it.
+  int num_seek_segments() const { return num_seek_segments_; }
+
+  // Gets the time ratio at the beginning of seeking segment _segment.
+  float seek_ratio(int _segment) const {
+    return static_cast<float>(_segment) / num_seek_segments_;
+  }
+
+  // Gets the seeking index buffers, for translations, rotations and scales.
+  // For each segment, the index stores num_soa_tracks() * 4 * 2 + 1 integers:
+  // the position of the cursor in the key buffer, followed by the indices of
+  // the 2 keys (left and right) of every track, as they would be in the
+  // SamplingCache after sampling the animation at seek_ratio(segment).
+  // This allows SamplingJob to seek (backward or forward) anywhere in the
+  // animation with a bounded cost, instead of scanning keys from the start.
+  span<const int> translations_seek() const { return translations_seek_; }
+  span<const int> rotations_seek() const { return rotations_seek_; }
+  span<const int> scales_seek() const { return scales_seek_; }
+
   // Get the estimated animation's size in bytes.
   size_t size() const;
 
@@ -98,6 +120,29 @@ class Animation {
   void Save(ozz::io::OArchive& _archive) const;
   void Load(ozz::io::IArchive& _archive, uint32_t _version);
 
+  // Memory view functions, aka zero-copy loading.
+  // A view is a native-endian image of all animation buffers (keys and seeking
+  // index), prefixed with a small header. As opposed to archives, a view is
+  // specific to the platform (endianness, compiler) and ozz version that
+  // produced it, so it's usually generated from an archive on the target
+  // platform, at cooking time.
+
+  // Gets the size in bytes of *this animation view.
+  size_t view_size() const;
+
+  // Writes *this animation view to _view, which must be at least view_size()
+  // bytes and 16 bytes aligned. Returns false if _view is invalid.
+  bool SaveView(span<char> _view) const;
+
+  // Binds *this animation to _view memory, as written by SaveView(). Nothing
+  // is copied nor deserialized, animation buffers point straight into _view,
+  // which could be a memory mapped file. _view must thus be 16 bytes aligned,
+  // and must remain valid and unchanged as long as *this animation uses it
+  // (until it's destroyed or loaded again). The view header (type, version,
+  // endianness and sizes) is validated in constant time, but keys are trusted.
+  // Returns false and leaves *this animation empty if _view is invalid.
+  bool LoadView(span<const char> _view);
+
  protected:
  private:
   // Disables copy and assignation.
@@ -112,6 +157,15 @@ class Animation {
                 size_t _rotation_count, size_t _scale_count);
   void Deallocate();
 
+  // Distributes _buffer memory to animation buffers, for the given counts.
+  // num_tracks_ must be set. _buffer is modified to reflect remain size.
+  void Bind(span<char>& _buffer, size_t _name_len, size_t _translation_count,
+            size_t _rotation_count, size_t _scale_count);
+
+  // Computes seeking index content from keyframes. Keys must be filled before
+  // calling this function.
+  void BuildSeekIndex();
+
   // Duration of the animation clip.
   float duration_;
 
@@ -122,10 +176,20 @@ class Animation {
   // Animation name.
   char* name_;
 
+  // Buffer allocated by *this animation for all its data. It's nullptr if
+  // animation is empty or bound to an external view.
+  void* allocation_;
+
   // Stores all translation/rotation/scale keys begin and end of buffers.
   span<Float3Key> translations_;
   span<QuaternionKey> rotations_;
   span<Float3Key> scales_;
+
+  // Seeking index, see num_seek_segments().
+  int num_seek_segments_;
+  span<int> translations_seek_;
+  span<int> rotations_seek_;
+  span<int> scales_seek_;
 };
 }  // namespace animation
 
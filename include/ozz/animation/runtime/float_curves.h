@@ -0,0 +1,129 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+
+#ifndef OZZ_OZZ_ANIMATION_RUNTIME_FLOAT_CURVES_H_
+#define OZZ_OZZ_ANIMATION_RUNTIME_FLOAT_CURVES_H_
+
+#include "ozz/base/io/archive_traits.h"
+#include "ozz/base/platform.h"
+#include "ozz/base/span.h"
+
+namespace ozz {
+namespace io {
+class IArchive;
+class OArchive;
+}  // namespace io
+namespace animation {
+
+// Forward declares the FloatCurvesBuilder, used to instantiate FloatCurves.
+namespace offline {
+class FloatCurvesBuilder;
+}
+
+// Forward declaration of key frame's type.
+struct FloatCurveKey;
+
+// Defines a runtime set of float curves, aka float user-channel tracks that
+// are always sampled together at the same ratio (blend shape weights, material
+// parameters...).
+// As opposed to a FloatTrack per channel, all the keys of all the curves are
+// packed in a single array, sorted by time ratio, the same way Animation stores
+// joint tracks. FloatCurvesSamplingJob can then sample all curves with a
+// single forward pass over the keys, interpolating 4 curves at a time with SoA
+// maths. Like tracks, curves have no duration: keys ratios are in the unit
+// interval [0,1]. This structure is usually filled by the FloatCurvesBuilder
+// and deserialized/loaded at runtime.
+class FloatCurves {
+ public:
+  // Defines FloatCurves constant values.
+  enum Constants {
+    // Defines the maximum number of curves. Keys store their curve index on 16
+    // bits.
+    kMaxCurves = 16384,
+  };
+
+  // Builds empty curves.
+  FloatCurves();
+
+  // Declares the public non-virtual destructor.
+  ~FloatCurves();
+
+  // Gets the number of curves.
+  int num_curves() const { return num_curves_; }
+
+  // Returns the number of SoA elements matching the number of curves. This
+  // value is useful to allocate SoA runtime data structures.
+  int num_soa_curves() const { return (num_curves_ + 3) / 4; }
+
+  // Gets curves name.
+  const char* name() const { return name_ ? name_ : ""; }
+
+  // Gets the buffer of keys, for all curves.
+  span<const FloatCurveKey> keys() const { return keys_; }
+
+  // Get the estimated curves' size in bytes.
+  size_t size() const;
+
+  // Serialization functions.
+  // Should not be called directly but through io::Archive << and >> operators.
+  void Save(ozz::io::OArchive& _archive) const;
+  void Load(ozz::io::IArchive& _archive, uint32_t _version);
+
+ private:
+  // Disables copy and assignation.
+  FloatCurves(FloatCurves const&);
+  void operator=(FloatCurves const&);
+
+  // FloatCurvesBuilder class is allowed to instantiate FloatCurves.
+  friend class offline::FloatCurvesBuilder;
+
+  // Internal allocation and destruction functions.
+  void Allocate(size_t _name_len, size_t _key_count);
+  void Deallocate();
+
+  // The number of curves. Keys buffer contains keys of num_soa_curves() * 4
+  // curves, because of SoA requirements.
+  int num_curves_;
+
+  // Curves name.
+  char* name_;
+
+  // Buffer allocated by *this object for all its data.
+  void* allocation_;
+
+  // Keys of all curves, sorted by ratio.
+  span<FloatCurveKey> keys_;
+};
+}  // namespace animation
+
+namespace io {
+OZZ_IO_TYPE_VERSION(1, animation::FloatCurves)
+OZZ_IO_TYPE_TAG("ozz-float_curves", animation::FloatCurves)
+}  // namespace io
+}  // namespace ozz
+#endif  // OZZ_OZZ_ANIMATION_RUNTIME_FLOAT_CURVES_H_
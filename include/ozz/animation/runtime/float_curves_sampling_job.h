@@ -0,0 +1,162 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+
+#ifndef OZZ_OZZ_ANIMATION_RUNTIME_FLOAT_CURVES_SAMPLING_JOB_H_
+#define OZZ_OZZ_ANIMATION_RUNTIME_FLOAT_CURVES_SAMPLING_JOB_H_
+
+#include "ozz/base/platform.h"
+#include "ozz/base/span.h"
+
+namespace ozz {
+namespace animation {
+
+// Forward declares the float curves type to sample.
+class FloatCurves;
+
+// Forward declares the cache object used by the FloatCurvesSamplingJob.
+class FloatCurvesSamplingCache;
+
+// Samples all the curves of a FloatCurves object at a given time ratio in the
+// unit interval [0,1], and outputs curves values to a contiguous array of
+// floats (output[i] is the value of curve i).
+// This is the batched counterpart of running a TrackSamplingJob per FloatTrack,
+// and gives the same results. Like SamplingJob, it uses a cache to store the
+// keys that are being interpolated, which is updated incrementally while the
+// curves are sampled forward. Curves are interpolated 4 at a time using SoA
+// maths. Backward sampling and jumps in time don't benefit from the cache, as
+// keys are scanned again from the beginning. The job does not owned the
+// buffers (in/output) and will thus not delete them during job's destruction.
+struct FloatCurvesSamplingJob {
+  // Default constructor, initializes default values.
+  FloatCurvesSamplingJob();
+
+  // Validates job parameters. Returns true for a valid job, or false otherwise:
+  // -if any input pointer is nullptr
+  // -if cache is too small for curves.
+  // -if output range is smaller than the number of curves.
+  bool Validate() const;
+
+  // Runs job's sampling task.
+  // The job is validated before any operation is performed, see Validate() for
+  // more details.
+  // Returns false if *this job is not valid.
+  bool Run() const;
+
+  // Time ratio in the unit interval [0,1] used to sample curves (where 0 is
+  // the beginning of the curves, 1 is the end).
+  // This ratio is clamped before job execution in order to resolves any
+  // approximation issue on range bounds.
+  float ratio;
+
+  // The curves to sample.
+  const FloatCurves* curves;
+
+  // A cache object that must be big enough to sample *this curves.
+  FloatCurvesSamplingCache* cache;
+
+  // Job output.
+  // The output range to be filled with curves values during job execution. It
+  // must be at least as big as the number of curves. Remaining values are left
+  // unchanged.
+  span<float> output;
+};
+
+namespace internal {
+// Soa hot data to interpolate.
+struct InterpSoaFloatCurve;
+}  // namespace internal
+
+// Declares the cache object used by the FloatCurvesSamplingJob to take
+// advantage of the frame coherency of curves sampling.
+class FloatCurvesSamplingCache {
+ public:
+  // Constructs an empty cache. The cache needs to be resized with the
+  // appropriate number of curves before it can be used with a
+  // FloatCurvesSamplingJob.
+  FloatCurvesSamplingCache();
+
+  // Constructs a cache that can be used to sample any FloatCurves with at most
+  // _max_curves curves. _max_curves is internally aligned to a multiple of soa
+  // size, which means max_curves() can return a different (but bigger) value
+  // than _max_curves.
+  explicit FloatCurvesSamplingCache(int _max_curves);
+
+  // Deallocates cache.
+  ~FloatCurvesSamplingCache();
+
+  // Resize the number of curves that the cache can support.
+  // This also implicitly invalidate the cache.
+  void Resize(int _max_curves);
+
+  // Invalidate the cache.
+  // The FloatCurvesSamplingJob automatically invalidates a cache when required
+  // during sampling, based on curves address and sampling time ratio. As for
+  // SamplingCache, it is recommended to manually invalidate a cache when it is
+  // known that this cache will not be used for with these curves again.
+  void Invalidate();
+
+  // The maximum number of curves that the cache can handle.
+  int max_curves() const { return max_soa_curves_ * 4; }
+  int max_soa_curves() const { return max_soa_curves_; }
+
+ private:
+  // Disables copy and assignation.
+  FloatCurvesSamplingCache(FloatCurvesSamplingCache const&);
+  void operator=(FloatCurvesSamplingCache const&);
+
+  friend struct FloatCurvesSamplingJob;
+
+  // Steps the cache in order to use it for potentially new curves and ratio.
+  // If _curves is different from the curves currently cached, or if _ratio
+  // shows that curves are sampled backward, then the cache is invalidated.
+  void Step(const FloatCurves& _curves, float _ratio);
+
+  // The curves this cache refers to. nullptr means that the cache is invalid.
+  const FloatCurves* curves_;
+
+  // The current time ratio in the curves.
+  float ratio_;
+
+  // The number of soa curves that can store this cache.
+  int max_soa_curves_;
+
+  // Soa hot data to interpolate.
+  internal::InterpSoaFloatCurve* soa_curves_;
+
+  // Points to the keys in the curves that are valid for the current time ratio.
+  int* keys_;
+
+  // Current cursor in the curves keys. 0 means that the cache is invalid.
+  int cursor_;
+
+  // Outdated soa entries. One bit per soa entry (32 curves per byte).
+  uint8_t* outdated_;
+};
+}  // namespace animation
+}  // namespace ozz
+#endif  // OZZ_OZZ_ANIMATION_RUNTIME_FLOAT_CURVES_SAMPLING_JOB_H_
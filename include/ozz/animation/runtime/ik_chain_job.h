@@ -0,0 +1,134 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+
+#ifndef OZZ_OZZ_ANIMATION_RUNTIME_IK_CHAIN_JOB_H_
+#define OZZ_OZZ_ANIMATION_RUNTIME_IK_CHAIN_JOB_H_
+
+#include "ozz/base/platform.h"
+#include "ozz/base/span.h"
+
+#include "ozz/base/maths/simd_math.h"
+
+namespace ozz {
+// Forward declaration of math structures.
+namespace math {
+struct SimdQuaternion;
+}
+
+namespace animation {
+
+// ozz::animation::IKChainJob performs inverse kinematic on a chain of any
+// number of joints (spines, tails, tentacles...), such that the last joint of
+// the chain (named end) reaches the provided target position (if possible).
+// The job only reads model-space matrices of the chain joints, and computes
+// the local-space rotation corrections of all of them in a single call, so
+// there's no need to update the full skeleton model-space matrices between
+// joints.
+// Chain joints must be ancestors, ordered from the root of the chain to its
+// end. They don't need to be direct ancestors (joints in-between will simply
+// remain fixed).
+// The chain is solved iteratively, with FABRIK (Forward And Backward Reaching
+// Inverse Kinematics) or CCD (Cyclic Coordinate Descent) algorithm. Iterations
+// stop once the end joint is closer to the target than a tolerance distance,
+// or when the iteration budget is consumed.
+struct IKChainJob {
+  // Chain solving algorithms.
+  enum Solver {
+    // Forward And Backward Reaching Inverse Kinematics. Joint positions are
+    // solved first, distributing the rotation along the whole chain, then
+    // converted to rotations. This is the default.
+    kFabrik,
+    // Cyclic Coordinate Descent. Each joint, from chain end to root, is
+    // rotated so the end joint points toward the target. Rotation tends to be
+    // concentrated on joints close to chain end.
+    kCcd,
+  };
+
+  // Maximum number of joints in a chain.
+  enum { kMaxJoints = 64 };
+
+  // Constructor, initializes default values.
+  IKChainJob();
+
+  // Validates job parameters. Returns true for a valid job, or false otherwise:
+  // -if joints has less than 2 or more than kMaxJoints joints.
+  // -if any joint index is out of models range.
+  // -if joint_corrections is smaller than joints.
+  // -if max_iterations or tolerance is negative.
+  bool Validate() const;
+
+  // Runs job's execution task.
+  // The job is validated before any operation is performed, see Validate() for
+  // more details.
+  // Returns false if *this job is not valid.
+  bool Run() const;
+
+  // Job input.
+
+  // Target IK position, in model-space. This is the position the end of the
+  // joint chain will try to reach.
+  math::SimdFloat4 target;
+
+  // Indices of the chain joints in models span, ordered from the chain root
+  // to its end.
+  span<const int16_t> joints;
+
+  // Model-space matrices of the skeleton (typically LocalToModelJob output).
+  // Only chain joints matrices are read.
+  span<const math::Float4x4> models;
+
+  // Chain solving algorithm, default is kFabrik.
+  Solver solver;
+
+  // Maximum number of iterations, bounding the cost per frame. Default is 10.
+  int max_iterations;
+
+  // Distance from the end joint to the target, below which the target is
+  // considered reached, and iterations stop. Default is 1e-3.
+  float tolerance;
+
+  // Weight given to the IK correction clamped in range [0,1]. This allows to
+  // blend / interpolate from no IK applied (0 weight) to full IK (1).
+  float weight;
+
+  // Job output.
+
+  // Local-space corrections to apply to each joint of the chain in order for
+  // the end joint to reach target position. These quaternions must be
+  // multiplied to the local-space quaternion of their respective joints. The
+  // end joint correction is always identity, as rotating it doesn't move it.
+  span<math::SimdQuaternion> joint_corrections;
+
+  // Optional boolean output value, set to true if end joint is within
+  // tolerance distance of the target. Target is considered unreached if weight
+  // is less than 1.
+  bool* reached;
+};
+}  // namespace animation
+}  // namespace ozz
+#endif  // OZZ_OZZ_ANIMATION_RUNTIME_IK_CHAIN_JOB_H_
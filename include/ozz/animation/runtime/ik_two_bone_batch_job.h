@@ -0,0 +1,111 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+
+#ifndef OZZ_OZZ_ANIMATION_RUNTIME_IK_TWO_BONE_BATCH_JOB_H_
+#define OZZ_OZZ_ANIMATION_RUNTIME_IK_TWO_BONE_BATCH_JOB_H_
+
+#include "ozz/base/platform.h"
+#include "ozz/base/span.h"
+
+#include "ozz/base/maths/simd_math.h"
+
+namespace ozz {
+// Forward declaration of math structures.
+namespace math {
+struct SoaQuaternion;
+}
+
+namespace animation {
+
+// ozz::animation::IKTwoBoneBatchJob performs the same inverse kinematic as
+// IKTwoBoneJob, but for a batch of independent two bone chains (typically the
+// legs of a crowd of characters). Chains are solved 4 by 4, each of the 4 SIMD
+// lanes solving a chain, with the same algorithm as IKTwoBoneJob. Results
+// match IKTwoBoneJob ones, within floating point precision.
+// Joint matrices, targets and pole vectors are provided per chain. Middle joint
+// axis and other settings are shared by all chains.
+// The job outputs start and middle joint rotation corrections as SoA
+// quaternions, chain i being in lane i%4 of quaternion i/4.
+struct IKTwoBoneBatchJob {
+  // Constructor, initializes default values.
+  IKTwoBoneBatchJob();
+
+  // Validates job parameters. Returns true for a valid job, or false otherwise:
+  // -if start_joints, mid_joints, end_joints, targets and pole_vectors don't
+  // have the same size.
+  // -if start_joint_corrections or mid_joint_corrections are smaller than the
+  // number of SoA chains, aka (start_joints.size() + 3) / 4.
+  // -if reached isn't empty and is smaller than the number of chains.
+  // -if mid_axis isn't normalized.
+  bool Validate() const;
+
+  // Runs job's execution task.
+  // The job is validated before any operation is performed, see Validate() for
+  // more details.
+  // Returns false if *this job is not valid.
+  bool Run() const;
+
+  // Job input.
+
+  // Model-space matrices of the start, middle and end joints of each chain.
+  // See IKTwoBoneJob::start_joint, mid_joint and end_joint.
+  span<const math::Float4x4> start_joints;
+  span<const math::Float4x4> mid_joints;
+  span<const math::Float4x4> end_joints;
+
+  // Target IK position of each chain, in model-space. See IKTwoBoneJob::target.
+  span<const math::SimdFloat4> targets;
+
+  // Pole vector of each chain, in model-space. See IKTwoBoneJob::pole_vector.
+  span<const math::SimdFloat4> pole_vectors;
+
+  // Normalized middle joint rotation axis, in middle joint local-space, shared
+  // by all chains. Default value is z axis. See IKTwoBoneJob::mid_axis.
+  math::SimdFloat4 mid_axis;
+
+  // Twist angle, soften ratio and weight applied to all chains. See
+  // IKTwoBoneJob::twist_angle, soften and weight.
+  float twist_angle;
+  float soften;
+  float weight;
+
+  // Job output.
+
+  // Local-space corrections to apply to start and middle joints of each chain,
+  // chain i being stored in lane i%4 of SoA quaternion i/4. Lanes beyond the
+  // number of chains are set to identity.
+  span<math::SoaQuaternion> start_joint_corrections;
+  span<math::SoaQuaternion> mid_joint_corrections;
+
+  // Optional output, set to true for each chain whose target can be reached.
+  // See IKTwoBoneJob::reached.
+  span<bool> reached;
+};
+}  // namespace animation
+}  // namespace ozz
+#endif  // OZZ_OZZ_ANIMATION_RUNTIME_IK_TWO_BONE_BATCH_JOB_H_
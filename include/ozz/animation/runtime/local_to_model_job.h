@@ -30,6 +30,7 @@
 
 #include "ozz/base/platform.h"
 #include "ozz/base/span.h"
+#include "ozz/base/task_runner.h"
 
 namespace ozz {
 
@@ -39,6 +40,7 @@ struct SoaTransform;
 }
 namespace math {
 struct Float4x4;
+struct Float3x4;
 }
 
 namespace animation {
@@ -46,6 +48,10 @@ namespace animation {
 // Forward declares the Skeleton object used to describe joint hierarchy.
 class Skeleton;
 
+// Forward declares the SkeletonPartition object used by
+// ParallelLocalToModelJob.
+class SkeletonPartition;
+
 // Computes model-space joint matrices from local-space SoaTransform.
 // This job uses the skeleton to define joints parent-child hierarchy. The job
 // iterates through all joints to compute their transform relatively to the
@@ -54,7 +60,8 @@ class Skeleton;
 // skeleton's joints. Job output is an array of matrices (in model-space),
 // ordered like skeleton's joints. Output are matrices, because the combination
 // of affine transformations can contain shearing or complex transformation
-// that cannot be represented as Transform object.
+// that cannot be represented as Transform object. Matrices can either be output
+// as Float4x4, or as smaller Float3x4 affine matrices (see output_3x4).
 struct LocalToModelJob {
   // Default constructor, initializes default values.
   LocalToModelJob();
@@ -63,8 +70,11 @@ struct LocalToModelJob {
   // -if any input pointer, including ranges, is nullptr.
   // -if the size of the input is smaller than the skeleton's number of joints.
   // Note that this input has a SoA format.
+  // -if both output and output_3x4 are set.
   // -if the size of of the output is smaller than the skeleton's number of
   // joints.
+  // -if input_dirty or output_dirty aren't empty but are smaller than the
+  // skeleton's number of joints.
   bool Validate() const;
 
   // Runs job's local-to-model task.
@@ -110,10 +120,91 @@ struct LocalToModelJob {
   // The input range that store local transforms.
   span<const ozz::math::SoaTransform> input;
 
+  // Optional per joint flags telling which local transforms changed since the
+  // previous update. If not empty, it must have at least skeleton's number of
+  // joints elements, and the job runs incrementally: only dirty joints and
+  // their descendants (in the "from"/"to" range) are recomputed, other output
+  // matrices are left unchanged. They must thus be valid from a previous
+  // update. This saves most of the job cost when only a few joints changed,
+  // after an IK correction or a partial layer for example.
+  // Note that root joints must be flagged if the root matrix changed. If
+  // "from_excluded" is true, "from" model-space matrix is considered changed,
+  // so all its children are recomputed.
+  span<const bool> input_dirty;
+
+  // Job output.
+
+  // The output range to be filled with model-space matrices.
+  span<ozz::math::Float4x4> output;
+
+  // Alternative output range to be filled with model-space 3x4 affine matrices.
+  // If set, output must be empty. Float3x4 matrices are 25% smaller, cheaper
+  // to compute and can be uploaded as is to GPU skinning palettes. Root matrix
+  // last row is ignored in this case.
+  span<ozz::math::Float3x4> output_3x4;
+
+  // Optional per joint flags telling which model-space matrices were
+  // recomputed. If not empty, it must have at least skeleton's number of
+  // joints elements. Flags are set to true for recomputed joints, and false
+  // for all others. This allows downstream updates (skinning matrices...) to
+  // skip unchanged joints.
+  span<bool> output_dirty;
+};
+
+// Computes model-space joint matrices from local-space SoaTransform, like
+// LocalToModelJob, for a skeleton partitioned in independent subtrees (see
+// SkeletonPartition). Shared ancestors are computed first, on the calling
+// thread. Partitions are then computed as independent tasks, which can be
+// distributed across threads with a task runner. This reduces the latency of
+// huge skeletons (creatures, facial rigs...) update.
+// Partitions are cheaper to compute for depth-first skeletons, as subtrees are
+// contiguous.
+struct ParallelLocalToModelJob {
+  // Default constructor, initializes default values.
+  ParallelLocalToModelJob();
+
+  // Validates job parameters. Returns true for a valid job, or false otherwise:
+  // -if skeleton or partition pointer is nullptr.
+  // -if partition wasn't built for a skeleton with the same number of joints.
+  // -if input or output ranges are invalid, see LocalToModelJob::Validate().
+  bool Validate() const;
+
+  // Runs job's local-to-model task.
+  // The job is validated before any operation is performed, see Validate() for
+  // more details.
+  // Returns false if job is not valid. See Validate() function.
+  bool Run() const;
+
+  // Job input.
+
+  // The Skeleton object describing the joint hierarchy used for local to
+  // model space conversion.
+  const Skeleton* skeleton;
+
+  // Partition of skeleton, usually built once when skeleton is loaded.
+  const SkeletonPartition* partition;
+
+  // The root matrix will multiply to every model space matrices, see
+  // LocalToModelJob::root.
+  const ozz::math::Float4x4* root;
+
+  // The input range that store local transforms.
+  span<const ozz::math::SoaTransform> input;
+
+  // Optional function used to run partitions tasks, allowing to distribute them
+  // across threads, see ozz::TaskRunner. Each task writes model-space matrices
+  // of its own partition joints only.
+  // Tasks are run serially on the calling thread if no runner is set.
+  TaskRunner task_runner;
+
   // Job output.
 
   // The output range to be filled with model-space matrices.
   span<ozz::math::Float4x4> output;
+
+  // Alternative output range to be filled with model-space 3x4 affine matrices,
+  // see LocalToModelJob::output_3x4.
+  span<ozz::math::Float3x4> output_3x4;
 };
 }  // namespace animation
 }  // namespace ozz
@@ -0,0 +1,133 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#ifndef OZZ_OZZ_ANIMATION_RUNTIME_SAMPLING_BLENDING_JOB_H_
+#define OZZ_OZZ_ANIMATION_RUNTIME_SAMPLING_BLENDING_JOB_H_
+
+#include "ozz/base/maths/simd_math.h"
+#include "ozz/base/span.h"
+
+namespace ozz {
+
+// Forward declaration of math structures.
+namespace math {
+struct SoaTransform;
+}
+
+namespace animation {
+
+// Forward declares the animation type to sample.
+class Animation;
+
+// Forward declares the cache object used to sample animations.
+class SamplingCache;
+
+// ozz::animation::SamplingBlendingJob fuses SamplingJob and BlendingJob in a
+// single job. Every layer is an animation sampled at a given time ratio, whose
+// result is directly blended to the output, without intermediate local-space
+// buffers. Joints are processed by small batches, so that the sampled
+// transforms of all layers remain in cpu cache until they're blended.
+// Blending stages (weights normalization, threshold and bind pose fallback,
+// partial and additive blending) behave exactly like BlendingJob, see
+// BlendingJob for more details.
+// Layers with a weight of 0 (or less, for non additive layers) are not
+// sampled.
+// The job does not owned any buffers (input/output) and will thus not delete
+// them during job's destruction.
+struct SamplingBlendingJob {
+  // Default constructor, initializes default values.
+  SamplingBlendingJob();
+
+  // Validates job parameters.
+  // Returns true for a valid job, false otherwise:
+  // -if any layer is not valid: nullptr animation or cache, cache too small,
+  // animation with less tracks than the bind pose, invalid joint weights.
+  // -if output range is not valid.
+  // -if output or joint weights buffers are smaller than the bind pose buffer.
+  // -if the threshold value is less than or equal to 0.f.
+  bool Validate() const;
+
+  // Runs job's sampling and blending task.
+  // The job is validated before any operation is performed, see Validate() for
+  // more details.
+  // Returns false if *this job is not valid.
+  bool Run() const;
+
+  // Defines a layer of blending input data (animation to sample) and
+  // parameters (weights).
+  struct Layer {
+    // Default constructor, initializes default values.
+    Layer();
+
+    // Blending weight of this layer, see BlendingJob::Layer::weight.
+    float weight;
+
+    // The animation to sample. It must have at least as many tracks as the
+    // bind pose buffer, even though only the number of transforms defined by
+    // the bind pose buffer will be processed.
+    const Animation* animation;
+
+    // A cache object that must be big enough to sample *this animation. A
+    // cache shall not be used by more than one layer of the same job.
+    SamplingCache* cache;
+
+    // Time ratio in the unit interval [0,1] used to sample the animation, see
+    // SamplingJob::ratio.
+    float ratio;
+
+    // Optional range [begin,end[ of blending weight for each joint in this
+    // layer, see BlendingJob::Layer::joint_weights.
+    span<const math::SimdFloat4> joint_weights;
+  };
+
+  // The job blends the bind pose to the output when the accumulated weight of
+  // all layers is less than this threshold value.
+  // Must be greater than 0.f.
+  float threshold;
+
+  // Job input layers, can be empty or nullptr.
+  // The range of layers that must be sampled and blended.
+  span<const Layer> layers;
+
+  // Job input additive layers, can be empty or nullptr.
+  // The range of layers that must be sampled and added to the output.
+  span<const Layer> additive_layers;
+
+  // The skeleton bind pose. The size of this buffer defines the number of
+  // transforms to blend, see BlendingJob::bind_pose.
+  span<const ozz::math::SoaTransform> bind_pose;
+
+  // Job output.
+  // The range of output transforms to be filled with blended layer
+  // transforms during job execution.
+  // Must be at least as big as the bind pose buffer, but only the number of
+  // transforms defined by the bind pose buffer size will be processed.
+  span<ozz::math::SoaTransform> output;
+};
+}  // namespace animation
+}  // namespace ozz
+#endif  // OZZ_OZZ_ANIMATION_RUNTIME_SAMPLING_BLENDING_JOB_H_
@@ -46,15 +46,21 @@ class Animation;
 // Forward declares the cache object used by the SamplingJob.
 class SamplingCache;
 
+// Forward declares the fused sampling and blending job, allowed to access
+// SamplingCache internals.
+struct SamplingBlendingJob;
+
 // Samples an animation at a given time ratio in the unit interval [0,1] (where
 // 0 is the beginning of the animation, 1 is the end), to output the
 // corresponding posture in local-space.
 // SamplingJob uses a cache (aka SamplingCache) to store intermediate values
 // (decompressed animation keyframes...) while sampling. This cache also stores
 // pre-computed values that allows drastic optimization while playing/sampling
-// the animation forward. Backward sampling works, but isn't optimized through
-// the cache. The job does not owned the buffers (in/output) and will thus not
-// delete them during job's destruction.
+// the animation forward. Backward sampling and jumps in time don't benefit from
+// the cache, but rely on the animation seeking index which bounds the number of
+// keys to process (see Animation::num_seek_segments()). The job does not owned
+// the buffers (in/output) and will thus not delete them during job's
+// destruction.
 struct SamplingJob {
   // Default constructor, initializes default values.
   SamplingJob();
@@ -62,6 +68,7 @@ struct SamplingJob {
   // Validates job parameters. Returns true for a valid job, or false otherwise:
   // -if any input pointer is nullptr
   // -if output range is invalid.
+  // -if soa_mask range isn't empty but is too small.
   bool Validate() const;
 
   // Runs job's sampling task.
@@ -90,6 +97,62 @@ struct SamplingJob {
   // If there are more joints in the animation, then the last joints are not
   // sampled.
   span<ozz::math::SoaTransform> output;
+
+  // Optional per soa track (aka 4 joints) enable mask. If not empty, it must
+  // have at least animation->num_soa_tracks() elements. Disabled soa tracks
+  // are neither decompressed nor interpolated, and their output SoaTransform is
+  // left unchanged. Animation keys still need to be iterated for all tracks
+  // though, as they are interleaved.
+  // This allows to pay only for the joints that are actually used, for partial
+  // animation layers or distant characters. As skeleton joints are ordered
+  // depth-first, a level of detail can be implemented by enabling only the
+  // first soa tracks.
+  // Decompressed keyframes of disabled tracks are kept outdated in the cache,
+  // so enabling them later is always valid.
+  span<const bool> soa_mask;
+};
+
+// Samples the same animation for a batch of instances, each one with its own
+// time ratio, cache and output. This is typically used for crowds, where many
+// characters play the same clip at different times.
+// Compared to running a SamplingJob per instance, the batch validates the
+// animation once, processes translations, rotations and scales of all
+// instances in turn to keep animation keys hot in cpu cache, and shares
+// decompressed keyframes between consecutive instances that are in the same
+// key interval. Sorting instances by ratio thus maximizes the gain.
+// A cache shall not be used more than once in the same batch.
+// The job does not owned the buffers (in/output) and will thus not delete them
+// during job's destruction.
+struct BatchSamplingJob {
+  // Default constructor, initializes default values.
+  BatchSamplingJob();
+
+  // Validates job parameters. Returns true for a valid job, or false otherwise:
+  // -if animation pointer is nullptr
+  // -if ratios, caches and outputs ranges don't have the same size.
+  // -if any cache is nullptr or too small.
+  // -if any output range is invalid.
+  // An empty batch is valid.
+  bool Validate() const;
+
+  // Runs job's sampling task for all instances.
+  // The job is validated before any operation is performed, see Validate() for
+  // more details.
+  // Returns false if *this job is not valid.
+  bool Run() const;
+
+  // The animation to sample, shared by all instances.
+  const Animation* animation;
+
+  // Per instance time ratios in the unit interval [0,1], see
+  // SamplingJob::ratio.
+  span<const float> ratios;
+
+  // Per instance caches, each must be big enough to sample *this animation.
+  span<SamplingCache* const> caches;
+
+  // Per instance job outputs, see SamplingJob::output.
+  span<const span<ozz::math::SoaTransform>> outputs;
 };
 
 namespace internal {
@@ -139,13 +202,28 @@ class SamplingCache {
   void operator=(SamplingCache const&);
 
   friend struct SamplingJob;
+  friend struct BatchSamplingJob;
+  friend struct SamplingBlendingJob;
 
   // Steps the cache in order to use it for a potentially new animation and
   // ratio. If the _animation is different from the animation currently cached,
   // or if the _ratio shows that the animation is played backward, then the
-  // cache is invalidated and reseted for the new _animation and _ratio.
+  // cache is invalidated and reseted for the new _animation and _ratio. Cache
+  // state is then restored from the animation seeking index by SamplingJob.
   void Step(const Animation& _animation, float _ratio);
 
+  // Steps the cache to _animation and _ratio, then updates keys and
+  // decompressed keyframes, so that the cache is ready for interpolation.
+  // _ratio is expected to be clamped in the unit interval. Soa tracks disabled
+  // by _mask (if not nullptr) aren't decompressed.
+  void Update(const Animation& _animation, float _ratio, const bool* _mask);
+
+  // Interpolates soa tracks [_from,_to[ at the ratio of the last Update, and
+  // outputs them to _output range, which must be big enough. Soa tracks
+  // disabled by _mask (if not nullptr, indexed from 0) are skipped.
+  void Interpolate(int _from, int _to, const bool* _mask,
+                   math::SoaTransform* _output) const;
+
   // The animation this cache refers to. nullptr means that the cache is invalid.
   const Animation* animation_;
 
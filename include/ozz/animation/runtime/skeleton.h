@@ -57,6 +57,10 @@ class SkeletonBuilder;
 // order. This is enough to traverse the whole joint hierarchy. See
 // IterateJointsDF() from skeleton_utils.h that implements a depth-first
 // traversal utility.
+// Joints can alternatively be stored in level order (see
+// SkeletonBuilder::level_order), in which case skeleton also provides a table
+// of hierarchy levels ranges. Joints of a same level are independent, which
+// allows LocalToModelJob to process them 4 by 4.
 class Skeleton {
  public:
   // Defines Skeleton constant values.
@@ -99,6 +103,13 @@ class Skeleton {
   // Returns joint's parent indices range.
   span<const int16_t> joint_parents() const { return joint_parents_; }
 
+  // Returns hierarchy levels ranges of a level ordered skeleton: the index of
+  // the first joint of every level, followed by the number of joints. Joints of
+  // level l are in range [joint_levels()[l], joint_levels()[l + 1]). Range is
+  // empty if skeleton joints aren't level ordered, aka if joint parent indices
+  // aren't sorted in increasing order.
+  span<const int16_t> joint_levels() const { return joint_levels_; }
+
   // Returns joint's name collection.
   span<const char* const> joint_names() const {
     return span<const char* const>(joint_names_.begin(), joint_names_.end());
@@ -109,6 +120,23 @@ class Skeleton {
   void Save(ozz::io::OArchive& _archive) const;
   void Load(ozz::io::IArchive& _archive, uint32_t _version);
 
+  // Memory view functions, aka zero-copy loading. See Animation::LoadView()
+  // for more details.
+
+  // Gets the size in bytes of *this skeleton view.
+  size_t view_size() const;
+
+  // Writes *this skeleton view to _view, which must be at least view_size()
+  // bytes and 16 bytes aligned. Returns false if _view is invalid.
+  bool SaveView(span<char> _view) const;
+
+  // Binds *this skeleton to _view memory, as written by SaveView(). Bind poses,
+  // parents and names point straight into _view, which must remain valid and
+  // unchanged as long as *this skeleton uses it. Only the small array of joint
+  // name pointers is allocated. Returns false and leaves *this skeleton empty
+  // if _view is invalid.
+  bool LoadView(span<const char> _view);
+
  private:
   // Disables copy and assignation.
   Skeleton(Skeleton const&);
@@ -119,11 +147,15 @@ class Skeleton {
   char* Allocate(size_t _char_count, size_t _num_joints);
   void Deallocate();
 
+  // Computes joint_levels_ from joint parents. joint_levels_ buffer must have
+  // been allocated with room for num_joints + 1 levels.
+  void InitLevels();
+
   // SkeletonBuilder class is allowed to instantiate an Skeleton.
   friend class offline::SkeletonBuilder;
 
-  // Buffers below store joint informations in joing depth first order. Their
-  // size is equal to the number of joints of the skeleton.
+  // Buffers below store joint informations in joint order (depth first or
+  // level order). Their size is equal to the number of joints of the skeleton.
 
   // Bind pose of every joint in local space.
   span<math::SoaTransform> joint_bind_poses_;
@@ -131,8 +163,16 @@ class Skeleton {
   // Array of joint parent indexes.
   span<int16_t> joint_parents_;
 
+  // Array of hierarchy levels first joint index. Its size is the number of
+  // levels + 1, or 0 if joints aren't level ordered.
+  span<int16_t> joint_levels_;
+
   // Stores the name of every joint in an array of c-strings.
   span<char*> joint_names_;
+
+  // Buffer allocated by *this skeleton. It contains all skeleton data, or only
+  // joint_names_ array if skeleton is bound to an external view.
+  void* allocation_;
 };
 }  // namespace animation
 
@@ -0,0 +1,119 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+
+#ifndef OZZ_OZZ_ANIMATION_RUNTIME_SKELETON_PARTITION_H_
+#define OZZ_OZZ_ANIMATION_RUNTIME_SKELETON_PARTITION_H_
+
+#include "ozz/base/platform.h"
+#include "ozz/base/span.h"
+
+namespace ozz {
+namespace animation {
+
+// Forward declares the Skeleton object used to describe joint hierarchy.
+class Skeleton;
+
+// Partitions a skeleton joint hierarchy into independent subtrees, whose
+// model-space matrices can be computed concurrently (see
+// ParallelLocalToModelJob).
+// Joints whose hierarchy is too big to fit a single partition are shared
+// ancestors, which must be computed before partitions. All other joints belong
+// to a subtree whose root is a skeleton root or the child of a shared ancestor.
+// Subtrees are then distributed to partitions in joint order, so that
+// partitions have a balanced number of joints and remain mostly contiguous.
+// A partition only depends on the skeleton hierarchy, so it's meant to be built
+// once, when the skeleton is loaded.
+// Subtrees of level ordered skeletons aren't contiguous, so their partitions
+// are split in many small ranges, which is less efficient.
+class SkeletonPartition {
+ public:
+  // Defines a range of contiguous joints [from,to], "to" included.
+  struct JointRange {
+    int16_t from;
+    int16_t to;
+  };
+
+  // Constructs an empty partition, with no joint.
+  SkeletonPartition();
+
+  // Constructs a partition of _skeleton, see Build().
+  SkeletonPartition(const Skeleton& _skeleton, int _max_partitions);
+
+  // Deallocates partition.
+  ~SkeletonPartition();
+
+  // Partitions _skeleton into at most _max_partitions balanced partitions.
+  // Less partitions are built if _skeleton hierarchy doesn't allow it, a
+  // single joint chain for example. _max_partitions is usually the number of
+  // threads that will compute partitions concurrently. It's clamped to
+  // 1 if smaller.
+  void Build(const Skeleton& _skeleton, int _max_partitions);
+
+  // Returns the number of joints of the skeleton *this partition was built
+  // for.
+  int num_joints() const { return num_joints_; }
+
+  // Returns the number of partitions.
+  int num_partitions() const {
+    return offsets_.empty() ? 0 : static_cast<int>(offsets_.size()) - 1;
+  }
+
+  // Returns the ranges of shared ancestors joints, in joint order. Ranges
+  // must be computed in order, before any partition.
+  span<const JointRange> shared_joints() const { return shared_; }
+
+  // Returns the ranges of joints of partition _partition, in joint order.
+  // Ranges must be computed in order, after shared ones, as every joint parent
+  // is either a shared ancestor or a previous joint of the same partition.
+  // _partition must be in range [0,num_partitions()[.
+  span<const JointRange> joints(int _partition) const;
+
+ private:
+  // Disables copy and assignation.
+  SkeletonPartition(SkeletonPartition const&);
+  void operator=(SkeletonPartition const&);
+
+  // Number of joints of the partitioned skeleton.
+  int num_joints_;
+
+  // Offsets of every partition first range in ranges_ array, followed by the
+  // total number of ranges.
+  span<int> offsets_;
+
+  // Ranges of shared ancestors joints.
+  span<JointRange> shared_;
+
+  // Ranges of joints of all partitions, sorted by partition.
+  span<JointRange> ranges_;
+
+  // Buffer allocated for all *this partition data.
+  void* allocation_;
+};
+}  // namespace animation
+}  // namespace ozz
+#endif  // OZZ_OZZ_ANIMATION_RUNTIME_SKELETON_PARTITION_H_
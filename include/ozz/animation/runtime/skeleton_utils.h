@@ -42,11 +42,21 @@ ozz::math::Transform GetJointLocalBindPose(const Skeleton& _skeleton,
 
 // Test if a joint is a leaf. _joint number must be in range [0, num joints].
 // "_joint" is a leaf if it's the last joint, or next joint's parent isn't
-// "_joint".
+// "_joint". For level ordered skeletons, "_joint" is a leaf if no joint of the
+// next level has "_joint" as parent.
 inline bool IsLeaf(const Skeleton& _skeleton, int _joint) {
   const int num_joints = _skeleton.num_joints();
   assert(_joint >= 0 && _joint < num_joints && "_joint index out of range");
   const span<const int16_t>& parents = _skeleton.joint_parents();
+  if (!_skeleton.joint_levels().empty()) {
+    // Parents are sorted in level order, so children would follow _joint.
+    for (int i = _joint + 1; i < num_joints && parents[i] <= _joint; ++i) {
+      if (parents[i] == _joint) {
+        return false;
+      }
+    }
+    return true;
+  }
   const int next = _joint + 1;
   return next == num_joints || parents[next] != _joint;
 }
@@ -57,15 +67,29 @@ inline bool IsLeaf(const Skeleton& _skeleton, int _joint) {
 // _current joint is a root. _from indicates the joint from which the joint
 // hierarchy traversal begins. Use Skeleton::kNoParent to traverse the
 // whole hierarchy, in case there are multiple roots.
+// For level ordered skeletons, joints are iterated in level order instead,
+// which still guarantees that a parent is iterated before its children.
 template <typename _Fct>
 inline _Fct IterateJointsDF(const Skeleton& _skeleton, _Fct _fct,
                             int _from = Skeleton::kNoParent) {
   const span<const int16_t>& parents = _skeleton.joint_parents();
   const int num_joints = _skeleton.num_joints();
-  //
-  // parents[i] >= _from is true as long as "i" is a child of "_from".
   static_assert(Skeleton::kNoParent < 0,
                 "Algorithm relies on kNoParent being negative");
+  if (_from >= 0 && !_skeleton.joint_levels().empty()) {
+    // "_from" hierarchy isn't contiguous, so joints are flagged as they are
+    // found to be part of it.
+    bool in_hierarchy[Skeleton::kMaxJoints];
+    for (int i = _from; i < num_joints; ++i) {
+      const int parent = parents[i];
+      in_hierarchy[i] = i == _from || (parent >= _from && in_hierarchy[parent]);
+      if (in_hierarchy[i]) {
+        _fct(i, parent);
+      }
+    }
+    return _fct;
+  }
+  // parents[i] >= _from is true as long as "i" is a child of "_from".
   for (int i = _from < 0 ? 0 : _from, process = i < num_joints; process;
        ++i, process = i < num_joints && parents[i] >= _from) {
     _fct(i, parents[i]);
@@ -61,11 +61,38 @@ class Track {
   Track();
   ~Track();
 
+  // Gets the number of keyframes.
+  size_t num_keys() const {
+    return ratios_.size() + quantized_ratios_.size();
+  }
+
   // Keyframe accessors.
+  // ratios() is empty if ratios are quantized, values() is empty if values are
+  // quantized, see quantized_ratios() and quantized_values().
   span<const float> ratios() const { return ratios_; }
   span<const _ValueType> values() const { return values_; }
   span<const uint8_t> steps() const { return steps_; }
 
+  // Quantized keyframe accessors. Quantization is optionally done by
+  // TrackBuilder (see TrackBuilder::quantize_ratios and quantize_values) for
+  // all track types but FloatTrack. Quantized ratios are 16 bits unsigned
+  // normalized integers. Quantized values are stored as 16 bits components:
+  // half floats for Float2Track to Float4Track, 3 components (smallest three
+  // encoding) for QuaternionTrack. TrackSamplingJob decompresses them while
+  // sampling.
+  span<const uint16_t> quantized_ratios() const { return quantized_ratios_; }
+  span<const uint16_t> quantized_values() const { return quantized_values_; }
+
+  // Edge index accessors. The edge index is built by TrackBuilder (see
+  // TrackBuilder::edge_index) for FloatTrack only. It stores, sorted by ratio,
+  // all the edges detected by TrackTriggeringJob when looping once over the
+  // track with edge_threshold() threshold. edge_rising() stores 1 bit per edge,
+  // set for rising edges.
+  bool has_edge_index() const { return has_edge_index_; }
+  float edge_threshold() const { return edge_threshold_; }
+  span<const float> edge_ratios() const { return edge_ratios_; }
+  span<const uint8_t> edge_rising() const { return edge_rising_; }
+
   // Get the estimated track's size in bytes.
   size_t size() const;
 
@@ -77,6 +104,21 @@ class Track {
   void Save(ozz::io::OArchive& _archive) const;
   void Load(ozz::io::IArchive& _archive, uint32_t _version);
 
+  // Memory view functions, aka zero-copy loading. See Animation::LoadView()
+  // for more details.
+
+  // Gets the size in bytes of *this track view.
+  size_t view_size() const;
+
+  // Writes *this track view to _view, which must be at least view_size() bytes
+  // and 16 bytes aligned. Returns false if _view is invalid.
+  bool SaveView(span<char> _view) const;
+
+  // Binds *this track to _view memory, as written by SaveView(). Nothing is
+  // copied, so _view must remain valid and unchanged as long as *this track
+  // uses it. Returns false and leaves *this track empty if _view is invalid.
+  bool LoadView(span<const char> _view);
+
  private:
   // Disables copy and assignation.
   Track(Track const&);
@@ -85,21 +127,49 @@ class Track {
   // TrackBuilder class is allowed to allocate a Track.
   friend class offline::TrackBuilder;
 
+  // Defines storage of keyframe ratios and values.
+  struct Layout {
+    size_t keys_count;
+    bool quantized_ratios;
+    bool quantized_values;
+    size_t edges_count;
+    size_t name_len;
+  };
+
   // Internal destruction function.
-  void Allocate(size_t _keys_count, size_t _name_len);
+  void Allocate(const Layout& _layout);
   void Deallocate();
 
+  // Distributes _buffer memory to track buffers, for the given _layout.
+  // _buffer is modified to reflect remain size.
+  void Bind(span<char>& _buffer, const Layout& _layout);
+
   // Keyframe ratios (0 is the beginning of the track, 1 is the end).
   span<float> ratios_;
 
   // Keyframe values.
   span<_ValueType> values_;
 
+  // Quantized keyframe ratios and values, used instead of ratios_ and values_
+  // when they're quantized.
+  span<uint16_t> quantized_ratios_;
+  span<uint16_t> quantized_values_;
+
   // Keyframe modes (1 bit per key): 1 for step, 0 for linear.
   span<uint8_t> steps_;
 
+  // Edge index, see edge_ratios() and edge_rising().
+  span<float> edge_ratios_;
+  span<uint8_t> edge_rising_;
+  float edge_threshold_;
+  bool has_edge_index_;
+
   // Track name.
   char* name_;
+
+  // Buffer allocated by *this track for all its data. It's nullptr if track is
+  // empty or bound to an external view.
+  void* allocation_;
 };
 
 // Definition of operations policies per track value type.
@@ -154,15 +224,15 @@ class QuaternionTrack : public internal::Track<math::Quaternion> {};
 
 }  // namespace animation
 namespace io {
-OZZ_IO_TYPE_VERSION(1, animation::FloatTrack)
+OZZ_IO_TYPE_VERSION(3, animation::FloatTrack)
 OZZ_IO_TYPE_TAG("ozz-float_track", animation::FloatTrack)
-OZZ_IO_TYPE_VERSION(1, animation::Float2Track)
+OZZ_IO_TYPE_VERSION(3, animation::Float2Track)
 OZZ_IO_TYPE_TAG("ozz-float2_track", animation::Float2Track)
-OZZ_IO_TYPE_VERSION(1, animation::Float3Track)
+OZZ_IO_TYPE_VERSION(3, animation::Float3Track)
 OZZ_IO_TYPE_TAG("ozz-float3_track", animation::Float3Track)
-OZZ_IO_TYPE_VERSION(1, animation::Float4Track)
+OZZ_IO_TYPE_VERSION(3, animation::Float4Track)
 OZZ_IO_TYPE_TAG("ozz-float4_track", animation::Float4Track)
-OZZ_IO_TYPE_VERSION(1, animation::QuaternionTrack)
+OZZ_IO_TYPE_VERSION(3, animation::QuaternionTrack)
 OZZ_IO_TYPE_TAG("ozz-quat_track", animation::QuaternionTrack)
 }  // namespace io
 }  // namespace ozz
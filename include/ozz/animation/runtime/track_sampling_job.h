@@ -33,6 +33,9 @@
 namespace ozz {
 namespace animation {
 
+// Forward declares the optional cache object used by track sampling jobs.
+class TrackSamplingCache;
+
 namespace internal {
 
 // TrackSamplingJob internal implementation. See *TrackSamplingJob for more
@@ -57,11 +60,39 @@ struct TrackSamplingJob {
   // Track to sample.
   const _Track* track;
 
+  // Optional cache, storing the key interval of the last sampling. If not
+  // nullptr, sampling starts searching keys from this interval, which is
+  // amortized O(1) when the track is sampled forward with small ratio steps.
+  // Backward sampling and jumps fall back to a binary search.
+  TrackSamplingCache* cache;
+
   // Job output.
   typename _Track::ValueType* result;
 };
 }  // namespace internal
 
+// Declares the cache object used by track sampling jobs, to take advantage of
+// the frame coherency of track sampling. A cache stores a single key interval,
+// so a cache is needed per track. It can be shared by tracks of any type, or
+// moved to another track, in which case it is automatically updated during the
+// next sampling.
+class TrackSamplingCache {
+ public:
+  // Constructs an invalid cache.
+  TrackSamplingCache() : key_(0) {}
+
+  // Invalidates the cache, so that next sampling starts searching keys from
+  // the track beginning.
+  void Invalidate() { key_ = 0; }
+
+ private:
+  template <typename _Track>
+  friend struct internal::TrackSamplingJob;
+
+  // Index of the first key of the last sampled key interval.
+  int key_;
+};
+
 // Track sampling job implementation. Track sampling allows to query a track
 // value for a specified ratio. This is a ratio rather than a time because
 // tracks have no duration.
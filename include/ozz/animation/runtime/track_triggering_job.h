@@ -46,6 +46,10 @@ class FloatTrack;
 // track types isn't possible.
 // The job execution actually performs a lazy evaluation of edges. It builds an
 // iterator that will process the next edge on each call to ++ operator.
+// If the track has an edge index built for the job threshold (see
+// TrackBuilder::edge_index), edges are found with binary searches in the
+// index, rather than by scanning all track keys in the triggered range. Edges
+// are exactly the same either way.
 struct TrackTriggeringJob {
   TrackTriggeringJob();
 
@@ -97,7 +101,7 @@ struct TrackTriggeringJob {
 // last edge has been reached.
 class TrackTriggeringJob::Iterator {
  public:
-  Iterator() : job_(nullptr), outer_(0.f), inner_(0) {}
+  Iterator() : job_(nullptr), outer_(0.f), inner_(0), inner_end_(0) {}
 
   // Evaluate next edge.
   // Calling this function on an end iterator results in an assertion in debug,
@@ -136,18 +140,27 @@ class TrackTriggeringJob::Iterator {
   Iterator(const TrackTriggeringJob* _job, End)
       : job_(_job),
         outer_(0.f),
-        inner_(-2) {  // Can never be reached while looping.
+        inner_(-2),  // Can never be reached while looping.
+        inner_end_(0) {
   }
 
+  // Evaluates next edge using track edge index.
+  void NextIndexed();
+
   // Job this iterator works on.
   const TrackTriggeringJob* job_;
 
   // Current value of the outer loop, aka a ratio cursor between from and to.
   float outer_;
 
-  // Current value of the inner loop, aka a key frame index.
+  // Current value of the inner loop, aka a key frame index. When using track
+  // edge index, this is an edge index, or -1 if edges range of the current
+  // outer loop isn't computed yet.
   ptrdiff_t inner_;
 
+  // Edge index only, end of the edges range of the current outer loop.
+  ptrdiff_t inner_end_;
+
   // Latest evaluated edge.
   Edge edge_;
 };
@@ -31,6 +31,7 @@
 // Declares endianness modes and functions to swap data from a mode to another.
 
 #include <cstddef>
+#include <cstring>
 
 #include "ozz/base/platform.h"
 
@@ -87,9 +88,14 @@ struct EndianSwapper<_Ty, 1> {
 template <typename _Ty>
 struct EndianSwapper<_Ty, 2> {
   OZZ_INLINE static void Swap(_Ty* _ty, size_t _count) {
+    // Works on integer words (memcpy avoids aliasing issues), which allows
+    // compilers to vectorize the loop.
     char* alias = reinterpret_cast<char*>(_ty);
-    for (size_t i = 0; i < _count * 2; i += 2) {
-      OZZ_BYTE_SWAP(alias[i + 0], alias[i + 1]);
+    for (size_t i = 0; i < _count; ++i) {
+      uint16_t w;
+      std::memcpy(&w, alias + i * 2, 2);
+      w = static_cast<uint16_t>((w >> 8) | (w << 8));
+      std::memcpy(alias + i * 2, &w, 2);
     }
   }
   OZZ_INLINE static _Ty Swap(_Ty _ty) {  // Pass by copy to swap _ty in-place.
@@ -104,9 +110,12 @@ template <typename _Ty>
 struct EndianSwapper<_Ty, 4> {
   OZZ_INLINE static void Swap(_Ty* _ty, size_t _count) {
     char* alias = reinterpret_cast<char*>(_ty);
-    for (size_t i = 0; i < _count * 4; i += 4) {
-      OZZ_BYTE_SWAP(alias[i + 0], alias[i + 3]);
-      OZZ_BYTE_SWAP(alias[i + 1], alias[i + 2]);
+    for (size_t i = 0; i < _count; ++i) {
+      uint32_t w;
+      std::memcpy(&w, alias + i * 4, 4);
+      w = (w >> 24) | ((w >> 8) & 0x0000ff00) | ((w << 8) & 0x00ff0000) |
+          (w << 24);
+      std::memcpy(alias + i * 4, &w, 4);
     }
   }
   OZZ_INLINE static _Ty Swap(_Ty _ty) {  // Pass by copy to swap _ty in-place.
@@ -122,11 +131,15 @@ template <typename _Ty>
 struct EndianSwapper<_Ty, 8> {
   OZZ_INLINE static void Swap(_Ty* _ty, size_t _count) {
     char* alias = reinterpret_cast<char*>(_ty);
-    for (size_t i = 0; i < _count * 8; i += 8) {
-      OZZ_BYTE_SWAP(alias[i + 0], alias[i + 7]);
-      OZZ_BYTE_SWAP(alias[i + 1], alias[i + 6]);
-      OZZ_BYTE_SWAP(alias[i + 2], alias[i + 5]);
-      OZZ_BYTE_SWAP(alias[i + 3], alias[i + 4]);
+    for (size_t i = 0; i < _count; ++i) {
+      uint64_t w;
+      std::memcpy(&w, alias + i * 8, 8);
+      w = ((w & 0x00ff00ff00ff00ffull) << 8) |
+          ((w >> 8) & 0x00ff00ff00ff00ffull);
+      w = ((w & 0x0000ffff0000ffffull) << 16) |
+          ((w >> 16) & 0x0000ffff0000ffffull);
+      w = (w << 32) | (w >> 32);
+      std::memcpy(alias + i * 8, &w, 8);
     }
   }
   OZZ_INLINE static _Ty Swap(_Ty _ty) {  // Pass by copy to swap _ty in-place.
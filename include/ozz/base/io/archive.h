@@ -84,6 +84,7 @@
 
 #include <stdint.h>
 #include <cassert>
+#include <cstring>
 
 #include "ozz/base/io/archive_traits.h"
 
@@ -313,36 +314,40 @@ struct Version<const Array<_Ty>> {
   enum { kValue = Version<const _Ty>::kValue };
 };
 
+// Saves _count primitive elements from _array with a single write if no endian
+// swap is required. Otherwise elements are swapped and written by chunks, as
+// swapping in place the whole (const) buffer is not possible.
+template <typename _Ty>
+inline void SavePrimitiveArray(OArchive& _archive, const _Ty* _array,
+                               size_t _count) {
+  if (!_archive.endian_swap()) {
+    OZZ_IF_DEBUG(size_t size =)
+    _archive.SaveBinary(_array, _count * sizeof(_Ty));
+    assert(size == _count * sizeof(_Ty));
+    return;
+  }
+  const size_t kChunkSize = 256;
+  _Ty chunk[kChunkSize];
+  for (size_t i = 0; i < _count; i += kChunkSize) {
+    const size_t count = _count - i < kChunkSize ? _count - i : kChunkSize;
+    std::memcpy(chunk, _array + i, count * sizeof(_Ty));
+    EndianSwapper<_Ty>::Swap(chunk, count);
+    OZZ_IF_DEBUG(size_t size =)
+    _archive.SaveBinary(chunk, count * sizeof(_Ty));
+    assert(size == count * sizeof(_Ty));
+  }
+}
+
 // Specializes Array Save/Load for primitive types.
 #define OZZ_IO_PRIMITIVE_TYPE(_type)                                       \
   template <>                                                               \
   inline void Array<const _type>::Save(OArchive& _archive) const {          \
-    if (_archive.endian_swap()) {                                           \
-      /* Save element by element as swapping in place the whole buffer is*/ \
-      /* not possible.*/                                                    \
-      for (size_t i = 0; i < count; ++i) {                                  \
-        _archive << array[i];                                               \
-      }                                                                     \
-    } else {                                                                \
-      OZZ_IF_DEBUG(size_t size =)                                           \
-      _archive.SaveBinary(array, count * sizeof(_type));                    \
-      assert(size == count * sizeof(_type));                                \
-    }                                                                       \
+    SavePrimitiveArray(_archive, array, count);                             \
   }                                                                         \
                                                                             \
   template <>                                                               \
   inline void Array<_type>::Save(OArchive& _archive) const {                \
-    if (_archive.endian_swap()) {                                           \
-      /* Save element by element as swapping in place the whole buffer is*/ \
-      /* not possible.*/                                                    \
-      for (size_t i = 0; i < count; ++i) {                                  \
-        _archive << array[i];                                               \
-      }                                                                     \
-    } else {                                                                \
-      OZZ_IF_DEBUG(size_t size =)                                           \
-      _archive.SaveBinary(array, count * sizeof(_type));                    \
-      assert(size == count * sizeof(_type));                                \
-    }                                                                       \
+    SavePrimitiveArray(_archive, array, count);                             \
   }                                                                         \
                                                                             \
   template <>                                                               \
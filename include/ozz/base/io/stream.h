@@ -32,6 +32,7 @@
 // Crt fread/fwrite/fseek/ftell like functions.
 
 #include "ozz/base/platform.h"
+#include "ozz/base/span.h"
 
 #include <cstddef>
 
@@ -131,6 +132,84 @@ class File : public Stream {
   void* file_;
 };
 
+// Implements a Stream of type File, that reads and writes through an
+// intermediate buffer of configurable size. This reduces the number of CRT
+// calls (and their locking overhead) to one per buffer instead of one per
+// archive primitive. Large reads and writes bypass the buffer.
+// Pending written data are flushed when seeking, reading, on Flush() call and
+// when the file is closed.
+class BufferedFile : public Stream {
+ public:
+  // Default size of the intermediate buffer.
+  static const size_t kDefaultBufferSize = 64 << 10;
+
+  // Open a file at path _filename with mode * _mode, in conformance with fopen
+  // specifications. _buffer_size is the size of the intermediate buffer, 0
+  // disables buffering.
+  // Use opened() function to test opening result.
+  BufferedFile(const char* _filename, const char* _mode,
+               size_t _buffer_size = kDefaultBufferSize);
+
+  // Gives _file ownership to the BufferedFile, which will be in charge of
+  // closing it. _file must be nullptr or a valid std::FILE pointer.
+  explicit BufferedFile(void* _file, size_t _buffer_size = kDefaultBufferSize);
+
+  // Flushes and closes the file if it is opened.
+  virtual ~BufferedFile();
+
+  // Flushes and closes the file if it is opened.
+  void Close();
+
+  // Writes pending data to the file.
+  // Returns false if all data couldn't be written.
+  bool Flush();
+
+  // See Stream::opened for details.
+  virtual bool opened() const;
+
+  // See Stream::Read for details.
+  virtual size_t Read(void* _buffer, size_t _size);
+
+  // See Stream::Write for details.
+  virtual size_t Write(const void* _buffer, size_t _size);
+
+  // See Stream::Seek for details.
+  virtual int Seek(int _offset, Origin _origin);
+
+  // See Stream::Tell for details.
+  virtual int Tell() const;
+
+  // See Stream::Tell for details.
+  virtual size_t Size() const;
+
+ private:
+  // Flushes pending written data, and sets file position to the logical
+  // position, moving back if data were read ahead. Buffer is empty afterward,
+  // so the file can switch between reading and writing. Nothing is done if
+  // no read or write happened since the last Sync, so that streams that can't
+  // seek (pipes...) can still be read or written.
+  bool Sync();
+
+  // The unbuffered file.
+  File file_;
+
+  // Intermediate buffer.
+  char* buffer_;
+
+  // Size of buffer_.
+  size_t buffer_size_;
+
+  // When writing, buffer_[0, buffer_pos_[ contains data pending to be written.
+  // When reading, buffer_[buffer_pos_, buffer_end_[ contains data read ahead.
+  size_t buffer_pos_;
+  size_t buffer_end_;
+
+  // Last operation done through the buffer, that Sync must complete before
+  // switching to another one.
+  enum Operation { kNone, kRead, kWrite };
+  Operation operation_;
+};
+
 // Implements an in-memory Stream. Allows to use a memory buffer as a Stream.
 // The opening mode is equivalent to fopen w+b (binary read/write).
 class MemoryStream : public Stream {
@@ -184,6 +263,44 @@ class MemoryStream : public Stream {
   // The cursor position in the buffer of data.
   int tell_;
 };
+
+// Implements a read-only Stream over an existing memory buffer, which isn't
+// copied nor owned by the stream. The buffer must remain valid as long as the
+// stream is used. This allows to deserialize archives that are already in
+// memory (embedded resources, downloaded data...) without an extra copy.
+// The opening mode is equivalent to fopen rb (binary read only), so writing
+// always fails.
+class ReadOnlyMemoryStream : public Stream {
+ public:
+  // Constructs a stream reading from _buffer. _buffer size must be less than
+  // std::numeric_limits<int>::max().
+  explicit ReadOnlyMemoryStream(span<const char> _buffer);
+
+  // See Stream::opened for details.
+  virtual bool opened() const;
+
+  // See Stream::Read for details.
+  virtual size_t Read(void* _buffer, size_t _size);
+
+  // See Stream::Write for details. Always returns 0.
+  virtual size_t Write(const void* _buffer, size_t _size);
+
+  // See Stream::Seek for details.
+  virtual int Seek(int _offset, Origin _origin);
+
+  // See Stream::Tell for details.
+  virtual int Tell() const;
+
+  // See Stream::Tell for details.
+  virtual size_t Size() const;
+
+ private:
+  // Buffer of data.
+  span<const char> buffer_;
+
+  // The cursor position in the buffer of data.
+  int tell_;
+};
 }  // namespace io
 }  // namespace ozz
 #endif  // OZZ_OZZ_BASE_IO_STREAM_H_
@@ -46,6 +46,13 @@
 #define OZZ_SIMD_FMA
 #endif
 
+// F16C (half precision conversions) is available on all AVX2 cpus, but msvc
+// doesn't define __F16C__.
+#if defined(__F16C__) || defined(OZZ_SIMD_F16C) || defined(OZZ_SIMD_AVX2)
+#include <immintrin.h>
+#define OZZ_SIMD_F16C
+#endif
+
 #if defined(__AVX__) || defined(OZZ_SIMD_AVX)
 #include <immintrin.h>
 #define OZZ_SIMD_AVX
@@ -1203,6 +1203,41 @@ OZZ_INLINE SimdInt4 Load3PtrU(const int* _i) {
   return ret;
 }
 
+OZZ_INLINE SimdInt4 LoadPtrU(const uint8_t* _u) {
+  const SimdInt4 ret = {_u[0], _u[1], _u[2], _u[3]};
+  return ret;
+}
+
+OZZ_INLINE SimdInt4 LoadPtrU(const uint16_t* _u) {
+  assert(!(uintptr_t(_u) & 0x1) && "Invalid alignment");
+  const SimdInt4 ret = {_u[0], _u[1], _u[2], _u[3]};
+  return ret;
+}
+
+OZZ_INLINE SimdInt4 Load3PtrU(const uint16_t* _u) {
+  assert(!(uintptr_t(_u) & 0x1) && "Invalid alignment");
+  const SimdInt4 ret = {_u[0], _u[1], _u[2], 0};
+  return ret;
+}
+
+OZZ_INLINE SimdInt4 LoadPtrU(const int16_t* _i) {
+  assert(!(uintptr_t(_i) & 0x1) && "Invalid alignment");
+  const SimdInt4 ret = {_i[0], _i[1], _i[2], _i[3]};
+  return ret;
+}
+
+OZZ_INLINE SimdInt4 Load2PtrU(const int16_t* _i) {
+  assert(!(uintptr_t(_i) & 0x1) && "Invalid alignment");
+  const SimdInt4 ret = {_i[0], _i[1], 0, 0};
+  return ret;
+}
+
+OZZ_INLINE SimdInt4 Load3PtrU(const int16_t* _i) {
+  assert(!(uintptr_t(_i) & 0x1) && "Invalid alignment");
+  const SimdInt4 ret = {_i[0], _i[1], _i[2], 0};
+  return ret;
+}
+
 OZZ_INLINE SimdInt4 FromFloatRound(_SimdFloat4 _f) {
   const SimdInt4 ret = {
       static_cast<int>(floor(_f.x + .5f)), static_cast<int>(floor(_f.y + .5f)),
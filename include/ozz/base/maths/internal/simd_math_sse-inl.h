@@ -32,6 +32,7 @@
 
 #include <stdint.h>
 #include <cassert>
+#include <cstring>
 
 // Temporarly needed while trigonometric functions aren't implemented.
 #include <cmath>
@@ -1095,6 +1096,66 @@ OZZ_INLINE SimdInt4 Load3PtrU(const int* _i) {
   return _mm_set_epi32(0, _i[2], _i[1], _i[0]);
 }
 
+OZZ_INLINE SimdInt4 LoadPtrU(const uint8_t* _u) {
+  int packed;
+  std::memcpy(&packed, _u, sizeof(packed));
+  const __m128i v = _mm_cvtsi32_si128(packed);
+#ifdef OZZ_SIMD_SSE4_1
+  return _mm_cvtepu8_epi32(v);
+#else   // OZZ_SIMD_SSE4_1
+  const __m128i zero = _mm_setzero_si128();
+  return _mm_unpacklo_epi16(_mm_unpacklo_epi8(v, zero), zero);
+#endif  // OZZ_SIMD_SSE4_1
+}
+
+OZZ_INLINE SimdInt4 LoadPtrU(const uint16_t* _u) {
+  assert(!(uintptr_t(_u) & 0x1) && "Invalid alignment");
+  const __m128i v = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(_u));
+  return _mm_unpacklo_epi16(v, _mm_setzero_si128());
+}
+
+OZZ_INLINE SimdInt4 Load3PtrU(const uint16_t* _u) {
+  assert(!(uintptr_t(_u) & 0x1) && "Invalid alignment");
+  int packed;
+  std::memcpy(&packed, _u, sizeof(packed));
+  const __m128i v = _mm_insert_epi16(_mm_cvtsi32_si128(packed), _u[2], 2);
+  return _mm_unpacklo_epi16(v, _mm_setzero_si128());
+}
+
+OZZ_INLINE SimdInt4 LoadPtrU(const int16_t* _i) {
+  assert(!(uintptr_t(_i) & 0x1) && "Invalid alignment");
+  const __m128i v = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(_i));
+#ifdef OZZ_SIMD_SSE4_1
+  return _mm_cvtepi16_epi32(v);
+#else   // OZZ_SIMD_SSE4_1
+  return _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+#endif  // OZZ_SIMD_SSE4_1
+}
+
+OZZ_INLINE SimdInt4 Load2PtrU(const int16_t* _i) {
+  assert(!(uintptr_t(_i) & 0x1) && "Invalid alignment");
+  int packed;
+  std::memcpy(&packed, _i, sizeof(packed));
+  const __m128i v = _mm_cvtsi32_si128(packed);
+#ifdef OZZ_SIMD_SSE4_1
+  return _mm_cvtepi16_epi32(v);
+#else   // OZZ_SIMD_SSE4_1
+  return _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+#endif  // OZZ_SIMD_SSE4_1
+}
+
+OZZ_INLINE SimdInt4 Load3PtrU(const int16_t* _i) {
+  assert(!(uintptr_t(_i) & 0x1) && "Invalid alignment");
+  int packed;
+  std::memcpy(&packed, _i, sizeof(packed));
+  const __m128i v = _mm_insert_epi16(_mm_cvtsi32_si128(packed), _i[2], 2);
+#ifdef OZZ_SIMD_SSE4_1
+  return _mm_cvtepi16_epi32(v);
+#else   // OZZ_SIMD_SSE4_1
+  return _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+#endif  // OZZ_SIMD_SSE4_1
+}
+
 OZZ_INLINE SimdInt4 FromFloatRound(_SimdFloat4 _f) {
   return _mm_cvtps_epi32(_f);
 }
@@ -2082,6 +2143,12 @@ inline SimdInt4 FloatToHalf(_SimdFloat4 _f) {
 }
 
 OZZ_INLINE SimdFloat4 HalfToFloat(_SimdInt4 _h) {
+#ifdef OZZ_SIMD_F16C
+  // Packs the 16 lower bits of each component, then uses hardware conversion.
+  const __m128i shuffle =
+      _mm_setr_epi8(0, 1, 4, 5, 8, 9, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1);
+  return _mm_cvtph_ps(_mm_shuffle_epi8(_h, shuffle));
+#else  // OZZ_SIMD_F16C
   const __m128i mask_nosign = _mm_set1_epi32(0x7fff);
   const __m128 magic = _mm_castsi128_ps(_mm_set1_epi32((254 - 15) << 23));
   const __m128i was_infnan = _mm_set1_epi32(0x7bff);
@@ -2096,6 +2163,7 @@ OZZ_INLINE SimdFloat4 HalfToFloat(_SimdInt4 _h) {
       _mm_and_ps(_mm_castsi128_ps(b_wasinfnan), exp_infnan);
   const __m128 sign_inf = _mm_or_ps(_mm_castsi128_ps(sign), infnanexp);
   return _mm_or_ps(scaled, sign_inf);
+#endif  // OZZ_SIMD_F16C
 }
 }  // namespace math
 }  // namespace ozz
@@ -0,0 +1,91 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+
+#ifndef OZZ_OZZ_BASE_MATHS_SIMD_FLOAT3X4_H_
+#define OZZ_OZZ_BASE_MATHS_SIMD_FLOAT3X4_H_
+
+#include "ozz/base/maths/simd_math.h"
+
+namespace ozz {
+namespace math {
+
+// Declare the 3x4 affine matrix type. Uses the row major convention, last row
+// being implicitly [0 0 0 1]:
+// [ m.rows[0].x m.rows[0].y m.rows[0].z m.rows[0].w ]   {v.x}
+// | m.rows[1].x m.rows[1].y m.rows[1].z m.rows[1].w | * {v.y}
+// | m.rows[2].x m.rows[2].y m.rows[2].z m.rows[2].w |   {v.z}
+// [ 0           0           0           1           ]   {v.1}
+// It's 25% smaller than a Float4x4, and matches the layout expected by most
+// GPU skinning palettes (3 float4 registers per joint).
+struct Float3x4 {
+  // Matrix rows.
+  SimdFloat4 rows[3];
+
+  // Returns the identity matrix.
+  static OZZ_INLINE Float3x4 identity() {
+    const Float3x4 ret = {{simd_float4::x_axis(), simd_float4::y_axis(),
+                           simd_float4::z_axis()}};
+    return ret;
+  }
+
+  // Returns the affine part of the Float4x4 matrix _m. Last row of _m is
+  // ignored, so it's expected to be [0 0 0 1].
+  static OZZ_INLINE Float3x4 FromFloat4x4(const Float4x4& _m) {
+    Float3x4 ret;
+    Transpose4x3(_m.cols, ret.rows);
+    return ret;
+  }
+};
+
+// Converts _m to a column major Float4x4 matrix.
+OZZ_INLINE Float4x4 ToFloat4x4(const Float3x4& _m) {
+  Float4x4 ret;
+  Transpose3x4(_m.rows, ret.cols);
+  ret.cols[3] = SetW(ret.cols[3], simd_float4::one());
+  return ret;
+}
+
+// Computes the multiplication of two affine matrices _a and _b.
+OZZ_INLINE Float3x4 operator*(const Float3x4& _a, const Float3x4& _b) {
+  // Implicit last row of _b only contributes _a translation.
+  const SimdInt4 mask_w = simd_int4::mask_000f();
+  Float3x4 ret;
+  for (int i = 0; i < 3; ++i) {
+    const SimdFloat4 row = _a.rows[i];
+    const SimdFloat4 xxxx = SplatX(row);
+    const SimdFloat4 yyyy = SplatY(row);
+    const SimdFloat4 zzzz = SplatZ(row);
+    const SimdFloat4 a = MAdd(xxxx, _b.rows[0], And(row, mask_w));
+    const SimdFloat4 b = MAdd(yyyy, _b.rows[1], a);
+    ret.rows[i] = MAdd(zzzz, _b.rows[2], b);
+  }
+  return ret;
+}
+}  // namespace math
+}  // namespace ozz
+#endif  // OZZ_OZZ_BASE_MATHS_SIMD_FLOAT3X4_H_
@@ -825,6 +825,60 @@ OZZ_INLINE SimdInt4 Load2PtrU(const int* _i);
 // r.w = 0
 OZZ_INLINE SimdInt4 Load3PtrU(const int* _i);
 
+// Loads the 4 unsigned 8 bits values of _u to the returned vector, zero
+// extended to 32 bits.
+// _u doesn't need to be aligned.
+// r.x = _u[0]
+// r.y = _u[1]
+// r.z = _u[2]
+// r.w = _u[3]
+OZZ_INLINE SimdInt4 LoadPtrU(const uint8_t* _u);
+
+// Loads the 4 unsigned 16 bits values of _u to the returned vector, zero
+// extended to 32 bits.
+// _u must be aligned to 2 bytes.
+// r.x = _u[0]
+// r.y = _u[1]
+// r.z = _u[2]
+// r.w = _u[3]
+OZZ_INLINE SimdInt4 LoadPtrU(const uint16_t* _u);
+
+// Loads the 3 first unsigned 16 bits values of _u to the x, y and z
+// components of the returned vector, zero extended to 32 bits. w is set to 0.
+// _u must be aligned to 2 bytes.
+// r.x = _u[0]
+// r.y = _u[1]
+// r.z = _u[2]
+// r.w = 0
+OZZ_INLINE SimdInt4 Load3PtrU(const uint16_t* _u);
+
+// Loads the 4 signed 16 bits values of _i to the returned vector, sign
+// extended to 32 bits.
+// _i must be aligned to 2 bytes.
+// r.x = _i[0]
+// r.y = _i[1]
+// r.z = _i[2]
+// r.w = _i[3]
+OZZ_INLINE SimdInt4 LoadPtrU(const int16_t* _i);
+
+// Loads the 2 first signed 16 bits values of _i to the x and y components of
+// the returned vector, sign extended to 32 bits. z and w are set to 0.
+// _i must be aligned to 2 bytes.
+// r.x = _i[0]
+// r.y = _i[1]
+// r.z = 0
+// r.w = 0
+OZZ_INLINE SimdInt4 Load2PtrU(const int16_t* _i);
+
+// Loads the 3 first signed 16 bits values of _i to the x, y and z components
+// of the returned vector, sign extended to 32 bits. w is set to 0.
+// _i must be aligned to 2 bytes.
+// r.x = _i[0]
+// r.y = _i[1]
+// r.z = _i[2]
+// r.w = 0
+OZZ_INLINE SimdInt4 Load3PtrU(const int16_t* _i);
+
 // Convert from float to integer by rounding the nearest value.
 OZZ_INLINE SimdInt4 FromFloatRound(_SimdFloat4 _f);
 
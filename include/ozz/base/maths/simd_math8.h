@@ -0,0 +1,283 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+
+#ifndef OZZ_OZZ_BASE_MATHS_SIMD_MATH8_H_
+#define OZZ_OZZ_BASE_MATHS_SIMD_MATH8_H_
+
+#include "ozz/base/maths/simd_math.h"
+#include "ozz/base/platform.h"
+
+// 8-wide SIMD math, available when AVX2 instruction set is enabled (see
+// ozz_build_simd_avx2 cmake option). A SimdFloat8 packs two SimdFloat4, the
+// first one in the low 128 bits. It allows to process two adjacent soa
+// structures at once while keeping their 4-wide memory layout, so it doesn't
+// change any runtime data or api.
+#if defined(OZZ_SIMD_AVX2)
+
+namespace ozz {
+namespace math {
+
+// Vector of eight floating point values.
+typedef __m256 SimdFloat8;
+
+// Argument type for SimdFloat8.
+typedef const __m256 _SimdFloat8;
+
+// Vector of eight integer values.
+typedef __m256i SimdInt8;
+
+// Argument type for SimdInt8.
+typedef const __m256i _SimdInt8;
+
+namespace simd_float8 {
+
+// Returns a SimdFloat8 vector with all components set to 0.
+OZZ_INLINE SimdFloat8 zero() { return _mm256_setzero_ps(); }
+
+// Returns a SimdFloat8 vector with all components set to 1.
+OZZ_INLINE SimdFloat8 one() { return _mm256_set1_ps(1.f); }
+
+// Loads _x to all components of the returned vector.
+OZZ_INLINE SimdFloat8 Load1(float _x) { return _mm256_set1_ps(_x); }
+
+// Loads _lo to the 4 first components of the returned vector, and _hi to the
+// 4 last ones.
+OZZ_INLINE SimdFloat8 Load(_SimdFloat4 _lo, _SimdFloat4 _hi) {
+  return _mm256_insertf128_ps(_mm256_castps128_ps256(_lo), _hi, 1);
+}
+
+// Loads the 8 values of _f, which don't need to be aligned.
+OZZ_INLINE SimdFloat8 LoadPtrU(const float* _f) { return _mm256_loadu_ps(_f); }
+
+// Converts from integer to float.
+OZZ_INLINE SimdFloat8 FromInt(_SimdInt8 _i) { return _mm256_cvtepi32_ps(_i); }
+}  // namespace simd_float8
+
+namespace simd_int8 {
+
+// Loads _x to all components of the returned vector.
+OZZ_INLINE SimdInt8 Load1(int _x) { return _mm256_set1_epi32(_x); }
+
+// Loads the 8 values to the returned vector components.
+OZZ_INLINE SimdInt8 Load(int _x0, int _x1, int _x2, int _x3, int _x4, int _x5,
+                         int _x6, int _x7) {
+  return _mm256_setr_epi32(_x0, _x1, _x2, _x3, _x4, _x5, _x6, _x7);
+}
+
+// Loads the 8 values of _i, which must be 32 bytes aligned.
+OZZ_INLINE SimdInt8 LoadPtr(const int* _i) {
+  return _mm256_load_si256(reinterpret_cast<const __m256i*>(_i));
+}
+
+// Loads _lo to the 4 first components of the returned vector, and _hi to the
+// 4 last ones.
+OZZ_INLINE SimdInt8 Load(_SimdInt4 _lo, _SimdInt4 _hi) {
+  return _mm256_inserti128_si256(_mm256_castsi128_si256(_lo), _hi, 1);
+}
+}  // namespace simd_int8
+
+// Returns the 4 first components of _v.
+OZZ_INLINE SimdFloat4 GetLo(_SimdFloat8 _v) {
+  return _mm256_castps256_ps128(_v);
+}
+
+// Returns the 4 last components of _v.
+OZZ_INLINE SimdFloat4 GetHi(_SimdFloat8 _v) {
+  return _mm256_extractf128_ps(_v, 1);
+}
+
+// Returns the 4 first components of _v.
+OZZ_INLINE SimdInt4 GetLo(_SimdInt8 _v) { return _mm256_castsi256_si128(_v); }
+
+// Returns the 4 last components of _v.
+OZZ_INLINE SimdInt4 GetHi(_SimdInt8 _v) {
+  return _mm256_extracti128_si256(_v, 1);
+}
+
+// Stores the 4 first components of _v to _lo, and the 4 last ones to _hi.
+OZZ_INLINE void Store(_SimdFloat8 _v, SimdFloat4* _lo, SimdFloat4* _hi) {
+  *_lo = GetLo(_v);
+  *_hi = GetHi(_v);
+}
+
+// Stores the 8 components of _v to _f, which doesn't need to be aligned.
+OZZ_INLINE void StorePtrU(_SimdFloat8 _v, float* _f) {
+  _mm256_storeu_ps(_f, _v);
+}
+
+// Transposes the two 4x4 matrices formed by the 4 first components of _in,
+// and by the 4 last ones. Matrices are transposed independently.
+OZZ_INLINE void Transpose4x4(const SimdFloat8 _in[4], SimdFloat8 _out[4]) {
+  const __m256 tmp0 = _mm256_unpacklo_ps(_in[0], _in[2]);
+  const __m256 tmp1 = _mm256_unpacklo_ps(_in[1], _in[3]);
+  const __m256 tmp2 = _mm256_unpackhi_ps(_in[0], _in[2]);
+  const __m256 tmp3 = _mm256_unpackhi_ps(_in[1], _in[3]);
+  _out[0] = _mm256_unpacklo_ps(tmp0, tmp1);
+  _out[1] = _mm256_unpackhi_ps(tmp0, tmp1);
+  _out[2] = _mm256_unpacklo_ps(tmp2, tmp3);
+  _out[3] = _mm256_unpackhi_ps(tmp2, tmp3);
+}
+
+// Computes the (multiply-add) operation (_a * _b) + _c.
+OZZ_INLINE SimdFloat8 MAdd(_SimdFloat8 _a, _SimdFloat8 _b, _SimdFloat8 _c) {
+#ifdef OZZ_SIMD_FMA
+  return _mm256_fmadd_ps(_a, _b, _c);
+#else   // OZZ_SIMD_FMA
+  return _mm256_add_ps(_mm256_mul_ps(_a, _b), _c);
+#endif  // OZZ_SIMD_FMA
+}
+
+// Returns the per component estimated reciprocal of _v.
+OZZ_INLINE SimdFloat8 RcpEst(_SimdFloat8 _v) { return _mm256_rcp_ps(_v); }
+
+// Returns the per component square root of _v.
+OZZ_INLINE SimdFloat8 Sqrt(_SimdFloat8 _v) { return _mm256_sqrt_ps(_v); }
+
+// Returns the per component estimated reciprocal square root of _v.
+OZZ_INLINE SimdFloat8 RSqrtEst(_SimdFloat8 _v) { return _mm256_rsqrt_ps(_v); }
+
+// Returns the per component estimated reciprocal square root of _v, where
+// approximation is improved with one more new Newton-Raphson step.
+OZZ_INLINE SimdFloat8 RSqrtEstNR(_SimdFloat8 _v) {
+  const __m256 nr = _mm256_rsqrt_ps(_v);
+  // Do one more Newton-Raphson step to improve precision.
+#ifdef OZZ_SIMD_FMA
+  const __m256 nmadd =
+      _mm256_fnmadd_ps(_mm256_mul_ps(_v, nr), nr, _mm256_set1_ps(3.f));
+#else   // OZZ_SIMD_FMA
+  const __m256 nmadd = _mm256_sub_ps(_mm256_set1_ps(3.f),
+                                     _mm256_mul_ps(_mm256_mul_ps(_v, nr), nr));
+#endif  // OZZ_SIMD_FMA
+  return _mm256_mul_ps(_mm256_mul_ps(_mm256_set1_ps(.5f), nr), nmadd);
+}
+
+// Returns per element the maximum of _a and _b.
+OZZ_INLINE SimdFloat8 Max(_SimdFloat8 _a, _SimdFloat8 _b) {
+  return _mm256_max_ps(_a, _b);
+}
+
+// Returns per element the minimum of _a and _b.
+OZZ_INLINE SimdFloat8 Min(_SimdFloat8 _a, _SimdFloat8 _b) {
+  return _mm256_min_ps(_a, _b);
+}
+
+// Returns per element the maximum of _v and 0.
+OZZ_INLINE SimdFloat8 Max0(_SimdFloat8 _v) {
+  return _mm256_max_ps(_mm256_setzero_ps(), _v);
+}
+
+// Returns the sign bit of _v.
+OZZ_INLINE SimdInt8 Sign(_SimdFloat8 _v) {
+  return _mm256_slli_epi32(_mm256_srli_epi32(_mm256_castps_si256(_v), 31), 31);
+}
+
+// Returns per element binary and operation of _a and _b.
+OZZ_INLINE SimdFloat8 And(_SimdFloat8 _a, _SimdFloat8 _b) {
+  return _mm256_and_ps(_a, _b);
+}
+
+// Returns per element binary or operation of _a and _b.
+OZZ_INLINE SimdFloat8 Or(_SimdFloat8 _a, _SimdFloat8 _b) {
+  return _mm256_or_ps(_a, _b);
+}
+
+// Returns per element binary xor operation of _a and _b.
+OZZ_INLINE SimdFloat8 Xor(_SimdFloat8 _a, _SimdFloat8 _b) {
+  return _mm256_xor_ps(_a, _b);
+}
+
+// Returns per element binary and operation of _a and _b.
+OZZ_INLINE SimdFloat8 And(_SimdFloat8 _a, _SimdInt8 _b) {
+  return _mm256_and_ps(_a, _mm256_castsi256_ps(_b));
+}
+
+// Returns per element binary or operation of _a and _b.
+OZZ_INLINE SimdFloat8 Or(_SimdFloat8 _a, _SimdInt8 _b) {
+  return _mm256_or_ps(_a, _mm256_castsi256_ps(_b));
+}
+
+// Returns per element binary xor operation of _a and _b.
+OZZ_INLINE SimdFloat8 Xor(_SimdFloat8 _a, _SimdInt8 _b) {
+  return _mm256_xor_ps(_a, _mm256_castsi256_ps(_b));
+}
+
+// Shifts the 8 signed or unsigned 32-bit integers in a left by count _bits
+// while shifting in zeros.
+OZZ_INLINE SimdInt8 ShiftL(_SimdInt8 _v, int _bits) {
+  return _mm256_slli_epi32(_v, _bits);
+}
+
+// Returns per element the comparison _a == _b.
+OZZ_INLINE SimdInt8 CmpEq(_SimdInt8 _a, _SimdInt8 _b) {
+  return _mm256_cmpeq_epi32(_a, _b);
+}
+
+// Converts from half-precision floats (IEEE-754 binary16) stored in the 16
+// lower bits of each component of _h, to single precision floats.
+OZZ_INLINE SimdFloat8 HalfToFloat(_SimdInt8 _h) {
+  // Packs the 16 lower bits of each component to the lower 128 bits, then uses
+  // hardware conversion.
+  const __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi32(_h, _h),
+                                                  _MM_SHUFFLE(3, 1, 2, 0));
+  return _mm256_cvtph_ps(_mm256_castsi256_si128(packed));
+}
+}  // namespace math
+}  // namespace ozz
+
+#if !defined(OZZ_DISABLE_SSE_NATIVE_OPERATORS)
+// Returns per element addition of _a and _b.
+OZZ_INLINE ozz::math::SimdFloat8 operator+(ozz::math::_SimdFloat8 _a,
+                                           ozz::math::_SimdFloat8 _b) {
+  return _mm256_add_ps(_a, _b);
+}
+
+// Returns per element subtraction of _a and _b.
+OZZ_INLINE ozz::math::SimdFloat8 operator-(ozz::math::_SimdFloat8 _a,
+                                           ozz::math::_SimdFloat8 _b) {
+  return _mm256_sub_ps(_a, _b);
+}
+
+// Returns per element negation of _v.
+OZZ_INLINE ozz::math::SimdFloat8 operator-(ozz::math::_SimdFloat8 _v) {
+  return _mm256_sub_ps(_mm256_setzero_ps(), _v);
+}
+
+// Returns per element multiplication of _a and _b.
+OZZ_INLINE ozz::math::SimdFloat8 operator*(ozz::math::_SimdFloat8 _a,
+                                           ozz::math::_SimdFloat8 _b) {
+  return _mm256_mul_ps(_a, _b);
+}
+
+// Returns per element division of _a and _b.
+OZZ_INLINE ozz::math::SimdFloat8 operator/(ozz::math::_SimdFloat8 _a,
+                                           ozz::math::_SimdFloat8 _b) {
+  return _mm256_div_ps(_a, _b);
+}
+#endif  // !defined(OZZ_DISABLE_SSE_NATIVE_OPERATORS)
+#endif  // OZZ_SIMD_AVX2
+#endif  // OZZ_OZZ_BASE_MATHS_SIMD_MATH8_H_
@@ -611,19 +611,22 @@ OZZ_INLINE SoaFloat2 NormalizeSafe(const SoaFloat2& _v,
 // _f is not limited to range [0,1].
 OZZ_INLINE SoaFloat4 Lerp(const SoaFloat4& _a, const SoaFloat4& _b,
                           _SimdFloat4 _f) {
-  const SoaFloat4 r = {(_b.x - _a.x) * _f + _a.x, (_b.y - _a.y) * _f + _a.y,
-                       (_b.z - _a.z) * _f + _a.z, (_b.w - _a.w) * _f + _a.w};
+  const SoaFloat4 r = {
+      MAdd(_b.x - _a.x, _f, _a.x), MAdd(_b.y - _a.y, _f, _a.y),
+      MAdd(_b.z - _a.z, _f, _a.z), MAdd(_b.w - _a.w, _f, _a.w)};
   return r;
 }
 OZZ_INLINE SoaFloat3 Lerp(const SoaFloat3& _a, const SoaFloat3& _b,
                           _SimdFloat4 _f) {
-  const SoaFloat3 r = {(_b.x - _a.x) * _f + _a.x, (_b.y - _a.y) * _f + _a.y,
-                       (_b.z - _a.z) * _f + _a.z};
+  const SoaFloat3 r = {MAdd(_b.x - _a.x, _f, _a.x),
+                       MAdd(_b.y - _a.y, _f, _a.y),
+                       MAdd(_b.z - _a.z, _f, _a.z)};
   return r;
 }
 OZZ_INLINE SoaFloat2 Lerp(const SoaFloat2& _a, const SoaFloat2& _b,
                           _SimdFloat4 _f) {
-  const SoaFloat2 r = {(_b.x - _a.x) * _f + _a.x, (_b.y - _a.y) * _f + _a.y};
+  const SoaFloat2 r = {MAdd(_b.x - _a.x, _f, _a.x),
+                       MAdd(_b.y - _a.y, _f, _a.y)};
   return r;
 }
 
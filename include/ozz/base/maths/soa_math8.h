@@ -0,0 +1,199 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+
+#ifndef OZZ_OZZ_BASE_MATHS_SOA_MATH8_H_
+#define OZZ_OZZ_BASE_MATHS_SOA_MATH8_H_
+
+#include "ozz/base/maths/simd_math8.h"
+#include "ozz/base/maths/soa_float.h"
+#include "ozz/base/maths/soa_float4x4.h"
+#include "ozz/base/maths/soa_quaternion.h"
+#include "ozz/base/maths/soa_transform.h"
+#include "ozz/base/platform.h"
+
+// 8-wide soa math, available when AVX2 instruction set is enabled. Each Soa8*
+// structure packs two adjacent 4-wide Soa* structures, using SimdFloat8
+// components. They're loaded from and stored to the 4-wide Soa* structures
+// used by runtime data.
+#if defined(OZZ_SIMD_AVX2)
+
+namespace ozz {
+namespace math {
+
+struct Soa8Float3 {
+  SimdFloat8 x, y, z;
+
+  // Loads _lo to the 4 first elements and _hi to the 4 last ones.
+  static OZZ_INLINE Soa8Float3 Load(const SoaFloat3& _lo,
+                                    const SoaFloat3& _hi) {
+    const Soa8Float3 r = {simd_float8::Load(_lo.x, _hi.x),
+                          simd_float8::Load(_lo.y, _hi.y),
+                          simd_float8::Load(_lo.z, _hi.z)};
+    return r;
+  }
+};
+
+struct Soa8Float4 {
+  SimdFloat8 x, y, z, w;
+
+  // Loads _lo to the 4 first elements and _hi to the 4 last ones.
+  static OZZ_INLINE Soa8Float4 Load(const SoaFloat4& _lo,
+                                    const SoaFloat4& _hi) {
+    const Soa8Float4 r = {
+        simd_float8::Load(_lo.x, _hi.x), simd_float8::Load(_lo.y, _hi.y),
+        simd_float8::Load(_lo.z, _hi.z), simd_float8::Load(_lo.w, _hi.w)};
+    return r;
+  }
+};
+
+struct Soa8Quaternion {
+  SimdFloat8 x, y, z, w;
+
+  // Loads _lo to the 4 first elements and _hi to the 4 last ones.
+  static OZZ_INLINE Soa8Quaternion Load(const SoaQuaternion& _lo,
+                                        const SoaQuaternion& _hi) {
+    const Soa8Quaternion r = {
+        simd_float8::Load(_lo.x, _hi.x), simd_float8::Load(_lo.y, _hi.y),
+        simd_float8::Load(_lo.z, _hi.z), simd_float8::Load(_lo.w, _hi.w)};
+    return r;
+  }
+};
+
+struct Soa8Transform {
+  Soa8Float3 translation;
+  Soa8Quaternion rotation;
+  Soa8Float3 scale;
+
+  // Loads _lo to the 4 first elements and _hi to the 4 last ones.
+  static OZZ_INLINE Soa8Transform Load(const SoaTransform& _lo,
+                                       const SoaTransform& _hi) {
+    const Soa8Transform r = {Soa8Float3::Load(_lo.translation, _hi.translation),
+                             Soa8Quaternion::Load(_lo.rotation, _hi.rotation),
+                             Soa8Float3::Load(_lo.scale, _hi.scale)};
+    return r;
+  }
+};
+
+struct Soa8Float4x4 {
+  // Soa matrix columns.
+  Soa8Float4 cols[4];
+
+  // Returns the affine transformation matrix built from split translation,
+  // rotation (quaternion) and scale. Same as SoaFloat4x4::FromAffine.
+  static OZZ_INLINE Soa8Float4x4 FromAffine(const Soa8Float3& _translation,
+                                            const Soa8Quaternion& _quaternion,
+                                            const Soa8Float3& _scale) {
+    const SimdFloat8 zero = simd_float8::zero();
+    const SimdFloat8 one = simd_float8::one();
+    const SimdFloat8 two = one + one;
+
+    const SimdFloat8 xx = _quaternion.x * _quaternion.x;
+    const SimdFloat8 xy = _quaternion.x * _quaternion.y;
+    const SimdFloat8 xz = _quaternion.x * _quaternion.z;
+    const SimdFloat8 xw = _quaternion.x * _quaternion.w;
+    const SimdFloat8 yy = _quaternion.y * _quaternion.y;
+    const SimdFloat8 yz = _quaternion.y * _quaternion.z;
+    const SimdFloat8 yw = _quaternion.y * _quaternion.w;
+    const SimdFloat8 zz = _quaternion.z * _quaternion.z;
+    const SimdFloat8 zw = _quaternion.z * _quaternion.w;
+
+    const Soa8Float4x4 ret = {
+        {{_scale.x * (one - two * (yy + zz)), _scale.x * two * (xy + zw),
+          _scale.x * two * (xz - yw), zero},
+         {_scale.y * two * (xy - zw), _scale.y * (one - two * (xx + zz)),
+          _scale.y * two * (yz + xw), zero},
+         {_scale.z * two * (xz + yw), _scale.z * two * (yz - xw),
+          _scale.z * (one - two * (xx + yy)), zero},
+         {_translation.x, _translation.y, _translation.z, one}}};
+    return ret;
+  }
+};
+
+// Stores the 4 first elements of _v to _lo, and the 4 last ones to _hi.
+OZZ_INLINE void Store(const Soa8Float3& _v, SoaFloat3* _lo, SoaFloat3* _hi) {
+  Store(_v.x, &_lo->x, &_hi->x);
+  Store(_v.y, &_lo->y, &_hi->y);
+  Store(_v.z, &_lo->z, &_hi->z);
+}
+
+// Stores the 4 first elements of _v to _lo, and the 4 last ones to _hi.
+OZZ_INLINE void Store(const Soa8Float4& _v, SoaFloat4* _lo, SoaFloat4* _hi) {
+  Store(_v.x, &_lo->x, &_hi->x);
+  Store(_v.y, &_lo->y, &_hi->y);
+  Store(_v.z, &_lo->z, &_hi->z);
+  Store(_v.w, &_lo->w, &_hi->w);
+}
+
+// Stores the 4 first elements of _q to _lo, and the 4 last ones to _hi.
+OZZ_INLINE void Store(const Soa8Quaternion& _q, SoaQuaternion* _lo,
+                      SoaQuaternion* _hi) {
+  Store(_q.x, &_lo->x, &_hi->x);
+  Store(_q.y, &_lo->y, &_hi->y);
+  Store(_q.z, &_lo->z, &_hi->z);
+  Store(_q.w, &_lo->w, &_hi->w);
+}
+
+// Stores the 4 first matrices of _m to _lo, and the 4 last ones to _hi.
+OZZ_INLINE void Store(const Soa8Float4x4& _m, SoaFloat4x4* _lo,
+                      SoaFloat4x4* _hi) {
+  for (int i = 0; i < 4; ++i) {
+    Store(_m.cols[i], &_lo->cols[i], &_hi->cols[i]);
+  }
+}
+
+// Returns the linear interpolation of _a and _b with coefficient _f.
+OZZ_INLINE Soa8Float3 Lerp(const Soa8Float3& _a, const Soa8Float3& _b,
+                           _SimdFloat8 _f) {
+  const Soa8Float3 r = {MAdd(_b.x - _a.x, _f, _a.x),
+                        MAdd(_b.y - _a.y, _f, _a.y),
+                        MAdd(_b.z - _a.z, _f, _a.z)};
+  return r;
+}
+
+// Returns the estimated normalized quaternion _q.
+OZZ_INLINE Soa8Quaternion NormalizeEst(const Soa8Quaternion& _q) {
+  const SimdFloat8 len2 = _q.x * _q.x + _q.y * _q.y + _q.z * _q.z + _q.w * _q.w;
+  const SimdFloat8 inv_len = RSqrtEstNR(len2);
+  const Soa8Quaternion r = {_q.x * inv_len, _q.y * inv_len, _q.z * inv_len,
+                            _q.w * inv_len};
+  return r;
+}
+
+// Returns the estimated normalized linear interpolation of quaternion _a and
+// _b with coefficient _f.
+OZZ_INLINE Soa8Quaternion NLerpEst(const Soa8Quaternion& _a,
+                                   const Soa8Quaternion& _b, _SimdFloat8 _f) {
+  const Soa8Quaternion lerp = {
+      MAdd(_b.x - _a.x, _f, _a.x), MAdd(_b.y - _a.y, _f, _a.y),
+      MAdd(_b.z - _a.z, _f, _a.z), MAdd(_b.w - _a.w, _f, _a.w)};
+  return NormalizeEst(lerp);
+}
+}  // namespace math
+}  // namespace ozz
+#endif  // OZZ_SIMD_AVX2
+#endif  // OZZ_OZZ_BASE_MATHS_SOA_MATH8_H_
@@ -110,9 +110,9 @@ OZZ_INLINE SimdInt4 IsNormalizedEst(const SoaQuaternion& _q) {
 // _f.
 OZZ_INLINE SoaQuaternion Lerp(const SoaQuaternion& _a, const SoaQuaternion& _b,
                               _SimdFloat4 _f) {
-  const SoaQuaternion r = {(_b.x - _a.x) * _f + _a.x, (_b.y - _a.y) * _f + _a.y,
-                           (_b.z - _a.z) * _f + _a.z,
-                           (_b.w - _a.w) * _f + _a.w};
+  const SoaQuaternion r = {
+      MAdd(_b.x - _a.x, _f, _a.x), MAdd(_b.y - _a.y, _f, _a.y),
+      MAdd(_b.z - _a.z, _f, _a.z), MAdd(_b.w - _a.w, _f, _a.w)};
   return r;
 }
 
@@ -120,8 +120,9 @@ OZZ_INLINE SoaQuaternion Lerp(const SoaQuaternion& _a, const SoaQuaternion& _b,
 // _f.
 OZZ_INLINE SoaQuaternion NLerp(const SoaQuaternion& _a, const SoaQuaternion& _b,
                                _SimdFloat4 _f) {
-  const SoaFloat4 lerp = {(_b.x - _a.x) * _f + _a.x, (_b.y - _a.y) * _f + _a.y,
-                          (_b.z - _a.z) * _f + _a.z, (_b.w - _a.w) * _f + _a.w};
+  const SoaFloat4 lerp = {
+      MAdd(_b.x - _a.x, _f, _a.x), MAdd(_b.y - _a.y, _f, _a.y),
+      MAdd(_b.z - _a.z, _f, _a.z), MAdd(_b.w - _a.w, _f, _a.w)};
   const SimdFloat4 len2 =
       lerp.x * lerp.x + lerp.y * lerp.y + lerp.z * lerp.z + lerp.w * lerp.w;
   const SimdFloat4 inv_len = math::simd_float4::one() / Sqrt(len2);
@@ -134,8 +135,9 @@ OZZ_INLINE SoaQuaternion NLerp(const SoaQuaternion& _a, const SoaQuaternion& _b,
 // coefficient _f.
 OZZ_INLINE SoaQuaternion NLerpEst(const SoaQuaternion& _a,
                                   const SoaQuaternion& _b, _SimdFloat4 _f) {
-  const SoaFloat4 lerp = {(_b.x - _a.x) * _f + _a.x, (_b.y - _a.y) * _f + _a.y,
-                          (_b.z - _a.z) * _f + _a.z, (_b.w - _a.w) * _f + _a.w};
+  const SoaFloat4 lerp = {
+      MAdd(_b.x - _a.x, _f, _a.x), MAdd(_b.y - _a.y, _f, _a.y),
+      MAdd(_b.z - _a.z, _f, _a.z), MAdd(_b.w - _a.w, _f, _a.w)};
   const SimdFloat4 len2 =
       lerp.x * lerp.x + lerp.y * lerp.y + lerp.z * lerp.z + lerp.w * lerp.w;
   // Uses RSqrtEstNR (with one more Newton-Raphson step) as quaternions loose
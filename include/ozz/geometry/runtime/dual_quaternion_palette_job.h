@@ -0,0 +1,87 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+
+#ifndef OZZ_OZZ_GEOMETRY_RUNTIME_DUAL_QUATERNION_PALETTE_JOB_H_
+#define OZZ_OZZ_GEOMETRY_RUNTIME_DUAL_QUATERNION_PALETTE_JOB_H_
+
+#include "ozz/base/maths/simd_math.h"
+#include "ozz/base/platform.h"
+#include "ozz/base/span.h"
+
+namespace ozz {
+namespace geometry {
+
+// Unit dual quaternion, representing a rigid transformation (rotation and
+// translation). real is the rotation quaternion, dual is half the translation
+// (as a pure quaternion) multiplied by the rotation quaternion. At 32 bytes,
+// it's half the size of a Float4x4.
+struct DualQuaternion {
+  math::SimdFloat4 real;
+  math::SimdFloat4 dual;
+};
+
+// Computes the dual quaternion palette used by dual quaternion skinning (see
+// SkinningJob::joint_dual_quaternions), from model-space joint matrices and
+// optional inverse bind pose matrices.
+// Joints are processed 4 by 4 with SoA maths: matrices to quaternions
+// conversion is branch-free. Dual quaternions only support rigid
+// transformations, so joint matrices scale is removed. Shearing isn't
+// supported.
+// Unlike linear blend skinning, dual quaternion skinning doesn't need inverse
+// transpose matrices to transform normals and tangents.
+struct DualQuaternionPaletteJob {
+  // Validates job parameters. Returns true for a valid job, or false otherwise:
+  // -if joint_matrices is empty.
+  // -if inverse_bind_poses isn't empty but is smaller than joint_matrices.
+  // -if output is smaller than joint_matrices.
+  bool Validate() const;
+
+  // Runs job's execution task.
+  // The job is validated before any operation is performed, see Validate() for
+  // more details.
+  // Returns false if *this job is not valid.
+  bool Run() const;
+
+  // Job input.
+
+  // Model-space joint matrices, as output by LocalToModelJob.
+  span<const math::Float4x4> joint_matrices;
+
+  // Optional inverse bind pose matrices, multiplied (right side) to
+  // joint_matrices. If empty, joint_matrices are considered to be skinning
+  // matrices already.
+  span<const math::Float4x4> inverse_bind_poses;
+
+  // Job output.
+
+  // Dual quaternion palette, one per joint matrix.
+  span<DualQuaternion> output;
+};
+}  // namespace geometry
+}  // namespace ozz
+#endif  // OZZ_OZZ_GEOMETRY_RUNTIME_DUAL_QUATERNION_PALETTE_JOB_H_
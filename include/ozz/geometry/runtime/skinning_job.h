@@ -28,14 +28,17 @@
 #ifndef OZZ_OZZ_GEOMETRY_RUNTIME_SKINNING_JOB_H_
 #define OZZ_OZZ_GEOMETRY_RUNTIME_SKINNING_JOB_H_
 
+#include "ozz/base/maths/vec_float.h"
 #include "ozz/base/platform.h"
 #include "ozz/base/span.h"
+#include "ozz/base/task_runner.h"
 
 namespace ozz {
 namespace math {
 struct Float4x4;
 }
 namespace geometry {
+struct DualQuaternion;
 
 // Provides per-vertex matrix palette skinning job implementation.
 // Skinning is the process of creating the association of skeleton joints with
@@ -71,6 +74,19 @@ namespace geometry {
 // joints matrices (see http://www.glprogramming.com/red/appendixf.html). This
 // code path is less efficient than the one without this matrices set, and
 // should only be used when input matrices have non uniform scaling or shearing.
+// Alternatively, the job implements dual quaternion skinning, from a palette of
+// dual quaternions (see DualQuaternionPaletteJob) instead of matrices. Dual
+// quaternion skinning preserves volume for twisted and bent joints, doesn't
+// need inverse transpose matrices, and its palette is half the size of a
+// matrix palette. It only supports rigid joint transformations though.
+// Positions, normals, tangents and weights can optionally be provided in
+// compact (quantized) formats, see SkinningJob::Format. Compact inputs are
+// decoded by the skinning loop while each vertex is loaded. They reduce vertex
+// buffers memory footprint, but add decoding work to every vertex. Skinning is
+// thus slower with compact inputs when it isn't memory bound, which was the
+// case of all measured meshes: 22.7ns per vertex, versus 13ns with float
+// inputs, even with 12M vertices. Compact inputs should be used to save memory
+// rather than skinning time.
 // The job does not owned the buffers (in/output) and will thus not delete them
 // during job's destruction.
 struct SkinningJob {
@@ -82,6 +98,8 @@ struct SkinningJob {
   // - if any range is invalid. See each range description.
   // - if normals are provided but positions aren't.
   // - if tangents are provided but normals aren't.
+  // - if format is invalid.
+  // - if both joint matrices and dual quaternions are provided, or none.
   // - if no output is provided while an input is. For example, if input normals
   // are provided, then output normals must also.
   bool Validate() const;
@@ -92,6 +110,43 @@ struct SkinningJob {
   // Returns false if *this job is not valid.
   bool Run() const;
 
+  // Runs job's skinning task for vertices of range [_begin,_end[ only. This
+  // allows to split a mesh in independent ranges, skinned by different threads
+  // for example, without offsetting every buffer by hand.
+  // The whole job is validated before any operation is performed, see
+  // Validate() for more details.
+  // Returns false if *this job is not valid, or if the range isn't included in
+  // [0,vertex_count].
+  bool Run(int _begin, int _end) const;
+
+  // Vertex input formats. A single format applies to all inputs of the job, so
+  // that a single skinning loop decodes the whole vertex.
+  // Compact formats read positions, normals, tangents and weights from their
+  // compact spans (in_positions_compact, joint_weights_unorm8...), with the
+  // same strides as float inputs. Compact positions are decoded as:
+  // position = value * in_positions_scale + in_positions_bias. Compact normals
+  // and tangents are always 2 x 16 bits signed normalized integers, octahedral
+  // encoding of a unit vector. They are normalized when decoded.
+  enum Format {
+    // 32 bits floats, read from float input spans. This is the default format.
+    kFloat,
+    // 3 x 16 bits IEEE half float positions, 8 bits unsigned normalized
+    // weights.
+    kHalfUnorm8,
+    // 3 x 16 bits IEEE half float positions, 16 bits unsigned normalized
+    // weights.
+    kHalfUnorm16,
+    // 3 x 16 bits signed normalized positions, 8 bits unsigned normalized
+    // weights.
+    kSnorm16Unorm8,
+    // 3 x 16 bits signed normalized positions, 16 bits unsigned normalized
+    // weights.
+    kSnorm16Unorm16,
+  };
+
+  // Format of all vertex inputs, kFloat by default.
+  Format format;
+
   // Number of vertices to transform. All input and output arrays must store at
   // least this number of vertices.
   int vertex_count;
@@ -106,6 +161,7 @@ struct SkinningJob {
   int influences_count;
 
   // Array of matrices for each joint. Joint are indexed through indices array.
+  // Required, unless joint_dual_quaternions are provided.
   span<const math::Float4x4> joint_matrices;
 
   // Optional array of inverse transposed matrices for each joint. If provided,
@@ -120,6 +176,13 @@ struct SkinningJob {
   // fall into a more costly code path in the skinning algorithm.
   span<const math::Float4x4> joint_inverse_transpose_matrices;
 
+  // Optional array of dual quaternions for each joint, see
+  // DualQuaternionPaletteJob. If provided, vertices are skinned with dual
+  // quaternion skinning, in which case joint_matrices and
+  // joint_inverse_transpose_matrices must be empty. Joints are indexed through
+  // indices array, the same way as joint matrices are.
+  span<const DualQuaternion> joint_dual_quaternions;
+
   // Array of joints indices. This array is used to indexes matrices in joints
   // array.
   // Each vertex has influences_max number of indices, meaning that the size of
@@ -137,6 +200,11 @@ struct SkinningJob {
   span<const float> joint_weights;
   size_t joint_weights_stride;
 
+  // Compact joint weights, used instead of joint_weights depending on format.
+  // They are read with joint_weights_stride.
+  span<const uint8_t> joint_weights_unorm8;
+  span<const uint16_t> joint_weights_unorm16;
+
   // Input vertex positions array (3 float values per vertex) and stride (number
   // of bytes between each position).
   // Array length must be at least vertex_count * in_positions_stride.
@@ -155,6 +223,16 @@ struct SkinningJob {
   span<const float> in_tangents;
   size_t in_tangents_stride;
 
+  // Compact input positions, normals and tangents, used instead of float
+  // inputs when format isn't kFloat. They are read with in_positions_stride,
+  // in_normals_stride and in_tangents_stride. Positions are decoded with
+  // in_positions_scale and in_positions_bias.
+  span<const uint16_t> in_positions_compact;
+  span<const uint16_t> in_normals_compact;
+  span<const uint16_t> in_tangents_compact;
+  math::Float3 in_positions_scale;
+  math::Float3 in_positions_bias;
+
   // Output vertex positions (3 float values per vertex) array and stride
   // (number of bytes between each position).
   // Array length must be at least vertex_count * out_positions_stride.
@@ -179,6 +257,52 @@ struct SkinningJob {
   span<float> out_tangents;
   size_t out_tangents_stride;
 };
+
+// Skins the vertices of a SkinningJob as independent ranges of vertices (see
+// SkinningJob::Run(int, int)), distributed across threads with a task runner.
+// This reduces the latency of skinning a single big mesh on many-core
+// platforms.
+// Range boundaries are aligned on cache lines of all output buffers (positions,
+// normals and tangents), so that concurrent tasks never write to the same cache
+// line (aka false sharing). Interleaved outputs are aligned on the cache lines
+// of their first member. Depending on outputs addresses and strides, there
+// might be no vertex that starts a cache line in all outputs. Boundaries are
+// then aligned for as many outputs as possible, and tasks might share the
+// cache lines of the others.
+struct ParallelSkinningJob {
+  // Default constructor, initializes default values.
+  ParallelSkinningJob();
+
+  // Validates job parameters. Returns true for a valid job, or false otherwise:
+  // -if skinning job is invalid, see SkinningJob::Validate().
+  // -if max_task_count or min_task_vertex_count is less than 1.
+  bool Validate() const;
+
+  // Runs job's skinning tasks.
+  // The job is validated before any operation is performed, see Validate() for
+  // more details.
+  // Returns false if job is not valid. See Validate() function.
+  bool Run() const;
+
+  // Job input.
+
+  // The skinning job to split, whose vertices are distributed across tasks.
+  SkinningJob job;
+
+  // Maximum number of tasks, usually the number of available threads. Default
+  // is 1.
+  int max_task_count;
+
+  // Minimum number of vertices per task, so that tasks are big enough for
+  // threading overhead to be negligible. Default is 1024.
+  int min_task_vertex_count;
+
+  // Optional function used to run skinning tasks, allowing to distribute them
+  // across threads, see ozz::TaskRunner. Each task skins its own range of
+  // vertices.
+  // Tasks are run serially on the calling thread if no runner is set.
+  TaskRunner task_runner;
+};
 }  // namespace geometry
 }  // namespace ozz
 #endif  // OZZ_OZZ_GEOMETRY_RUNTIME_SKINNING_JOB_H_
@@ -0,0 +1,103 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+
+#ifndef OZZ_OZZ_GEOMETRY_RUNTIME_SKINNING_PALETTE_JOB_H_
+#define OZZ_OZZ_GEOMETRY_RUNTIME_SKINNING_PALETTE_JOB_H_
+
+#include "ozz/base/platform.h"
+#include "ozz/base/span.h"
+
+namespace ozz {
+namespace math {
+struct Float4x4;
+struct Float3x4;
+}  // namespace math
+namespace geometry {
+
+// Builds the skinning matrices palette of a mesh, from skeleton model-space
+// joint matrices (as output by LocalToModelJob) and the mesh inverse bind
+// poses.
+// A mesh is usually skinned by a subset of the skeleton joints only, so the
+// palette is indexed through a remapping table: palette entry i is
+// joint_matrices[joint_remaps[i]] * inverse_bind_poses[i].
+// The job can also output the inverse transpose of skinning matrices, used by
+// SkinningJob to transform normals and tangents when matrices have non-uniform
+// scale. Matrices whose axes are orthogonal (rotation and scale, uniform or
+// not) use a fast path that avoids the general 4x4 inverse. Only matrices with
+// shearing fall back to the general inverse.
+struct SkinningPaletteJob {
+  // Validates job parameters. Returns true for a valid job, or false otherwise:
+  // -if both joint_matrices and joint_matrices_3x4 are set, or none.
+  // -if any joint_remaps index is out of joint matrices range.
+  // -if inverse_bind_poses is smaller than the palette size, which is
+  // joint_remaps size, or joint matrices size if joint_remaps is empty.
+  // -if both output and output_3x4 are set, or none.
+  // -if outputs are smaller than the palette size.
+  bool Validate() const;
+
+  // Runs job's execution task.
+  // The job is validated before any operation is performed, see Validate() for
+  // more details.
+  // Returns false if *this job is not valid.
+  bool Run() const;
+
+  // Job input.
+
+  // Model-space joint matrices, as output by LocalToModelJob. Exclusive with
+  // joint_matrices_3x4.
+  span<const math::Float4x4> joint_matrices;
+
+  // Model-space joint 3x4 affine matrices, as output by
+  // LocalToModelJob::output_3x4. They are multiplied as is with inverse bind
+  // poses, without being converted to Float4x4. Exclusive with joint_matrices.
+  span<const math::Float3x4> joint_matrices_3x4;
+
+  // Optional joint remapping table, index of the joint matrices used by each
+  // palette entry. If empty, palette entry i uses joint matrix i.
+  span<const uint16_t> joint_remaps;
+
+  // Inverse bind pose matrices, one per palette entry.
+  span<const math::Float4x4> inverse_bind_poses;
+
+  // Job output.
+
+  // Skinning matrices palette. Exclusive with output_3x4.
+  span<math::Float4x4> output;
+
+  // Skinning matrices palette, as 3x4 affine matrices (see
+  // ozz::math::Float3x4), matching GPU skinning palettes layout. Exclusive
+  // with output.
+  span<math::Float3x4> output_3x4;
+
+  // Optional inverse transpose of skinning matrices, to be used as
+  // SkinningJob::joint_inverse_transpose_matrices.
+  span<math::Float4x4> output_inverse_transpose;
+};
+}  // namespace geometry
+}  // namespace ozz
+#endif  // OZZ_OZZ_GEOMETRY_RUNTIME_SKINNING_PALETTE_JOB_H_
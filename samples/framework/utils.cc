@@ -289,7 +289,7 @@ bool LoadSkeleton(const char* _filename, ozz::animation::Skeleton* _skeleton) {
   assert(_filename && _skeleton);
   ozz::log::Out() << "Loading skeleton archive " << _filename << "."
                   << std::endl;
-  ozz::io::File file(_filename, "rb");
+  ozz::io::BufferedFile file(_filename, "rb");
   if (!file.opened()) {
     ozz::log::Err() << "Failed to open skeleton file " << _filename << "."
                     << std::endl;
@@ -313,7 +313,7 @@ bool LoadAnimation(const char* _filename,
   assert(_filename && _animation);
   ozz::log::Out() << "Loading animation archive: " << _filename << "."
                   << std::endl;
-  ozz::io::File file(_filename, "rb");
+  ozz::io::BufferedFile file(_filename, "rb");
   if (!file.opened()) {
     ozz::log::Err() << "Failed to open animation file " << _filename << "."
                     << std::endl;
@@ -337,7 +337,7 @@ template <typename _Track>
 bool LoadTrackImpl(const char* _filename, _Track* _track) {
   assert(_filename && _track);
   ozz::log::Out() << "Loading track archive: " << _filename << "." << std::endl;
-  ozz::io::File file(_filename, "rb");
+  ozz::io::BufferedFile file(_filename, "rb");
   if (!file.opened()) {
     ozz::log::Err() << "Failed to open track file " << _filename << "."
                     << std::endl;
@@ -376,7 +376,7 @@ bool LoadTrack(const char* _filename, ozz::animation::QuaternionTrack* _track) {
 bool LoadMesh(const char* _filename, ozz::sample::Mesh* _mesh) {
   assert(_filename && _mesh);
   ozz::log::Out() << "Loading mesh archive: " << _filename << "." << std::endl;
-  ozz::io::File file(_filename, "rb");
+  ozz::io::BufferedFile file(_filename, "rb");
   if (!file.opened()) {
     ozz::log::Err() << "Failed to open mesh file " << _filename << "."
                     << std::endl;
@@ -400,7 +400,7 @@ bool LoadMeshes(const char* _filename,
   assert(_filename && _meshes);
   ozz::log::Out() << "Loading meshes archive: " << _filename << "."
                   << std::endl;
-  ozz::io::File file(_filename, "rb");
+  ozz::io::BufferedFile file(_filename, "rb");
   if (!file.opened()) {
     ozz::log::Err() << "Failed to open mesh file " << _filename << "."
                     << std::endl;
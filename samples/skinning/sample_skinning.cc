@@ -36,6 +36,7 @@
 #include "ozz/animation/runtime/local_to_model_job.h"
 #include "ozz/animation/runtime/sampling_job.h"
 #include "ozz/animation/runtime/skeleton.h"
+#include "ozz/geometry/runtime/skinning_palette_job.h"
 #include "ozz/base/log.h"
 #include "ozz/base/maths/math_ex.h"
 #include "ozz/base/maths/simd_math.h"
@@ -102,9 +103,13 @@ class SkinningSampleApplication : public ozz::sample::Application {
       // the joint remapping table (available from the mesh object) to reorder
       // model-space matrices and build skinning ones.
       for (const ozz::sample::Mesh& mesh : meshes_) {
-        for (size_t i = 0; i < mesh.joint_remaps.size(); ++i) {
-          skinning_matrices_[i] =
-              models_[mesh.joint_remaps[i]] * mesh.inverse_bind_poses[i];
+        ozz::geometry::SkinningPaletteJob palette_job;
+        palette_job.joint_matrices = make_span(models_);
+        palette_job.joint_remaps = make_span(mesh.joint_remaps);
+        palette_job.inverse_bind_poses = make_span(mesh.inverse_bind_poses);
+        palette_job.output = make_span(skinning_matrices_);
+        if (!palette_job.Run()) {
+          return false;
         }
 
         // Renders skin.
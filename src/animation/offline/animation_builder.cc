@@ -316,6 +316,9 @@ unique_ptr<Animation> AnimationBuilder::operator()(
   CopyToAnimation(&sorting_rotations, &animation->rotations_, inv_duration);
   CopyToAnimation(&sorting_scales, &animation->scales_, inv_duration);
 
+  // Builds seeking index from sorted keys.
+  animation->BuildSeekIndex();
+
   // Copy animation's name.
   if (animation->name_) {
     strcpy(animation->name_, _input.name.c_str());
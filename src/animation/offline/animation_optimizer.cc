@@ -239,6 +239,59 @@ class ScaleAdapter {
  private:
   float length_;
 };
+// Decimates one track (translation, rotation or scale) of a joint. Task _index
+// is 3 * joint + track type. Every task writes a different output track, so
+// they can be run concurrently.
+class DecimationTask {
+ public:
+  DecimationTask(const RawAnimation* _input, const Skeleton* _skeleton,
+                 const HierarchyBuilder* _hierarchy, RawAnimation* _output)
+      : input_(_input),
+        skeleton_(_skeleton),
+        hierarchy_(_hierarchy),
+        output_(_output) {}
+
+  void operator()(int _index) const {
+    const int i = _index / 3;
+    const RawAnimation::JointTrack& input = input_->tracks[i];
+    RawAnimation::JointTrack& output = output_->tracks[i];
+
+    // Gets joint specs back.
+    const float joint_length = hierarchy_->specs[i].length;
+    const int parent = skeleton_->joint_parents()[i];
+    const float parent_scale =
+        (parent != Skeleton::kNoParent) ? hierarchy_->specs[parent].scale : 1.f;
+    const float tolerance = hierarchy_->specs[i].tolerance;
+
+    // Filters independently T, R and S tracks.
+    switch (_index % 3) {
+      case 0: {
+        // This joint translation is affected by parent scale.
+        const PositionAdapter tadap(parent_scale);
+        Decimate(input.translations, tadap, tolerance, &output.translations);
+        break;
+      }
+      case 1: {
+        // This joint rotation affects children translations/length.
+        const RotationAdapter radap(joint_length);
+        Decimate(input.rotations, radap, tolerance, &output.rotations);
+        break;
+      }
+      default: {
+        // This joint scale affects children translations/length.
+        const ScaleAdapter sadap(joint_length);
+        Decimate(input.scales, sadap, tolerance, &output.scales);
+        break;
+      }
+    }
+  }
+
+ private:
+  const RawAnimation* input_;
+  const Skeleton* skeleton_;
+  const HierarchyBuilder* hierarchy_;
+  RawAnimation* output_;
+};
 }  // namespace
 
 bool AnimationOptimizer::operator()(const RawAnimation& _input,
@@ -270,27 +323,16 @@ bool AnimationOptimizer::operator()(const RawAnimation& _input,
   _output->duration = _input.duration;
   _output->tracks.resize(num_tracks);
 
-  for (int i = 0; i < num_tracks; ++i) {
-    const RawAnimation::JointTrack& input = _input.tracks[i];
-    RawAnimation::JointTrack& output = _output->tracks[i];
-
-    // Gets joint specs back.
-    const float joint_length = hierarchy.specs[i].length;
-    const int parent = _skeleton.joint_parents()[i];
-    const float parent_scale =
-        (parent != Skeleton::kNoParent) ? hierarchy.specs[parent].scale : 1.f;
-    const float tolerance = hierarchy.specs[i].tolerance;
-
-    // Filters independently T, R and S tracks.
-    // This joint translation is affected by parent scale.
-    const PositionAdapter tadap(parent_scale);
-    Decimate(input.translations, tadap, tolerance, &output.translations);
-    // This joint rotation affects children translations/length.
-    const RotationAdapter radap(joint_length);
-    Decimate(input.rotations, radap, tolerance, &output.rotations);
-    // This joint scale affects children translations/length.
-    const ScaleAdapter sadap(joint_length);
-    Decimate(input.scales, sadap, tolerance, &output.scales);
+  // Decimates translation, rotation and scale tracks of each joint as
+  // independent tasks.
+  const DecimationTask task(&_input, &_skeleton, &hierarchy, _output);
+  const int num_tasks = num_tracks * 3;
+  if (task_runner) {
+    task_runner(num_tasks, task);
+  } else {
+    for (int i = 0; i < num_tasks; ++i) {
+      task(i);
+    }
   }
 
   // Output animation is always valid though.
@@ -0,0 +1,167 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+
+#include "ozz/animation/offline/float_curves_builder.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+#include "ozz/animation/offline/raw_float_curves.h"
+#include "ozz/animation/runtime/float_curves.h"
+#include "ozz/base/containers/vector.h"
+#include "ozz/base/maths/math_ex.h"
+#include "ozz/base/memory/allocator.h"
+
+// Internal include file
+#define OZZ_INCLUDE_PRIVATE_HEADER  // Allows to include private headers.
+#include "animation/runtime/animation_keyframe.h"
+
+namespace ozz {
+namespace animation {
+namespace offline {
+namespace {
+
+struct SortingCurveKey {
+  uint16_t track;
+  float prev_key_ratio;
+  RawFloatTrack::Keyframe key;
+};
+
+// Keyframe sorting. Stores first by ratio of the previous key of the same
+// curve, and then by curve number. This is the order in which
+// FloatCurvesSamplingJob needs keys while sampling forward.
+bool SortingCurveKeyLess(const SortingCurveKey& _left,
+                         const SortingCurveKey& _right) {
+  const float ratio_diff = _left.prev_key_ratio - _right.prev_key_ratio;
+  return ratio_diff < 0.f || (ratio_diff == 0.f && _left.track < _right.track);
+}
+
+void PushBackCurveKey(uint16_t _track, float* _prev_ratio,
+                      const RawFloatTrack::Keyframe& _key,
+                      ozz::vector<SortingCurveKey>* _dest) {
+  const SortingCurveKey key = {_track, *_prev_ratio, _key};
+  _dest->push_back(key);
+  *_prev_ratio = _key.ratio;
+}
+
+// Copies a curve to the sorting keys, and fixes up the first (ratio = 0) and
+// last (ratio = 1) keys, the same way TrackBuilder does.
+void CopyCurve(const RawFloatTrack& _src, uint16_t _track,
+               ozz::vector<SortingCurveKey>* _dest) {
+  const RawFloatTrack::Keyframes& keyframes = _src.keyframes;
+  float prev_ratio = -1.f;
+  if (keyframes.size() < 2) {  // Adds 2 constant keys.
+    const float value = keyframes.empty() ? 0.f : keyframes.front().value;
+    const RawFloatTrack::Keyframe first = {RawTrackInterpolation::kLinear, 0.f,
+                                           value};
+    PushBackCurveKey(_track, &prev_ratio, first, _dest);
+    const RawFloatTrack::Keyframe last = {RawTrackInterpolation::kLinear, 1.f,
+                                          value};
+    PushBackCurveKey(_track, &prev_ratio, last, _dest);
+    return;
+  }
+
+  // Copies all keys, and pushes first and last keys if they don't exist.
+  if (keyframes.front().ratio != 0.f) {
+    const RawFloatTrack::Keyframe first = {RawTrackInterpolation::kLinear, 0.f,
+                                           keyframes.front().value};
+    PushBackCurveKey(_track, &prev_ratio, first, _dest);
+  }
+  for (size_t i = 0; i < keyframes.size(); ++i) {
+    PushBackCurveKey(_track, &prev_ratio, keyframes[i], _dest);
+  }
+  if (keyframes.back().ratio != 1.f) {
+    const RawFloatTrack::Keyframe last = {RawTrackInterpolation::kLinear, 1.f,
+                                          keyframes.back().value};
+    PushBackCurveKey(_track, &prev_ratio, last, _dest);
+  }
+}
+}  // namespace
+
+unique_ptr<FloatCurves> FloatCurvesBuilder::operator()(
+    const RawFloatCurves& _input) const {
+  // Tests _input validity.
+  if (!_input.Validate()) {
+    return nullptr;
+  }
+
+  // Everything is fine, allocates and fills the curves.
+  // Nothing can fail now.
+  unique_ptr<FloatCurves> curves = make_unique<FloatCurves>();
+
+  // Sets curves count. Can be safely casted to uint16_t as number of curves
+  // has already been validated.
+  const uint16_t num_curves = static_cast<uint16_t>(_input.num_curves());
+  curves->num_curves_ = num_curves;
+  const uint16_t num_soa_curves = Align(num_curves, 4);
+
+  // Declares and preallocates keys to sort.
+  size_t num_keys = 0;
+  for (int i = 0; i < num_curves; ++i) {
+    // +2 because worst case needs to add the first and last keys.
+    num_keys += _input.curves[i].keyframes.size() + 2;
+  }
+  ozz::vector<SortingCurveKey> sorting_keys;
+  sorting_keys.reserve(num_keys + (num_soa_curves - num_curves) * 2);
+
+  // Copies all curves, then adds enough default curves to match soa
+  // requirements.
+  uint16_t i = 0;
+  for (; i < num_curves; ++i) {
+    CopyCurve(_input.curves[i], i, &sorting_keys);
+  }
+  const RawFloatTrack empty;
+  for (; i < num_soa_curves; ++i) {
+    CopyCurve(empty, i, &sorting_keys);
+  }
+
+  // Sort keys to favor cache coherency.
+  std::sort(sorting_keys.begin(), sorting_keys.end(), &SortingCurveKeyLess);
+
+  // Fills output.
+  curves->Allocate(_input.name.length(), sorting_keys.size());
+  for (size_t k = 0; k < sorting_keys.size(); ++k) {
+    const SortingCurveKey& src = sorting_keys[k];
+    FloatCurveKey& key = curves->keys_[k];
+    key.ratio = src.key.ratio;
+    key.track = src.track;
+    key.step = src.key.interpolation == RawTrackInterpolation::kStep;
+    key.value = src.key.value;
+  }
+
+  // Copy curves name.
+  if (curves->name_) {
+    std::strcpy(curves->name_, _input.name.c_str());
+  }
+
+  return curves;  // Success.
+}
+}  // namespace offline
+}  // namespace animation
+}  // namespace ozz
@@ -94,6 +94,18 @@ struct Extern<animation::offline::RawAnimation::JointTrack> {
   }
 };
 
+// Keys are made of floats only (time, then value components), which matches
+// their archive format. They can thus be serialized as a single float array.
+static_assert(sizeof(animation::offline::RawAnimation::TranslationKey) ==
+                  4 * sizeof(float),
+              "Unexpected TranslationKey layout");
+static_assert(sizeof(animation::offline::RawAnimation::RotationKey) ==
+                  5 * sizeof(float),
+              "Unexpected RotationKey layout");
+static_assert(sizeof(animation::offline::RawAnimation::ScaleKey) ==
+                  4 * sizeof(float),
+              "Unexpected ScaleKey layout");
+
 OZZ_IO_TYPE_VERSION(1, animation::offline::RawAnimation::TranslationKey)
 
 template <>
@@ -102,21 +114,13 @@ struct Extern<animation::offline::RawAnimation::TranslationKey> {
       OArchive& _archive,
       const animation::offline::RawAnimation::TranslationKey* _keys,
       size_t _count) {
-    for (size_t i = 0; i < _count; ++i) {
-      const animation::offline::RawAnimation::TranslationKey& key = _keys[i];
-      _archive << key.time;
-      _archive << key.value;
-    }
+    _archive << MakeArray(reinterpret_cast<const float*>(_keys), 4 * _count);
   }
   static void Load(IArchive& _archive,
                    animation::offline::RawAnimation::TranslationKey* _keys,
                    size_t _count, uint32_t _version) {
     (void)_version;
-    for (size_t i = 0; i < _count; ++i) {
-      animation::offline::RawAnimation::TranslationKey& key = _keys[i];
-      _archive >> key.time;
-      _archive >> key.value;
-    }
+    _archive >> MakeArray(reinterpret_cast<float*>(_keys), 4 * _count);
   }
 };
 
@@ -127,21 +131,13 @@ struct Extern<animation::offline::RawAnimation::RotationKey> {
   static void Save(OArchive& _archive,
                    const animation::offline::RawAnimation::RotationKey* _keys,
                    size_t _count) {
-    for (size_t i = 0; i < _count; ++i) {
-      const animation::offline::RawAnimation::RotationKey& key = _keys[i];
-      _archive << key.time;
-      _archive << key.value;
-    }
+    _archive << MakeArray(reinterpret_cast<const float*>(_keys), 5 * _count);
   }
   static void Load(IArchive& _archive,
                    animation::offline::RawAnimation::RotationKey* _keys,
                    size_t _count, uint32_t _version) {
     (void)_version;
-    for (size_t i = 0; i < _count; ++i) {
-      animation::offline::RawAnimation::RotationKey& key = _keys[i];
-      _archive >> key.time;
-      _archive >> key.value;
-    }
+    _archive >> MakeArray(reinterpret_cast<float*>(_keys), 5 * _count);
   }
 };
 
@@ -152,21 +148,13 @@ struct Extern<animation::offline::RawAnimation::ScaleKey> {
   static void Save(OArchive& _archive,
                    const animation::offline::RawAnimation::ScaleKey* _keys,
                    size_t _count) {
-    for (size_t i = 0; i < _count; ++i) {
-      const animation::offline::RawAnimation::ScaleKey& key = _keys[i];
-      _archive << key.time;
-      _archive << key.value;
-    }
+    _archive << MakeArray(reinterpret_cast<const float*>(_keys), 4 * _count);
   }
   static void Load(IArchive& _archive,
                    animation::offline::RawAnimation::ScaleKey* _keys,
                    size_t _count, uint32_t _version) {
     (void)_version;
-    for (size_t i = 0; i < _count; ++i) {
-      animation::offline::RawAnimation::ScaleKey& key = _keys[i];
-      _archive >> key.time;
-      _archive >> key.value;
-    }
+    _archive >> MakeArray(reinterpret_cast<float*>(_keys), 4 * _count);
   }
 };
 }  // namespace io
@@ -0,0 +1,67 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+
+#include "ozz/animation/offline/raw_float_curves.h"
+
+#include <cassert>
+
+#include "ozz/animation/runtime/float_curves.h"
+#include "ozz/base/containers/string_archive.h"
+#include "ozz/base/containers/vector_archive.h"
+#include "ozz/base/io/archive.h"
+
+namespace ozz {
+namespace animation {
+namespace offline {
+
+bool RawFloatCurves::Validate() const {
+  if (curves.size() > FloatCurves::kMaxCurves) {
+    return false;
+  }
+  for (size_t i = 0; i < curves.size(); ++i) {
+    if (!curves[i].Validate()) {
+      return false;
+    }
+  }
+  return true;  // Validated.
+}
+
+void RawFloatCurves::Save(io::OArchive& _archive) const {
+  _archive << curves;
+  _archive << name;
+}
+
+void RawFloatCurves::Load(io::IArchive& _archive, uint32_t _version) {
+  (void)_version;
+  assert(_version == 1);
+  _archive >> curves;
+  _archive >> name;
+}
+}  // namespace offline
+}  // namespace animation
+}  // namespace ozz
@@ -68,12 +68,39 @@ struct JointLister {
   // Array of joints in the traversed DAG order.
   ozz::vector<Joint> linear_joints;
 };
+
+// Applies _fct to each joint level by level: all roots first, then all their
+// children...
+template <typename _Fct>
+void IterateJointsByLevel(const RawSkeleton& _skeleton, _Fct _fct) {
+  struct Siblings {
+    const RawSkeleton::Joint::Children* children;
+    const RawSkeleton::Joint* parent;
+  };
+  ozz::vector<Siblings> level;
+  ozz::vector<Siblings> next_level;
+  const Siblings roots = {&_skeleton.roots, nullptr};
+  level.push_back(roots);
+  while (!level.empty()) {
+    for (const Siblings& siblings : level) {
+      for (const RawSkeleton::Joint& joint : *siblings.children) {
+        _fct(joint, siblings.parent);
+        const Siblings children = {&joint.children, &joint};
+        next_level.push_back(children);
+      }
+    }
+    level.swap(next_level);
+    next_level.clear();
+  }
+}
 }  // namespace
 
+SkeletonBuilder::SkeletonBuilder() : level_order(false) {}
+
 // Validates the RawSkeleton and fills a Skeleton.
 // Uses RawSkeleton::IterateJointsDF to traverse in DAG depth-first order.
 // Building skeleton hierarchy in depth first order make it easier to iterate a
-// skeleton sub-hierarchy.
+// skeleton sub-hierarchy. Joints can alternatively be ordered level by level.
 unique_ptr<ozz::animation::Skeleton> SkeletonBuilder::operator()(
     const RawSkeleton& _raw_skeleton) const {
   // Tests _raw_skeleton validity.
@@ -90,7 +117,11 @@ unique_ptr<ozz::animation::Skeleton> SkeletonBuilder::operator()(
   // list.
   // Iteration order defines runtime skeleton joint ordering.
   JointLister lister(num_joints);
-  IterateJointsDF<JointLister&>(_raw_skeleton, lister);
+  if (level_order) {
+    IterateJointsByLevel<JointLister&>(_raw_skeleton, lister);
+  } else {
+    IterateJointsDF<JointLister&>(_raw_skeleton, lister);
+  }
   assert(static_cast<int>(lister.linear_joints.size()) == num_joints);
 
   // Computes name's buffer size.
@@ -116,6 +147,7 @@ unique_ptr<ozz::animation::Skeleton> SkeletonBuilder::operator()(
   for (int i = 0; i < num_joints; ++i) {
     skeleton->joint_parents_[i] = lister.linear_joints[i].parent;
   }
+  skeleton->InitLevels();
 
   // Transfers t-poses.
   const math::SimdFloat4 w_axis = math::simd_float4::w_axis();
@@ -32,6 +32,11 @@
 #include <cstdlib>
 #include <cstring>
 
+#if !defined(__EMSCRIPTEN__)
+#include <atomic>
+#include <thread>
+#endif  // __EMSCRIPTEN__
+
 #include "animation/offline/tools/import2ozz_config.h"
 #include "animation/offline/tools/import2ozz_track.h"
 #include "ozz/animation/offline/additive_animation_builder.h"
@@ -45,7 +50,9 @@
 #include "ozz/animation/runtime/skeleton.h"
 #include "ozz/base/io/archive.h"
 #include "ozz/base/io/stream.h"
+#include "ozz/base/containers/vector.h"
 #include "ozz/base/log.h"
+#include "ozz/base/maths/math_ex.h"
 #include "ozz/base/maths/soa_transform.h"
 #include "ozz/base/memory/unique_ptr.h"
 #include "ozz/options/options.h"
@@ -55,6 +62,32 @@ namespace animation {
 namespace offline {
 namespace {
 
+#if !defined(__EMSCRIPTEN__)
+// Runs optimization tasks fetched one by one from a shared counter, as their
+// costs vary a lot from a track to another.
+void OptimizationWorker(std::atomic_int* _next,
+                        const std::function<void(int)>* _task, int _count) {
+  for (int i = (*_next)++; i < _count; i = (*_next)++) {
+    (*_task)(i);
+  }
+}
+
+// Distributes optimization tasks on all hardware threads.
+void RunOptimizationTasks(int _count, const std::function<void(int)>& _task) {
+  const int num_threads = math::Min(
+      static_cast<int>(std::thread::hardware_concurrency()), _count);
+  std::atomic_int next(0);
+  ozz::vector<std::thread> threads;
+  for (int i = 1; i < num_threads; ++i) {
+    threads.push_back(std::thread(OptimizationWorker, &next, &_task, _count));
+  }
+  OptimizationWorker(&next, &_task, _count);  // Calling thread works too.
+  for (size_t i = 0; i < threads.size(); ++i) {
+    threads[i].join();
+  }
+}
+#endif  // __EMSCRIPTEN__
+
 void DisplaysOptimizationstatistics(const RawAnimation& _non_optimized,
                                     const RawAnimation& _optimized) {
   size_t opt_translations = 0, opt_rotations = 0, opt_scales = 0;
@@ -99,7 +132,7 @@ unique_ptr<ozz::animation::Skeleton> LoadSkeleton(const char* _path) {
     }
     ozz::log::LogV() << "Opens input skeleton ozz binary file: " << _path
                      << std::endl;
-    ozz::io::File file(_path, "rb");
+    ozz::io::BufferedFile file(_path, "rb");
     if (!file.opened()) {
       ozz::log::Err() << "Failed to open input skeleton ozz binary file: \""
                       << _path << "\"" << std::endl;
@@ -170,6 +203,9 @@ bool Export(OzzImporter& _importer, const RawAnimation& _input_animation,
   if (_config["optimize"].asBool()) {
     ozz::log::Log() << "Optimizing animation." << std::endl;
     AnimationOptimizer optimizer;
+#if !defined(__EMSCRIPTEN__)
+    optimizer.task_runner = RunOptimizationTasks;
+#endif  // __EMSCRIPTEN__
 
     // Setup optimizer from config parameters.
     const Json::Value& tolerances = _config["optimization_settings"];
@@ -287,7 +323,7 @@ bool Export(OzzImporter& _importer, const RawAnimation& _input_animation,
 
     ozz::log::LogV() << "Opens output file: \"" << filename << "\""
                      << std::endl;
-    ozz::io::File file(filename.c_str(), "wb");
+    ozz::io::BufferedFile file(filename.c_str(), "wb");
     if (!file.opened()) {
       ozz::log::Err() << "Failed to open output file: \"" << filename << "\""
                       << std::endl;
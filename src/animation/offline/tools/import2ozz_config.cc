@@ -231,6 +231,10 @@ bool SanitizeSkeletonImport(Json::Value& _root, bool _all_options) {
       _root, "enable", true,
       "Imports (from source data file) and writes skeleton output file.");
   MakeDefault(_root, "raw", false, "Outputs raw skeleton.");
+  MakeDefault(_root, "level_order", false,
+              "Orders runtime skeleton joints level by level (breadth-first) "
+              "instead of depth-first. This allows local-to-model conversion to "
+              "process sibling joints together.");
   MakeDefaultObject(
       _root, "types",
       "Define nodes types that should be considered as skeleton joints.");
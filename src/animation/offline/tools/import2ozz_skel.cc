@@ -154,6 +154,7 @@ bool ImportSkeleton(const Json::Value& _config, OzzImporter* _importer,
     // Builds runtime skeleton.
     ozz::log::Log() << "Builds runtime skeleton." << std::endl;
     SkeletonBuilder builder;
+    builder.level_order = import_config["level_order"].asBool();
     skeleton = builder(raw_skeleton);
     if (!skeleton) {
       ozz::log::Err() << "Failed to build runtime skeleton." << std::endl;
@@ -168,7 +169,7 @@ bool ImportSkeleton(const Json::Value& _config, OzzImporter* _importer,
   {
     const char* filename = skeleton_config["filename"].asCString();
     ozz::log::Log() << "Opens output file: " << filename << std::endl;
-    ozz::io::File file(filename, "wb");
+    ozz::io::BufferedFile file(filename, "wb");
     if (!file.opened()) {
       ozz::log::Err() << "Failed to open output file: \"" << filename << "\"."
                       << std::endl;
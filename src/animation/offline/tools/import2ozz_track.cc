@@ -149,7 +149,7 @@ bool Export(OzzImporter& _importer, const _RawTrack& _raw_track,
         _config["filename"].asCString(), _raw_track.name.c_str());
 
     ozz::log::LogV() << "Opens output file: " << filename << std::endl;
-    ozz::io::File file(filename.c_str(), "wb");
+    ozz::io::BufferedFile file(filename.c_str(), "wb");
     if (!file.opened()) {
       ozz::log::Err() << "Failed to open output file: " << filename
                       << std::endl;
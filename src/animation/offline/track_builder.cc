@@ -31,13 +31,20 @@
 #include <cmath>
 #include <cstring>
 #include <limits>
+#include <type_traits>
 
+#include "ozz/base/containers/vector.h"
 #include "ozz/base/memory/allocator.h"
 
 #include "ozz/animation/offline/raw_track.h"
 
 #include "ozz/animation/runtime/track.h"
 
+// Internal include file
+#define OZZ_INCLUDE_PRIVATE_HEADER  // Allows to include private headers.
+#include "animation/runtime/track_edge.h"
+#include "animation/runtime/track_quantization.h"
+
 namespace ozz {
 namespace animation {
 namespace offline {
@@ -92,8 +99,60 @@ void Fixup(_Keyframes* _keyframes) {
   // Nothing to do by default.
   (void)_keyframes;
 }
+
+// Detects edges of _keyframes, as TrackTriggeringJob would when looping once
+// over the track. Edges are output in keys order, which is also ratio order.
+template <typename _Keyframes>
+void DetectEdges(const _Keyframes& _keyframes, float _threshold,
+                 ozz::vector<float>* _ratios, ozz::vector<bool>* _rising) {
+  // Edges can only be detected on float tracks.
+  (void)_keyframes;
+  (void)_threshold;
+  (void)_ratios;
+  (void)_rising;
+}
+
+template <>
+void DetectEdges<RawFloatTrack::Keyframes>(
+    const RawFloatTrack::Keyframes& _keyframes, float _threshold,
+    ozz::vector<float>* _ratios, ozz::vector<bool>* _rising) {
+  const size_t num_keys = _keyframes.size();
+  for (size_t i1 = 0; i1 < num_keys; ++i1) {
+    // First key is compared to the last one, to detect edges when looping.
+    const size_t i0 = i1 == 0 ? num_keys - 1 : i1 - 1;
+    const RawFloatTrack::Keyframe& key0 = _keyframes[i0];
+    const RawFloatTrack::Keyframe& key1 = _keyframes[i1];
+    float ratio;
+    bool rising;
+    if (animation::internal::DetectTrackEdge(
+            i1 == 0 ? key1.ratio : key0.ratio, key1.ratio, key0.value,
+            key1.value, key0.interpolation == RawTrackInterpolation::kStep,
+            _threshold, &ratio, &rising)) {
+      _ratios->push_back(ratio);
+      _rising->push_back(rising);
+    }
+  }
+}
+
+// Tests if keyframes ratios remain strictly increasing once quantized.
+template <typename _Keyframes>
+bool CanQuantizeRatios(const _Keyframes& _keyframes) {
+  for (size_t i = 1; i < _keyframes.size(); ++i) {
+    if (animation::internal::QuantizeTrackRatio(_keyframes[i - 1].ratio) >=
+        animation::internal::QuantizeTrackRatio(_keyframes[i].ratio)) {
+      return false;
+    }
+  }
+  return true;
+}
 }  // namespace
 
+TrackBuilder::TrackBuilder()
+    : edge_index(false),
+      edge_threshold(0.f),
+      quantize_ratios(false),
+      quantize_values(false) {}
+
 // Ensures _input's validity and allocates _animation.
 // An animation needs to have at least two key frames per joint, the first at
 // t = 0 and the last at t = 1. If at least one of those keys are not
@@ -125,23 +184,56 @@ unique_ptr<_Track> TrackBuilder::Build(const _RawTrack& _input) const {
   // the shortest path during the normalized-lerp.
   Fixup(&keyframes);
 
-  // Allocates output track.
+  // Detects edges, to build the edge index.
+  ozz::vector<float> edge_ratios;
+  ozz::vector<bool> edge_rising;
+  if (edge_index) {
+    DetectEdges(keyframes, edge_threshold, &edge_ratios, &edge_rising);
+  }
+
+  // Allocates output track. Float tracks are never quantized.
+  typedef typename _RawTrack::ValueType ValueType;
+  const bool quantizable = !std::is_same<ValueType, float>::value;
   const size_t name_len = _input.name.size();
-  track->Allocate(keyframes.size(), _input.name.size());
+  const typename _Track::Layout layout = {
+      keyframes.size(),
+      quantizable && quantize_ratios && CanQuantizeRatios(keyframes),
+      quantizable && quantize_values, edge_ratios.size(), name_len};
+  track->Allocate(layout);
 
   // Copy all keys to output.
-  assert(keyframes.size() == track->ratios_.size() &&
-         keyframes.size() == track->values_.size() &&
+  assert(keyframes.size() == track->num_keys() &&
          keyframes.size() <= track->steps_.size() * 8);
+  typedef animation::internal::TrackQuantization<ValueType> Quantization;
   memset(track->steps_.data(), 0, track->steps_.size_bytes());
   for (size_t i = 0; i < keyframes.size(); ++i) {
     const typename _RawTrack::Keyframe& src_key = keyframes[i];
-    track->ratios_[i] = src_key.ratio;
-    track->values_[i] = src_key.value;
+    if (layout.quantized_ratios) {
+      track->quantized_ratios_[i] =
+          animation::internal::QuantizeTrackRatio(src_key.ratio);
+    } else {
+      track->ratios_[i] = src_key.ratio;
+    }
+    if (layout.quantized_values) {
+      Quantization::Quantize(
+          src_key.value,
+          track->quantized_values_.data() + i * Quantization::kComponents);
+    } else {
+      track->values_[i] = src_key.value;
+    }
     track->steps_[i / 8] |=
         (src_key.interpolation == RawTrackInterpolation::kStep) << (i & 7);
   }
 
+  // Copy edge index. Only float tracks can be indexed.
+  track->has_edge_index_ = edge_index && std::is_same<ValueType, float>::value;
+  track->edge_threshold_ = track->has_edge_index_ ? edge_threshold : 0.f;
+  memset(track->edge_rising_.data(), 0, track->edge_rising_.size_bytes());
+  for (size_t i = 0; i < edge_ratios.size(); ++i) {
+    track->edge_ratios_[i] = edge_ratios[i];
+    track->edge_rising_[i / 8] |= edge_rising[i] << (i & 7);
+  }
+
   // Copy track's name.
   if (name_len) {
     strcpy(track->name_, _input.name.c_str());
@@ -39,12 +39,179 @@
 // Internal include file
 #define OZZ_INCLUDE_PRIVATE_HEADER  // Allows to include private headers.
 #include "animation/runtime/animation_keyframe.h"
+#include "animation/runtime/view_header.h"
 
 namespace ozz {
 
 namespace animation {
 
-Animation::Animation() : duration_(0.f), num_tracks_(0), name_(nullptr) {}
+namespace {
+// Average number of keys per track that a seeking segment should span. The
+// seeking index of a segment costs 2 integers per track, which remains small
+// compared to the keys it allows to skip.
+const size_t kSeekKeysPerTrack = 16;
+
+// Computes the number of seeking segments required for an animation with
+// _num_tracks tracks and the given key counts.
+int ComputeNumSeekSegments(int _num_tracks, size_t _translation_count,
+                           size_t _rotation_count, size_t _scale_count) {
+  if (_num_tracks == 0) {
+    return 0;
+  }
+  const size_t num_aligned_tracks = static_cast<size_t>(Align(_num_tracks, 4));
+  const size_t max_count =
+      math::Max(_translation_count, math::Max(_rotation_count, _scale_count));
+  const size_t num_segments =
+      max_count / (num_aligned_tracks * kSeekKeysPerTrack);
+  // A single segment would only duplicate cache initialization.
+  return num_segments < 2 ? 0 : static_cast<int>(num_segments);
+}
+
+// Computes the number of integers of each seeking index buffer.
+size_t ComputeSeekCount(int _num_tracks, int _num_segments) {
+  return _num_segments > 0
+             ? _num_segments * (Align(_num_tracks, 4) * 2 + 1)
+             : 0;
+}
+
+// Computes the size of the buffer required to store all animation data.
+size_t ComputeBufferSize(int _num_tracks, size_t _name_len,
+                         size_t _translation_count, size_t _rotation_count,
+                         size_t _scale_count) {
+  const int num_segments = ComputeNumSeekSegments(
+      _num_tracks, _translation_count, _rotation_count, _scale_count);
+  return (_name_len > 0 ? _name_len + 1 : 0) +
+         _translation_count * sizeof(Float3Key) +
+         _rotation_count * sizeof(QuaternionKey) +
+         _scale_count * sizeof(Float3Key) +
+         ComputeSeekCount(_num_tracks, num_segments) * 3 * sizeof(int);
+}
+
+// Header of animation views, followed by animation buffers in Bind() order.
+struct AnimationViewHeader {
+  internal::ViewHeader base;
+  float duration;
+  int32_t num_tracks;
+  int32_t name_len;
+  int32_t translation_count;
+  int32_t rotation_count;
+  int32_t scale_count;
+};
+
+// Simulates SamplingJob cache cursor update at every segment ratio, and stores
+// each resulting state to the seeking index.
+template <typename _Key>
+void FillSeekIndex(const Animation& _animation,
+                   const span<const _Key>& _keys, const span<int>& _seek) {
+  const int num_segments = _animation.num_seek_segments();
+  const int num_tracks = _animation.num_soa_tracks() * 4;
+  const int stride = num_tracks * 2 + 1;
+  assert(_seek.size() == static_cast<size_t>(num_segments * stride));
+
+  // Initializes first segment with the first 2 sets of key frames. The sorting
+  // algorithm ensures that the first 2 key frames of a track are consecutive.
+  int* cache = _seek.begin() + 1;
+  for (int i = 0; i < num_tracks; ++i) {
+    cache[i * 2 + 0] = i;
+    cache[i * 2 + 1] = i + num_tracks;
+  }
+  int cursor = num_tracks * 2;
+  const int num_keys = static_cast<int>(_keys.size());
+  for (int s = 0; s < num_segments; ++s) {
+    int* segment = _seek.begin() + s * stride;
+    if (s != 0) {  // Starts from previous segment state.
+      std::memcpy(segment + 1, segment + 1 - stride,
+                  sizeof(int) * num_tracks * 2);
+    }
+    cache = segment + 1;
+
+    // Same stepping as SamplingJob, see UpdateCacheCursor.
+    const float ratio = _animation.seek_ratio(s);
+    while (cursor < num_keys &&
+           _keys[cache[_keys[cursor].track * 2 + 1]].ratio <= ratio) {
+      const int base = _keys[cursor].track * 2;
+      cache[base] = cache[base + 1];
+      cache[base + 1] = cursor;
+      ++cursor;
+    }
+    segment[0] = cursor;
+  }
+}
+
+// Float3Key memory layout matches its archive format (ratio, track, value), so
+// keys are read and written in bulk. Endianness is fixed in place when needed.
+static_assert(sizeof(Float3Key) ==
+                  sizeof(float) + sizeof(uint16_t) + sizeof(uint16_t) * 3,
+              "Float3Key must not be padded");
+
+void SaveFloat3Keys(io::OArchive& _archive,
+                    const span<const Float3Key>& _keys) {
+  if (!_archive.endian_swap()) {
+    _archive.SaveBinary(_keys.data(), _keys.size_bytes());
+    return;
+  }
+  for (const Float3Key& key : _keys) {
+    _archive << key.ratio;
+    _archive << key.track;
+    _archive << io::MakeArray(key.value);
+  }
+}
+
+void LoadFloat3Keys(io::IArchive& _archive, const span<Float3Key>& _keys) {
+  _archive.LoadBinary(_keys.data(), _keys.size_bytes());
+  if (_archive.endian_swap()) {
+    for (Float3Key& key : _keys) {
+      key.ratio = EndianSwap(key.ratio);
+      key.track = EndianSwap(key.track);
+      EndianSwap(key.value, 3);
+    }
+  }
+}
+
+// QuaternionKey uses bit fields, so its archive format (ratio, track, largest,
+// sign, value) differs from memory layout. Keys are read by chunks and decoded
+// from a local buffer, rather than field by field from the archive.
+void LoadQuaternionKeys(io::IArchive& _archive,
+                        const span<QuaternionKey>& _keys) {
+  const size_t kRecordSize = sizeof(float) + sizeof(uint16_t) +
+                             sizeof(uint8_t) + sizeof(bool) +
+                             sizeof(int16_t) * 3;
+  const size_t kChunkSize = 256;
+  char buffer[kChunkSize * kRecordSize];
+  const bool swap = _archive.endian_swap();
+  for (size_t i = 0; i < _keys.size(); i += kChunkSize) {
+    const size_t count = math::Min(_keys.size() - i, kChunkSize);
+    _archive.LoadBinary(buffer, count * kRecordSize);
+    const char* record = buffer;
+    for (size_t j = 0; j < count; ++j, record += kRecordSize) {
+      QuaternionKey& key = _keys[i + j];
+      float ratio;
+      std::memcpy(&ratio, record, sizeof(float));
+      uint16_t track;
+      std::memcpy(&track, record + 4, sizeof(uint16_t));
+      int16_t value[3];
+      std::memcpy(value, record + 8, sizeof(value));
+      if (swap) {
+        ratio = EndianSwap(ratio);
+        track = EndianSwap(track);
+        EndianSwap(value, 3);
+      }
+      key.ratio = ratio;
+      key.track = track;
+      key.largest = record[6] & 3;
+      key.sign = record[7] & 1;
+      std::memcpy(key.value, value, sizeof(value));
+    }
+  }
+}
+}  // namespace
+
+Animation::Animation()
+    : duration_(0.f),
+      num_tracks_(0),
+      name_(nullptr),
+      allocation_(nullptr),
+      num_seek_segments_(0) {}
 
 Animation::~Animation() { Deallocate(); }
 
@@ -54,47 +221,77 @@ void Animation::Allocate(size_t _name_len, size_t _translation_count,
   // alignment values first).
   static_assert(alignof(Float3Key) >= alignof(QuaternionKey) &&
                     alignof(QuaternionKey) >= alignof(Float3Key) &&
-                    alignof(Float3Key) >= alignof(char),
+                    alignof(Float3Key) >= alignof(int) &&
+                    alignof(int) >= alignof(char),
                 "Must serve larger alignment values first)");
 
-  assert(name_ == nullptr && translations_.size() == 0 &&
-         rotations_.size() == 0 && scales_.size() == 0);
+  assert(allocation_ == nullptr && name_ == nullptr &&
+         translations_.size() == 0 && rotations_.size() == 0 &&
+         scales_.size() == 0);
 
   // Compute overall size and allocate a single buffer for all the data.
-  const size_t buffer_size = (_name_len > 0 ? _name_len + 1 : 0) +
-                             _translation_count * sizeof(Float3Key) +
-                             _rotation_count * sizeof(QuaternionKey) +
-                             _scale_count * sizeof(Float3Key);
-  span<char> buffer = {static_cast<char*>(memory::default_allocator()->Allocate(
-                           buffer_size, alignof(Float3Key))),
-                       buffer_size};
+  const size_t buffer_size =
+      ComputeBufferSize(num_tracks_, _name_len, _translation_count,
+                        _rotation_count, _scale_count);
+  allocation_ =
+      memory::default_allocator()->Allocate(buffer_size, alignof(Float3Key));
+  span<char> buffer = {static_cast<char*>(allocation_), buffer_size};
+
+  Bind(buffer, _name_len, _translation_count, _rotation_count, _scale_count);
+
+  assert(buffer.empty() && "Whole buffer should be consumned");
+}
+
+void Animation::Bind(span<char>& _buffer, size_t _name_len,
+                     size_t _translation_count, size_t _rotation_count,
+                     size_t _scale_count) {
+  // Seeking index size depends on keys count, for each of the 3 buffers.
+  num_seek_segments_ = ComputeNumSeekSegments(num_tracks_, _translation_count,
+                                              _rotation_count, _scale_count);
+  const size_t seek_count = ComputeSeekCount(num_tracks_, num_seek_segments_);
 
   // Fix up pointers. Serves larger alignment values first.
-  translations_ = fill_span<Float3Key>(buffer, _translation_count);
-  rotations_ = fill_span<QuaternionKey>(buffer, _rotation_count);
-  scales_ = fill_span<Float3Key>(buffer, _scale_count);
+  translations_ = fill_span<Float3Key>(_buffer, _translation_count);
+  rotations_ = fill_span<QuaternionKey>(_buffer, _rotation_count);
+  scales_ = fill_span<Float3Key>(_buffer, _scale_count);
+  translations_seek_ = fill_span<int>(_buffer, seek_count);
+  rotations_seek_ = fill_span<int>(_buffer, seek_count);
+  scales_seek_ = fill_span<int>(_buffer, seek_count);
 
   // Let name be nullptr if animation has no name. Allows to avoid allocating
   // this buffer in the constructor of empty animations.
   name_ =
-      _name_len > 0 ? fill_span<char>(buffer, _name_len + 1).data() : nullptr;
-
-  assert(buffer.empty() && "Whole buffer should be consumned");
+      _name_len > 0 ? fill_span<char>(_buffer, _name_len + 1).data() : nullptr;
 }
 
 void Animation::Deallocate() {
-  memory::default_allocator()->Deallocate(
-      as_writable_bytes(translations_).data());
+  memory::default_allocator()->Deallocate(allocation_);
+  allocation_ = nullptr;
 
   name_ = nullptr;
   translations_ = {};
   rotations_ = {};
   scales_ = {};
+  num_seek_segments_ = 0;
+  translations_seek_ = {};
+  rotations_seek_ = {};
+  scales_seek_ = {};
+}
+
+void Animation::BuildSeekIndex() {
+  if (num_seek_segments_ == 0) {
+    return;
+  }
+  FillSeekIndex<Float3Key>(*this, translations_, translations_seek_);
+  FillSeekIndex<QuaternionKey>(*this, rotations_, rotations_seek_);
+  FillSeekIndex<Float3Key>(*this, scales_, scales_seek_);
 }
 
 size_t Animation::size() const {
-  const size_t size = sizeof(*this) + translations_.size_bytes() +
-                      rotations_.size_bytes() + scales_.size_bytes();
+  const size_t size =
+      sizeof(*this) + translations_.size_bytes() + rotations_.size_bytes() +
+      scales_.size_bytes() + translations_seek_.size_bytes() +
+      rotations_seek_.size_bytes() + scales_seek_.size_bytes();
   return size;
 }
 
@@ -114,11 +311,7 @@ void Animation::Save(ozz::io::OArchive& _archive) const {
 
   _archive << ozz::io::MakeArray(name_, name_len);
 
-  for (const Float3Key& key : translations_) {
-    _archive << key.ratio;
-    _archive << key.track;
-    _archive << ozz::io::MakeArray(key.value);
-  }
+  SaveFloat3Keys(_archive, translations_);
 
   for (const QuaternionKey& key : rotations_) {
     _archive << key.ratio;
@@ -131,11 +324,7 @@ void Animation::Save(ozz::io::OArchive& _archive) const {
     _archive << ozz::io::MakeArray(key.value);
   }
 
-  for (const Float3Key& key : scales_) {
-    _archive << key.ratio;
-    _archive << key.track;
-    _archive << ozz::io::MakeArray(key.value);
-  }
+  SaveFloat3Keys(_archive, scales_);
 }
 
 void Animation::Load(ozz::io::IArchive& _archive, uint32_t _version) {
@@ -173,31 +362,96 @@ void Animation::Load(ozz::io::IArchive& _archive, uint32_t _version) {
     name_[name_len] = 0;
   }
 
-  for (Float3Key& key : translations_) {
-    _archive >> key.ratio;
-    _archive >> key.track;
-    _archive >> ozz::io::MakeArray(key.value);
+  LoadFloat3Keys(_archive, translations_);
+
+  LoadQuaternionKeys(_archive, rotations_);
+
+  LoadFloat3Keys(_archive, scales_);
+
+  // Seeking index isn't serialized, as it can be rebuilt from keys.
+  BuildSeekIndex();
+}
+
+size_t Animation::view_size() const {
+  const size_t name_len = name_ ? std::strlen(name_) : 0;
+  return internal::ViewDataOffset<AnimationViewHeader>() +
+         ComputeBufferSize(num_tracks_, name_len, translations_.size(),
+                           rotations_.size(), scales_.size());
+}
+
+bool Animation::SaveView(span<char> _view) const {
+  const size_t size = view_size();
+  if (!IsAligned(_view.data(), internal::kViewAlignment) ||
+      _view.size() < size) {
+    return false;
   }
 
-  for (QuaternionKey& key : rotations_) {
-    _archive >> key.ratio;
-    uint16_t track;
-    _archive >> track;
-    key.track = track;
-    uint8_t largest;
-    _archive >> largest;
-    key.largest = largest & 3;
-    bool sign;
-    _archive >> sign;
-    key.sign = sign & 1;
-    _archive >> ozz::io::MakeArray(key.value);
+  // Header, padding included.
+  const size_t offset = internal::ViewDataOffset<AnimationViewHeader>();
+  std::memset(_view.data(), 0, offset);
+  AnimationViewHeader* header =
+      reinterpret_cast<AnimationViewHeader*>(_view.data());
+  internal::InitViewHeader<Animation>(size, &header->base);
+  const size_t name_len = name_ ? std::strlen(name_) : 0;
+  header->duration = duration_;
+  header->num_tracks = num_tracks_;
+  header->name_len = static_cast<int32_t>(name_len);
+  header->translation_count = static_cast<int32_t>(translations_.size());
+  header->rotation_count = static_cast<int32_t>(rotations_.size());
+  header->scale_count = static_cast<int32_t>(scales_.size());
+
+  // Buffers, in the same order as Bind().
+  span<char> buffer = {_view.data() + offset, size - offset};
+  internal::CopyToView<Float3Key>(translations_, buffer);
+  internal::CopyToView<QuaternionKey>(rotations_, buffer);
+  internal::CopyToView<Float3Key>(scales_, buffer);
+  internal::CopyToView<int>(translations_seek_, buffer);
+  internal::CopyToView<int>(rotations_seek_, buffer);
+  internal::CopyToView<int>(scales_seek_, buffer);
+  if (name_len > 0) {
+    internal::CopyToView<char>({name_, name_len + 1}, buffer);
   }
+  assert(buffer.empty() && "Whole buffer should be consumned");
 
-  for (Float3Key& key : scales_) {
-    _archive >> key.ratio;
-    _archive >> key.track;
-    _archive >> ozz::io::MakeArray(key.value);
+  return true;
+}
+
+bool Animation::LoadView(span<const char> _view) {
+  // Destroy animation in case it was already used before.
+  Deallocate();
+  duration_ = 0.f;
+  num_tracks_ = 0;
+
+  const AnimationViewHeader* header =
+      internal::ValidateViewHeader<Animation, AnimationViewHeader>(_view);
+  if (!header || header->num_tracks < 0 || header->name_len < 0 ||
+      header->translation_count < 0 || header->rotation_count < 0 ||
+      header->scale_count < 0) {
+    log::Err() << "Invalid Animation view." << std::endl;
+    return false;
+  }
+
+  const size_t offset = internal::ViewDataOffset<AnimationViewHeader>();
+  const size_t buffer_size = ComputeBufferSize(
+      header->num_tracks, header->name_len, header->translation_count,
+      header->rotation_count, header->scale_count);
+  // Name is the last buffer, it must be null terminated.
+  if (header->base.size != offset + buffer_size ||
+      (header->name_len > 0 && _view[offset + buffer_size - 1] != 0)) {
+    log::Err() << "Invalid Animation view size." << std::endl;
+    return false;
   }
+
+  // Runtime animation buffers are never written once loaded, so view memory
+  // can be bound, even if it's read-only.
+  span<char> buffer = {const_cast<char*>(_view.data()) + offset, buffer_size};
+  duration_ = header->duration;
+  num_tracks_ = header->num_tracks;
+  Bind(buffer, header->name_len, header->translation_count,
+       header->rotation_count, header->scale_count);
+  assert(buffer.empty() && "Whole buffer should be consumned");
+
+  return true;
 }
 }  // namespace animation
 }  // namespace ozz
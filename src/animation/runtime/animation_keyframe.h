@@ -75,6 +75,17 @@ struct QuaternionKey {
   int16_t value[3];      // The quantized value of the 3 smallest components.
 };
 
+// Defines the float curve key frame type, used by FloatCurves.
+// Value is stored with full precision, as float curves are user channels which
+// range isn't known. step is 1 if the value is held constant up to the next key
+// of the same curve, 0 if it's linearly interpolated.
+struct FloatCurveKey {
+  float ratio;
+  uint16_t track;
+  uint16_t step;
+  float value;
+};
+
 }  // namespace animation
 }  // namespace ozz
 #endif  // OZZ_ANIMATION_RUNTIME_ANIMATION_KEYFRAME_H_
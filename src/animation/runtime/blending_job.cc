@@ -34,6 +34,10 @@
 #include "ozz/base/maths/math_ex.h"
 #include "ozz/base/maths/soa_transform.h"
 
+// Internal include file
+#define OZZ_INCLUDE_PRIVATE_HEADER  // Allows to include private headers.
+#include "animation/runtime/blending_job_passes.h"
+
 namespace ozz {
 namespace animation {
 
@@ -92,70 +96,6 @@ bool BlendingJob::Validate() const {
 
 namespace {
 
-// Macro that defines the process of blending the 1st pass.
-#define OZZ_BLEND_1ST_PASS(_in, _simd_weight, _out)     \
-  do {                                                  \
-    _out->translation = _in.translation * _simd_weight; \
-    _out->rotation = _in.rotation * _simd_weight;       \
-    _out->scale = _in.scale * _simd_weight;             \
-  } while (void(0), 0)
-
-// Macro that defines the process of blending any pass but the first.
-#define OZZ_BLEND_N_PASS(_in, _simd_weight, _out)                              \
-  do {                                                                         \
-    /* Blends translation. */                                                  \
-    _out->translation = _out->translation + _in.translation * _simd_weight;    \
-    /* Blends rotations, negates opposed quaternions to be sure to choose*/    \
-    /* the shortest path between the two.*/                                    \
-    const math::SimdInt4 sign = math::Sign(Dot(_out->rotation, _in.rotation)); \
-    const math::SoaQuaternion rotation = {                                     \
-        math::Xor(_in.rotation.x, sign), math::Xor(_in.rotation.y, sign),      \
-        math::Xor(_in.rotation.z, sign), math::Xor(_in.rotation.w, sign)};     \
-    _out->rotation = _out->rotation + rotation * _simd_weight;                 \
-    /* Blends scales.*/                                                        \
-    _out->scale = _out->scale + _in.scale * _simd_weight;                      \
-  } while (void(0), 0)
-
-// Macro that defines the process of adding a pass.
-#define OZZ_ADD_PASS(_in, _simd_weight, _out)                                \
-  do {                                                                       \
-    _out.translation = _out.translation + _in.translation * _simd_weight;    \
-    /* Interpolate quaternion between identity and src.rotation.*/           \
-    /* Quaternion sign is fixed up, so that lerp takes the shortest path.*/  \
-    const math::SimdInt4 sign = math::Sign(_in.rotation.w);                  \
-    const math::SoaQuaternion rotation = {                                   \
-        math::Xor(_in.rotation.x, sign), math::Xor(_in.rotation.y, sign),    \
-        math::Xor(_in.rotation.z, sign), math::Xor(_in.rotation.w, sign)};   \
-    const math::SoaQuaternion interp_quat = {                                \
-        rotation.x * _simd_weight, rotation.y * _simd_weight,                \
-        rotation.z * _simd_weight, (rotation.w - one) * _simd_weight + one}; \
-    _out.rotation = NormalizeEst(interp_quat) * _out.rotation;               \
-    _out.scale =                                                             \
-        _out.scale * (one_minus_weight_f3 + (_in.scale * _simd_weight));     \
-  } while (void(0), 0)
-
-// Macro that defines the process of subtracting a pass.
-#define OZZ_SUB_PASS(_in, _simd_weight, _out)                                  \
-  do {                                                                         \
-    _out.translation = _out.translation - _in.translation * _simd_weight;      \
-    /* Interpolate quaternion between identity and src.rotation.*/             \
-    /* Quaternion sign is fixed up, so that lerp takes the shortest path.*/    \
-    const math::SimdInt4 sign = math::Sign(_in.rotation.w);                    \
-    const math::SoaQuaternion rotation = {                                     \
-        math::Xor(_in.rotation.x, sign), math::Xor(_in.rotation.y, sign),      \
-        math::Xor(_in.rotation.z, sign), math::Xor(_in.rotation.w, sign)};     \
-    const math::SoaQuaternion interp_quat = {                                  \
-        rotation.x * _simd_weight, rotation.y * _simd_weight,                  \
-        rotation.z * _simd_weight, (rotation.w - one) * _simd_weight + one};   \
-    _out.rotation = Conjugate(NormalizeEst(interp_quat)) * _out.rotation;      \
-    const math::SoaFloat3 rcp_scale = {                                        \
-        math::RcpEst(math::MAdd(_in.scale.x, _simd_weight, one_minus_weight)), \
-        math::RcpEst(math::MAdd(_in.scale.y, _simd_weight, one_minus_weight)), \
-        math::RcpEst(                                                          \
-            math::MAdd(_in.scale.z, _simd_weight, one_minus_weight))};         \
-    _out.scale = _out.scale * rcp_scale;                                       \
-  } while (void(0), 0)
-
 // Defines parameters that are passed through blending stages.
 struct ProcessArgs {
   ProcessArgs(const BlendingJob& _job)
@@ -339,20 +279,14 @@ void Normalize(ProcessArgs* _args) {
     const math::SimdFloat4 ratio =
         math::simd_float4::Load1(1.f / _args->accumulated_weight);
     for (size_t i = 0; i < _args->num_soa_joints; ++i) {
-      math::SoaTransform& dest = _args->job.output[i];
-      dest.rotation = NormalizeEst(dest.rotation);
-      dest.translation = dest.translation * ratio;
-      dest.scale = dest.scale * ratio;
+      OZZ_NORMALIZE_PASS(ratio, (&_args->job.output[i]));
     }
   } else {
     // Partial blending normalization requires to compute the divider per-joint.
     const math::SimdFloat4 one = math::simd_float4::one();
     for (size_t i = 0; i < _args->num_soa_joints; ++i) {
       const math::SimdFloat4 ratio = one / _args->accumulated_weights[i];
-      math::SoaTransform& dest = _args->job.output[i];
-      dest.rotation = NormalizeEst(dest.rotation);
-      dest.translation = dest.translation * ratio;
-      dest.scale = dest.scale * ratio;
+      OZZ_NORMALIZE_PASS(ratio, (&_args->job.output[i]));
     }
   }
 }
@@ -0,0 +1,286 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#ifndef OZZ_ANIMATION_RUNTIME_BLENDING_JOB_PASSES_H_
+#define OZZ_ANIMATION_RUNTIME_BLENDING_JOB_PASSES_H_
+
+#ifndef OZZ_INCLUDE_PRIVATE_HEADER
+#error "This header is private, it cannot be included from public headers."
+#endif  // OZZ_INCLUDE_PRIVATE_HEADER
+
+#include "ozz/base/maths/simd_math8.h"
+#include "ozz/base/maths/soa_transform.h"
+
+// Defines blending passes shared by BlendingJob and SamplingBlendingJob, so
+// that both jobs output the exact same result.
+
+#if defined(OZZ_SIMD_AVX2)
+
+// With AVX2, soa transforms are still blended one by one, but adjacent
+// SimdFloat4 members (x and y of a SoaFloat3, xy and zw of a SoaQuaternion)
+// are processed by a single 8-wide operation. This halves the number of
+// loads, stores and arithmetic instructions, which bound blending passes.
+namespace ozz {
+namespace animation {
+namespace internal {
+
+// Loads two adjacent SimdFloat4, starting from _v.
+OZZ_INLINE math::SimdFloat8 Load2(const math::SimdFloat4& _v) {
+  return math::simd_float8::LoadPtrU(reinterpret_cast<const float*>(&_v));
+}
+
+// Stores _v to two adjacent SimdFloat4, starting from _v.
+OZZ_INLINE void Store2(math::_SimdFloat8 _v, math::SimdFloat4* _out) {
+  math::StorePtrU(_v, reinterpret_cast<float*>(_out));
+}
+
+OZZ_INLINE void Blend1stPass(const math::SoaTransform& _in,
+                             math::_SimdFloat4 _weight,
+                             math::SoaTransform* _out) {
+  const math::SimdFloat8 weight = math::simd_float8::Load(_weight, _weight);
+  Store2(Load2(_in.translation.x) * weight, &_out->translation.x);
+  _out->translation.z = _in.translation.z * _weight;
+  Store2(Load2(_in.rotation.x) * weight, &_out->rotation.x);
+  Store2(Load2(_in.rotation.z) * weight, &_out->rotation.z);
+  Store2(Load2(_in.scale.x) * weight, &_out->scale.x);
+  _out->scale.z = _in.scale.z * _weight;
+}
+
+OZZ_INLINE void BlendNPass(const math::SoaTransform& _in,
+                           math::_SimdFloat4 _weight,
+                           math::SoaTransform* _out) {
+  const math::SimdFloat8 weight = math::simd_float8::Load(_weight, _weight);
+
+  // Blends translation.
+  Store2(math::MAdd(Load2(_in.translation.x), weight,
+                    Load2(_out->translation.x)),
+         &_out->translation.x);
+  _out->translation.z = math::MAdd(_in.translation.z, _weight,
+                                   _out->translation.z);
+
+  // Blends rotations, negates opposed quaternions to be sure to choose the
+  // shortest path between the two.
+  const math::SimdFloat8 in_xy = Load2(_in.rotation.x);
+  const math::SimdFloat8 in_zw = Load2(_in.rotation.z);
+  const math::SimdFloat8 out_xy = Load2(_out->rotation.x);
+  const math::SimdFloat8 out_zw = Load2(_out->rotation.z);
+  const math::SimdFloat8 dot2 = math::MAdd(in_zw, out_zw, in_xy * out_xy);
+  const math::SimdInt4 sign4 =
+      math::Sign(math::GetLo(dot2) + math::GetHi(dot2));
+  const math::SimdInt8 sign = math::simd_int8::Load(sign4, sign4);
+  Store2(math::MAdd(math::Xor(in_xy, sign), weight, out_xy),
+         &_out->rotation.x);
+  Store2(math::MAdd(math::Xor(in_zw, sign), weight, out_zw),
+         &_out->rotation.z);
+
+  // Blends scales.
+  Store2(math::MAdd(Load2(_in.scale.x), weight, Load2(_out->scale.x)),
+         &_out->scale.x);
+  _out->scale.z = math::MAdd(_in.scale.z, _weight, _out->scale.z);
+}
+
+// Interpolates quaternion between identity and _q. Quaternion sign is fixed
+// up, so that lerp takes the shortest path.
+OZZ_INLINE math::SoaQuaternion AdditiveRotation(const math::SoaQuaternion& _q,
+                                                math::_SimdFloat4 _weight,
+                                                math::_SimdFloat4 _one) {
+  const math::SimdInt4 sign = math::Sign(_q.w);
+  const math::SoaQuaternion rotation = {
+      math::Xor(_q.x, sign), math::Xor(_q.y, sign), math::Xor(_q.z, sign),
+      math::Xor(_q.w, sign)};
+  const math::SoaQuaternion interp_quat = {
+      rotation.x * _weight, rotation.y * _weight, rotation.z * _weight,
+      (rotation.w - _one) * _weight + _one};
+  return NormalizeEst(interp_quat);
+}
+
+OZZ_INLINE void AddPass(const math::SoaTransform& _in,
+                        math::_SimdFloat4 _weight, math::_SimdFloat4 _one,
+                        math::_SimdFloat4 _one_minus_weight,
+                        math::SoaTransform* _out) {
+  const math::SimdFloat8 weight = math::simd_float8::Load(_weight, _weight);
+  const math::SimdFloat8 one_minus_weight =
+      math::simd_float8::Load(_one_minus_weight, _one_minus_weight);
+  Store2(math::MAdd(Load2(_in.translation.x), weight,
+                    Load2(_out->translation.x)),
+         &_out->translation.x);
+  _out->translation.z = math::MAdd(_in.translation.z, _weight,
+                                   _out->translation.z);
+  _out->rotation =
+      AdditiveRotation(_in.rotation, _weight, _one) * _out->rotation;
+  Store2(Load2(_out->scale.x) *
+             math::MAdd(Load2(_in.scale.x), weight, one_minus_weight),
+         &_out->scale.x);
+  _out->scale.z =
+      _out->scale.z * math::MAdd(_in.scale.z, _weight, _one_minus_weight);
+}
+
+OZZ_INLINE void SubPass(const math::SoaTransform& _in,
+                        math::_SimdFloat4 _weight, math::_SimdFloat4 _one,
+                        math::_SimdFloat4 _one_minus_weight,
+                        math::SoaTransform* _out) {
+  const math::SimdFloat8 weight = math::simd_float8::Load(_weight, _weight);
+  const math::SimdFloat8 one_minus_weight =
+      math::simd_float8::Load(_one_minus_weight, _one_minus_weight);
+  Store2(Load2(_out->translation.x) - Load2(_in.translation.x) * weight,
+         &_out->translation.x);
+  _out->translation.z = _out->translation.z - _in.translation.z * _weight;
+  _out->rotation =
+      Conjugate(AdditiveRotation(_in.rotation, _weight, _one)) *
+      _out->rotation;
+  Store2(Load2(_out->scale.x) *
+             math::RcpEst(
+                 math::MAdd(Load2(_in.scale.x), weight, one_minus_weight)),
+         &_out->scale.x);
+  _out->scale.z =
+      _out->scale.z *
+      math::RcpEst(math::MAdd(_in.scale.z, _weight, _one_minus_weight));
+}
+
+OZZ_INLINE void NormalizePass(math::_SimdFloat4 _ratio,
+                              math::SoaTransform* _out) {
+  const math::SimdFloat8 ratio = math::simd_float8::Load(_ratio, _ratio);
+
+  // Uses RSqrtEstNR like SoaQuaternion NormalizeEst.
+  const math::SimdFloat8 xy = Load2(_out->rotation.x);
+  const math::SimdFloat8 zw = Load2(_out->rotation.z);
+  const math::SimdFloat8 len2 = math::MAdd(zw, zw, xy * xy);
+  const math::SimdFloat4 inv_len4 =
+      math::RSqrtEstNR(math::GetLo(len2) + math::GetHi(len2));
+  const math::SimdFloat8 inv_len = math::simd_float8::Load(inv_len4, inv_len4);
+  Store2(xy * inv_len, &_out->rotation.x);
+  Store2(zw * inv_len, &_out->rotation.z);
+
+  Store2(Load2(_out->translation.x) * ratio, &_out->translation.x);
+  _out->translation.z = _out->translation.z * _ratio;
+  Store2(Load2(_out->scale.x) * ratio, &_out->scale.x);
+  _out->scale.z = _out->scale.z * _ratio;
+}
+}  // namespace internal
+}  // namespace animation
+}  // namespace ozz
+
+// Macro that defines the process of blending the 1st pass.
+#define OZZ_BLEND_1ST_PASS(_in, _simd_weight, _out) \
+  ozz::animation::internal::Blend1stPass(_in, _simd_weight, _out)
+
+// Macro that defines the process of blending any pass but the first.
+#define OZZ_BLEND_N_PASS(_in, _simd_weight, _out) \
+  ozz::animation::internal::BlendNPass(_in, _simd_weight, _out)
+
+// Macro that defines the process of adding a pass.
+#define OZZ_ADD_PASS(_in, _simd_weight, _out)                 \
+  ozz::animation::internal::AddPass(_in, _simd_weight, one, \
+                                    one_minus_weight_f3.x, &_out)
+
+// Macro that defines the process of subtracting a pass.
+#define OZZ_SUB_PASS(_in, _simd_weight, _out)                 \
+  ozz::animation::internal::SubPass(_in, _simd_weight, one, \
+                                    one_minus_weight, &_out)
+
+// Macro that defines the normalization of a blended output, where _ratio is
+// the inverse of the accumulated weight.
+#define OZZ_NORMALIZE_PASS(_ratio, _out) \
+  ozz::animation::internal::NormalizePass(_ratio, _out)
+
+#else  // OZZ_SIMD_AVX2
+
+// Macro that defines the process of blending the 1st pass.
+#define OZZ_BLEND_1ST_PASS(_in, _simd_weight, _out)     \
+  do {                                                  \
+    _out->translation = _in.translation * _simd_weight; \
+    _out->rotation = _in.rotation * _simd_weight;       \
+    _out->scale = _in.scale * _simd_weight;             \
+  } while (void(0), 0)
+
+// Macro that defines the process of blending any pass but the first.
+#define OZZ_BLEND_N_PASS(_in, _simd_weight, _out)                              \
+  do {                                                                         \
+    /* Blends translation. */                                                  \
+    _out->translation = _out->translation + _in.translation * _simd_weight;    \
+    /* Blends rotations, negates opposed quaternions to be sure to choose*/    \
+    /* the shortest path between the two.*/                                    \
+    const math::SimdInt4 sign = math::Sign(Dot(_out->rotation, _in.rotation)); \
+    const math::SoaQuaternion rotation = {                                     \
+        math::Xor(_in.rotation.x, sign), math::Xor(_in.rotation.y, sign),      \
+        math::Xor(_in.rotation.z, sign), math::Xor(_in.rotation.w, sign)};     \
+    _out->rotation = _out->rotation + rotation * _simd_weight;                 \
+    /* Blends scales.*/                                                        \
+    _out->scale = _out->scale + _in.scale * _simd_weight;                      \
+  } while (void(0), 0)
+
+// Macro that defines the process of adding a pass.
+#define OZZ_ADD_PASS(_in, _simd_weight, _out)                                \
+  do {                                                                       \
+    _out.translation = _out.translation + _in.translation * _simd_weight;    \
+    /* Interpolate quaternion between identity and src.rotation.*/           \
+    /* Quaternion sign is fixed up, so that lerp takes the shortest path.*/  \
+    const math::SimdInt4 sign = math::Sign(_in.rotation.w);                  \
+    const math::SoaQuaternion rotation = {                                   \
+        math::Xor(_in.rotation.x, sign), math::Xor(_in.rotation.y, sign),    \
+        math::Xor(_in.rotation.z, sign), math::Xor(_in.rotation.w, sign)};   \
+    const math::SoaQuaternion interp_quat = {                                \
+        rotation.x * _simd_weight, rotation.y * _simd_weight,                \
+        rotation.z * _simd_weight, (rotation.w - one) * _simd_weight + one}; \
+    _out.rotation = NormalizeEst(interp_quat) * _out.rotation;               \
+    _out.scale =                                                             \
+        _out.scale * (one_minus_weight_f3 + (_in.scale * _simd_weight));     \
+  } while (void(0), 0)
+
+// Macro that defines the process of subtracting a pass.
+#define OZZ_SUB_PASS(_in, _simd_weight, _out)                                  \
+  do {                                                                         \
+    _out.translation = _out.translation - _in.translation * _simd_weight;      \
+    /* Interpolate quaternion between identity and src.rotation.*/             \
+    /* Quaternion sign is fixed up, so that lerp takes the shortest path.*/    \
+    const math::SimdInt4 sign = math::Sign(_in.rotation.w);                    \
+    const math::SoaQuaternion rotation = {                                     \
+        math::Xor(_in.rotation.x, sign), math::Xor(_in.rotation.y, sign),      \
+        math::Xor(_in.rotation.z, sign), math::Xor(_in.rotation.w, sign)};     \
+    const math::SoaQuaternion interp_quat = {                                  \
+        rotation.x * _simd_weight, rotation.y * _simd_weight,                  \
+        rotation.z * _simd_weight, (rotation.w - one) * _simd_weight + one};   \
+    _out.rotation = Conjugate(NormalizeEst(interp_quat)) * _out.rotation;      \
+    const math::SoaFloat3 rcp_scale = {                                        \
+        math::RcpEst(math::MAdd(_in.scale.x, _simd_weight, one_minus_weight)), \
+        math::RcpEst(math::MAdd(_in.scale.y, _simd_weight, one_minus_weight)), \
+        math::RcpEst(                                                          \
+            math::MAdd(_in.scale.z, _simd_weight, one_minus_weight))};         \
+    _out.scale = _out.scale * rcp_scale;                                       \
+  } while (void(0), 0)
+
+// Macro that defines the normalization of a blended output, where _ratio is
+// the inverse of the accumulated weight.
+#define OZZ_NORMALIZE_PASS(_ratio, _out)            \
+  do {                                              \
+    _out->rotation = NormalizeEst(_out->rotation);  \
+    _out->translation = _out->translation * _ratio; \
+    _out->scale = _out->scale * _ratio;             \
+  } while (void(0), 0)
+#endif  // OZZ_SIMD_AVX2
+
+#endif  // OZZ_ANIMATION_RUNTIME_BLENDING_JOB_PASSES_H_
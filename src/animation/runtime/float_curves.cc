@@ -0,0 +1,157 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+
+#include "ozz/animation/runtime/float_curves.h"
+
+#include <cassert>
+#include <cstring>
+
+#include "ozz/base/io/archive.h"
+#include "ozz/base/log.h"
+#include "ozz/base/memory/allocator.h"
+
+// Internal include file
+#define OZZ_INCLUDE_PRIVATE_HEADER  // Allows to include private headers.
+#include "animation/runtime/animation_keyframe.h"
+
+namespace ozz {
+namespace animation {
+
+namespace {
+// FloatCurveKey memory layout matches its archive format (ratio, track, step,
+// value), so keys are read and written in bulk. Endianness is fixed in place
+// when needed.
+static_assert(sizeof(FloatCurveKey) == sizeof(float) + sizeof(uint16_t) * 2 +
+                                           sizeof(float),
+              "FloatCurveKey must not be padded");
+}  // namespace
+
+FloatCurves::FloatCurves()
+    : num_curves_(0), name_(nullptr), allocation_(nullptr) {}
+
+FloatCurves::~FloatCurves() { Deallocate(); }
+
+void FloatCurves::Allocate(size_t _name_len, size_t _key_count) {
+  // Distributes buffer memory while ensuring proper alignment (serves larger
+  // alignment values first).
+  static_assert(alignof(FloatCurveKey) >= alignof(char),
+                "Must serve larger alignment values first)");
+
+  assert(allocation_ == nullptr && name_ == nullptr && keys_.size() == 0);
+
+  // Compute overall size and allocate a single buffer for all the data.
+  const size_t buffer_size = (_name_len > 0 ? _name_len + 1 : 0) +
+                             _key_count * sizeof(FloatCurveKey);
+  allocation_ = memory::default_allocator()->Allocate(buffer_size,
+                                                     alignof(FloatCurveKey));
+  span<char> buffer = {static_cast<char*>(allocation_), buffer_size};
+
+  // Fix up pointers. Serves larger alignment values first.
+  keys_ = fill_span<FloatCurveKey>(buffer, _key_count);
+
+  // Let name be nullptr if curves have no name. Allows to avoid allocating
+  // this buffer in the constructor of empty curves.
+  name_ =
+      _name_len > 0 ? fill_span<char>(buffer, _name_len + 1).data() : nullptr;
+
+  assert(buffer.empty() && "Whole buffer should be consumned");
+}
+
+void FloatCurves::Deallocate() {
+  // Deallocate everything at once.
+  memory::default_allocator()->Deallocate(allocation_);
+  allocation_ = nullptr;
+
+  name_ = nullptr;
+  keys_ = {};
+}
+
+size_t FloatCurves::size() const { return sizeof(*this) + keys_.size_bytes(); }
+
+void FloatCurves::Save(ozz::io::OArchive& _archive) const {
+  _archive << static_cast<int32_t>(num_curves_);
+
+  const size_t name_len = name_ ? std::strlen(name_) : 0;
+  _archive << static_cast<int32_t>(name_len);
+
+  const ptrdiff_t key_count = keys_.size();
+  _archive << static_cast<int32_t>(key_count);
+
+  _archive << ozz::io::MakeArray(name_, name_len);
+
+  if (!_archive.endian_swap()) {
+    _archive.SaveBinary(keys_.data(), keys_.size_bytes());
+    return;
+  }
+  for (const FloatCurveKey& key : keys_) {
+    _archive << key.ratio;
+    _archive << key.track;
+    _archive << key.step;
+    _archive << key.value;
+  }
+}
+
+void FloatCurves::Load(ozz::io::IArchive& _archive, uint32_t _version) {
+  // Destroy curves in case they were already used before.
+  Deallocate();
+  num_curves_ = 0;
+
+  if (_version != 1) {
+    log::Err() << "Unsupported FloatCurves version " << _version << "."
+               << std::endl;
+    return;
+  }
+
+  int32_t num_curves;
+  _archive >> num_curves;
+  num_curves_ = num_curves;
+
+  int32_t name_len;
+  _archive >> name_len;
+  int32_t key_count;
+  _archive >> key_count;
+
+  Allocate(name_len, key_count);
+
+  if (name_) {  // nullptr name_ is supported.
+    _archive >> ozz::io::MakeArray(name_, name_len);
+    name_[name_len] = 0;
+  }
+
+  _archive.LoadBinary(keys_.data(), keys_.size_bytes());
+  if (_archive.endian_swap()) {
+    for (FloatCurveKey& key : keys_) {
+      key.ratio = EndianSwap(key.ratio);
+      key.track = EndianSwap(key.track);
+      key.step = EndianSwap(key.step);
+      key.value = EndianSwap(key.value);
+    }
+  }
+}
+}  // namespace animation
+}  // namespace ozz
@@ -0,0 +1,315 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+
+#include "ozz/animation/runtime/float_curves_sampling_job.h"
+
+#include <cassert>
+
+#include "ozz/animation/runtime/float_curves.h"
+#include "ozz/base/maths/math_ex.h"
+#include "ozz/base/maths/simd_math.h"
+#include "ozz/base/memory/allocator.h"
+
+// Internal include file
+#define OZZ_INCLUDE_PRIVATE_HEADER  // Allows to include private headers.
+#include "animation/runtime/animation_keyframe.h"
+
+namespace ozz {
+namespace animation {
+
+namespace internal {
+struct InterpSoaFloatCurve {
+  math::SimdFloat4 ratio[2];
+  math::SimdFloat4 value[2];
+  math::SimdInt4 step;  // Mask of the curves that are stepped.
+};
+}  // namespace internal
+
+FloatCurvesSamplingJob::FloatCurvesSamplingJob()
+    : ratio(0.f), curves(nullptr), cache(nullptr) {}
+
+bool FloatCurvesSamplingJob::Validate() const {
+  // Test for nullptr pointers.
+  if (!curves || !cache) {
+    return false;
+  }
+  bool valid = true;
+
+  // Tests cache and output sizes.
+  valid &= cache->max_soa_curves() >= curves->num_soa_curves();
+  valid &= output.size() >= static_cast<size_t>(curves->num_curves());
+
+  return valid;
+}
+
+namespace {
+// Flags all soa entries as outdated. It cares to only flag valid soa entries as
+// this is the exit condition of other algorithms.
+void OutdateAllCurves(int _num_soa_curves, uint8_t* _outdated) {
+  const int num_outdated_flags = (_num_soa_curves + 7) / 8;
+  for (int i = 0; i < num_outdated_flags - 1; ++i) {
+    _outdated[i] = 0xff;
+  }
+  _outdated[num_outdated_flags - 1] =
+      0xff >> (num_outdated_flags * 8 - _num_soa_curves);
+}
+
+// Loops through the sorted keys and updates cache keys, the same way as
+// SamplingJob does for joint tracks. Keys are sorted by the ratio of the
+// previous key of the same curve, so the loop ends as soon as it finds a key
+// that isn't needed yet to interpolate at _ratio.
+void UpdateCurvesCursor(float _ratio, int _num_soa_curves,
+                        const span<const FloatCurveKey>& _keys, int* _cursor,
+                        int* _cache, uint8_t* _outdated) {
+  assert(_num_soa_curves >= 1);
+  const int num_curves = _num_soa_curves * 4;
+  assert(_keys.begin() + num_curves * 2 <= _keys.end());
+
+  const FloatCurveKey* cursor = nullptr;
+  if (!*_cursor) {
+    // Initializes interpolated entries with the first 2 sets of keys. The
+    // sorting algorithm ensures that the first 2 keys of all curves are the
+    // first 2 rows of the keys buffer.
+    for (int i = 0; i < num_curves; ++i) {
+      _cache[i * 2 + 0] = i;
+      _cache[i * 2 + 1] = i + num_curves;
+    }
+    cursor = _keys.begin() + num_curves * 2;  // New cursor position.
+
+    // All entries are outdated.
+    OutdateAllCurves(_num_soa_curves, _outdated);
+  } else {
+    cursor = _keys.begin() + *_cursor;  // Might be == end()
+    assert(cursor >= _keys.begin() + num_curves * 2 && cursor <= _keys.end());
+  }
+
+  while (cursor < _keys.end() &&
+         _keys[_cache[cursor->track * 2 + 1]].ratio <= _ratio) {
+    // Flag this soa entry as outdated.
+    _outdated[cursor->track / 32] |= (1 << ((cursor->track & 0x1f) / 4));
+    // Updates cache.
+    const int base = cursor->track * 2;
+    _cache[base] = _cache[base + 1];
+    _cache[base + 1] = static_cast<int>(cursor - _keys.begin());
+    // Process next key.
+    ++cursor;
+  }
+  assert(cursor <= _keys.end());
+
+  // Updates cursor output.
+  *_cursor = static_cast<int>(cursor - _keys.begin());
+}
+
+// Loads outdated soa entries from keys.
+void UpdateInterpCurves(int _num_soa_curves,
+                        const span<const FloatCurveKey>& _keys,
+                        const int* _interp, uint8_t* _outdated,
+                        internal::InterpSoaFloatCurve* _interp_keys) {
+  const int num_outdated_flags = (_num_soa_curves + 7) / 8;
+  for (int j = 0; j < num_outdated_flags; ++j) {
+    uint8_t outdated = _outdated[j];
+    _outdated[j] = 0;  // Reset outdated entries as all will be processed.
+    for (int i = j * 8; outdated; ++i, outdated >>= 1) {
+      if (!(outdated & 1)) {
+        continue;
+      }
+      const int base = i * 4 * 2;  // * soa size * 2 keys
+      internal::InterpSoaFloatCurve& interp = _interp_keys[i];
+
+      // Left side keys, which also define the interpolation mode.
+      const FloatCurveKey& k00 = _keys[_interp[base + 0]];
+      const FloatCurveKey& k10 = _keys[_interp[base + 2]];
+      const FloatCurveKey& k20 = _keys[_interp[base + 4]];
+      const FloatCurveKey& k30 = _keys[_interp[base + 6]];
+      interp.ratio[0] =
+          math::simd_float4::Load(k00.ratio, k10.ratio, k20.ratio, k30.ratio);
+      interp.value[0] =
+          math::simd_float4::Load(k00.value, k10.value, k20.value, k30.value);
+      interp.step =
+          math::CmpNe(math::simd_int4::Load(k00.step, k10.step, k20.step,
+                                            k30.step),
+                      math::simd_int4::zero());
+
+      // Right side keys.
+      const FloatCurveKey& k01 = _keys[_interp[base + 1]];
+      const FloatCurveKey& k11 = _keys[_interp[base + 3]];
+      const FloatCurveKey& k21 = _keys[_interp[base + 5]];
+      const FloatCurveKey& k31 = _keys[_interp[base + 7]];
+      interp.ratio[1] =
+          math::simd_float4::Load(k01.ratio, k11.ratio, k21.ratio, k31.ratio);
+      interp.value[1] =
+          math::simd_float4::Load(k01.value, k11.value, k21.value, k31.value);
+    }
+  }
+}
+
+// Interpolates all curves and stores their values to _output, which contains
+// _num_curves values.
+void InterpolateCurves(float _ratio, int _num_curves,
+                       const internal::InterpSoaFloatCurve* _interp_keys,
+                       float* _output) {
+  const math::SimdFloat4 ratio = math::simd_float4::Load1(_ratio);
+  const math::SimdFloat4 one = math::simd_float4::one();
+  const int num_soa_curves = (_num_curves + 3) / 4;
+  for (int i = 0; i < num_soa_curves; ++i) {
+    const internal::InterpSoaFloatCurve& interp = _interp_keys[i];
+
+    // Linear interpolation uses an exact division, so that results match
+    // TrackSamplingJob. Stepped curves only reach the right key value at the
+    // end of the curve, where _ratio equals right key ratio.
+    const math::SimdFloat4 linear =
+        (ratio - interp.ratio[0]) / (interp.ratio[1] - interp.ratio[0]);
+    const math::SimdFloat4 step =
+        math::And(one, math::CmpGe(ratio, interp.ratio[1]));
+    const math::SimdFloat4 alpha = math::Select(interp.step, step, linear);
+    const math::SimdFloat4 value =
+        math::Lerp(interp.value[0], interp.value[1], alpha);
+
+    // Stores values, the last soa entry might be incomplete.
+    float* output = _output + i * 4;
+    switch (math::Min(_num_curves - i * 4, 4)) {
+      case 4:
+        math::StorePtrU(value, output);
+        break;
+      case 3:
+        math::Store3PtrU(value, output);
+        break;
+      case 2:
+        math::Store2PtrU(value, output);
+        break;
+      default:
+        math::Store1PtrU(value, output);
+        break;
+    }
+  }
+}
+}  // namespace
+
+bool FloatCurvesSamplingJob::Run() const {
+  if (!Validate()) {
+    return false;
+  }
+
+  const int num_soa_curves = curves->num_soa_curves();
+  if (num_soa_curves == 0) {  // Early out if there's no curve.
+    return true;
+  }
+
+  // Clamps ratio in range [0,1].
+  const float clamped_ratio = math::Clamp(0.f, ratio, 1.f);
+
+  // Step the cache to these potentially new curves and ratio, then fetch keys.
+  cache->Step(*curves, clamped_ratio);
+  UpdateCurvesCursor(clamped_ratio, num_soa_curves, curves->keys(),
+                     &cache->cursor_, cache->keys_, cache->outdated_);
+  UpdateInterpCurves(num_soa_curves, curves->keys(), cache->keys_,
+                     cache->outdated_, cache->soa_curves_);
+
+  // Interpolates soa hot data.
+  InterpolateCurves(clamped_ratio, curves->num_curves(), cache->soa_curves_,
+                    output.begin());
+
+  return true;
+}
+
+FloatCurvesSamplingCache::FloatCurvesSamplingCache()
+    : max_soa_curves_(0),
+      soa_curves_(nullptr) {  // soa_curves_ is the allocation pointer.
+  Invalidate();
+}
+
+FloatCurvesSamplingCache::FloatCurvesSamplingCache(int _max_curves)
+    : max_soa_curves_(0),
+      soa_curves_(nullptr) {  // soa_curves_ is the allocation pointer.
+  Resize(_max_curves);
+}
+
+FloatCurvesSamplingCache::~FloatCurvesSamplingCache() {
+  // Deallocates everything at once.
+  memory::default_allocator()->Deallocate(soa_curves_);
+}
+
+void FloatCurvesSamplingCache::Resize(int _max_curves) {
+  using internal::InterpSoaFloatCurve;
+
+  // Reset existing data.
+  Invalidate();
+  memory::default_allocator()->Deallocate(soa_curves_);
+
+  // Updates maximum supported soa curves.
+  max_soa_curves_ = (_max_curves + 3) / 4;
+
+  // Allocate all cache data at once in a single allocation.
+  // Alignment is guaranteed because memory is dispatch from the highest
+  // alignment requirement (Soa data: SimdFloat4) to the lowest (outdated
+  // flag: unsigned char).
+  static_assert(alignof(InterpSoaFloatCurve) >= alignof(int) &&
+                    alignof(int) >= alignof(uint8_t),
+                "Must serve larger alignment values first)");
+
+  // Computes allocation size.
+  const size_t max_curves = max_soa_curves_ * 4;
+  const size_t num_outdated = (max_soa_curves_ + 7) / 8;
+  const size_t size = sizeof(InterpSoaFloatCurve) * max_soa_curves_ +
+                      sizeof(int) * max_curves * 2 +  // 2 keys per curve.
+                      sizeof(uint8_t) * num_outdated;
+
+  // Allocates all at once.
+  char* alloc_begin =
+      reinterpret_cast<char*>(memory::default_allocator()->Allocate(
+          size, alignof(InterpSoaFloatCurve)));
+  char* alloc_cursor = alloc_begin;
+
+  soa_curves_ = reinterpret_cast<InterpSoaFloatCurve*>(alloc_cursor);
+  alloc_cursor += sizeof(InterpSoaFloatCurve) * max_soa_curves_;
+  keys_ = reinterpret_cast<int*>(alloc_cursor);
+  alloc_cursor += sizeof(int) * max_curves * 2;
+  outdated_ = reinterpret_cast<uint8_t*>(alloc_cursor);
+  alloc_cursor += sizeof(uint8_t) * num_outdated;
+
+  assert(alloc_cursor == alloc_begin + size);
+}
+
+void FloatCurvesSamplingCache::Step(const FloatCurves& _curves,
+                                    float _ratio) {
+  // The cache is invalidated if curves have changed or if they are being
+  // rewind.
+  if (curves_ != &_curves || _ratio < ratio_) {
+    curves_ = &_curves;
+    cursor_ = 0;
+  }
+  ratio_ = _ratio;
+}
+
+void FloatCurvesSamplingCache::Invalidate() {
+  curves_ = nullptr;
+  ratio_ = 0.f;
+  cursor_ = 0;
+}
+}  // namespace animation
+}  // namespace ozz
@@ -0,0 +1,253 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+
+#include "ozz/animation/runtime/ik_chain_job.h"
+
+#include <cassert>
+
+#include "ozz/base/maths/simd_quaternion.h"
+
+using namespace ozz::math;
+
+namespace ozz {
+namespace animation {
+IKChainJob::IKChainJob()
+    : target(math::simd_float4::zero()),
+      solver(kFabrik),
+      max_iterations(10),
+      tolerance(1e-3f),
+      weight(1.f),
+      reached(nullptr) {}
+
+bool IKChainJob::Validate() const {
+  bool valid = true;
+  valid &= joints.size() >= 2 && joints.size() <= kMaxJoints;
+  for (size_t i = 0; i < joints.size(); ++i) {
+    valid &= joints[i] >= 0 && static_cast<size_t>(joints[i]) < models.size();
+  }
+  valid &= joint_corrections.size() >= joints.size();
+  valid &= max_iterations >= 0;
+  valid &= tolerance >= 0.f;
+  return valid;
+}
+
+namespace {
+
+// Tests if the end joint, at _end position, is within tolerance distance of
+// the target.
+bool IsChainEndReached(const IKChainJob& _job, _SimdFloat4 _end) {
+  const SimdFloat4 tolerance = simd_float4::Load1(_job.tolerance);
+  return AreAllTrue1(
+      CmpLe(Length3Sqr(_job.target - _end), tolerance * tolerance));
+}
+
+// Moves _position at _length distance from _anchor, along _anchor to
+// _position direction. Stays on _anchor if both are at the same position.
+SimdFloat4 ConstrainBoneLength(_SimdFloat4 _anchor, _SimdFloat4 _position,
+                               _SimdFloat4 _length) {
+  const SimdFloat4 zero = simd_float4::zero();
+  return _anchor + NormalizeSafe3(_position - _anchor, zero) * _length;
+}
+
+// Solves chain _positions with FABRIK, and deduces the model-space rotations
+// applied to each joint. Returns true if target is reached.
+bool SolveChainFabrik(const IKChainJob& _job, int _num_joints,
+                      SimdFloat4* _positions, SimdQuaternion* _rotations) {
+  const int end = _num_joints - 1;
+
+  // Bone lengths, and original positions used to deduce rotations.
+  SimdFloat4 lengths[IKChainJob::kMaxJoints];
+  SimdFloat4 original[IKChainJob::kMaxJoints];
+  SimdFloat4 chain_length = simd_float4::zero();
+  for (int i = 0; i < end; ++i) {
+    lengths[i] = SplatX(Length3(_positions[i + 1] - _positions[i]));
+    chain_length = chain_length + lengths[i];
+    original[i] = _positions[i];
+  }
+  original[end] = _positions[end];
+
+  bool lreached = IsChainEndReached(_job, _positions[end]);
+  if (!lreached && _job.max_iterations > 0) {
+    const SimdFloat4 root = _positions[0];
+    if (AreAllTrue1(CmpGt(Length3(_job.target - root), chain_length))) {
+      // Target is out of reach, the chain is stretched toward it.
+      for (int i = 0; i < end; ++i) {
+        _positions[i + 1] =
+            ConstrainBoneLength(_positions[i], _job.target, lengths[i]);
+      }
+    } else {
+      for (int iteration = 0;
+           iteration < _job.max_iterations && !lreached; ++iteration) {
+        // Forward reaching, from end to root.
+        _positions[end] = _job.target;
+        for (int i = end - 1; i >= 0; --i) {
+          _positions[i] =
+              ConstrainBoneLength(_positions[i + 1], _positions[i], lengths[i]);
+        }
+        // Backward reaching, from root to end.
+        _positions[0] = root;
+        for (int i = 0; i < end; ++i) {
+          _positions[i + 1] =
+              ConstrainBoneLength(_positions[i], _positions[i + 1], lengths[i]);
+        }
+        lreached = IsChainEndReached(_job, _positions[end]);
+      }
+    }
+    lreached = IsChainEndReached(_job, _positions[end]);
+  }
+
+  // Deduces rotations that align each bone, once rotated by its parents, with
+  // its solved direction.
+  SimdQuaternion parent = SimdQuaternion::identity();
+  for (int i = 0; i < end; ++i) {
+    const SimdFloat4 bone =
+        TransformVector(parent, original[i + 1] - original[i]);
+    _rotations[i] = SimdQuaternion::FromVectors(
+                        bone, _positions[i + 1] - _positions[i]) *
+                    parent;
+    parent = _rotations[i];
+  }
+  _rotations[end] = parent;
+
+  return lreached;
+}
+
+// Solves chain _positions with CCD, accumulating the model-space rotations
+// applied to each joint. Returns true if target is reached.
+bool SolveChainCcd(const IKChainJob& _job, int _num_joints,
+                   SimdFloat4* _positions, SimdQuaternion* _rotations) {
+  const int end = _num_joints - 1;
+  for (int i = 0; i <= end; ++i) {
+    _rotations[i] = SimdQuaternion::identity();
+  }
+
+  bool lreached = IsChainEndReached(_job, _positions[end]);
+  for (int iteration = 0; iteration < _job.max_iterations && !lreached;
+       ++iteration) {
+    // Rotates each joint, from end to root, so that the end joint points
+    // toward the target.
+    for (int i = end - 1; i >= 0; --i) {
+      const SimdFloat4 pivot = _positions[i];
+      const SimdQuaternion rotation = SimdQuaternion::FromVectors(
+          _positions[end] - pivot, _job.target - pivot);
+      for (int j = i + 1; j <= end; ++j) {
+        _positions[j] =
+            pivot + TransformVector(rotation, _positions[j] - pivot);
+      }
+      for (int j = i; j <= end; ++j) {
+        _rotations[j] = rotation * _rotations[j];
+      }
+    }
+    lreached = IsChainEndReached(_job, _positions[end]);
+  }
+  return lreached;
+}
+
+// Converts joint _index model-space rotation, relative to its parent one, to a
+// joint local-space correction, weighted by job weight.
+SimdQuaternion ComputeChainCorrection(const IKChainJob& _job, int _index,
+                                      const SimdQuaternion* _rotations) {
+  const SimdFloat4 zero = simd_float4::zero();
+  const SimdQuaternion delta_ms =
+      _index == 0 ? _rotations[0]
+                  : Conjugate(_rotations[_index - 1]) * _rotations[_index];
+
+  // Rotation axis is transformed to joint local-space, keeping its length
+  // (sine of the half angle). If the matrix isn't invertible, it'll be all 0,
+  // which results in an identity correction.
+  SimdInt4 invertible;
+  const Float4x4 inv_joint = Invert(_job.models[_job.joints[_index]],
+                                    &invertible);
+  const SimdFloat4 axis_ls = TransformVector(inv_joint, delta_ms.xyzw);
+  const SimdFloat4 len2s =
+      SetY(Length3Sqr(delta_ms.xyzw), Length3Sqr(axis_ls));
+  SimdQuaternion correction = SimdQuaternion::identity();
+  if (AreAllTrue1(CmpGt(SplatY(len2s), zero))) {
+    const SimdFloat4 scale = SplatX(Sqrt(len2s) * RSqrtEstNR(SplatY(len2s)));
+    correction.xyzw = SetW(axis_ls * scale, SplatW(delta_ms.xyzw));
+  }
+
+  // Fix up quaternion so w is always positive, which is required for NLerp
+  // (with identity quaternion) to lerp the shortest path.
+  const SimdFloat4 correction_fu =
+      Xor(correction.xyzw, And(simd_int4::mask_sign(),
+                               CmpLt(SplatW(correction.xyzw), zero)));
+  if (_job.weight < 1.f) {
+    const SimdFloat4 simd_weight = Max(zero, simd_float4::Load1(_job.weight));
+    const SimdFloat4 lerp =
+        Lerp(simd_float4::w_axis(), correction_fu, simd_weight);
+    correction.xyzw = lerp * SplatX(RSqrtEstNR(Length4Sqr(lerp)));
+  } else {
+    correction.xyzw = correction_fu;
+  }
+  return correction;
+}
+}  // namespace
+
+bool IKChainJob::Run() const {
+  if (!Validate()) {
+    return false;
+  }
+
+  const int num_joints = static_cast<int>(joints.size());
+
+  // Early out if weight is 0.
+  if (weight <= 0.f) {
+    // No correction.
+    for (int i = 0; i < num_joints; ++i) {
+      joint_corrections[i] = SimdQuaternion::identity();
+    }
+    // Target isn't reached.
+    if (reached) {
+      *reached = false;
+    }
+    return true;
+  }
+
+  // Solves chain joints positions and model-space rotations.
+  SimdFloat4 positions[kMaxJoints];
+  SimdQuaternion rotations[kMaxJoints];
+  for (int i = 0; i < num_joints; ++i) {
+    positions[i] = models[joints[i]].cols[3];
+  }
+  const bool lreached =
+      solver == kCcd
+          ? SolveChainCcd(*this, num_joints, positions, rotations)
+          : SolveChainFabrik(*this, num_joints, positions, rotations);
+  if (reached) {
+    *reached = lreached && weight >= 1.f;
+  }
+
+  // Converts to local-space corrections.
+  for (int i = 0; i < num_joints; ++i) {
+    joint_corrections[i] = ComputeChainCorrection(*this, i, rotations);
+  }
+  return true;
+}
+}  // namespace animation
+}  // namespace ozz
@@ -0,0 +1,511 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+
+#include "ozz/animation/runtime/ik_two_bone_batch_job.h"
+
+#include <cassert>
+
+#include "ozz/base/maths/soa_float.h"
+#include "ozz/base/maths/soa_float4x4.h"
+#include "ozz/base/maths/soa_quaternion.h"
+
+using namespace ozz::math;
+
+namespace ozz {
+namespace animation {
+IKTwoBoneBatchJob::IKTwoBoneBatchJob()
+    : mid_axis(math::simd_float4::z_axis()),
+      twist_angle(0.f),
+      soften(1.f),
+      weight(1.f) {}
+
+bool IKTwoBoneBatchJob::Validate() const {
+  bool valid = true;
+  const size_t num_chains = start_joints.size();
+  valid &= mid_joints.size() == num_chains;
+  valid &= end_joints.size() == num_chains;
+  valid &= targets.size() == num_chains;
+  valid &= pole_vectors.size() == num_chains;
+  const size_t num_soa_chains = (num_chains + 3) / 4;
+  valid &= start_joint_corrections.size() >= num_soa_chains;
+  valid &= mid_joint_corrections.size() >= num_soa_chains;
+  valid &= reached.empty() || reached.size() >= num_chains;
+  valid &= ozz::math::AreAllTrue1(ozz::math::IsNormalizedEst3(mid_axis));
+  return valid;
+}
+
+namespace {
+
+// Transforms SoA point _p (w = 1) by SoA matrix _m.
+SoaFloat3 SoaTransformPoint(const SoaFloat4x4& _m, const SoaFloat3& _p) {
+  const SoaFloat3 ret = {
+      _m.cols[0].x * _p.x + _m.cols[1].x * _p.y + _m.cols[2].x * _p.z +
+          _m.cols[3].x,
+      _m.cols[0].y * _p.x + _m.cols[1].y * _p.y + _m.cols[2].y * _p.z +
+          _m.cols[3].y,
+      _m.cols[0].z * _p.x + _m.cols[1].z * _p.y + _m.cols[2].z * _p.z +
+          _m.cols[3].z};
+  return ret;
+}
+
+// Transforms SoA vector _v (w = 0) by SoA matrix _m.
+SoaFloat3 SoaTransformVector(const SoaFloat4x4& _m, const SoaFloat3& _v) {
+  const SoaFloat3 ret = {
+      _m.cols[0].x * _v.x + _m.cols[1].x * _v.y + _m.cols[2].x * _v.z,
+      _m.cols[0].y * _v.x + _m.cols[1].y * _v.y + _m.cols[2].y * _v.z,
+      _m.cols[0].z * _v.x + _m.cols[1].z * _v.y + _m.cols[2].z * _v.z};
+  return ret;
+}
+
+// Rotates SoA vector _v by SoA quaternion _q, see TransformVector for
+// SimdQuaternion.
+SoaFloat3 SoaTransformVector(const SoaQuaternion& _q, const SoaFloat3& _v) {
+  const SoaFloat3 q_xyz = {_q.x, _q.y, _q.z};
+  const SoaFloat3 w_v = {_q.w * _v.x, _q.w * _v.y, _q.w * _v.z};
+  const SoaFloat3 cross1 = Cross(q_xyz, _v) + w_v;
+  const SoaFloat3 cross2 = Cross(q_xyz, cross1);
+  return _v + cross2 + cross2;
+}
+
+// See SimdQuaternion::FromAxisAngle.
+SoaQuaternion SoaFromAxisAngle(const SoaFloat3& _axis, _SimdFloat4 _angle) {
+  const SimdFloat4 half_angle = _angle * simd_float4::Load1(.5f);
+  const SimdFloat4 half_sin = Sin(half_angle);
+  const SimdFloat4 half_cos = Cos(half_angle);
+  const SoaQuaternion quat = {_axis.x * half_sin, _axis.y * half_sin,
+                              _axis.z * half_sin, half_cos};
+  return quat;
+}
+
+// See SimdQuaternion::FromAxisCosAngle.
+SoaQuaternion SoaFromAxisCosAngle(const SoaFloat3& _axis, _SimdFloat4 _cos) {
+  const SimdFloat4 one = simd_float4::one();
+  const SimdFloat4 half_cos2 = (one + _cos) * simd_float4::Load1(.5f);
+  const SimdFloat4 half_sin = Sqrt(one - half_cos2);
+  const SoaQuaternion quat = {_axis.x * half_sin, _axis.y * half_sin,
+                              _axis.z * half_sin, Sqrt(half_cos2)};
+  return quat;
+}
+
+// See SimdQuaternion::FromVectors. Lanes where a vector is null get identity.
+SoaQuaternion SoaFromVectors(const SoaFloat3& _from, const SoaFloat3& _to) {
+  const SimdFloat4 zero = simd_float4::zero();
+  const SimdFloat4 norm_from_norm_to =
+      Sqrt(LengthSqr(_from) * LengthSqr(_to));
+  const SimdFloat4 real_part = norm_from_norm_to + Dot(_from, _to);
+
+  // If _from and _to are exactly opposite, rotate 180 degrees around an
+  // arbitrary orthogonal axis.
+  const SimdInt4 opposite =
+      CmpLt(real_part, simd_float4::Load1(1.e-6f) * norm_from_norm_to);
+  const SimdInt4 x_major = CmpGt(Abs(_from.x), Abs(_from.z));
+  const SoaFloat3 cross = Cross(_from, _to);
+  const SoaQuaternion quat = {
+      Select(opposite, Select(x_major, -_from.y, zero), cross.x),
+      Select(opposite, Select(x_major, _from.x, -_from.z), cross.y),
+      Select(opposite, Select(x_major, zero, _from.y), cross.z),
+      Select(opposite, zero, real_part)};
+  const SoaQuaternion normalized = Normalize(quat);
+
+  const SimdInt4 null =
+      CmpLt(norm_from_norm_to, simd_float4::Load1(1.e-6f));
+  const SoaQuaternion ret = {Select(null, zero, normalized.x),
+                             Select(null, zero, normalized.y),
+                             Select(null, zero, normalized.z),
+                             Select(null, simd_float4::one(), normalized.w)};
+  return ret;
+}
+
+// Selects _true lanes where _b is set, _false ones otherwise.
+SoaQuaternion SoaSelect(_SimdInt4 _b, const SoaQuaternion& _true,
+                        const SoaQuaternion& _false) {
+  const SoaQuaternion ret = {
+      Select(_b, _true.x, _false.x), Select(_b, _true.y, _false.y),
+      Select(_b, _true.z, _false.z), Select(_b, _true.w, _false.w)};
+  return ret;
+}
+
+// Loads the 4 chains starting at _first, to SoA structures. Lanes beyond the
+// last chain duplicate it, so they remain valid for the solver.
+struct SoaIKChains {
+  SoaIKChains(const IKTwoBoneBatchJob& _job, size_t _first) {
+    const size_t last = _job.start_joints.size() - 1;
+    size_t chains[4];
+    for (size_t i = 0; i < 4; ++i) {
+      chains[i] = _first + i < last ? _first + i : last;
+    }
+    LoadMatrices(_job.start_joints, chains, &start_joint);
+    LoadMatrices(_job.mid_joints, chains, &mid_joint);
+    LoadMatrices(_job.end_joints, chains, &end_joint);
+    LoadVectors(_job.targets, chains, &target);
+    LoadVectors(_job.pole_vectors, chains, &pole_vector);
+  }
+
+  static void LoadMatrices(const span<const Float4x4>& _matrices,
+                           const size_t* _chains, SoaFloat4x4* _out) {
+    for (int c = 0; c < 4; ++c) {
+      const SimdFloat4 in[4] = {
+          _matrices[_chains[0]].cols[c], _matrices[_chains[1]].cols[c],
+          _matrices[_chains[2]].cols[c], _matrices[_chains[3]].cols[c]};
+      SimdFloat4 out[4];
+      Transpose4x4(in, out);
+      _out->cols[c] = SoaFloat4::Load(out[0], out[1], out[2], out[3]);
+    }
+  }
+
+  static void LoadVectors(const span<const SimdFloat4>& _vectors,
+                          const size_t* _chains, SoaFloat3* _out) {
+    const SimdFloat4 in[4] = {_vectors[_chains[0]], _vectors[_chains[1]],
+                              _vectors[_chains[2]], _vectors[_chains[3]]};
+    SimdFloat4 out[3];
+    Transpose4x3(in, out);
+    *_out = SoaFloat3::Load(out[0], out[1], out[2]);
+  }
+
+  SoaFloat4x4 start_joint;
+  SoaFloat4x4 mid_joint;
+  SoaFloat4x4 end_joint;
+  SoaFloat3 target;
+  SoaFloat3 pole_vector;
+};
+
+// Local data structure used to share constant data accross ik stages, see
+// IKTwoBoneJob implementation.
+struct SoaIKConstantSetup {
+  SoaIKConstantSetup(const IKTwoBoneBatchJob& _job,
+                     const SoaIKChains& _chains) {
+    // Prepares constants
+    one = simd_float4::one();
+    mask_sign = simd_int4::mask_sign();
+    m_one = Xor(one, mask_sign);
+    mid_axis = SoaFloat3::Load(SplatX(_job.mid_axis), SplatY(_job.mid_axis),
+                               SplatZ(_job.mid_axis));
+
+    // Computes inverse matrices required to change to start and mid spaces.
+    // Matrices that aren't invertible are set to 0, which will result in
+    // identity correction quaternions.
+    SimdInt4 invertible;
+    inv_start_joint = Invert(_chains.start_joint, &invertible);
+    const SoaFloat4x4 inv_mid_joint = Invert(_chains.mid_joint, &invertible);
+
+    const SoaFloat3 start =
+        SoaFloat3::Load(_chains.start_joint.cols[3].x,
+                        _chains.start_joint.cols[3].y,
+                        _chains.start_joint.cols[3].z);
+    const SoaFloat3 mid =
+        SoaFloat3::Load(_chains.mid_joint.cols[3].x,
+                        _chains.mid_joint.cols[3].y,
+                        _chains.mid_joint.cols[3].z);
+    const SoaFloat3 end =
+        SoaFloat3::Load(_chains.end_joint.cols[3].x,
+                        _chains.end_joint.cols[3].y,
+                        _chains.end_joint.cols[3].z);
+
+    // Transform some positions to mid joint space (_ms)
+    const SoaFloat3 start_ms = SoaTransformPoint(inv_mid_joint, start);
+    const SoaFloat3 end_ms = SoaTransformPoint(inv_mid_joint, end);
+
+    // Transform some positions to start joint space (_ss)
+    const SoaFloat3 mid_ss = SoaTransformPoint(inv_start_joint, mid);
+    const SoaFloat3 end_ss = SoaTransformPoint(inv_start_joint, end);
+
+    // Computes bones vectors and length in mid and start spaces.
+    start_mid_ms = -start_ms;
+    mid_end_ms = end_ms;
+    start_mid_ss = mid_ss;
+    start_mid_ss_len2 = LengthSqr(start_mid_ss);
+    mid_end_ss_len2 = LengthSqr(end_ss - mid_ss);
+    start_end_ss_len2 = LengthSqr(end_ss);
+  }
+
+  // Constants
+  SimdFloat4 one;
+  SimdFloat4 m_one;
+  SimdInt4 mask_sign;
+  SoaFloat3 mid_axis;
+
+  // Inverse matrices
+  SoaFloat4x4 inv_start_joint;
+
+  // Bones vectors and length in mid and start spaces (_ms and _ss).
+  SoaFloat3 start_mid_ms;
+  SoaFloat3 mid_end_ms;
+  SoaFloat3 start_mid_ss;
+  SimdFloat4 start_mid_ss_len2;
+  SimdFloat4 mid_end_ss_len2;
+  SimdFloat4 start_end_ss_len2;
+};
+
+// Smoothen target position, see IKTwoBoneJob SoftenTarget. Returns reached
+// mask.
+SimdInt4 SoaSoftenTarget(const IKTwoBoneBatchJob& _job,
+                         const SoaIKChains& _chains,
+                         const SoaIKConstantSetup& _setup,
+                         SoaFloat3* _start_target_ss,
+                         SimdFloat4* _start_target_ss_len2) {
+  const SimdFloat4 zero = simd_float4::zero();
+  const SoaFloat3 start_target_original_ss =
+      SoaTransformPoint(_setup.inv_start_joint, _chains.target);
+  const SimdFloat4 start_target_original_ss_len2 =
+      LengthSqr(start_target_original_ss);
+  const SimdFloat4 start_mid_ss_len = Sqrt(_setup.start_mid_ss_len2);
+  const SimdFloat4 mid_end_ss_len = Sqrt(_setup.mid_end_ss_len2);
+  const SimdFloat4 start_target_original_ss_len =
+      Sqrt(start_target_original_ss_len2);
+  const SimdFloat4 bone_len_diff_abs = Abs(start_mid_ss_len - mid_end_ss_len);
+  const SimdFloat4 bones_chain_len = start_mid_ss_len + mid_end_ss_len;
+  const SimdFloat4 da =
+      bones_chain_len *
+      Clamp(zero, simd_float4::Load1(_job.soften), _setup.one);
+  const SimdFloat4 ds = bones_chain_len - da;
+
+  // Sotftens target position if it is further than a ratio (_soften) of the
+  // whole bone chain length, and ds and start_target_original_ss_len2 are != 0.
+  const SimdInt4 further = CmpGt(start_target_original_ss_len, da);
+  const SimdInt4 softened =
+      And(And(further, CmpGt(start_target_original_ss_len, zero)),
+          CmpGt(ds, zero));
+
+  // Finds interpolation ratio (aka alpha), and approximate an exponential
+  // function with : 1-(3^4)/(alpha+3)^4
+  const SimdFloat4 alpha = (start_target_original_ss_len - da) * RcpEst(ds);
+  const SimdFloat4 op = alpha + simd_float4::Load1(3.f);
+  const SimdFloat4 op2 = op * op;
+  const SimdFloat4 op4 = op2 * op2;
+  const SimdFloat4 ratio = simd_float4::Load1(81.f) * RcpEst(op4);
+
+  // Recomputes start_target_ss vector and length.
+  const SimdFloat4 start_target_ss_len = da + ds - ds * ratio;
+  const SimdFloat4 scale =
+      start_target_ss_len * RcpEst(start_target_original_ss_len);
+  *_start_target_ss_len2 =
+      Select(softened, start_target_ss_len * start_target_ss_len,
+             start_target_original_ss_len2);
+  *_start_target_ss = SoaFloat3::Load(
+      Select(softened, start_target_original_ss.x * scale,
+             start_target_original_ss.x),
+      Select(softened, start_target_original_ss.y * scale,
+             start_target_original_ss.y),
+      Select(softened, start_target_original_ss.z * scale,
+             start_target_original_ss.z));
+
+  // Reachable if not further than da, but further than |d1−d2|.
+  return AndNot(CmpGt(start_target_original_ss_len, bone_len_diff_abs),
+                further);
+}
+
+SoaQuaternion SoaComputeMidJoint(const SoaIKConstantSetup& _setup,
+                                 _SimdFloat4 _start_target_ss_len2) {
+  // Computes expected (corrected) and initial angle at mid_ss joint, using law
+  // of cosine (generalized Pythagorean).
+  const SimdFloat4 start_mid_end_sum_ss_len2 =
+      _setup.start_mid_ss_len2 + _setup.mid_end_ss_len2;
+  const SimdFloat4 start_mid_end_ss_half_rlen =
+      simd_float4::Load1(.5f) *
+      RSqrtEstNR(_setup.start_mid_ss_len2 * _setup.mid_end_ss_len2);
+  const SimdFloat4 mid_corrected_cos_angle =
+      Clamp(_setup.m_one,
+            (start_mid_end_sum_ss_len2 - _start_target_ss_len2) *
+                start_mid_end_ss_half_rlen,
+            _setup.one);
+  const SimdFloat4 mid_initial_cos_angle =
+      Clamp(_setup.m_one,
+            (start_mid_end_sum_ss_len2 - _setup.start_end_ss_len2) *
+                start_mid_end_ss_half_rlen,
+            _setup.one);
+
+  // Computes corrected angle
+  const SimdFloat4 mid_corrected_angle = ACos(mid_corrected_cos_angle);
+
+  // Computes initial angle, negative if mid-to-end joint is bent backward.
+  const SoaFloat3 bent_side_ref = Cross(_setup.start_mid_ms, _setup.mid_axis);
+  const SimdInt4 bent_side_flip =
+      CmpLt(Dot(bent_side_ref, _setup.mid_end_ms), simd_float4::zero());
+  const SimdFloat4 mid_initial_angle =
+      Xor(ACos(mid_initial_cos_angle), And(bent_side_flip, _setup.mask_sign));
+
+  // Finally deduces initial to corrected angle difference.
+  return SoaFromAxisAngle(_setup.mid_axis,
+                          mid_corrected_angle - mid_initial_angle);
+}
+
+SoaQuaternion SoaComputeStartJoint(const IKTwoBoneBatchJob& _job,
+                                   const SoaIKChains& _chains,
+                                   const SoaIKConstantSetup& _setup,
+                                   const SoaQuaternion& _mid_rot_ms,
+                                   const SoaFloat3& _start_target_ss,
+                                   _SimdFloat4 _start_target_ss_len2) {
+  // Pole vector in start joint space (_ss)
+  const SoaFloat3 pole_ss =
+      SoaTransformVector(_setup.inv_start_joint, _chains.pole_vector);
+
+  // start_mid_ss with quaternion mid_rot_ms applied.
+  const SoaFloat3 mid_end_ss_final = SoaTransformVector(
+      _setup.inv_start_joint,
+      SoaTransformVector(_chains.mid_joint,
+                         SoaTransformVector(_mid_rot_ms, _setup.mid_end_ms)));
+  const SoaFloat3 start_end_ss_final = _setup.start_mid_ss + mid_end_ss_final;
+
+  // Quaternion for rotating the effector onto the target
+  const SoaQuaternion end_to_target_rot_ss =
+      SoaFromVectors(start_end_ss_final, _start_target_ss);
+
+  // Calculates rotate_plane_ss quaternion which aligns joint chain plane to
+  // the reference plane (pole vector). This can only be computed for lanes
+  // where start target axis is valid (not 0 length).
+  const SimdInt4 valid = CmpGt(_start_target_ss_len2, simd_float4::zero());
+  if (!AreAllFalse(valid)) {
+    // Computes each plane normal.
+    const SoaFloat3 ref_plane_normal_ss = Cross(_start_target_ss, pole_ss);
+    const SoaFloat3 mid_axis_ss = SoaTransformVector(
+        _setup.inv_start_joint,
+        SoaTransformVector(_chains.mid_joint, _setup.mid_axis));
+    const SoaFloat3 joint_plane_normal_ss =
+        SoaTransformVector(end_to_target_rot_ss, mid_axis_ss);
+
+    // Computes angle cosine between the 2 normalized normals.
+    const SimdFloat4 rotate_plane_cos_angle =
+        Dot(ref_plane_normal_ss *
+                RSqrtEstNR(LengthSqr(ref_plane_normal_ss)),
+            joint_plane_normal_ss *
+                RSqrtEstNR(LengthSqr(joint_plane_normal_ss)));
+
+    // Computes rotation axis, which is either start_target_ss or
+    // -start_target_ss depending on rotation direction.
+    const SoaFloat3 rotate_plane_axis_ss =
+        _start_target_ss * RSqrtEstNR(_start_target_ss_len2);
+    const SimdFloat4 start_axis_flip =
+        And(Dot(joint_plane_normal_ss, pole_ss), _setup.mask_sign);
+    const SoaFloat3 rotate_plane_axis_flipped_ss =
+        SoaFloat3::Load(Xor(rotate_plane_axis_ss.x, start_axis_flip),
+                        Xor(rotate_plane_axis_ss.y, start_axis_flip),
+                        Xor(rotate_plane_axis_ss.z, start_axis_flip));
+
+    // Builds quaternion along rotation axis.
+    const SoaQuaternion rotate_plane_ss = SoaFromAxisCosAngle(
+        rotate_plane_axis_flipped_ss,
+        Clamp(_setup.m_one, rotate_plane_cos_angle, _setup.one));
+
+    SoaQuaternion start_rot_ss;
+    if (_job.twist_angle != 0.f) {
+      // If a twist angle is provided, rotation angle is rotated along
+      // rotation plane axis.
+      const SoaQuaternion twist_ss = SoaFromAxisAngle(
+          rotate_plane_axis_ss, simd_float4::Load1(_job.twist_angle));
+      start_rot_ss = twist_ss * rotate_plane_ss * end_to_target_rot_ss;
+    } else {
+      start_rot_ss = rotate_plane_ss * end_to_target_rot_ss;
+    }
+    return SoaSelect(valid, start_rot_ss, end_to_target_rot_ss);
+  }
+  return end_to_target_rot_ss;
+}
+
+// Fix up quaternion so w is always positive, which is required for NLerp
+// (with identity quaternion) to lerp the shortest path. Then applies weight.
+SoaQuaternion SoaWeightOutput(const IKTwoBoneBatchJob& _job,
+                              const SoaIKConstantSetup& _setup,
+                              const SoaQuaternion& _rot) {
+  const SimdInt4 flip =
+      And(_setup.mask_sign, CmpLt(_rot.w, simd_float4::zero()));
+  const SoaQuaternion rot_fu = {Xor(_rot.x, flip), Xor(_rot.y, flip),
+                                Xor(_rot.z, flip), Xor(_rot.w, flip)};
+  if (_job.weight < 1.f) {
+    // NLerp rotation.
+    const SimdFloat4 simd_weight =
+        Max(simd_float4::zero(), simd_float4::Load1(_job.weight));
+    const SoaQuaternion lerp =
+        Lerp(SoaQuaternion::identity(), rot_fu, simd_weight);
+    return lerp * RSqrtEstNR(Dot(lerp, lerp));
+  }
+  return rot_fu;
+}
+}  // namespace
+
+bool IKTwoBoneBatchJob::Run() const {
+  if (!Validate()) {
+    return false;
+  }
+
+  // Chains are solved 4 by 4, also in AVX2 builds. 8 wide SimdFloat8 (see
+  // simd_math8.h) only implements the arithmetic used by sampling, blending
+  // and local-to-model kernels. The solver also needs SoA float3, matrix
+  // inversion, quaternions, comparisons, selects and trigonometric functions
+  // (ACos, Sin, Cos). These only exist 4 wide, and would all need an 8 wide
+  // version first.
+  const size_t num_chains = start_joints.size();
+  for (size_t i = 0; i < num_chains; i += 4) {
+    SoaQuaternion& start_correction = start_joint_corrections[i / 4];
+    SoaQuaternion& mid_correction = mid_joint_corrections[i / 4];
+    int reached_mask = 0;
+
+    if (weight <= 0.f) {
+      // No correction, target isn't reached.
+      start_correction = mid_correction = SoaQuaternion::identity();
+    } else {
+      // Prepares constant ik data.
+      const SoaIKChains chains(*this, i);
+      const SoaIKConstantSetup setup(*this, chains);
+
+      // Finds soften target position.
+      SoaFloat3 start_target_ss;
+      SimdFloat4 start_target_ss_len2;
+      const SimdInt4 lreached = SoaSoftenTarget(
+          *this, chains, setup, &start_target_ss, &start_target_ss_len2);
+      reached_mask = weight >= 1.f ? MoveMask(lreached) : 0;
+
+      // Solves mid joint rotation, then start joint rotation.
+      const SoaQuaternion mid_rot_ms =
+          SoaComputeMidJoint(setup, start_target_ss_len2);
+      const SoaQuaternion start_rot_ss =
+          SoaComputeStartJoint(*this, chains, setup, mid_rot_ms,
+                               start_target_ss, start_target_ss_len2);
+
+      // Finally apply weight and output quaternions. Lanes beyond the last
+      // chain are set to identity.
+      const size_t remain = num_chains - i;
+      const SimdInt4 used =
+          simd_int4::Load(remain > 0, remain > 1, remain > 2, remain > 3);
+      start_correction =
+          SoaSelect(used, SoaWeightOutput(*this, setup, start_rot_ss),
+                    SoaQuaternion::identity());
+      mid_correction =
+          SoaSelect(used, SoaWeightOutput(*this, setup, mid_rot_ms),
+                    SoaQuaternion::identity());
+    }
+
+    if (!reached.empty()) {
+      for (size_t j = i; j < num_chains && j < i + 4; ++j) {
+        reached[j] = (reached_mask & (1 << (j - i))) != 0;
+      }
+    }
+  }
+  return true;
+}
+}  // namespace animation
+}  // namespace ozz
@@ -27,14 +27,18 @@
 
 #include "ozz/animation/runtime/local_to_model_job.h"
 
+#include <algorithm>
 #include <cassert>
 
 #include "ozz/base/maths/math_ex.h"
+#include "ozz/base/maths/simd_float3x4.h"
 #include "ozz/base/maths/simd_math.h"
 #include "ozz/base/maths/soa_float4x4.h"
+#include "ozz/base/maths/soa_math8.h"
 #include "ozz/base/maths/soa_transform.h"
 
 #include "ozz/animation/runtime/skeleton.h"
+#include "ozz/animation/runtime/skeleton_partition.h"
 
 namespace ozz {
 namespace animation {
@@ -62,51 +66,500 @@ bool LocalToModelJob::Validate() const {
 
   // Test input and output ranges, implicitly tests for nullptr end pointers.
   valid &= input.size() >= num_soa_joints;
-  valid &= output.size() >= num_joints;
+
+  // Output is output_3x4 if it's set, in which case output must be empty.
+  valid &= output_3x4.empty()
+               ? output.size() >= num_joints
+               : output.empty() && output_3x4.size() >= num_joints;
+
+  // Optional dirty flags.
+  valid &= input_dirty.empty() || input_dirty.size() >= num_joints;
+  valid &= output_dirty.empty() || output_dirty.size() >= num_joints;
 
   return valid;
 }
 
-bool LocalToModelJob::Run() const {
-  if (!Validate()) {
-    return false;
+namespace {
+// Converts soa matrices to 4 aos Float4x4 matrices.
+OZZ_INLINE void ToAos(const math::SoaFloat4x4& _soa, math::Float4x4 _aos[4]) {
+  math::Transpose16x16(&_soa.cols[0].x, _aos->cols);
+}
+
+// Converts soa matrices to 4 aos Float3x4 matrices. Last row is skipped, which
+// saves a quarter of the transposition.
+OZZ_INLINE void ToAos(const math::SoaFloat4x4& _soa, math::Float3x4 _aos[4]) {
+  const math::SimdFloat4 xs[4] = {_soa.cols[0].x, _soa.cols[1].x,
+                                  _soa.cols[2].x, _soa.cols[3].x};
+  const math::SimdFloat4 ys[4] = {_soa.cols[0].y, _soa.cols[1].y,
+                                  _soa.cols[2].y, _soa.cols[3].y};
+  const math::SimdFloat4 zs[4] = {_soa.cols[0].z, _soa.cols[1].z,
+                                  _soa.cols[2].z, _soa.cols[3].z};
+  math::SimdFloat4 rows[3][4];
+  math::Transpose4x4(xs, rows[0]);
+  math::Transpose4x4(ys, rows[1]);
+  math::Transpose4x4(zs, rows[2]);
+  for (int i = 0; i < 4; ++i) {
+    _aos[i].rows[0] = rows[0][i];
+    _aos[i].rows[1] = rows[1][i];
+    _aos[i].rows[2] = rows[2][i];
+  }
+}
+
+// Gathers 4 aos Float4x4 matrices to soa matrices.
+OZZ_INLINE void ToSoa(const math::Float4x4* const _aos[4],
+                      math::SoaFloat4x4* _soa) {
+  for (int c = 0; c < 4; ++c) {
+    const math::SimdFloat4 cols[4] = {_aos[0]->cols[c], _aos[1]->cols[c],
+                                      _aos[2]->cols[c], _aos[3]->cols[c]};
+    math::Transpose4x4(cols, &_soa->cols[c].x);
+  }
+}
+
+// Gathers 4 aos Float3x4 matrices to soa matrices. Last row isn't set, as it's
+// implicitly [0 0 0 1].
+OZZ_INLINE void ToSoa(const math::Float3x4* const _aos[4],
+                      math::SoaFloat4x4* _soa) {
+  for (int r = 0; r < 3; ++r) {
+    const math::SimdFloat4 rows[4] = {_aos[0]->rows[r], _aos[1]->rows[r],
+                                      _aos[2]->rows[r], _aos[3]->rows[r]};
+    math::SimdFloat4 cols[4];
+    math::Transpose4x4(rows, cols);
+    for (int c = 0; c < 4; ++c) {
+      (&_soa->cols[c].x)[r] = cols[c];
+    }
+  }
+}
+
+// Multiplies soa matrices _parents and _locals, and outputs the 4 resulting
+// aos Float4x4 matrices.
+OZZ_INLINE void MultiplySoa(const math::SoaFloat4x4& _parents,
+                            const math::SoaFloat4x4& _locals,
+                            math::Float4x4 _models[4]) {
+  // Columns are transposed and stored one by one, which limits the number of
+  // live registers.
+  for (int c = 0; c < 4; ++c) {
+    const math::SoaFloat4 col = _parents * _locals.cols[c];
+    math::SimdFloat4 cols[4];
+    math::Transpose4x4(&col.x, cols);
+    for (int j = 0; j < 4; ++j) {
+      _models[j].cols[c] = cols[j];
+    }
+  }
+}
+
+// Multiplies affine soa matrices _parents and _locals, and outputs the 4
+// resulting aos Float3x4 matrices. Last rows are implicitly [0 0 0 1], so they
+// are neither read nor computed.
+OZZ_INLINE void MultiplySoa(const math::SoaFloat4x4& _parents,
+                            const math::SoaFloat4x4& _locals,
+                            math::Float3x4 _models[4]) {
+  for (int r = 0; r < 3; ++r) {
+    const math::SimdFloat4 p0 = (&_parents.cols[0].x)[r];
+    const math::SimdFloat4 p1 = (&_parents.cols[1].x)[r];
+    const math::SimdFloat4 p2 = (&_parents.cols[2].x)[r];
+    math::SimdFloat4 row[4];
+    for (int c = 0; c < 4; ++c) {
+      const math::SoaFloat4& l = _locals.cols[c];
+      row[c] = math::MAdd(p0, l.x, math::MAdd(p1, l.y, p2 * l.z));
+    }
+    row[3] = row[3] + (&_parents.cols[3].x)[r];
+    math::SimdFloat4 rows[4];
+    math::Transpose4x4(row, rows);
+    for (int j = 0; j < 4; ++j) {
+      _models[j].rows[r] = rows[j];
+    }
+  }
+}
+
+#if defined(OZZ_SIMD_AVX2)
+// Converts soa matrices of two adjacent soa transforms to 8 aos Float4x4
+// matrices, the 4 first ones being the ones of the low soa transform.
+OZZ_INLINE void ToAos(const math::Soa8Float4x4& _soa, math::Float4x4 _aos[8]) {
+  for (int c = 0; c < 4; ++c) {
+    math::SimdFloat8 cols[4];
+    math::Transpose4x4(&_soa.cols[c].x, cols);
+    for (int j = 0; j < 4; ++j) {
+      math::Store(cols[j], &_aos[j].cols[c], &_aos[j + 4].cols[c]);
+    }
+  }
+}
+
+// Converts soa matrices of two adjacent soa transforms to 8 aos Float3x4
+// matrices, the 4 first ones being the ones of the low soa transform.
+OZZ_INLINE void ToAos(const math::Soa8Float4x4& _soa, math::Float3x4 _aos[8]) {
+  for (int r = 0; r < 3; ++r) {
+    const math::SimdFloat8 cols[4] = {
+        (&_soa.cols[0].x)[r], (&_soa.cols[1].x)[r], (&_soa.cols[2].x)[r],
+        (&_soa.cols[3].x)[r]};
+    math::SimdFloat8 rows[4];
+    math::Transpose4x4(cols, rows);
+    for (int j = 0; j < 4; ++j) {
+      math::Store(rows[j], &_aos[j].rows[r], &_aos[j + 4].rows[r]);
+    }
+  }
+}
+#endif  // OZZ_SIMD_AVX2
+
+// Builds the 4 aos matrices of soa transform _transform.
+template <typename _Matrix>
+OZZ_INLINE void BuildAos(const math::SoaTransform& _transform,
+                         _Matrix _aos[4]) {
+  ToAos(math::SoaFloat4x4::FromAffine(_transform.translation,
+                                      _transform.rotation, _transform.scale),
+        _aos);
+}
+
+// Builds local aos matrices from soa transforms, which are mostly requested
+// in order. With AVX2, matrices of two adjacent soa transforms are built and
+// transposed at once, the second ones being kept for the next request.
+template <typename _Matrix>
+class LocalAosMatrices {
+ public:
+  // _end is the index of the last requested soa transform, plus 1.
+  LocalAosMatrices(const span<const math::SoaTransform>& _input, int _end)
+      : input_(_input.data()),
+        end_(math::Min(_end, static_cast<int>(_input.size()))),
+        next_(-1) {}
+
+  // Returns the 4 local matrices of soa transform _soa. Returned matrices are
+  // valid until next call.
+  const _Matrix* Get(int _soa) {
+#if defined(OZZ_SIMD_AVX2)
+    if (_soa == next_) {
+      next_ = -1;
+      return matrices_ + 4;
+    }
+    if (_soa + 1 < end_) {
+      BuildPair(_soa);
+      return matrices_;
+    }
+#endif  // OZZ_SIMD_AVX2
+    BuildAos(input_[_soa], matrices_);
+    return matrices_;
   }
 
-  const span<const int16_t>& parents = skeleton->joint_parents();
+ private:
+#if defined(OZZ_SIMD_AVX2)
+  // Builds matrices of soa transforms _soa and _soa + 1. It isn't inlined,
+  // which keeps 256-bit registers out of the callers.
+  OZZ_NOINLINE void BuildPair(int _soa) {
+    const math::Soa8Transform& transform =
+        math::Soa8Transform::Load(input_[_soa], input_[_soa + 1]);
+    ToAos(math::Soa8Float4x4::FromAffine(transform.translation,
+                                         transform.rotation, transform.scale),
+          matrices_);
+    next_ = _soa + 1;
+  }
+#endif  // OZZ_SIMD_AVX2
 
-  // Initializes an identity matrix that will be used to compute roots model
-  // matrices without requiring a branch.
-  const math::Float4x4 identity = math::Float4x4::identity();
-  const math::Float4x4* root_matrix = (root == nullptr) ? &identity : root;
+  const math::SoaTransform* input_;
+  int end_;
+  int next_;
+#if defined(OZZ_SIMD_AVX2)
+  _Matrix matrices_[8];
+#else   // OZZ_SIMD_AVX2
+  _Matrix matrices_[4];
+#endif  // OZZ_SIMD_AVX2
+};
 
-  // Applies hierarchical transformation.
+// Applies hierarchical transformation to _output matrices, whose type defines
+// the output layout. If _Incremental is true, only dirty joints and their
+// descendants are recomputed. Dirty flags are then propagated to children in
+// _dirty, which must be big enough for all skeleton joints. Otherwise _dirty
+// is optional, and set to true for all recomputed joints.
+template <typename _Matrix, bool _Incremental>
+void Process(const LocalToModelJob& _job, const span<_Matrix>& _output,
+             const _Matrix& _root, bool* _dirty) {
+  const span<const int16_t>& parents = _job.skeleton->joint_parents();
+  const int from = _job.from;
   // Loop ends after "to".
-  const int end = math::Min(to + 1, skeleton->num_joints());
+  const int end = math::Min(_job.to + 1, _job.skeleton->num_joints());
   // Begins iteration from "from", or the next joint if "from" is excluded.
-  // Process next joint if end is not reach. parents[begin] >= from is true as
-  // long as "begin" is a child of "from".
-  for (int i = math::Max(from + from_excluded, 0),
-           process = i < end && (!from_excluded || parents[i] >= from);
+  const int begin = math::Max(from + _job.from_excluded, 0);
+  LocalAosMatrices<_Matrix> local_matrices(_job.input, (end + 3) / 4);
+
+  // A joint is processed as long as it's in range and a child of "from".
+  // parents[i] >= from is true as long as "i" is a child of "from", so
+  // processed joints are contiguous, starting from begin.
+  for (int i = begin,
+           process = i < end && (!_job.from_excluded || parents[i] >= from);
        process;) {
+    // Finds the processed joints of the current soa group, and the dirty ones
+    // in incremental mode. A joint is dirty if its input is, or if its parent
+    // was recomputed. Excluded "from" is considered dirty as it was updated by
+    // the user.
+    const int soa_begin = i;
+    bool any_dirty = !_Incremental;
+    for (const int soa_end = (i + 4) & ~3; i < soa_end && process;
+         ++i, process = i < end && parents[i] >= from) {
+      if (_Incremental) {
+        const int parent = parents[i];
+        const bool parent_dirty =
+            parent == Skeleton::kNoParent
+                ? false
+                : (parent >= begin ? _dirty[parent] : parent == from);
+        _dirty[i] = _job.input_dirty[i] || parent_dirty;
+        any_dirty |= _dirty[i];
+      } else if (_dirty) {
+        _dirty[i] = true;
+      }
+    }
+
+    // Nothing to do for this soa group.
+    if (!any_dirty) {
+      continue;
+    }
+
+    // Builds aos matrices from soa transforms. In incremental mode, the next
+    // soa group is usually clean, so matrices aren't built by pairs.
+    _Matrix aos_matrices[4];
+    const _Matrix* local_aos_matrices = aos_matrices;
+    if (_Incremental) {
+      BuildAos(_job.input[soa_begin / 4], aos_matrices);
+    } else {
+      local_aos_matrices = local_matrices.Get(soa_begin / 4);
+    }
+
+    for (int j = soa_begin; j < i; ++j) {
+      if (!_Incremental || _dirty[j]) {
+        const int parent = parents[j];
+        const _Matrix& parent_matrix =
+            parent == Skeleton::kNoParent ? _root : _output[parent];
+        _output[j] = parent_matrix * local_aos_matrices[j & 3];
+      }
+    }
+  }
+}
+
+// Level ordered skeletons version of Process. "from" hierarchy isn't contiguous
+// in this case, so joints are flagged as they are found to be part of it.
+// Soa groups whose joints all need to be recomputed, and whose parents were all
+// computed before, are processed 4 by 4 with soa maths. Parent indices being
+// sorted, the last joint of a group has the highest parent index.
+template <typename _Matrix, bool _Incremental>
+void ProcessLevelOrdered(const LocalToModelJob& _job,
+                         const span<_Matrix>& _output, const _Matrix& _root,
+                         bool* _dirty) {
+  const span<const int16_t>& parents = _job.skeleton->joint_parents();
+  const int from = _job.from;
+  const int end = math::Min(_job.to + 1, _job.skeleton->num_joints());
+  const int begin = math::Max(from + _job.from_excluded, 0);
+
+  bool in_hierarchy[Skeleton::kMaxJoints];
+  for (int soa_begin = begin & ~3; soa_begin < end; soa_begin += 4) {
+    // Finds joints of the current soa group to recompute.
+    const int soa_end = math::Min(soa_begin + 4, end);
+    bool recompute[4] = {false, false, false, false};
+    int num_recomputed = 0;
+    for (int i = math::Max(soa_begin, begin); i < soa_end; ++i) {
+      const int parent = parents[i];
+      in_hierarchy[i] = i == from || parent == from ||
+                        (parent >= begin && in_hierarchy[parent]);
+      bool process = in_hierarchy[i];
+      if (_Incremental) {
+        const bool parent_dirty =
+            parent >= begin ? _dirty[parent]
+                            : (parent == from && parent != Skeleton::kNoParent);
+        process &= _job.input_dirty[i] || parent_dirty;
+        _dirty[i] = process;
+      } else if (_dirty) {
+        _dirty[i] = process;
+      }
+      recompute[i & 3] = process;
+      num_recomputed += process;
+    }
+
+    // Nothing to do for this soa group.
+    if (num_recomputed == 0) {
+      continue;
+    }
+
     // Builds soa matrices from soa transforms.
-    const math::SoaTransform& transform = input[i / 4];
+    const math::SoaTransform& transform = _job.input[soa_begin / 4];
     const math::SoaFloat4x4 local_soa_matrices = math::SoaFloat4x4::FromAffine(
         transform.translation, transform.rotation, transform.scale);
 
-    // Converts to aos matrices.
-    math::Float4x4 local_aos_matrices[4];
-    math::Transpose16x16(&local_soa_matrices.cols[0].x,
-                         local_aos_matrices->cols);
+    if (num_recomputed == 4 && parents[soa_begin + 3] < soa_begin) {
+      // Joints are independent, gathers parents to multiply in soa.
+      const _Matrix* parent_matrices[4];
+      for (int j = 0; j < 4; ++j) {
+        const int parent = parents[soa_begin + j];
+        parent_matrices[j] =
+            parent == Skeleton::kNoParent ? &_root : &_output[parent];
+      }
+      math::SoaFloat4x4 parent_soa_matrices;
+      ToSoa(parent_matrices, &parent_soa_matrices);
+      MultiplySoa(parent_soa_matrices, local_soa_matrices,
+                  &_output[soa_begin]);
+      continue;
+    }
 
-    // parents[i] >= from is true as long as "i" is a child of "from".
-    for (const int soa_end = (i + 4) & ~3; i < soa_end && process;
-         ++i, process = i < end && parents[i] >= from) {
-      const int parent = parents[i];
-      const math::Float4x4* parent_matrix =
-          parent == Skeleton::kNoParent ? root_matrix : &output[parent];
-      output[i] = *parent_matrix * local_aos_matrices[i & 3];
+    // Converts to aos matrices, and multiplies joints one by one.
+    _Matrix local_aos_matrices[4];
+    ToAos(local_soa_matrices, local_aos_matrices);
+    for (int j = soa_begin; j < soa_end; ++j) {
+      if (recompute[j & 3]) {
+        const int parent = parents[j];
+        const _Matrix& parent_matrix =
+            parent == Skeleton::kNoParent ? _root : _output[parent];
+        _output[j] = parent_matrix * local_aos_matrices[j & 3];
+      }
+    }
+  }
+}
+
+template <typename _Matrix>
+void Process(const LocalToModelJob& _job, const span<_Matrix>& _output,
+             const _Matrix& _root) {
+  const bool level_ordered = !_job.skeleton->joint_levels().empty();
+  if (!_job.input_dirty.empty()) {
+    // Dirty flags are propagated in output_dirty if available.
+    bool dirty[Skeleton::kMaxJoints];
+    bool* flags = _job.output_dirty.empty() ? dirty : _job.output_dirty.data();
+    if (level_ordered) {
+      ProcessLevelOrdered<_Matrix, true>(_job, _output, _root, flags);
+    } else {
+      Process<_Matrix, true>(_job, _output, _root, flags);
+    }
+  } else {
+    bool* flags =
+        _job.output_dirty.empty() ? nullptr : _job.output_dirty.data();
+    if (level_ordered) {
+      ProcessLevelOrdered<_Matrix, false>(_job, _output, _root, flags);
+    } else {
+      Process<_Matrix, false>(_job, _output, _root, flags);
+    }
+  }
+}
+}  // namespace
+
+bool LocalToModelJob::Run() const {
+  if (!Validate()) {
+    return false;
+  }
+
+  // Output flags are set for recomputed joints only.
+  if (!output_dirty.empty()) {
+    std::fill(output_dirty.begin(),
+              output_dirty.begin() + skeleton->num_joints(), false);
+  }
+
+  // Root matrix is used to compute roots model matrices without requiring a
+  // branch.
+  const math::Float4x4 root_matrix =
+      (root == nullptr) ? math::Float4x4::identity() : *root;
+
+  if (output_3x4.empty()) {
+    Process(*this, output, root_matrix);
+  } else {
+    Process(*this, output_3x4, math::Float3x4::FromFloat4x4(root_matrix));
+  }
+  return true;
+}
+
+ParallelLocalToModelJob::ParallelLocalToModelJob()
+    : skeleton(nullptr), partition(nullptr), root(nullptr) {}
+
+bool ParallelLocalToModelJob::Validate() const {
+  if (!skeleton || !partition) {
+    return false;
+  }
+  bool valid = partition->num_joints() == skeleton->num_joints();
+
+  // Inputs and outputs are validated the same way as LocalToModelJob.
+  LocalToModelJob job;
+  job.skeleton = skeleton;
+  job.input = input;
+  job.output = output;
+  job.output_3x4 = output_3x4;
+  valid &= job.Validate();
+
+  return valid;
+}
+
+namespace {
+// Computes model-space matrices of contiguous joints [_from,_to]. The parent
+// of every joint must either be in the range, or already computed.
+template <typename _Matrix>
+void ProcessRange(const ParallelLocalToModelJob& _job,
+                  const span<_Matrix>& _output, const _Matrix& _root,
+                  const SkeletonPartition::JointRange& _range) {
+  const span<const int16_t>& parents = _job.skeleton->joint_parents();
+  LocalAosMatrices<_Matrix> local_matrices(_job.input, _range.to / 4 + 1);
+  for (int soa_begin = _range.from & ~3; soa_begin <= _range.to;
+       soa_begin += 4) {
+    // Builds aos matrices from soa transforms.
+    const _Matrix* local_aos_matrices = local_matrices.Get(soa_begin / 4);
+
+    const int end = math::Min(soa_begin + 3, static_cast<int>(_range.to));
+    for (int j = math::Max(soa_begin, static_cast<int>(_range.from)); j <= end;
+         ++j) {
+      const int parent = parents[j];
+      const _Matrix& parent_matrix =
+          parent == Skeleton::kNoParent ? _root : _output[parent];
+      _output[j] = parent_matrix * local_aos_matrices[j & 3];
+    }
+  }
+}
+
+// Computes all joint ranges of a partition. Partitions are independent, so
+// tasks write to different output joints.
+template <typename _Matrix>
+class PartitionTask {
+ public:
+  PartitionTask(const ParallelLocalToModelJob& _job,
+                const span<_Matrix>& _output, const _Matrix& _root)
+      : job_(&_job), output_(_output), root_(&_root) {}
+
+  void operator()(int _index) const {
+    for (const SkeletonPartition::JointRange& range :
+         job_->partition->joints(_index)) {
+      ProcessRange(*job_, output_, *root_, range);
     }
   }
+
+ private:
+  const ParallelLocalToModelJob* job_;
+  span<_Matrix> output_;
+  const _Matrix* root_;
+};
+
+template <typename _Matrix>
+void Process(const ParallelLocalToModelJob& _job, const span<_Matrix>& _output,
+             const _Matrix& _root) {
+  // Shared ancestors are computed first, on the calling thread.
+  for (const SkeletonPartition::JointRange& range :
+       _job.partition->shared_joints()) {
+    ProcessRange(_job, _output, _root, range);
+  }
+
+  // Partitions only depend on shared ancestors, they're computed as
+  // independent tasks.
+  const PartitionTask<_Matrix> task(_job, _output, _root);
+  const int num_tasks = _job.partition->num_partitions();
+  if (_job.task_runner) {
+    _job.task_runner(num_tasks, task);
+  } else {
+    for (int i = 0; i < num_tasks; ++i) {
+      task(i);
+    }
+  }
+}
+}  // namespace
+
+bool ParallelLocalToModelJob::Run() const {
+  if (!Validate()) {
+    return false;
+  }
+
+  const math::Float4x4 root_matrix =
+      (root == nullptr) ? math::Float4x4::identity() : *root;
+
+  if (output_3x4.empty()) {
+    Process(*this, output, root_matrix);
+  } else {
+    Process(*this, output_3x4, math::Float3x4::FromFloat4x4(root_matrix));
+  }
   return true;
 }
 }  // namespace animation
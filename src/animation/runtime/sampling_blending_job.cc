@@ -0,0 +1,393 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#include "ozz/animation/runtime/sampling_blending_job.h"
+
+#include <cassert>
+#include <cstddef>
+
+#include "ozz/animation/runtime/animation.h"
+#include "ozz/animation/runtime/sampling_job.h"
+#include "ozz/base/maths/math_ex.h"
+#include "ozz/base/maths/soa_transform.h"
+
+// Internal include file
+#define OZZ_INCLUDE_PRIVATE_HEADER  // Allows to include private headers.
+#include "animation/runtime/blending_job_passes.h"
+
+namespace ozz {
+namespace animation {
+
+SamplingBlendingJob::Layer::Layer()
+    : weight(0.f), animation(nullptr), cache(nullptr), ratio(0.f) {}
+
+SamplingBlendingJob::SamplingBlendingJob() : threshold(.1f) {}
+
+namespace {
+bool ValidateLayer(const SamplingBlendingJob::Layer& _layer,
+                   size_t _min_range) {
+  // Test for nullptr pointers.
+  if (!_layer.animation || !_layer.cache) {
+    return false;
+  }
+
+  bool valid = true;
+
+  // Tests animation and cache sizes.
+  const int num_soa_tracks = _layer.animation->num_soa_tracks();
+  valid &= static_cast<size_t>(num_soa_tracks) >= _min_range;
+  valid &= _layer.cache->max_soa_tracks() >= num_soa_tracks;
+
+  // Joint weights are optional.
+  if (!_layer.joint_weights.empty()) {
+    valid &= _layer.joint_weights.size() >= _min_range;
+  }
+  return valid;
+}
+}  // namespace
+
+bool SamplingBlendingJob::Validate() const {
+  // Don't need any early out, as jobs are valid in most of the performance
+  // critical cases.
+  // Tests are written in multiple lines in order to avoid branches.
+  bool valid = true;
+
+  // Test for valid threshold).
+  valid &= threshold > 0.f;
+
+  // Test for nullptr begin pointers.
+  valid &= !bind_pose.empty();
+  valid &= !output.empty();
+
+  // The bind pose size defines the ranges of transforms to blend, so all
+  // other buffers should be bigger.
+  const size_t min_range = bind_pose.size();
+  valid &= output.size() >= min_range;
+
+  // Validates layers.
+  for (const Layer& layer : layers) {
+    valid &= ValidateLayer(layer, min_range);
+  }
+
+  // Validates additive layers.
+  for (const Layer& layer : additive_layers) {
+    valid &= ValidateLayer(layer, min_range);
+  }
+
+  return valid;
+}
+
+namespace {
+
+// Number of soa joints processed per batch. Sampled transforms of a batch are
+// stored on the stack, so they remain in cpu cache until they're blended.
+const size_t kBatchSoaJoints = 16;
+
+// Defines parameters that are shared by all batches. They only depend on
+// layers weights, not on joints.
+struct SamplingBlendingArgs {
+  SamplingBlendingArgs(const SamplingBlendingJob& _job)
+      : job(_job),
+        num_soa_joints(_job.bind_pose.size()),
+        num_passes(0),
+        num_partial_passes(0),
+        accumulated_weight(0.f),
+        bind_pose_weight(0.f) {
+    // The range of all buffers has already been validated.
+    assert(job.output.size() >= num_soa_joints);
+
+    for (const SamplingBlendingJob::Layer& layer : job.layers) {
+      if (layer.weight <= 0.f) {
+        continue;
+      }
+      accumulated_weight += layer.weight;
+      num_partial_passes += !layer.joint_weights.empty();
+      ++num_passes;
+    }
+
+    // When there's no partial blending, bind pose threshold is tested
+    // globally. This also defines the weight used for normalization.
+    if (num_partial_passes == 0) {
+      bind_pose_weight = job.threshold - accumulated_weight;
+      if (bind_pose_weight > 0.f) {
+        accumulated_weight = num_passes == 0 ? 1.f : job.threshold;
+      }
+    }
+  }
+
+  // The job to process.
+  const SamplingBlendingJob& job;
+
+  // The number of transforms to process as defined by the size of the bind
+  // pose.
+  size_t num_soa_joints;
+
+  // Number of blended passes (excluding passes with a weight <= 0.f),
+  // including partial passes.
+  int num_passes;
+
+  // Number of partial blending passes (aka with a weight per-joint).
+  int num_partial_passes;
+
+  // The accumulated weight of all layers, including bind pose.
+  float accumulated_weight;
+
+  // Weight of the bind pose, only relevant without partial blending.
+  float bind_pose_weight;
+
+ private:
+  // Disables assignment operators.
+  SamplingBlendingArgs(const SamplingBlendingArgs&);
+  void operator=(const SamplingBlendingArgs&);
+};
+
+// Samples and blends soa joints [_from,_to[ of all layers to the output.
+// Follows BlendingJob stages, restricted to this range of joints.
+// _interpolate is the function used to interpolate a layer's sampled
+// animation.
+template <typename _Interpolate>
+void ProcessBatch(const SamplingBlendingArgs& _args, size_t _from, size_t _to,
+                  const _Interpolate& _interpolate) {
+  assert(_to - _from <= kBatchSoaJoints);
+  const SamplingBlendingJob& job = _args.job;
+  const size_t count = _to - _from;
+  const int from = static_cast<int>(_from);
+  const int to = static_cast<int>(_to);
+  math::SoaTransform* output = job.output.begin() + _from;
+
+  // Stores sampled transforms of the current layer and per-joint accumulated
+  // weights.
+  math::SoaTransform sampled[kBatchSoaJoints];
+  math::SimdFloat4 accumulated_weights[kBatchSoaJoints];
+
+  // Blends all layers.
+  int num_passes = 0;
+  for (const SamplingBlendingJob::Layer& layer : job.layers) {
+    // Skip irrelevant layers.
+    if (layer.weight <= 0.f) {
+      continue;
+    }
+    _interpolate(layer, from, to, sampled);
+
+    const math::SimdFloat4 layer_weight =
+        math::simd_float4::Load1(layer.weight);
+    if (!layer.joint_weights.empty()) {
+      // This layer has per-joint weights.
+      const math::SimdFloat4* joint_weights =
+          layer.joint_weights.begin() + _from;
+      if (num_passes == 0) {
+        for (size_t i = 0; i < count; ++i) {
+          const math::SoaTransform& src = sampled[i];
+          math::SoaTransform* dest = output + i;
+          const math::SimdFloat4 weight =
+              layer_weight * math::Max0(joint_weights[i]);
+          accumulated_weights[i] = weight;
+          OZZ_BLEND_1ST_PASS(src, weight, dest);
+        }
+      } else {
+        for (size_t i = 0; i < count; ++i) {
+          const math::SoaTransform& src = sampled[i];
+          math::SoaTransform* dest = output + i;
+          const math::SimdFloat4 weight =
+              layer_weight * math::Max0(joint_weights[i]);
+          accumulated_weights[i] = accumulated_weights[i] + weight;
+          OZZ_BLEND_N_PASS(src, weight, dest);
+        }
+      }
+    } else {
+      // This is a full layer.
+      if (num_passes == 0) {
+        for (size_t i = 0; i < count; ++i) {
+          const math::SoaTransform& src = sampled[i];
+          math::SoaTransform* dest = output + i;
+          accumulated_weights[i] = layer_weight;
+          OZZ_BLEND_1ST_PASS(src, layer_weight, dest);
+        }
+      } else {
+        for (size_t i = 0; i < count; ++i) {
+          const math::SoaTransform& src = sampled[i];
+          math::SoaTransform* dest = output + i;
+          accumulated_weights[i] = accumulated_weights[i] + layer_weight;
+          OZZ_BLEND_N_PASS(src, layer_weight, dest);
+        }
+      }
+    }
+    ++num_passes;
+  }
+  assert(num_passes == _args.num_passes);
+
+  // Blends bind pose if accumulated weight is less than the threshold.
+  const math::SoaTransform* bind_pose = job.bind_pose.begin() + _from;
+  if (_args.num_partial_passes == 0) {
+    if (_args.bind_pose_weight > 0.f) {
+      if (_args.num_passes == 0) {
+        // Strictly copying bind-pose.
+        for (size_t i = 0; i < count; ++i) {
+          output[i] = bind_pose[i];
+        }
+      } else {
+        const math::SimdFloat4 simd_bp_weight =
+            math::simd_float4::Load1(_args.bind_pose_weight);
+        for (size_t i = 0; i < count; ++i) {
+          const math::SoaTransform& src = bind_pose[i];
+          math::SoaTransform* dest = output + i;
+          OZZ_BLEND_N_PASS(src, simd_bp_weight, dest);
+        }
+      }
+    }
+  } else {
+    // Threshold must be tested for each joint.
+    const math::SimdFloat4 threshold = math::simd_float4::Load1(job.threshold);
+    for (size_t i = 0; i < count; ++i) {
+      const math::SoaTransform& src = bind_pose[i];
+      math::SoaTransform* dest = output + i;
+      const math::SimdFloat4 bp_weight =
+          math::Max0(threshold - accumulated_weights[i]);
+      accumulated_weights[i] = math::Max(threshold, accumulated_weights[i]);
+      OZZ_BLEND_N_PASS(src, bp_weight, dest);
+    }
+  }
+
+  // Normalizes output.
+  if (_args.num_partial_passes == 0) {
+    const math::SimdFloat4 ratio =
+        math::simd_float4::Load1(1.f / _args.accumulated_weight);
+    for (size_t i = 0; i < count; ++i) {
+      OZZ_NORMALIZE_PASS(ratio, (&output[i]));
+    }
+  } else {
+    const math::SimdFloat4 one = math::simd_float4::one();
+    for (size_t i = 0; i < count; ++i) {
+      const math::SimdFloat4 ratio = one / accumulated_weights[i];
+      OZZ_NORMALIZE_PASS(ratio, (&output[i]));
+    }
+  }
+
+  // Process additive layers.
+  const math::SimdFloat4 one = math::simd_float4::one();
+  for (const SamplingBlendingJob::Layer& layer : job.additive_layers) {
+    // Skip layer if its weight is 0.
+    if (layer.weight == 0.f) {
+      continue;
+    }
+    _interpolate(layer, from, to, sampled);
+
+    const math::SimdFloat4* joint_weights =
+        layer.joint_weights.empty() ? nullptr
+                                    : layer.joint_weights.begin() + _from;
+    if (layer.weight > 0.f) {
+      // Weight is positive, need to perform additive blending.
+      const math::SimdFloat4 layer_weight =
+          math::simd_float4::Load1(layer.weight);
+      if (joint_weights) {
+        for (size_t i = 0; i < count; ++i) {
+          const math::SoaTransform& src = sampled[i];
+          math::SoaTransform& dest = output[i];
+          const math::SimdFloat4 weight =
+              layer_weight * math::Max0(joint_weights[i]);
+          const math::SimdFloat4 one_minus_weight = one - weight;
+          const math::SoaFloat3 one_minus_weight_f3 = {
+              one_minus_weight, one_minus_weight, one_minus_weight};
+          OZZ_ADD_PASS(src, weight, dest);
+        }
+      } else {
+        const math::SimdFloat4 one_minus_weight = one - layer_weight;
+        const math::SoaFloat3 one_minus_weight_f3 = {
+            one_minus_weight, one_minus_weight, one_minus_weight};
+        for (size_t i = 0; i < count; ++i) {
+          const math::SoaTransform& src = sampled[i];
+          math::SoaTransform& dest = output[i];
+          OZZ_ADD_PASS(src, layer_weight, dest);
+        }
+      }
+    } else {
+      // Weight is negative, need to perform subtractive blending.
+      const math::SimdFloat4 layer_weight =
+          math::simd_float4::Load1(-layer.weight);
+      if (joint_weights) {
+        for (size_t i = 0; i < count; ++i) {
+          const math::SoaTransform& src = sampled[i];
+          math::SoaTransform& dest = output[i];
+          const math::SimdFloat4 weight =
+              layer_weight * math::Max0(joint_weights[i]);
+          const math::SimdFloat4 one_minus_weight = one - weight;
+          OZZ_SUB_PASS(src, weight, dest);
+        }
+      } else {
+        const math::SimdFloat4 one_minus_weight = one - layer_weight;
+        for (size_t i = 0; i < count; ++i) {
+          const math::SoaTransform& src = sampled[i];
+          math::SoaTransform& dest = output[i];
+          OZZ_SUB_PASS(src, layer_weight, dest);
+        }
+      }
+    }
+  }
+}
+}  // namespace
+
+bool SamplingBlendingJob::Run() const {
+  if (!Validate()) {
+    return false;
+  }
+
+  // Samples all relevant layers, up to keyframes decompression. Interpolation
+  // is deferred to batches processing.
+  for (const Layer& layer : layers) {
+    if (layer.weight > 0.f) {
+      layer.cache->Update(*layer.animation, math::Clamp(0.f, layer.ratio, 1.f),
+                          nullptr);
+    }
+  }
+  for (const Layer& layer : additive_layers) {
+    if (layer.weight != 0.f) {
+      layer.cache->Update(*layer.animation, math::Clamp(0.f, layer.ratio, 1.f),
+                          nullptr);
+    }
+  }
+
+  // Initializes blending parameters that are shared across batches.
+  const SamplingBlendingArgs blending_args(*this);
+
+  // Interpolation function, which has access to cache internals.
+  const auto interpolate = [](const Layer& _layer, int _from, int _to,
+                              math::SoaTransform* _output) {
+    _layer.cache->Interpolate(_from, _to, nullptr, _output);
+  };
+
+  // Samples and blends joints by batches.
+  for (size_t from = 0; from < blending_args.num_soa_joints;
+       from += kBatchSoaJoints) {
+    const size_t to =
+        math::Min(from + kBatchSoaJoints, blending_args.num_soa_joints);
+    ProcessBatch(blending_args, from, to, interpolate);
+  }
+
+  return true;
+}
+}  // namespace animation
+}  // namespace ozz
@@ -28,10 +28,12 @@
 #include "ozz/animation/runtime/sampling_job.h"
 
 #include <cassert>
+#include <cstring>
 
 #include "ozz/animation/runtime/animation.h"
 #include "ozz/base/maths/math_constant.h"
 #include "ozz/base/maths/math_ex.h"
+#include "ozz/base/maths/soa_math8.h"
 #include "ozz/base/maths/soa_transform.h"
 #include "ozz/base/memory/allocator.h"
 
@@ -71,10 +73,60 @@ bool SamplingJob::Validate() const {
   // Tests cache size.
   valid &= cache->max_soa_tracks() >= num_soa_tracks;
 
+  // Tests optional mask size.
+  valid &= soa_mask.empty() ||
+           soa_mask.size() >= static_cast<size_t>(num_soa_tracks);
+
   return valid;
 }
 
 namespace {
+// Flags all soa entries as outdated. It cares to only flag valid soa entries as
+// this is the exit condition of other algorithms.
+void OutdateAll(int _num_soa_tracks, unsigned char* _outdated) {
+  const int num_outdated_flags = (_num_soa_tracks + 7) / 8;
+  for (int i = 0; i < num_outdated_flags - 1; ++i) {
+    _outdated[i] = 0xff;
+  }
+  _outdated[num_outdated_flags - 1] =
+      0xff >> (num_outdated_flags * 8 - _num_soa_tracks);
+}
+
+// Uses animation seeking index to restore the cache state of the segment that
+// contains _ratio. This is done only if it allows to skip more keys than the
+// cost of restoring the cache, which is always the case when the cursor was
+// invalidated (because of backward sampling for example).
+void SeekCacheCursor(const Animation& _animation, float _ratio,
+                     const ozz::span<const int>& _seek, int* _cursor,
+                     int* _cache, unsigned char* _outdated) {
+  const int num_segments = _animation.num_seek_segments();
+  if (num_segments == 0) {
+    return;
+  }
+
+  // Finds the segment that contains _ratio. Fixes up possible float
+  // approximations, so that segment's ratio is never greater than _ratio.
+  int segment = math::Min(static_cast<int>(_ratio * num_segments),
+                          num_segments - 1);
+  while (segment > 0 && _animation.seek_ratio(segment) > _ratio) {
+    --segment;
+  }
+
+  // Seeks only if it's worth it.
+  const int num_soa_tracks = _animation.num_soa_tracks();
+  const int num_tracks = num_soa_tracks * 4;
+  const int stride = num_tracks * 2 + 1;
+  const int* entry = _seek.begin() + segment * stride;
+  if (*_cursor != 0 && entry[0] - *_cursor <= num_tracks * 2) {
+    return;
+  }
+
+  // Restores cursor and keys, every entry is now outdated.
+  *_cursor = entry[0];
+  std::memcpy(_cache, entry + 1, sizeof(int) * num_tracks * 2);
+  OutdateAll(num_soa_tracks, _outdated);
+}
+
 // Loops through the sorted key frames and update cache structure.
 template <typename _Key>
 void UpdateCacheCursor(float _ratio, int _num_soa_tracks,
@@ -104,14 +156,8 @@ void UpdateCacheCursor(float _ratio, int _num_soa_tracks,
     }
     cursor = _keys.begin() + num_tracks * 2;  // New cursor position.
 
-    // All entries are outdated. It cares to only flag valid soa entries as
-    // this is the exit condition of other algorithms.
-    const int num_outdated_flags = (_num_soa_tracks + 7) / 8;
-    for (int i = 0; i < num_outdated_flags - 1; ++i) {
-      _outdated[i] = 0xff;
-    }
-    _outdated[num_outdated_flags - 1] =
-        0xff >> (num_outdated_flags * 8 - _num_soa_tracks);
+    // All entries are outdated.
+    OutdateAll(_num_soa_tracks, _outdated);
   } else {
     cursor = _keys.begin() + *_cursor;  // Might be == end()
     assert(cursor >= _keys.begin() + num_tracks * 2 && cursor <= _keys.end());
@@ -140,11 +186,13 @@ void UpdateCacheCursor(float _ratio, int _num_soa_tracks,
   *_cursor = static_cast<int>(cursor - _keys.begin());
 }
 
+// Decompresses outdated soa entries. Entries disabled by _mask (if not
+// nullptr) remain outdated, so they are decompressed once enabled again.
 template <typename _Key, typename _InterpKey, typename _Decompress>
 void UpdateInterpKeyframes(int _num_soa_tracks,
                            const ozz::span<const _Key>& _keys,
-                           const int* _interp, uint8_t* _outdated,
-                           _InterpKey* _interp_keys,
+                           const int* _interp, const bool* _mask,
+                           uint8_t* _outdated, _InterpKey* _interp_keys,
                            const _Decompress& _decompress) {
   const int num_outdated_flags = (_num_soa_tracks + 7) / 8;
   for (int j = 0; j < num_outdated_flags; ++j) {
@@ -154,32 +202,65 @@ void UpdateInterpKeyframes(int _num_soa_tracks,
       if (!(outdated & 1)) {
         continue;
       }
+      if (_mask && !_mask[i]) {
+        _outdated[j] |= 1 << (i & 7);  // Skipped, so still outdated.
+        continue;
+      }
       const int base = i * 4 * 2;  // * soa size * 2 keys
 
-      // Decompress left side keyframes and store them in soa structures.
+      // Left side keyframes.
       const _Key& k00 = _keys[_interp[base + 0]];
       const _Key& k10 = _keys[_interp[base + 2]];
       const _Key& k20 = _keys[_interp[base + 4]];
       const _Key& k30 = _keys[_interp[base + 6]];
       _interp_keys[i].ratio[0] =
           math::simd_float4::Load(k00.ratio, k10.ratio, k20.ratio, k30.ratio);
-      _decompress(k00, k10, k20, k30, &_interp_keys[i].value[0]);
 
-      // Decompress right side keyframes and store them in soa structures.
+      // Right side keyframes.
       const _Key& k01 = _keys[_interp[base + 1]];
       const _Key& k11 = _keys[_interp[base + 3]];
       const _Key& k21 = _keys[_interp[base + 5]];
       const _Key& k31 = _keys[_interp[base + 7]];
       _interp_keys[i].ratio[1] =
           math::simd_float4::Load(k01.ratio, k11.ratio, k21.ratio, k31.ratio);
-      _decompress(k01, k11, k21, k31, &_interp_keys[i].value[1]);
+
+      // Decompress both sides keyframes and store them in soa structures.
+      const _Key* keys[8] = {&k00, &k10, &k20, &k30, &k01, &k11, &k21, &k31};
+      _decompress(keys, _interp_keys[i].value);
     }
   }
 }
 
-inline void DecompressFloat3(const Float3Key& _k0, const Float3Key& _k1,
-                             const Float3Key& _k2, const Float3Key& _k3,
-                             math::SoaFloat3* _soa_float3) {
+// Decompresses the 8 keys of _keys, the 4 first ones to _values[0] and the 4
+// last ones to _values[1].
+#if defined(OZZ_SIMD_AVX2)
+// 8 keys are decompressed at once with 8-wide simd.
+void DecompressFloat3(const Float3Key* const _keys[8],
+                      math::SoaFloat3 _values[2]) {
+  const Float3Key& k0 = *_keys[0];
+  const Float3Key& k1 = *_keys[1];
+  const Float3Key& k2 = *_keys[2];
+  const Float3Key& k3 = *_keys[3];
+  const Float3Key& k4 = *_keys[4];
+  const Float3Key& k5 = *_keys[5];
+  const Float3Key& k6 = *_keys[6];
+  const Float3Key& k7 = *_keys[7];
+  const math::Soa8Float3 values = {
+      math::HalfToFloat(math::simd_int8::Load(
+          k0.value[0], k1.value[0], k2.value[0], k3.value[0], k4.value[0],
+          k5.value[0], k6.value[0], k7.value[0])),
+      math::HalfToFloat(math::simd_int8::Load(
+          k0.value[1], k1.value[1], k2.value[1], k3.value[1], k4.value[1],
+          k5.value[1], k6.value[1], k7.value[1])),
+      math::HalfToFloat(math::simd_int8::Load(
+          k0.value[2], k1.value[2], k2.value[2], k3.value[2], k4.value[2],
+          k5.value[2], k6.value[2], k7.value[2]))};
+  math::Store(values, &_values[0], &_values[1]);
+}
+#else   // OZZ_SIMD_AVX2
+inline void DecompressSoaFloat3(const Float3Key& _k0, const Float3Key& _k1,
+                                const Float3Key& _k2, const Float3Key& _k3,
+                                math::SoaFloat3* _soa_float3) {
   _soa_float3->x = math::HalfToFloat(math::simd_int4::Load(
       _k0.value[0], _k1.value[0], _k2.value[0], _k3.value[0]));
   _soa_float3->y = math::HalfToFloat(math::simd_int4::Load(
@@ -188,14 +269,98 @@ inline void DecompressFloat3(const Float3Key& _k0, const Float3Key& _k1,
       _k0.value[2], _k1.value[2], _k2.value[2], _k3.value[2]));
 }
 
+void DecompressFloat3(const Float3Key* const _keys[8],
+                      math::SoaFloat3 _values[2]) {
+  DecompressSoaFloat3(*_keys[0], *_keys[1], *_keys[2], *_keys[3],
+                      &_values[0]);
+  DecompressSoaFloat3(*_keys[4], *_keys[5], *_keys[6], *_keys[7],
+                      &_values[1]);
+}
+#endif  // OZZ_SIMD_AVX2
+
 // Defines a mapping table that defines components assignation in the output
 // quaternion.
 constexpr int kCpntMapping[4][4] = {
     {0, 0, 1, 2}, {0, 0, 1, 2}, {0, 1, 0, 2}, {0, 1, 2, 0}};
 
-void DecompressQuaternion(const QuaternionKey& _k0, const QuaternionKey& _k1,
-                          const QuaternionKey& _k2, const QuaternionKey& _k3,
-                          math::SoaQuaternion* _quaternion) {
+#if defined(OZZ_SIMD_AVX2)
+// 8 keys are decompressed at once with 8-wide simd.
+void DecompressQuaternion(const QuaternionKey* const _keys[8],
+                          math::SoaQuaternion _values[2]) {
+  // Prepares an array of input values, according to the mapping required to
+  // restore quaternion largest component.
+  alignas(32) int cmp_keys[4][8];
+  for (int i = 0; i < 8; ++i) {
+    const QuaternionKey& key = *_keys[i];
+    const int* m = kCpntMapping[key.largest];
+    cmp_keys[0][i] = key.value[m[0]];
+    cmp_keys[1][i] = key.value[m[1]];
+    cmp_keys[2][i] = key.value[m[2]];
+    cmp_keys[3][i] = key.value[m[3]];
+
+    // Resets largest component to 0.
+    cmp_keys[key.largest][i] = 0;
+  }
+
+  // Rebuilds quaternion from quantized values.
+  const math::SimdFloat8 kInt2Float =
+      math::simd_float8::Load1(1.f / (32767.f * math::kSqrt2));
+  math::SimdFloat8 cpnt[4] = {
+      kInt2Float *
+          math::simd_float8::FromInt(math::simd_int8::LoadPtr(cmp_keys[0])),
+      kInt2Float *
+          math::simd_float8::FromInt(math::simd_int8::LoadPtr(cmp_keys[1])),
+      kInt2Float *
+          math::simd_float8::FromInt(math::simd_int8::LoadPtr(cmp_keys[2])),
+      kInt2Float *
+          math::simd_float8::FromInt(math::simd_int8::LoadPtr(cmp_keys[3])),
+  };
+
+  // Get back length of 4th component. Favors performance over accuracy by using
+  // x * RSqrtEst(x) instead of Sqrt(x).
+  // ww0 cannot be 0 because we 're recomputing the largest component.
+  const math::SimdFloat8 dot = cpnt[0] * cpnt[0] + cpnt[1] * cpnt[1] +
+                               cpnt[2] * cpnt[2] + cpnt[3] * cpnt[3];
+  const math::SimdFloat8 ww0 = math::Max(math::simd_float8::Load1(1e-16f),
+                                         math::simd_float8::one() - dot);
+  const math::SimdFloat8 w0 = ww0 * math::RSqrtEst(ww0);
+  // Re-applies 4th component' s sign.
+  const QuaternionKey& k0 = *_keys[0];
+  const QuaternionKey& k1 = *_keys[1];
+  const QuaternionKey& k2 = *_keys[2];
+  const QuaternionKey& k3 = *_keys[3];
+  const QuaternionKey& k4 = *_keys[4];
+  const QuaternionKey& k5 = *_keys[5];
+  const QuaternionKey& k6 = *_keys[6];
+  const QuaternionKey& k7 = *_keys[7];
+  const math::SimdInt8 sign =
+      math::ShiftL(math::simd_int8::Load(k0.sign, k1.sign, k2.sign, k3.sign,
+                                         k4.sign, k5.sign, k6.sign, k7.sign),
+                   31);
+  const math::SimdFloat8 restored = math::Or(w0, sign);
+
+  // Re-injects the largest component inside the SoA structure.
+  const math::SimdInt8 largest =
+      math::simd_int8::Load(k0.largest, k1.largest, k2.largest, k3.largest,
+                            k4.largest, k5.largest, k6.largest, k7.largest);
+  for (int i = 0; i < 4; ++i) {
+    const math::SimdInt8 mask =
+        math::CmpEq(largest, math::simd_int8::Load1(i));
+    cpnt[i] = math::Or(cpnt[i], math::And(restored, mask));
+  }
+
+  // Stores result.
+  math::Store(cpnt[0], &_values[0].x, &_values[1].x);
+  math::Store(cpnt[1], &_values[0].y, &_values[1].y);
+  math::Store(cpnt[2], &_values[0].z, &_values[1].z);
+  math::Store(cpnt[3], &_values[0].w, &_values[1].w);
+}
+#else   // OZZ_SIMD_AVX2
+void DecompressSoaQuaternion(const QuaternionKey& _k0,
+                             const QuaternionKey& _k1,
+                             const QuaternionKey& _k2,
+                             const QuaternionKey& _k3,
+                             math::SoaQuaternion* _quaternion) {
   // Selects proper mapping for each key.
   const int* m0 = kCpntMapping[_k0.largest];
   const int* m1 = kCpntMapping[_k1.largest];
@@ -262,33 +427,179 @@ void DecompressQuaternion(const QuaternionKey& _k0, const QuaternionKey& _k1,
   _quaternion->w = cpnt[3];
 }
 
+void DecompressQuaternion(const QuaternionKey* const _keys[8],
+                          math::SoaQuaternion _values[2]) {
+  DecompressSoaQuaternion(*_keys[0], *_keys[1], *_keys[2], *_keys[3],
+                          &_values[0]);
+  DecompressSoaQuaternion(*_keys[4], *_keys[5], *_keys[6], *_keys[7],
+                          &_values[1]);
+}
+#endif  // OZZ_SIMD_AVX2
+
+// Interpolates soa entry _i.
+inline void InterpolateSoa(math::_SimdFloat4 _anim_ratio, int _i,
+                           const internal::InterpSoaFloat3* _translations,
+                           const internal::InterpSoaQuaternion* _rotations,
+                           const internal::InterpSoaFloat3* _scales,
+                           math::SoaTransform* _output) {
+  // Prepares interpolation coefficients.
+  const math::SimdFloat4 interp_t_ratio =
+      (_anim_ratio - _translations[_i].ratio[0]) *
+      math::RcpEst(_translations[_i].ratio[1] - _translations[_i].ratio[0]);
+  const math::SimdFloat4 interp_r_ratio =
+      (_anim_ratio - _rotations[_i].ratio[0]) *
+      math::RcpEst(_rotations[_i].ratio[1] - _rotations[_i].ratio[0]);
+  const math::SimdFloat4 interp_s_ratio =
+      (_anim_ratio - _scales[_i].ratio[0]) *
+      math::RcpEst(_scales[_i].ratio[1] - _scales[_i].ratio[0]);
+
+  // Processes interpolations.
+  // The lerp of the rotation uses the shortest path, because opposed
+  // quaternions were negated during animation build stage (AnimationBuilder).
+  _output[_i].translation = Lerp(_translations[_i].value[0],
+                                 _translations[_i].value[1], interp_t_ratio);
+  _output[_i].rotation = NLerpEst(_rotations[_i].value[0],
+                                  _rotations[_i].value[1], interp_r_ratio);
+  _output[_i].scale =
+      Lerp(_scales[_i].value[0], _scales[_i].value[1], interp_s_ratio);
+}
+
+#if defined(OZZ_SIMD_AVX2)
+// Loads interpolation ratios _side of soa entries _i and _i + 1.
+template <typename _InterpKey>
+OZZ_INLINE math::SimdFloat8 LoadRatio8(const _InterpKey* _keys, int _i,
+                                       int _side) {
+  return math::simd_float8::Load(_keys[_i].ratio[_side],
+                                 _keys[_i + 1].ratio[_side]);
+}
+
+// Interpolates soa entries _i and _i + 1 at once, with 8-wide simd.
+inline void InterpolateSoa8(math::_SimdFloat8 _anim_ratio, int _i,
+                            const internal::InterpSoaFloat3* _translations,
+                            const internal::InterpSoaQuaternion* _rotations,
+                            const internal::InterpSoaFloat3* _scales,
+                            math::SoaTransform* _output) {
+  // Prepares interpolation coefficients.
+  const math::SimdFloat8 t_ratio0 = LoadRatio8(_translations, _i, 0);
+  const math::SimdFloat8 interp_t_ratio =
+      (_anim_ratio - t_ratio0) *
+      math::RcpEst(LoadRatio8(_translations, _i, 1) - t_ratio0);
+  const math::SimdFloat8 r_ratio0 = LoadRatio8(_rotations, _i, 0);
+  const math::SimdFloat8 interp_r_ratio =
+      (_anim_ratio - r_ratio0) *
+      math::RcpEst(LoadRatio8(_rotations, _i, 1) - r_ratio0);
+  const math::SimdFloat8 s_ratio0 = LoadRatio8(_scales, _i, 0);
+  const math::SimdFloat8 interp_s_ratio =
+      (_anim_ratio - s_ratio0) *
+      math::RcpEst(LoadRatio8(_scales, _i, 1) - s_ratio0);
+
+  // Processes interpolations, the same way as InterpolateSoa.
+  const internal::InterpSoaFloat3* translations = _translations + _i;
+  const math::Soa8Float3 translation = Lerp(
+      math::Soa8Float3::Load(translations[0].value[0],
+                             translations[1].value[0]),
+      math::Soa8Float3::Load(translations[0].value[1],
+                             translations[1].value[1]),
+      interp_t_ratio);
+  const internal::InterpSoaQuaternion* rotations = _rotations + _i;
+  const math::Soa8Quaternion rotation = NLerpEst(
+      math::Soa8Quaternion::Load(rotations[0].value[0],
+                                 rotations[1].value[0]),
+      math::Soa8Quaternion::Load(rotations[0].value[1],
+                                 rotations[1].value[1]),
+      interp_r_ratio);
+  const internal::InterpSoaFloat3* scales = _scales + _i;
+  const math::Soa8Float3 scale =
+      Lerp(math::Soa8Float3::Load(scales[0].value[0], scales[1].value[0]),
+           math::Soa8Float3::Load(scales[0].value[1], scales[1].value[1]),
+           interp_s_ratio);
+
+  math::SoaTransform* output = _output + _i;
+  math::Store(translation, &output[0].translation, &output[1].translation);
+  math::Store(rotation, &output[0].rotation, &output[1].rotation);
+  math::Store(scale, &output[0].scale, &output[1].scale);
+}
+#endif  // OZZ_SIMD_AVX2
+
 void Interpolates(float _anim_ratio, int _num_soa_tracks,
                   const internal::InterpSoaFloat3* _translations,
                   const internal::InterpSoaQuaternion* _rotations,
-                  const internal::InterpSoaFloat3* _scales,
+                  const internal::InterpSoaFloat3* _scales, const bool* _mask,
                   math::SoaTransform* _output) {
   const math::SimdFloat4 anim_ratio = math::simd_float4::Load1(_anim_ratio);
-  for (int i = 0; i < _num_soa_tracks; ++i) {
-    // Prepares interpolation coefficients.
-    const math::SimdFloat4 interp_t_ratio =
-        (anim_ratio - _translations[i].ratio[0]) *
-        math::RcpEst(_translations[i].ratio[1] - _translations[i].ratio[0]);
-    const math::SimdFloat4 interp_r_ratio =
-        (anim_ratio - _rotations[i].ratio[0]) *
-        math::RcpEst(_rotations[i].ratio[1] - _rotations[i].ratio[0]);
-    const math::SimdFloat4 interp_s_ratio =
-        (anim_ratio - _scales[i].ratio[0]) *
-        math::RcpEst(_scales[i].ratio[1] - _scales[i].ratio[0]);
-
-    // Processes interpolations.
-    // The lerp of the rotation uses the shortest path, because opposed
-    // quaternions were negated during animation build stage (AnimationBuilder).
-    _output[i].translation = Lerp(_translations[i].value[0],
-                                  _translations[i].value[1], interp_t_ratio);
-    _output[i].rotation = NLerpEst(_rotations[i].value[0],
-                                   _rotations[i].value[1], interp_r_ratio);
-    _output[i].scale =
-        Lerp(_scales[i].value[0], _scales[i].value[1], interp_s_ratio);
+  int i = 0;
+#if defined(OZZ_SIMD_AVX2)
+  // Soa entries are interpolated 2 by 2 with 8-wide simd.
+  const math::SimdFloat8 anim_ratio8 = math::simd_float8::Load1(_anim_ratio);
+  for (; i < _num_soa_tracks - 1; i += 2) {
+    if (!_mask || (_mask[i] && _mask[i + 1])) {
+      InterpolateSoa8(anim_ratio8, i, _translations, _rotations, _scales,
+                      _output);
+    } else if (_mask[i] || _mask[i + 1]) {
+      // Only one entry is enabled.
+      InterpolateSoa(anim_ratio, _mask[i] ? i : i + 1, _translations,
+                     _rotations, _scales, _output);
+    }
+  }
+#endif  // OZZ_SIMD_AVX2
+  for (; i < _num_soa_tracks; ++i) {
+    if (_mask && !_mask[i]) {
+      continue;  // Output is left unchanged for disabled tracks.
+    }
+    InterpolateSoa(anim_ratio, i, _translations, _rotations, _scales,
+                   _output);
+  }
+}
+
+// Copies outdated soa entries from _src interpolation keys, instead of
+// decompressing them again. This is valid only if _src cache points to the
+// same keys, which is the case if both caches have the same cursor.
+template <typename _InterpKey>
+void CopyInterpKeyframes(int _num_soa_tracks, const _InterpKey* _src,
+                         uint8_t* _outdated, _InterpKey* _interp_keys) {
+  const int num_outdated_flags = (_num_soa_tracks + 7) / 8;
+  for (int j = 0; j < num_outdated_flags; ++j) {
+    uint8_t outdated = _outdated[j];
+    _outdated[j] = 0;  // Reset outdated entries as all will be processed.
+    for (int i = j * 8; outdated; ++i, outdated >>= 1) {
+      if (outdated & 1) {
+        _interp_keys[i] = _src[i];
+      }
+    }
+  }
+}
+
+// Updates cache cursor and interpolated keyframes of a single transform type
+// (translation, rotation or scale), for all instances of a batch.
+template <typename _Key, typename _InterpKey, typename _Decompress>
+void UpdateBatch(const Animation& _animation, const span<const _Key>& _keys,
+                 const span<const int>& _seek, const span<const float>& _ratios,
+                 const span<SamplingCache* const>& _caches,
+                 int SamplingCache::*_cursor, int* SamplingCache::*_cache_keys,
+                 uint8_t* SamplingCache::*_outdated,
+                 _InterpKey* SamplingCache::*_interp_keys,
+                 const _Decompress& _decompress) {
+  const int num_soa_tracks = _animation.num_soa_tracks();
+  const SamplingCache* previous = nullptr;
+  for (size_t i = 0; i < _caches.size(); ++i) {
+    SamplingCache& cache = *_caches[i];
+    const float anim_ratio = math::Clamp(0.f, _ratios[i], 1.f);
+    SeekCacheCursor(_animation, anim_ratio, _seek, &(cache.*_cursor),
+                    cache.*_cache_keys, cache.*_outdated);
+    UpdateCacheCursor(anim_ratio, num_soa_tracks, _keys, &(cache.*_cursor),
+                      cache.*_cache_keys, cache.*_outdated);
+
+    // Cache state only depends on the cursor position, so previous instance
+    // keyframes can be shared if cursors match.
+    if (previous && previous->*_cursor == cache.*_cursor) {
+      CopyInterpKeyframes(num_soa_tracks, previous->*_interp_keys,
+                          cache.*_outdated, cache.*_interp_keys);
+    } else {
+      UpdateInterpKeyframes(num_soa_tracks, _keys, cache.*_cache_keys,
+                            nullptr, cache.*_outdated, cache.*_interp_keys,
+                            _decompress);
+    }
+    previous = &cache;
   }
 }
 }  // namespace
@@ -308,36 +619,87 @@ bool SamplingJob::Run() const {
   // Clamps ratio in range [0,duration].
   const float anim_ratio = math::Clamp(0.f, ratio, 1.f);
 
-  // Step the cache to this potentially new animation and ratio.
+  // Step the cache to this potentially new animation and ratio, then fetch
+  // keys and decompress keyframes.
   assert(cache->max_soa_tracks() >= num_soa_tracks);
-  cache->Step(*animation, anim_ratio);
+  const bool* mask = soa_mask.empty() ? nullptr : soa_mask.begin();
+  cache->Update(*animation, anim_ratio, mask);
 
-  // Fetch key frames from the animation to the cache a r = anim_ratio.
-  // Then updates outdated soa hot values.
-  UpdateCacheCursor(anim_ratio, num_soa_tracks, animation->translations(),
-                    &cache->translation_cursor_, cache->translation_keys_,
-                    cache->outdated_translations_);
-  UpdateInterpKeyframes(num_soa_tracks, animation->translations(),
-                        cache->translation_keys_, cache->outdated_translations_,
-                        cache->soa_translations_, &DecompressFloat3);
-
-  UpdateCacheCursor(anim_ratio, num_soa_tracks, animation->rotations(),
-                    &cache->rotation_cursor_, cache->rotation_keys_,
-                    cache->outdated_rotations_);
-  UpdateInterpKeyframes(num_soa_tracks, animation->rotations(),
-                        cache->rotation_keys_, cache->outdated_rotations_,
-                        cache->soa_rotations_, &DecompressQuaternion);
-
-  UpdateCacheCursor(anim_ratio, num_soa_tracks, animation->scales(),
-                    &cache->scale_cursor_, cache->scale_keys_,
-                    cache->outdated_scales_);
-  UpdateInterpKeyframes(num_soa_tracks, animation->scales(), cache->scale_keys_,
-                        cache->outdated_scales_, cache->soa_scales_,
-                        &DecompressFloat3);
+  // Interpolates soa hot data.
+  cache->Interpolate(0, num_soa_tracks, mask, output.begin());
+
+  return true;
+}
+
+BatchSamplingJob::BatchSamplingJob() : animation(nullptr) {}
+
+bool BatchSamplingJob::Validate() const {
+  // Test for nullptr pointers.
+  if (!animation) {
+    return false;
+  }
+  bool valid = true;
+
+  // All instance ranges must match.
+  valid &= ratios.size() == caches.size();
+  valid &= outputs.size() == caches.size();
+  if (!valid) {
+    return false;
+  }
+
+  // Tests every instance cache and output size.
+  const size_t num_soa_tracks =
+      static_cast<size_t>(animation->num_soa_tracks());
+  for (size_t i = 0; i < caches.size(); ++i) {
+    const SamplingCache* cache = caches[i];
+    if (!cache) {
+      return false;
+    }
+    valid &= static_cast<size_t>(cache->max_soa_tracks()) >= num_soa_tracks;
+    valid &= !outputs[i].empty();
+    valid &= outputs[i].size() >= num_soa_tracks;
+  }
+
+  return valid;
+}
+
+bool BatchSamplingJob::Run() const {
+  if (!Validate()) {
+    return false;
+  }
+
+  const int num_soa_tracks = animation->num_soa_tracks();
+  if (num_soa_tracks == 0) {  // Early out if animation contains no joint.
+    return true;
+  }
+
+  // Step all caches to this potentially new animation and ratio.
+  for (size_t i = 0; i < caches.size(); ++i) {
+    caches[i]->Step(*animation, math::Clamp(0.f, ratios[i], 1.f));
+  }
+
+  // Updates each transform type for all instances in turn, so that animation
+  // keys remain in cpu cache.
+  UpdateBatch(*animation, animation->translations(),
+              animation->translations_seek(), ratios, caches,
+              &SamplingCache::translation_cursor_,
+              &SamplingCache::translation_keys_,
+              &SamplingCache::outdated_translations_,
+              &SamplingCache::soa_translations_, &DecompressFloat3);
+  UpdateBatch(*animation, animation->rotations(), animation->rotations_seek(),
+              ratios, caches, &SamplingCache::rotation_cursor_,
+              &SamplingCache::rotation_keys_,
+              &SamplingCache::outdated_rotations_,
+              &SamplingCache::soa_rotations_, &DecompressQuaternion);
+  UpdateBatch(*animation, animation->scales(), animation->scales_seek(),
+              ratios, caches, &SamplingCache::scale_cursor_,
+              &SamplingCache::scale_keys_, &SamplingCache::outdated_scales_,
+              &SamplingCache::soa_scales_, &DecompressFloat3);
 
   // Interpolates soa hot data.
-  Interpolates(anim_ratio, num_soa_tracks, cache->soa_translations_,
-               cache->soa_rotations_, cache->soa_scales_, output.begin());
+  for (size_t i = 0; i < caches.size(); ++i) {
+    caches[i]->Interpolate(0, num_soa_tracks, nullptr, outputs[i].begin());
+  }
 
   return true;
 }
@@ -441,6 +803,53 @@ void SamplingCache::Step(const Animation& _animation, float _ratio) {
   ratio_ = _ratio;
 }
 
+void SamplingCache::Update(const Animation& _animation, float _ratio,
+                           const bool* _mask) {
+  const int num_soa_tracks = _animation.num_soa_tracks();
+  assert(max_soa_tracks_ >= num_soa_tracks && num_soa_tracks > 0);
+
+  // Step the cache to this potentially new animation and ratio.
+  Step(_animation, _ratio);
+
+  // Fetch key frames from the animation to the cache a r = _ratio.
+  // Seeking index is used first to skip keys when possible.
+  // Then updates outdated soa hot values.
+  SeekCacheCursor(_animation, _ratio, _animation.translations_seek(),
+                  &translation_cursor_, translation_keys_,
+                  outdated_translations_);
+  UpdateCacheCursor(_ratio, num_soa_tracks, _animation.translations(),
+                    &translation_cursor_, translation_keys_,
+                    outdated_translations_);
+  UpdateInterpKeyframes(num_soa_tracks, _animation.translations(),
+                        translation_keys_, _mask, outdated_translations_,
+                        soa_translations_, &DecompressFloat3);
+
+  SeekCacheCursor(_animation, _ratio, _animation.rotations_seek(),
+                  &rotation_cursor_, rotation_keys_, outdated_rotations_);
+  UpdateCacheCursor(_ratio, num_soa_tracks, _animation.rotations(),
+                    &rotation_cursor_, rotation_keys_, outdated_rotations_);
+  UpdateInterpKeyframes(num_soa_tracks, _animation.rotations(), rotation_keys_,
+                        _mask, outdated_rotations_, soa_rotations_,
+                        &DecompressQuaternion);
+
+  SeekCacheCursor(_animation, _ratio, _animation.scales_seek(), &scale_cursor_,
+                  scale_keys_, outdated_scales_);
+  UpdateCacheCursor(_ratio, num_soa_tracks, _animation.scales(),
+                    &scale_cursor_, scale_keys_, outdated_scales_);
+  UpdateInterpKeyframes(num_soa_tracks, _animation.scales(), scale_keys_,
+                        _mask, outdated_scales_, soa_scales_,
+                        &DecompressFloat3);
+}
+
+void SamplingCache::Interpolate(int _from, int _to, const bool* _mask,
+                                math::SoaTransform* _output) const {
+  assert(animation_ && _from >= 0 && _from <= _to &&
+         _to <= animation_->num_soa_tracks());
+  Interpolates(ratio_, _to - _from, soa_translations_ + _from,
+               soa_rotations_ + _from, soa_scales_ + _from,
+               _mask ? _mask + _from : nullptr, _output);
+}
+
 void SamplingCache::Invalidate() {
   animation_ = nullptr;
   ratio_ = 0.f;
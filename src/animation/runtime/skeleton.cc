@@ -36,10 +36,30 @@
 #include "ozz/base/maths/soa_transform.h"
 #include "ozz/base/memory/allocator.h"
 
+// Internal include file
+#define OZZ_INCLUDE_PRIVATE_HEADER  // Allows to include private headers.
+#include "animation/runtime/view_header.h"
+
 namespace ozz {
 namespace animation {
 
-Skeleton::Skeleton() {}
+namespace {
+// Header of skeleton views, followed by bind poses, parents and names
+// characters buffers.
+struct SkeletonViewHeader {
+  internal::ViewHeader base;
+  int32_t num_joints;
+  int32_t chars_count;
+};
+
+// Computes the size of skeleton view buffers.
+size_t ComputeViewBufferSize(size_t _num_joints, size_t _chars_count) {
+  return (_num_joints + 3) / 4 * sizeof(math::SoaTransform) +
+         _num_joints * sizeof(int16_t) + _chars_count;
+}
+}  // namespace
+
+Skeleton::Skeleton() : allocation_(nullptr) {}
 
 Skeleton::~Skeleton() { Deallocate(); }
 
@@ -65,13 +85,14 @@ char* Skeleton::Allocate(size_t _chars_size, size_t _num_joints) {
       num_soa_joints * sizeof(math::SoaTransform);
   const size_t names_size = _num_joints * sizeof(char*);
   const size_t joint_parents_size = _num_joints * sizeof(int16_t);
-  const size_t buffer_size =
-      names_size + _chars_size + joint_parents_size + joint_bind_poses_size;
+  const size_t joint_levels_size = (_num_joints + 1) * sizeof(int16_t);
+  const size_t buffer_size = names_size + _chars_size + joint_parents_size +
+                             joint_levels_size + joint_bind_poses_size;
 
   // Allocates whole buffer.
-  span<char> buffer = {static_cast<char*>(memory::default_allocator()->Allocate(
-                           buffer_size, alignof(math::SoaTransform))),
-                       buffer_size};
+  allocation_ = memory::default_allocator()->Allocate(
+      buffer_size, alignof(math::SoaTransform));
+  span<char> buffer = {static_cast<char*>(allocation_), buffer_size};
 
   // Serves larger alignment values first.
   // Bind pose first, biggest alignment.
@@ -80,8 +101,10 @@ char* Skeleton::Allocate(size_t _chars_size, size_t _num_joints) {
   // Then names array, second biggest alignment.
   joint_names_ = fill_span<char*>(buffer, _num_joints);
 
-  // Parents, third biggest alignment.
+  // Parents and levels, third biggest alignment. Levels span is shrunk to the
+  // actual number of levels by InitLevels.
   joint_parents_ = fill_span<int16_t>(buffer, _num_joints);
+  joint_levels_ = fill_span<int16_t>(buffer, _num_joints + 1);
 
   // Remaning buffer will be used to store joint names.
   assert(buffer.size_bytes() == _chars_size &&
@@ -90,10 +113,42 @@ char* Skeleton::Allocate(size_t _chars_size, size_t _num_joints) {
 }
 
 void Skeleton::Deallocate() {
-  memory::default_allocator()->Deallocate(as_writable_bytes(joint_bind_poses_).data());
+  memory::default_allocator()->Deallocate(allocation_);
+  allocation_ = nullptr;
   joint_bind_poses_ = {};
   joint_names_ = {};
   joint_parents_ = {};
+  joint_levels_ = {};
+}
+
+void Skeleton::InitLevels() {
+  const int num_joints = this->num_joints();
+  if (num_joints == 0) {
+    return;
+  }
+  assert(joint_levels_.size() >= static_cast<size_t>(num_joints) + 1);
+
+  // Joints are level ordered if parent indices are sorted, which implies that
+  // a joint is never deeper than the joints that follow it. Parents must also
+  // precede their children, which is expected from any skeleton, but is tested
+  // so that depth is always initialized.
+  int16_t depths[kMaxJoints];
+  int num_levels = 0;
+  for (int i = 0; i < num_joints; ++i) {
+    const int parent = joint_parents_[i];
+    if (parent >= i || (i > 0 && parent < joint_parents_[i - 1])) {
+      joint_levels_ = {};
+      return;
+    }
+    const int depth = parent == kNoParent ? 0 : depths[parent] + 1;
+    assert(depth == num_levels - 1 || depth == num_levels);
+    if (depth == num_levels) {
+      joint_levels_[num_levels++] = static_cast<int16_t>(i);
+    }
+    depths[i] = static_cast<int16_t>(depth);
+  }
+  joint_levels_[num_levels] = static_cast<int16_t>(num_joints);
+  joint_levels_ = {joint_levels_.data(), static_cast<size_t>(num_levels) + 1};
 }
 
 void Skeleton::Save(ozz::io::OArchive& _archive) const {
@@ -156,6 +211,113 @@ void Skeleton::Load(ozz::io::IArchive& _archive, uint32_t _version) {
 
   _archive >> ozz::io::MakeArray(joint_parents_);
   _archive >> ozz::io::MakeArray(joint_bind_poses_);
+
+  // Levels aren't serialized, as they can be deduced from parents.
+  InitLevels();
+}
+
+size_t Skeleton::view_size() const {
+  size_t chars_count = 0;
+  for (const char* name : joint_names_) {
+    chars_count += std::strlen(name) + 1;
+  }
+  return internal::ViewDataOffset<SkeletonViewHeader>() +
+         ComputeViewBufferSize(joint_parents_.size(), chars_count);
+}
+
+bool Skeleton::SaveView(span<char> _view) const {
+  const size_t size = view_size();
+  if (!IsAligned(_view.data(), internal::kViewAlignment) ||
+      _view.size() < size) {
+    return false;
+  }
+
+  // Header, padding included.
+  const size_t offset = internal::ViewDataOffset<SkeletonViewHeader>();
+  std::memset(_view.data(), 0, offset);
+  SkeletonViewHeader* header =
+      reinterpret_cast<SkeletonViewHeader*>(_view.data());
+  internal::InitViewHeader<Skeleton>(size, &header->base);
+  const int num_joints = this->num_joints();
+  const size_t chars_count =
+      size - offset - ComputeViewBufferSize(num_joints, 0);
+  header->num_joints = num_joints;
+  header->chars_count = static_cast<int32_t>(chars_count);
+
+  // Buffers. Names are all concatenated in the same buffer, starting at
+  // joint_names_[0].
+  span<char> buffer = {_view.data() + offset, size - offset};
+  internal::CopyToView<math::SoaTransform>(joint_bind_poses_, buffer);
+  internal::CopyToView<int16_t>(joint_parents_, buffer);
+  if (num_joints > 0) {
+    internal::CopyToView<char>({joint_names_[0], chars_count}, buffer);
+  }
+  assert(buffer.empty() && "Whole buffer should be consumned");
+
+  return true;
+}
+
+bool Skeleton::LoadView(span<const char> _view) {
+  // Deallocate skeleton in case it was already used before.
+  Deallocate();
+
+  const SkeletonViewHeader* header =
+      internal::ValidateViewHeader<Skeleton, SkeletonViewHeader>(_view);
+  if (!header || header->num_joints < 0 || header->chars_count < 0 ||
+      header->num_joints > kMaxJoints) {
+    log::Err() << "Invalid Skeleton view." << std::endl;
+    return false;
+  }
+
+  // Names characters are the last buffer, they must be null terminated.
+  const int num_joints = header->num_joints;
+  const size_t offset = internal::ViewDataOffset<SkeletonViewHeader>();
+  const size_t buffer_size =
+      ComputeViewBufferSize(num_joints, header->chars_count);
+  if (header->base.size != offset + buffer_size ||
+      (num_joints > 0 && (header->chars_count < num_joints ||
+                          _view[offset + buffer_size - 1] != 0))) {
+    log::Err() << "Invalid Skeleton view size." << std::endl;
+    return false;
+  }
+
+  // Early out if skeleton's empty.
+  if (num_joints == 0) {
+    return true;
+  }
+
+  // Runtime skeleton buffers are never written once loaded, so view memory can
+  // be bound, even if it's read-only.
+  span<char> buffer = {const_cast<char*>(_view.data()) + offset, buffer_size};
+  joint_bind_poses_ =
+      fill_span<math::SoaTransform>(buffer, (num_joints + 3) / 4);
+  joint_parents_ = fill_span<int16_t>(buffer, num_joints);
+
+  // Only names pointers and levels need to be allocated.
+  static_assert(alignof(char*) >= alignof(int16_t),
+                "Must serve larger alignment values first)");
+  const size_t allocation_size =
+      num_joints * sizeof(char*) + (num_joints + 1) * sizeof(int16_t);
+  allocation_ =
+      memory::default_allocator()->Allocate(allocation_size, alignof(char*));
+  span<char> allocation = {static_cast<char*>(allocation_), allocation_size};
+  joint_names_ = fill_span<char*>(allocation, num_joints);
+  joint_levels_ = fill_span<int16_t>(allocation, num_joints + 1);
+  InitLevels();
+
+  // Fixes up names pointers.
+  char* cursor = buffer.data();
+  for (int i = 0; i < num_joints; ++i) {
+    if (cursor >= buffer.end()) {
+      log::Err() << "Invalid Skeleton view names." << std::endl;
+      Deallocate();
+      return false;
+    }
+    joint_names_[i] = cursor;
+    cursor += std::strlen(cursor) + 1;
+  }
+
+  return true;
 }
 }  // namespace animation
 }  // namespace ozz
@@ -0,0 +1,181 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+
+#include "ozz/animation/runtime/skeleton_partition.h"
+
+#include <algorithm>
+#include <cassert>
+
+#include "ozz/animation/runtime/skeleton.h"
+#include "ozz/base/maths/math_ex.h"
+#include "ozz/base/memory/allocator.h"
+
+namespace ozz {
+namespace animation {
+
+SkeletonPartition::SkeletonPartition()
+    : num_joints_(0), allocation_(nullptr) {}
+
+SkeletonPartition::SkeletonPartition(const Skeleton& _skeleton,
+                                     int _max_partitions)
+    : num_joints_(0), allocation_(nullptr) {
+  Build(_skeleton, _max_partitions);
+}
+
+SkeletonPartition::~SkeletonPartition() {
+  memory::default_allocator()->Deallocate(allocation_);
+}
+
+span<const SkeletonPartition::JointRange> SkeletonPartition::joints(
+    int _partition) const {
+  assert(_partition >= 0 && _partition < num_partitions() &&
+         "Partition index out of range");
+  return {ranges_.data() + offsets_[_partition],
+          ranges_.data() + offsets_[_partition + 1]};
+}
+
+void SkeletonPartition::Build(const Skeleton& _skeleton,
+                              int _max_partitions) {
+  // Reset existing data.
+  memory::Allocator* allocator = memory::default_allocator();
+  allocator->Deallocate(allocation_);
+  allocation_ = nullptr;
+  offsets_ = {};
+  shared_ = {};
+  ranges_ = {};
+
+  const span<const int16_t>& parents = _skeleton.joint_parents();
+  num_joints_ = _skeleton.num_joints();
+  if (num_joints_ == 0) {
+    return;
+  }
+  const int max_partitions = math::Clamp(1, _max_partitions, num_joints_);
+
+  // Computes subtrees sizes. Parents are always before their children, in
+  // both depth-first and level order.
+  int sizes[Skeleton::kMaxJoints];
+  std::fill(sizes, sizes + num_joints_, 1);
+  for (int i = num_joints_ - 1; i > 0; --i) {
+    const int parent = parents[i];
+    if (parent != Skeleton::kNoParent) {
+      sizes[parent] += sizes[i];
+    }
+  }
+
+  // Joints whose subtree is bigger than a balanced partition are shared.
+  // Subtrees of all other joints are small enough, their roots are the
+  // children of shared joints (or skeleton roots).
+  const int max_subtree_size =
+      (num_joints_ + max_partitions - 1) / max_partitions;
+  int num_subtree_joints = 0;
+  for (int i = 0; i < num_joints_; ++i) {
+    const int parent = parents[i];
+    if (sizes[i] <= max_subtree_size &&
+        (parent == Skeleton::kNoParent || sizes[parent] > max_subtree_size)) {
+      num_subtree_joints += sizes[i];
+    }
+  }
+
+  // Assigns every joint to a partition, or to shared joints (-1). Subtrees
+  // are distributed in joint order, each to the partition that contains the
+  // middle of the subtree, so partitions are balanced and contiguous.
+  int partition_of[Skeleton::kMaxJoints];
+  int num_partitions = 0;
+  for (int i = 0, distributed = 0, last = -1; i < num_joints_; ++i) {
+    const int parent = parents[i];
+    if (sizes[i] > max_subtree_size) {
+      partition_of[i] = -1;
+    } else if (parent == Skeleton::kNoParent ||
+               sizes[parent] > max_subtree_size) {
+      const int partition = math::Min(
+          (distributed * 2 + sizes[i]) * max_partitions /
+              (num_subtree_joints * 2),
+          max_partitions - 1);
+      distributed += sizes[i];
+      // Skips empty partitions.
+      num_partitions += partition != last;
+      last = partition;
+      partition_of[i] = num_partitions - 1;
+    } else {
+      partition_of[i] = partition_of[parent];
+    }
+  }
+
+  // Splits joints in ranges of contiguous joints of the same partition.
+  JointRange ranges[Skeleton::kMaxJoints];
+  int num_ranges = 0;
+  int offsets[Skeleton::kMaxJoints + 1] = {};
+  for (int i = 0; i < num_joints_; ++i) {
+    if (i == 0 || partition_of[i] != partition_of[i - 1]) {
+      ranges[num_ranges].from = static_cast<int16_t>(i);
+      ++num_ranges;
+      // Counts ranges per partition, shared first.
+      ++offsets[partition_of[i] + 1];
+    }
+    ranges[num_ranges - 1].to = static_cast<int16_t>(i);
+  }
+  const int num_shared = offsets[0];
+
+  // Allocates all data at once. Alignment is guaranteed because memory is
+  // dispatched from the highest alignment requirement to the lowest.
+  static_assert(alignof(int) >= alignof(JointRange),
+                "Must serve larger alignment values first)");
+  const size_t size =
+      sizeof(int) * (num_partitions + 1) + sizeof(JointRange) * num_ranges;
+  char* cursor =
+      reinterpret_cast<char*>(allocator->Allocate(size, alignof(int)));
+  allocation_ = cursor;
+  offsets_ = {reinterpret_cast<int*>(cursor),
+              static_cast<size_t>(num_partitions + 1)};
+  cursor += offsets_.size_bytes();
+  shared_ = {reinterpret_cast<JointRange*>(cursor),
+             static_cast<size_t>(num_shared)};
+  cursor += shared_.size_bytes();
+  ranges_ = {reinterpret_cast<JointRange*>(cursor),
+             static_cast<size_t>(num_ranges - num_shared)};
+
+  // Computes partitions offsets, and sorts ranges by partition, keeping joint
+  // order.
+  offsets_[0] = 0;
+  for (int i = 0; i < num_partitions; ++i) {
+    offsets_[i + 1] = offsets_[i] + offsets[i + 1];
+  }
+  int shared_cursor = 0;
+  int cursors[Skeleton::kMaxJoints];
+  std::copy(offsets_.begin(), offsets_.end(), cursors);
+  for (int i = 0; i < num_ranges; ++i) {
+    const int partition = partition_of[ranges[i].from];
+    if (partition < 0) {
+      shared_[shared_cursor++] = ranges[i];
+    } else {
+      ranges_[cursors[partition]++] = ranges[i];
+    }
+  }
+}
+}  // namespace animation
+}  // namespace ozz
@@ -28,6 +28,7 @@
 #include "ozz/animation/runtime/track.h"
 
 #include <cassert>
+#include <cstring>
 
 #include "ozz/base/io/archive.h"
 #include "ozz/base/log.h"
@@ -35,13 +36,86 @@
 #include "ozz/base/maths/math_ex.h"
 #include "ozz/base/memory/allocator.h"
 
+// Internal include file
+#define OZZ_INCLUDE_PRIVATE_HEADER  // Allows to include private headers.
+#include "animation/runtime/track_quantization.h"
+#include "animation/runtime/view_header.h"
+
 namespace ozz {
 namespace animation {
 
 namespace internal {
 
+namespace {
+// Number of quantized values components per key.
+template <typename _ValueType>
+size_t QuantizedComponents(bool _quantized_values) {
+  return _quantized_values ? TrackQuantization<_ValueType>::kComponents : 0;
+}
+
+// Computes the size of the buffer required to store all track data.
+template <typename _ValueType, typename _Layout>
+size_t ComputeTrackBufferSize(const _Layout& _layout) {
+  const size_t keys = _layout.keys_count;
+  const size_t full_values = _layout.quantized_values ? 0 : keys;
+  const size_t full_ratios = _layout.quantized_ratios ? 0 : keys;
+  const size_t quantized_ratios = _layout.quantized_ratios ? keys : 0;
+  const size_t quantized_values =
+      keys * QuantizedComponents<_ValueType>(_layout.quantized_values);
+  return full_values * sizeof(_ValueType) +                 // values
+         full_ratios * sizeof(float) +                      // ratios
+         _layout.edges_count * sizeof(float) +              // edge ratios
+         quantized_ratios * sizeof(uint16_t) +              // quantized ratios
+         quantized_values * sizeof(uint16_t) +              // quantized values
+         (keys + 7) * sizeof(uint8_t) / 8 +                 // steps
+         (_layout.edges_count + 7) * sizeof(uint8_t) / 8 +  // edge rising
+         (_layout.name_len > 0 ? _layout.name_len + 1 : 0);
+}
+
+// Header of track views, followed by track buffers in Bind() order.
+struct TrackViewHeader {
+  ViewHeader base;
+  int32_t keys_count;
+  int32_t edges_count;
+  int32_t name_len;
+  int32_t has_edge_index;
+  float edge_threshold;
+  int32_t quantized_ratios;
+  int32_t quantized_values;
+};
+
+// Maps track value types to their runtime track type, which defines view tag
+// and version.
+template <typename _ValueType>
+struct TrackType;
+template <>
+struct TrackType<float> {
+  typedef FloatTrack Type;
+};
+template <>
+struct TrackType<math::Float2> {
+  typedef Float2Track Type;
+};
+template <>
+struct TrackType<math::Float3> {
+  typedef Float3Track Type;
+};
+template <>
+struct TrackType<math::Float4> {
+  typedef Float4Track Type;
+};
+template <>
+struct TrackType<math::Quaternion> {
+  typedef QuaternionTrack Type;
+};
+}  // namespace
+
 template <typename _ValueType>
-Track<_ValueType>::Track() : name_(nullptr) {}
+Track<_ValueType>::Track()
+    : edge_threshold_(0.f),
+      has_edge_index_(false),
+      name_(nullptr),
+      allocation_(nullptr) {}
 
 template <typename _ValueType>
 Track<_ValueType>::~Track() {
@@ -49,66 +123,103 @@ Track<_ValueType>::~Track() {
 }
 
 template <typename _ValueType>
-void Track<_ValueType>::Allocate(size_t _keys_count, size_t _name_len) {
-  assert(ratios_.size() == 0 && values_.size() == 0);
+void Track<_ValueType>::Allocate(const Layout& _layout) {
+  assert(allocation_ == nullptr && num_keys() == 0 && values_.size() == 0 &&
+         quantized_values_.size() == 0);
+
+  // Compute overall size and allocate a single buffer for all the data.
+  const size_t buffer_size = ComputeTrackBufferSize<_ValueType>(_layout);
+  allocation_ =
+      memory::default_allocator()->Allocate(buffer_size, alignof(_ValueType));
+  span<char> buffer = {static_cast<char*>(allocation_), buffer_size};
+
+  Bind(buffer, _layout);
+
+  assert(buffer.empty() && "Whole buffer should be consumned");
+}
 
+template <typename _ValueType>
+void Track<_ValueType>::Bind(span<char>& _buffer, const Layout& _layout) {
   // Distributes buffer memory while ensuring proper alignment (serves larger
   // alignment values first).
   static_assert(alignof(_ValueType) >= alignof(float) &&
-                    alignof(float) >= alignof(uint8_t),
+                    alignof(float) >= alignof(uint16_t) &&
+                    alignof(uint16_t) >= alignof(uint8_t),
                 "Must serve larger alignment values first)");
 
-  // Compute overall size and allocate a single buffer for all the data.
-  const size_t buffer_size = _keys_count * sizeof(_ValueType) +  // values
-                             _keys_count * sizeof(float) +       // ratios
-                             (_keys_count + 7) * sizeof(uint8_t) / 8 +  // steps
-                             (_name_len > 0 ? _name_len + 1 : 0);
-  span<char> buffer = {static_cast<char*>(memory::default_allocator()->Allocate(
-                           buffer_size, alignof(_ValueType))),
-                       buffer_size};
-
   // Fix up pointers. Serves larger alignment values first.
-  values_ = fill_span<_ValueType>(buffer, _keys_count);
-  ratios_ = fill_span<float>(buffer, _keys_count);
-  steps_ = fill_span<uint8_t>(buffer, (_keys_count + 7) / 8);
+  const size_t keys = _layout.keys_count;
+  const size_t quantized_ratios = _layout.quantized_ratios ? keys : 0;
+  const size_t quantized_values =
+      keys * QuantizedComponents<_ValueType>(_layout.quantized_values);
+  values_ = fill_span<_ValueType>(_buffer, _layout.quantized_values ? 0 : keys);
+  ratios_ = fill_span<float>(_buffer, keys - quantized_ratios);
+  edge_ratios_ = fill_span<float>(_buffer, _layout.edges_count);
+  quantized_ratios_ = fill_span<uint16_t>(_buffer, quantized_ratios);
+  quantized_values_ = fill_span<uint16_t>(_buffer, quantized_values);
+  steps_ = fill_span<uint8_t>(_buffer, (keys + 7) / 8);
+  edge_rising_ = fill_span<uint8_t>(_buffer, (_layout.edges_count + 7) / 8);
 
   // Let name be nullptr if track has no name. Allows to avoid allocating this
   // buffer in the constructor of empty animations.
-  name_ =
-      _name_len > 0 ? fill_span<char>(buffer, _name_len + 1).data() : nullptr;
-
-  assert(buffer.empty() && "Whole buffer should be consumned");
+  name_ = _layout.name_len > 0
+              ? fill_span<char>(_buffer, _layout.name_len + 1).data()
+              : nullptr;
 }
 
 template <typename _ValueType>
 void Track<_ValueType>::Deallocate() {
   // Deallocate everything at once.
-  memory::default_allocator()->Deallocate(as_writable_bytes(values_).data());
+  memory::default_allocator()->Deallocate(allocation_);
+  allocation_ = nullptr;
 
   values_ = {};
   ratios_ = {};
+  quantized_ratios_ = {};
+  quantized_values_ = {};
   steps_ = {};
+  edge_ratios_ = {};
+  edge_rising_ = {};
+  edge_threshold_ = 0.f;
+  has_edge_index_ = false;
   name_ = nullptr;
 }
 
 template <typename _ValueType>
 size_t Track<_ValueType>::size() const {
-  const size_t size = sizeof(*this) + values_.size_bytes() +
-                      ratios_.size_bytes() + steps_.size_bytes();
+  const size_t size =
+      sizeof(*this) + values_.size_bytes() + ratios_.size_bytes() +
+      quantized_ratios_.size_bytes() + quantized_values_.size_bytes() +
+      steps_.size_bytes() + edge_ratios_.size_bytes() +
+      edge_rising_.size_bytes();
   return size;
 }
 
 template <typename _ValueType>
 void Track<_ValueType>::Save(ozz::io::OArchive& _archive) const {
-  uint32_t num_keys = static_cast<uint32_t>(ratios_.size());
+  uint32_t num_keys = static_cast<uint32_t>(this->num_keys());
   _archive << num_keys;
 
   const size_t name_len = name_ ? std::strlen(name_) : 0;
   _archive << static_cast<int32_t>(name_len);
 
+  uint32_t num_edges = static_cast<uint32_t>(edge_ratios_.size());
+  _archive << num_edges;
+  _archive << has_edge_index_;
+  _archive << edge_threshold_;
+
+  const bool quantized_ratios = !quantized_ratios_.empty();
+  _archive << quantized_ratios;
+  const bool quantized_values = !quantized_values_.empty();
+  _archive << quantized_values;
+
   _archive << ozz::io::MakeArray(ratios_);
   _archive << ozz::io::MakeArray(values_);
+  _archive << ozz::io::MakeArray(quantized_ratios_);
+  _archive << ozz::io::MakeArray(quantized_values_);
   _archive << ozz::io::MakeArray(steps_);
+  _archive << ozz::io::MakeArray(edge_ratios_);
+  _archive << ozz::io::MakeArray(edge_rising_);
 
   _archive << ozz::io::MakeArray(name_, name_len);
 }
@@ -118,7 +229,7 @@ void Track<_ValueType>::Load(ozz::io::IArchive& _archive, uint32_t _version) {
   // Destroy animation in case it was already used before.
   Deallocate();
 
-  if (_version > 1) {
+  if (_version > 3) {
     log::Err() << "Unsupported Track version " << _version << "." << std::endl;
     return;
   }
@@ -129,11 +240,37 @@ void Track<_ValueType>::Load(ozz::io::IArchive& _archive, uint32_t _version) {
   int32_t name_len;
   _archive >> name_len;
 
-  Allocate(num_keys, name_len);
+  // Version 1 tracks have no edge index.
+  uint32_t num_edges = 0;
+  bool has_edge_index = false;
+  float edge_threshold = 0.f;
+  if (_version > 1) {
+    _archive >> num_edges;
+    _archive >> has_edge_index;
+    _archive >> edge_threshold;
+  }
+
+  // Tracks are quantized since version 3.
+  bool quantized_ratios = false;
+  bool quantized_values = false;
+  if (_version > 2) {
+    _archive >> quantized_ratios;
+    _archive >> quantized_values;
+  }
+
+  const Layout layout = {num_keys, quantized_ratios, quantized_values,
+                         num_edges, static_cast<size_t>(name_len)};
+  Allocate(layout);
+  has_edge_index_ = has_edge_index;
+  edge_threshold_ = edge_threshold;
 
   _archive >> ozz::io::MakeArray(ratios_);
   _archive >> ozz::io::MakeArray(values_);
+  _archive >> ozz::io::MakeArray(quantized_ratios_);
+  _archive >> ozz::io::MakeArray(quantized_values_);
   _archive >> ozz::io::MakeArray(steps_);
+  _archive >> ozz::io::MakeArray(edge_ratios_);
+  _archive >> ozz::io::MakeArray(edge_rising_);
 
   if (name_) {  // nullptr name_ is supported.
     _archive >> ozz::io::MakeArray(name_, name_len);
@@ -141,6 +278,94 @@ void Track<_ValueType>::Load(ozz::io::IArchive& _archive, uint32_t _version) {
   }
 }
 
+template <typename _ValueType>
+size_t Track<_ValueType>::view_size() const {
+  const size_t name_len = name_ ? std::strlen(name_) : 0;
+  const Layout layout = {num_keys(), !quantized_ratios_.empty(),
+                         !quantized_values_.empty(), edge_ratios_.size(),
+                         name_len};
+  return ViewDataOffset<TrackViewHeader>() +
+         ComputeTrackBufferSize<_ValueType>(layout);
+}
+
+template <typename _ValueType>
+bool Track<_ValueType>::SaveView(span<char> _view) const {
+  const size_t size = view_size();
+  if (!IsAligned(_view.data(), kViewAlignment) || _view.size() < size) {
+    return false;
+  }
+
+  // Header, padding included.
+  const size_t offset = ViewDataOffset<TrackViewHeader>();
+  std::memset(_view.data(), 0, offset);
+  TrackViewHeader* header = reinterpret_cast<TrackViewHeader*>(_view.data());
+  InitViewHeader<typename TrackType<_ValueType>::Type>(size, &header->base);
+  const size_t name_len = name_ ? std::strlen(name_) : 0;
+  header->keys_count = static_cast<int32_t>(num_keys());
+  header->edges_count = static_cast<int32_t>(edge_ratios_.size());
+  header->name_len = static_cast<int32_t>(name_len);
+  header->has_edge_index = has_edge_index_;
+  header->edge_threshold = edge_threshold_;
+  header->quantized_ratios = !quantized_ratios_.empty();
+  header->quantized_values = !quantized_values_.empty();
+
+  // Buffers, in the same order as Bind().
+  span<char> buffer = {_view.data() + offset, size - offset};
+  CopyToView<_ValueType>(values_, buffer);
+  CopyToView<float>(ratios_, buffer);
+  CopyToView<float>(edge_ratios_, buffer);
+  CopyToView<uint16_t>(quantized_ratios_, buffer);
+  CopyToView<uint16_t>(quantized_values_, buffer);
+  CopyToView<uint8_t>(steps_, buffer);
+  CopyToView<uint8_t>(edge_rising_, buffer);
+  if (name_len > 0) {
+    CopyToView<char>({name_, name_len + 1}, buffer);
+  }
+  assert(buffer.empty() && "Whole buffer should be consumned");
+
+  return true;
+}
+
+template <typename _ValueType>
+bool Track<_ValueType>::LoadView(span<const char> _view) {
+  // Destroy track in case it was already used before.
+  Deallocate();
+
+  typedef typename TrackType<_ValueType>::Type Type;
+  const TrackViewHeader* header =
+      ValidateViewHeader<Type, TrackViewHeader>(_view);
+  if (!header || header->keys_count < 0 || header->edges_count < 0 ||
+      header->name_len < 0) {
+    log::Err() << "Invalid Track view." << std::endl;
+    return false;
+  }
+
+  const size_t offset = ViewDataOffset<TrackViewHeader>();
+  const Layout layout = {static_cast<size_t>(header->keys_count),
+                         header->quantized_ratios != 0,
+                         header->quantized_values != 0,
+                         static_cast<size_t>(header->edges_count),
+                         static_cast<size_t>(header->name_len)};
+  const size_t buffer_size = ComputeTrackBufferSize<_ValueType>(layout);
+
+  // Name is the last buffer, it must be null terminated.
+  if (header->base.size != offset + buffer_size ||
+      (header->name_len > 0 && _view[offset + buffer_size - 1] != 0)) {
+    log::Err() << "Invalid Track view size." << std::endl;
+    return false;
+  }
+
+  // Runtime track buffers are never written once loaded, so view memory can be
+  // bound, even if it's read-only.
+  span<char> buffer = {const_cast<char*>(_view.data()) + offset, buffer_size};
+  Bind(buffer, layout);
+  assert(buffer.empty() && "Whole buffer should be consumned");
+  has_edge_index_ = header->has_edge_index != 0;
+  edge_threshold_ = header->edge_threshold;
+
+  return true;
+}
+
 // Explicitly instantiate supported tracks.
 template class Track<float>;
 template class Track<math::Float2>;
@@ -0,0 +1,81 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+
+#ifndef OZZ_ANIMATION_RUNTIME_TRACK_EDGE_H_
+#define OZZ_ANIMATION_RUNTIME_TRACK_EDGE_H_
+
+#ifndef OZZ_INCLUDE_PRIVATE_HEADER
+#error "This header is private, it cannot be included from public headers."
+#endif  // OZZ_INCLUDE_PRIVATE_HEADER
+
+#include <cassert>
+
+#include "ozz/base/maths/math_ex.h"
+#include "ozz/base/platform.h"
+
+namespace ozz {
+namespace animation {
+namespace internal {
+
+// Detects if the track curve segment from key 0 (ratio _tk0 and value _vk0) to
+// key 1 (ratio _tk1 and value _vk1) crosses _threshold, going forward. _step
+// is true if key 0 interpolation is kStep.
+// Returns true if an edge is detected, in which case _ratio receives the ratio
+// at which the curve crosses threshold, and _rising tells if the curve becomes
+// greater than threshold. This function is shared by TrackTriggeringJob and
+// TrackBuilder edge index, so that both find exactly the same edges.
+inline bool DetectTrackEdge(float _tk0, float _tk1, float _vk0, float _vk1,
+                            bool _step, float _threshold, float* _ratio,
+                            bool* _rising) {
+  if (_vk0 <= _threshold && _vk1 > _threshold) {
+    *_rising = true;
+  } else if (_vk0 > _threshold && _vk1 <= _threshold) {
+    *_rising = false;
+  } else {
+    return false;
+  }
+
+  if (_step) {
+    *_ratio = _tk1;
+  } else {
+    assert(_vk0 != _vk1);  // Won't divide by 0
+
+    // Finds where the curve crosses threshold value. This is the lerp
+    // equation, where we know the result and look for alpha, aka un-lerp.
+    const float alpha = (_threshold - _vk0) / (_vk1 - _vk0);
+
+    // Remaps to keyframes actual times. Result is clamped to the segment, so
+    // that edges remain sorted despite floating point approximations.
+    *_ratio = math::Clamp(_tk0, math::Lerp(_tk0, _tk1, alpha), _tk1);
+  }
+  return true;
+}
+}  // namespace internal
+}  // namespace animation
+}  // namespace ozz
+#endif  // OZZ_ANIMATION_RUNTIME_TRACK_EDGE_H_
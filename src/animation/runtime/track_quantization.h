@@ -0,0 +1,176 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+
+#ifndef OZZ_ANIMATION_RUNTIME_TRACK_QUANTIZATION_H_
+#define OZZ_ANIMATION_RUNTIME_TRACK_QUANTIZATION_H_
+
+#ifndef OZZ_INCLUDE_PRIVATE_HEADER
+#error "This header is private, it cannot be included from public headers."
+#endif  // OZZ_INCLUDE_PRIVATE_HEADER
+
+#include <cmath>
+
+#include "ozz/base/maths/math_constant.h"
+#include "ozz/base/maths/math_ex.h"
+#include "ozz/base/maths/quaternion.h"
+#include "ozz/base/maths/simd_math.h"
+#include "ozz/base/maths/vec_float.h"
+#include "ozz/base/platform.h"
+
+namespace ozz {
+namespace animation {
+namespace internal {
+
+// Quantized ratios are 16 bits unsigned normalized integers. Sampling ratios
+// are quantized the same way (rounded to nearest) to search quantized keys, so
+// a key is reached when sampling exactly at its original ratio.
+inline uint16_t QuantizeTrackRatio(float _ratio) {
+  return static_cast<uint16_t>(
+      math::Clamp(0.f, _ratio, 1.f) * 65535.f + .5f);
+}
+
+inline float DequantizeTrackRatio(uint16_t _ratio) {
+  return _ratio * (1.f / 65535.f);
+}
+
+// Defines how track values are quantized to kComponents 16 bits integers.
+// Float values are stored as half floats.
+template <typename _ValueType>
+struct TrackQuantization;
+
+template <>
+struct TrackQuantization<float> {
+  enum { kComponents = 1 };
+  static void Quantize(float _value, uint16_t* _quantized) {
+    _quantized[0] = math::FloatToHalf(_value);
+  }
+  static float Dequantize(const uint16_t* _quantized) {
+    return math::HalfToFloat(_quantized[0]);
+  }
+};
+
+template <>
+struct TrackQuantization<math::Float2> {
+  enum { kComponents = 2 };
+  static void Quantize(const math::Float2& _value, uint16_t* _quantized) {
+    _quantized[0] = math::FloatToHalf(_value.x);
+    _quantized[1] = math::FloatToHalf(_value.y);
+  }
+  static math::Float2 Dequantize(const uint16_t* _quantized) {
+    return math::Float2(math::HalfToFloat(_quantized[0]),
+                        math::HalfToFloat(_quantized[1]));
+  }
+};
+
+template <>
+struct TrackQuantization<math::Float3> {
+  enum { kComponents = 3 };
+  static void Quantize(const math::Float3& _value, uint16_t* _quantized) {
+    _quantized[0] = math::FloatToHalf(_value.x);
+    _quantized[1] = math::FloatToHalf(_value.y);
+    _quantized[2] = math::FloatToHalf(_value.z);
+  }
+  static math::Float3 Dequantize(const uint16_t* _quantized) {
+    return math::Float3(math::HalfToFloat(_quantized[0]),
+                        math::HalfToFloat(_quantized[1]),
+                        math::HalfToFloat(_quantized[2]));
+  }
+};
+
+template <>
+struct TrackQuantization<math::Float4> {
+  enum { kComponents = 4 };
+  static void Quantize(const math::Float4& _value, uint16_t* _quantized) {
+    _quantized[0] = math::FloatToHalf(_value.x);
+    _quantized[1] = math::FloatToHalf(_value.y);
+    _quantized[2] = math::FloatToHalf(_value.z);
+    _quantized[3] = math::FloatToHalf(_value.w);
+  }
+  static math::Float4 Dequantize(const uint16_t* _quantized) {
+    return math::Float4(
+        math::HalfToFloat(_quantized[0]), math::HalfToFloat(_quantized[1]),
+        math::HalfToFloat(_quantized[2]), math::HalfToFloat(_quantized[3]));
+  }
+};
+
+// Quaternions are normalized, so only the 3 smallest components are stored,
+// the largest one is restored from the 3 others. Like QuaternionKey, the 3
+// smallest components are pre-multiplied by sqrt(2) to use the whole [-1,1]
+// range. Each is quantized to a 15 bits signed integer, the remaining low bit
+// of the 3 components stores the index of the largest component (2 bits) and
+// its sign (1 bit). The sign is kept as track keys hemisphere is fixed up by
+// TrackBuilder to take the shortest path during the normalized-lerp.
+template <>
+struct TrackQuantization<math::Quaternion> {
+  enum { kComponents = 3 };
+  static void Quantize(const math::Quaternion& _value, uint16_t* _quantized) {
+    const float cpnts[4] = {_value.x, _value.y, _value.z, _value.w};
+    int largest = 0;
+    for (int i = 1; i < 4; ++i) {
+      if (std::abs(cpnts[i]) > std::abs(cpnts[largest])) {
+        largest = i;
+      }
+    }
+    const int bits[3] = {largest & 1, largest >> 1, cpnts[largest] < 0.f};
+    const float kFloat2Int = 16383.f * math::kSqrt2;
+    for (int i = 0, j = 0; i < 4; ++i) {
+      if (i == largest) {
+        continue;
+      }
+      const int value = math::Clamp(
+          -16383, static_cast<int>(std::floor(cpnts[i] * kFloat2Int + .5f)),
+          16383);
+      _quantized[j] = static_cast<uint16_t>((value * 2) | bits[j]);
+      ++j;
+    }
+  }
+  static math::Quaternion Dequantize(const uint16_t* _quantized) {
+    const float kInt2Float = 1.f / (16383.f * math::kSqrt2);
+    float smallest[3];
+    int bits[3];
+    for (int i = 0; i < 3; ++i) {
+      const int value = static_cast<int16_t>(_quantized[i]);
+      bits[i] = value & 1;
+      smallest[i] = ((value - bits[i]) / 2) * kInt2Float;
+    }
+    const int largest = bits[0] | (bits[1] << 1);
+    const float dot = smallest[0] * smallest[0] + smallest[1] * smallest[1] +
+                      smallest[2] * smallest[2];
+    const float restored = std::sqrt(math::Max(0.f, 1.f - dot));
+    float cpnts[4];
+    for (int i = 0, j = 0; i < 4; ++i) {
+      cpnts[i] = i == largest ? (bits[2] ? -restored : restored)
+                              : smallest[j++];
+    }
+    return math::Quaternion(cpnts[0], cpnts[1], cpnts[2], cpnts[3]);
+  }
+};
+}  // namespace internal
+}  // namespace animation
+}  // namespace ozz
+#endif  // OZZ_ANIMATION_RUNTIME_TRACK_QUANTIZATION_H_
@@ -32,13 +32,75 @@
 #include <algorithm>
 #include <cassert>
 
+// Internal include file
+#define OZZ_INCLUDE_PRIVATE_HEADER  // Allows to include private headers.
+#include "animation/runtime/track_quantization.h"
+
 namespace ozz {
 namespace animation {
 namespace internal {
 
 template <typename _Track>
 TrackSamplingJob<_Track>::TrackSamplingJob()
-    : ratio(0.f), track(nullptr), result(nullptr) {}
+    : ratio(0.f), track(nullptr), cache(nullptr), result(nullptr) {}
+
+namespace {
+// Returns the first key with a ratio greater than _ratio, like
+// std::upper_bound, but starting search from key _hint. Forward search gallops
+// from _hint (doubling steps), so its cost only depends on the number of keys
+// between _hint and the result.
+// _Ratio is float, or uint16_t for quantized ratios.
+template <typename _Ratio>
+const _Ratio* UpperBound(const span<const _Ratio>& _ratios, _Ratio _ratio,
+                         size_t _hint) {
+  const _Ratio* begin = _ratios.begin();
+  const _Ratio* end = _ratios.end();
+  const _Ratio* lower = _hint < _ratios.size() ? begin + _hint : begin;
+  if (*lower > _ratio) {
+    // Backward, the result is before hint.
+    return std::upper_bound(begin, lower, _ratio);
+  }
+
+  // Forward, *lower <= _ratio.
+  for (ptrdiff_t step = 1; step < end - lower; step *= 2) {
+    const _Ratio* probe = lower + step;
+    if (*probe > _ratio) {
+      return std::upper_bound(lower + 1, probe, _ratio);
+    }
+    lower = probe;
+  }
+  return std::upper_bound(lower + 1, end, _ratio);
+}
+
+// Searches the index of the first key with a ratio greater than _ratio, using
+// cached key _hint (if not nullptr) as search start.
+template <typename _Ratio>
+size_t SearchKey(const span<const _Ratio>& _ratios, _Ratio _ratio,
+                 const int* _hint) {
+  const _Ratio* key =
+      _hint ? UpperBound(_ratios, _ratio, static_cast<size_t>(*_hint))
+            : std::upper_bound(_ratios.begin(), _ratios.end(), _ratio);
+  return key - _ratios.begin();
+}
+
+// Gets key _index ratio, decompressing it if needed.
+template <typename _ValueType>
+float KeyRatio(const Track<_ValueType>& _track, size_t _index) {
+  return _track.ratios().empty()
+             ? DequantizeTrackRatio(_track.quantized_ratios()[_index])
+             : _track.ratios()[_index];
+}
+
+// Gets key _index value, decompressing it if needed.
+template <typename _ValueType>
+_ValueType KeyValue(const Track<_ValueType>& _track, size_t _index) {
+  typedef TrackQuantization<_ValueType> Quantization;
+  return _track.values().empty()
+             ? Quantization::Dequantize(_track.quantized_values().data() +
+                                        _index * Quantization::kComponents)
+             : _track.values()[_index];
+}
+}  // namespace
 
 template <typename _Track>
 bool TrackSamplingJob<_Track>::Validate() const {
@@ -57,38 +119,41 @@ bool TrackSamplingJob<_Track>::Run() const {
   // Clamps ratio in range [0,1].
   const float clamped_ratio = math::Clamp(0.f, ratio, 1.f);
 
-  // Search keyframes to interpolate.
-  const span<const float> ratios = track->ratios();
-  const span<const ValueType> values = track->values();
-  assert(ratios.size() == values.size() &&
-         track->steps().size() * 8 >= values.size());
-
   // Default track returns identity.
-  if (ratios.size() == 0) {
+  const size_t num_keys = track->num_keys();
+  assert(track->steps().size() * 8 >= num_keys);
+  if (num_keys == 0) {
     *result = internal::TrackPolicy<ValueType>::identity();
     return true;
   }
 
   // Search for the first key frame with a ratio value greater than input ratio.
-  // Our ratio is between this one and the previous one.
-  const float* ptk1 = std::upper_bound(ratios.begin(), ratios.end(), clamped_ratio);
+  // Our ratio is between this one and the previous one. Quantized ratios are
+  // searched without being decompressed.
+  const int* hint = cache ? &cache->key_ : nullptr;
+  const size_t id1 =
+      track->ratios().empty()
+          ? SearchKey(track->quantized_ratios(),
+                      QuantizeTrackRatio(clamped_ratio), hint)
+          : SearchKey(track->ratios(), clamped_ratio, hint);
 
   // Deduce keys indices.
-  const size_t id1 = ptk1 - ratios.begin();
   const size_t id0 = id1 - 1;
+  if (cache) {
+    cache->key_ = static_cast<int>(id0);
+  }
 
   const bool id0step = (track->steps()[id0 / 8] & (1 << (id0 & 7))) != 0;
-  if (id0step || ptk1 == ratios.end()) {
-    *result = values[id0];
+  if (id0step || id1 == num_keys) {
+    *result = KeyValue(*track, id0);
   } else {
     // Lerp relevant keys.
-    const float tk0 = ratios[id0];
-    const float tk1 = ratios[id1];
-    assert(clamped_ratio >= tk0 && clamped_ratio < tk1 && tk0 != tk1);
-    const float alpha = (clamped_ratio - tk0) / (tk1 - tk0);
-    const ValueType& vk0 = values[id0];
-    const ValueType& vk1 = values[id1];
-    *result = internal::TrackPolicy<ValueType>::Lerp(vk0, vk1, alpha);
+    const float tk0 = KeyRatio(*track, id0);
+    const float tk1 = KeyRatio(*track, id1);
+    const float alpha = math::Clamp(0.f, (clamped_ratio - tk0) / (tk1 - tk0),
+                                    1.f);
+    *result = internal::TrackPolicy<ValueType>::Lerp(
+        KeyValue(*track, id0), KeyValue(*track, id1), alpha);
   }
   return true;
 }
@@ -31,6 +31,10 @@
 #include <algorithm>
 #include <cassert>
 
+// Internal include file
+#define OZZ_INCLUDE_PRIVATE_HEADER  // Allows to include private headers.
+#include "animation/runtime/track_edge.h"
+
 namespace ozz {
 namespace animation {
 
@@ -64,48 +68,47 @@ namespace {
 inline bool DetectEdge(ptrdiff_t _i0, ptrdiff_t _i1, bool _forward,
                        const TrackTriggeringJob& _job,
                        TrackTriggeringJob::Edge* _edge) {
+  const span<const float>& ratios = _job.track->ratios();
   const span<const float>& values = _job.track->values();
-
-  const float vk0 = values[_i0];
-  const float vk1 = values[_i1];
-
-  bool detected = false;
-  if (vk0 <= _job.threshold && vk1 > _job.threshold) {
-    // Rising edge
-    _edge->rising = _forward;
-    detected = true;
-  } else if (vk0 > _job.threshold && vk1 <= _job.threshold) {
-    // Falling edge
-    _edge->rising = !_forward;
-    detected = true;
+  const span<const uint8_t>& steps = _job.track->steps();
+
+  // When looping (_i1 is the first key), the edge is at the beginning of the
+  // track.
+  const float tk0 = _i1 == 0 ? ratios[_i1] : ratios[_i0];
+  const bool step = (steps[_i0 / 8] & (1 << (_i0 & 7))) != 0;
+  bool rising;
+  if (!internal::DetectTrackEdge(tk0, ratios[_i1], values[_i0], values[_i1],
+                                 step, _job.threshold, &_edge->ratio,
+                                 &rising)) {
+    return false;
   }
+  _edge->rising = rising == _forward;
+  return true;
+}
 
-  if (detected) {
-    const span<const float>& ratios = _job.track->ratios();
-    const span<const uint8_t>& steps = _job.track->steps();
+// Tests if the job can use track edge index.
+inline bool UseEdgeIndex(const TrackTriggeringJob& _job) {
+  return _job.track->has_edge_index() &&
+         _job.track->edge_threshold() == _job.threshold;
+}
 
-    const bool step = (steps[_i0 / 8] & (1 << (_i0 & 7))) != 0;
-    if (step) {
-      _edge->ratio = ratios[_i1];
+// Returns the index of the first edge whose ratio, offset by _outer, is greater
+// or equal to _ratio. This is a binary search (as std::lower_bound), on ratios
+// offset exactly the same way as edges yielded by the iterator.
+inline ptrdiff_t LowerEdge(const span<const float>& _edges, float _outer,
+                           float _ratio) {
+  ptrdiff_t first = 0;
+  ptrdiff_t count = _edges.size();
+  while (count > 0) {
+    const ptrdiff_t half = count / 2;
+    if (_edges[first + half] + _outer < _ratio) {
+      first += half + 1;
+      count -= half + 1;
     } else {
-      assert(vk0 != vk1);  // Won't divide by 0
-
-      if (_i1 == 0) {
-        _edge->ratio = 0.f;
-      } else {
-        // Finds where the curve crosses threshold value.
-        // This is the lerp equation, where we know the result and look for
-        // alpha, aka un-lerp.
-        const float alpha = (_job.threshold - vk0) / (vk1 - vk0);
-
-        // Remaps to keyframes actual times.
-        const float tk0 = ratios[_i0];
-        const float tk1 = ratios[_i1];
-        _edge->ratio = math::Lerp(tk0, tk1, alpha);
-      }
+      count = half;
     }
   }
-  return detected;
+  return first;
 }
 }  // namespace
 
@@ -120,15 +123,71 @@ TrackTriggeringJob::Iterator::Iterator(const TrackTriggeringJob* _job)
   // complexity, but for consistency of forward and backward triggering, it's
   // better to let iterator ++ implementation filter included and excluded
   // edges.
-  inner_ = job_->from < job_->to ? 0 : _job->track->ratios().size() - 1;
+  if (UseEdgeIndex(*job_)) {
+    inner_ = -1;  // Edges range isn't computed yet.
+  } else {
+    inner_ = job_->from < job_->to ? 0 : _job->track->ratios().size() - 1;
+  }
 
   // Evaluates first edge.
   ++*this;
 }
 
+void TrackTriggeringJob::Iterator::NextIndexed() {
+  // Edges of an outer loop are the ones that would be yielded by the keys loop
+  // of operator ++, found with binary searches. The first search is included,
+  // the second excluded, unless the loop is entirely in the range.
+  const span<const float>& edges = job_->track->edge_ratios();
+  const span<const uint8_t>& rising = job_->track->edge_rising();
+  const ptrdiff_t num_edges = edges.size();
+
+  if (job_->to > job_->from) {
+    for (; outer_ < job_->to; outer_ += 1.f) {
+      if (inner_ < 0) {
+        inner_ = LowerEdge(edges, outer_, job_->from);
+        inner_end_ = job_->to >= 1.f + outer_
+                         ? num_edges
+                         : LowerEdge(edges, outer_, job_->to);
+      }
+      if (inner_ < inner_end_) {
+        edge_.ratio = edges[inner_] + outer_;
+        edge_.rising = (rising[inner_ / 8] & (1 << (inner_ & 7))) != 0;
+        ++inner_;
+        return;  // Yield found edge.
+      }
+      inner_ = -1;  // Ready for next loop.
+    }
+  } else {
+    // Backward, inner_ iterates from the end of the range.
+    for (; outer_ + 1.f > job_->to; outer_ -= 1.f) {
+      if (inner_ < 0) {
+        inner_end_ = LowerEdge(edges, outer_, job_->to);
+        inner_ = job_->from >= 1.f + outer_
+                     ? num_edges
+                     : LowerEdge(edges, outer_, job_->from);
+      }
+      if (inner_ > inner_end_) {
+        --inner_;
+        edge_.ratio = edges[inner_] + outer_;
+        edge_.rising = (rising[inner_ / 8] & (1 << (inner_ & 7))) == 0;
+        return;  // Yield found edge.
+      }
+      inner_ = -1;  // Ready for next loop.
+    }
+  }
+
+  // Set iterator to end position.
+  *this = job_->end();
+}
+
 const TrackTriggeringJob::Iterator& TrackTriggeringJob::Iterator::operator++() {
   assert(*this != job_->end() && "Can't increment end iterator.");
 
+  if (UseEdgeIndex(*job_)) {
+    NextIndexed();
+    return *this;
+  }
+
   const span<const float>& ratios = job_->track->ratios();
   const ptrdiff_t num_keys = ratios.size();
 
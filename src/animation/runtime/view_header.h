@@ -0,0 +1,122 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+
+#ifndef OZZ_ANIMATION_RUNTIME_VIEW_HEADER_H_
+#define OZZ_ANIMATION_RUNTIME_VIEW_HEADER_H_
+
+#ifndef OZZ_INCLUDE_PRIVATE_HEADER
+#error "This header is private, it cannot be included from public headers."
+#endif  // OZZ_INCLUDE_PRIVATE_HEADER
+
+#include <cstring>
+
+#include "ozz/base/io/archive_traits.h"
+#include "ozz/base/platform.h"
+#include "ozz/base/span.h"
+
+namespace ozz {
+namespace animation {
+namespace internal {
+
+// Memory views are native-endian images of runtime objects buffers, that can
+// be used in place (see Animation::LoadView). View memory must be aligned to
+// the highest alignment requirement of runtime data, aka simd types.
+constexpr size_t kViewAlignment = 16;
+
+// Endianness marker written with native endianness, so that a view produced
+// for a platform with a different endianness can be detected.
+constexpr uint32_t kViewEndianness = 0x01020304;
+
+// Common header of all runtime objects views. Each type extends it with its
+// own buffer sizes, and data follows at kViewAlignment aligned offset.
+struct ViewHeader {
+  // Type tag, as declared for archives with OZZ_IO_TYPE_TAG.
+  char tag[32];
+
+  // Type version, as declared for archives with OZZ_IO_TYPE_VERSION.
+  uint32_t version;
+
+  // kViewEndianness, written natively.
+  uint32_t endianness;
+
+  // Size of the whole view, header included.
+  uint64_t size;
+};
+
+// Initializes _header for a view of type _Ty of _size bytes.
+template <typename _Ty>
+inline void InitViewHeader(size_t _size, ViewHeader* _header) {
+  typedef io::internal::Tag<const _Ty> Tag;
+  static_assert(Tag::kTagLength <= sizeof(ViewHeader::tag),
+                "Tag doesn't fit in view header");
+  std::memset(_header, 0, sizeof(*_header));
+  std::memcpy(_header->tag, Tag::Get(), Tag::kTagLength);
+  _header->version = io::internal::Version<const _Ty>::kValue;
+  _header->endianness = kViewEndianness;
+  _header->size = _size;
+}
+
+// Validates that _view is aligned and big enough to contain a _Header, and
+// that the view header matches type _Ty. Returns _view _Header, or nullptr if
+// it's invalid.
+template <typename _Ty, typename _Header>
+inline const _Header* ValidateViewHeader(const span<const char>& _view) {
+  if (!IsAligned(_view.data(), kViewAlignment) ||
+      _view.size() < sizeof(_Header)) {
+    return nullptr;
+  }
+  const _Header* header = reinterpret_cast<const _Header*>(_view.data());
+  const ViewHeader& base = header->base;
+  typedef io::internal::Tag<const _Ty> Tag;
+  if (std::memcmp(base.tag, Tag::Get(), Tag::kTagLength) != 0 ||
+      base.version != io::internal::Version<const _Ty>::kValue ||
+      base.endianness != kViewEndianness || base.size > _view.size()) {
+    return nullptr;
+  }
+  return header;
+}
+
+// Gets the offset of view data, which follows _Header.
+template <typename _Header>
+inline size_t ViewDataOffset() {
+  return Align(sizeof(_Header), kViewAlignment);
+}
+
+// Copies _src content to the beginning of _dest buffer. _dest is modified to
+// reflect remain size.
+template <typename _Ty>
+inline void CopyToView(const span<const _Ty>& _src, span<char>& _dest) {
+  const span<_Ty> dest = fill_span<_Ty>(_dest, _src.size());
+  if (!_src.empty()) {
+    std::memcpy(dest.data(), _src.data(), _src.size_bytes());
+  }
+}
+}  // namespace internal
+}  // namespace animation
+}  // namespace ozz
+#endif  // OZZ_ANIMATION_RUNTIME_VIEW_HEADER_H_
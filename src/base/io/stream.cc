@@ -107,6 +107,163 @@ size_t File::Size() const {
   return static_cast<size_t>(end);
 }
 
+// Starts BufferedFile implementation.
+const size_t BufferedFile::kDefaultBufferSize;
+
+BufferedFile::BufferedFile(const char* _filename, const char* _mode,
+                           size_t _buffer_size)
+    : file_(_filename, _mode),
+      buffer_(nullptr),
+      buffer_size_(_buffer_size),
+      buffer_pos_(0),
+      buffer_end_(0),
+      operation_(kNone) {
+  if (file_.opened() && buffer_size_ != 0) {
+    buffer_ = reinterpret_cast<char*>(
+        ozz::memory::default_allocator()->Allocate(buffer_size_, 16));
+  }
+}
+
+BufferedFile::BufferedFile(void* _file, size_t _buffer_size)
+    : file_(_file),
+      buffer_(nullptr),
+      buffer_size_(_buffer_size),
+      buffer_pos_(0),
+      buffer_end_(0),
+      operation_(kNone) {
+  if (file_.opened() && buffer_size_ != 0) {
+    buffer_ = reinterpret_cast<char*>(
+        ozz::memory::default_allocator()->Allocate(buffer_size_, 16));
+  }
+}
+
+BufferedFile::~BufferedFile() {
+  Close();
+  ozz::memory::default_allocator()->Deallocate(buffer_);
+  buffer_ = nullptr;
+}
+
+void BufferedFile::Close() {
+  if (file_.opened()) {
+    Flush();
+    file_.Close();
+  }
+  buffer_pos_ = buffer_end_ = 0;
+  operation_ = kNone;
+}
+
+bool BufferedFile::Flush() {
+  if (operation_ != kWrite || buffer_pos_ == 0) {
+    return true;
+  }
+  const size_t pending = buffer_pos_;
+  buffer_pos_ = 0;
+  return file_.Write(buffer_, pending) == pending;
+}
+
+bool BufferedFile::Sync() {
+  if (operation_ == kNone) {
+    return true;
+  }
+  // C standard requires a file positioning call when switching between
+  // reading and writing, so the position is always set, even if nothing was
+  // read ahead.
+  bool success = true;
+  int ahead = 0;
+  if (operation_ == kWrite) {
+    success = Flush();
+  } else {
+    ahead = static_cast<int>(buffer_end_ - buffer_pos_);
+  }
+  success &= file_.Seek(-ahead, kCurrent) == 0;
+  buffer_pos_ = buffer_end_ = 0;
+  operation_ = kNone;
+  return success;
+}
+
+bool BufferedFile::opened() const { return file_.opened(); }
+
+size_t BufferedFile::Read(void* _buffer, size_t _size) {
+  if (operation_ != kRead) {
+    if (!Sync()) {
+      return 0;
+    }
+    operation_ = kRead;
+  }
+
+  // Consumes data already read ahead.
+  char* dest = reinterpret_cast<char*>(_buffer);
+  const size_t available = buffer_end_ - buffer_pos_;
+  const size_t copied = math::Min(available, _size);
+  if (copied != 0) {
+    std::memcpy(dest, buffer_ + buffer_pos_, copied);
+    buffer_pos_ += copied;
+  }
+  const size_t remaining = _size - copied;
+  if (remaining == 0) {
+    return _size;
+  }
+
+  // Buffer is exhausted. Big reads bypass it, otherwise it's refilled.
+  buffer_pos_ = buffer_end_ = 0;
+  if (remaining >= buffer_size_) {
+    return copied + file_.Read(dest + copied, remaining);
+  }
+  buffer_end_ = file_.Read(buffer_, buffer_size_);
+  buffer_pos_ = math::Min(remaining, buffer_end_);
+  std::memcpy(dest + copied, buffer_, buffer_pos_);
+  return copied + buffer_pos_;
+}
+
+size_t BufferedFile::Write(const void* _buffer, size_t _size) {
+  if (operation_ != kWrite) {
+    if (!Sync()) {
+      return 0;
+    }
+    operation_ = kWrite;
+  }
+
+  // Flushes if there isn't enough space left in the buffer.
+  if (_size > buffer_size_ - buffer_pos_ && !Flush()) {
+    return 0;
+  }
+
+  // Big writes bypass the buffer.
+  if (_size >= buffer_size_) {
+    return file_.Write(_buffer, _size);
+  }
+  std::memcpy(buffer_ + buffer_pos_, _buffer, _size);
+  buffer_pos_ += _size;
+  return _size;
+}
+
+int BufferedFile::Seek(int _offset, Origin _origin) {
+  if (!Sync()) {
+    return -1;
+  }
+  return file_.Seek(_offset, _origin);
+}
+
+int BufferedFile::Tell() const {
+  const int tell = file_.Tell();
+  if (tell < 0) {
+    return tell;
+  }
+  return operation_ == kWrite
+             ? tell + static_cast<int>(buffer_pos_)
+             : tell - static_cast<int>(buffer_end_ - buffer_pos_);
+}
+
+size_t BufferedFile::Size() const {
+  const size_t size = file_.Size();
+  if (operation_ == kWrite && buffer_pos_ != 0) {
+    // Pending data can extend the file.
+    const size_t end = static_cast<size_t>(file_.Tell()) + buffer_pos_;
+    return math::Max(size, end);
+  }
+  return size;
+}
+
 // Starts MemoryStream implementation.
 const size_t MemoryStream::kBufferSizeIncrement = 16 << 10;
 const size_t MemoryStream::kMaxSize = std::numeric_limits<int>::max();
@@ -213,5 +370,63 @@ bool MemoryStream::Resize(size_t _size) {
   }
   return _size == 0 || buffer_ != nullptr;
 }
+
+// Starts ReadOnlyMemoryStream implementation.
+ReadOnlyMemoryStream::ReadOnlyMemoryStream(span<const char> _buffer)
+    : buffer_(_buffer), tell_(0) {
+  assert(_buffer.size() <
+             static_cast<size_t>(std::numeric_limits<int>::max()) &&
+         "Buffer is too big");
+}
+
+bool ReadOnlyMemoryStream::opened() const { return true; }
+
+size_t ReadOnlyMemoryStream::Read(void* _buffer, size_t _size) {
+  const int end = static_cast<int>(buffer_.size());
+  // A read cannot set file position beyond the end of the file.
+  if (tell_ >= end) {
+    return 0;
+  }
+  const size_t read_size = math::Min(static_cast<size_t>(end - tell_), _size);
+  std::memcpy(_buffer, buffer_.data() + tell_, read_size);
+  tell_ += static_cast<int>(read_size);
+  return read_size;
+}
+
+size_t ReadOnlyMemoryStream::Write(const void* _buffer, size_t _size) {
+  (void)_buffer;
+  (void)_size;
+  return 0;
+}
+
+int ReadOnlyMemoryStream::Seek(int _offset, Origin _origin) {
+  const int max_size = std::numeric_limits<int>::max();
+  int origin;
+  switch (_origin) {
+    case kCurrent:
+      origin = tell_;
+      break;
+    case kEnd:
+      origin = static_cast<int>(buffer_.size());
+      break;
+    case kSet:
+      origin = 0;
+      break;
+    default:
+      return -1;
+  }
+
+  // Exit if seeking before file begin or beyond max file size.
+  if (origin < -_offset || (_offset > 0 && origin > max_size - _offset)) {
+    return -1;
+  }
+
+  tell_ = origin + _offset;
+  return 0;
+}
+
+int ReadOnlyMemoryStream::Tell() const { return tell_; }
+
+size_t ReadOnlyMemoryStream::Size() const { return buffer_.size(); }
 }  // namespace io
 }  // namespace ozz
@@ -0,0 +1,176 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+
+#include "ozz/geometry/runtime/dual_quaternion_palette_job.h"
+
+#include <cassert>
+
+#include "ozz/base/maths/simd_math.h"
+
+namespace ozz {
+namespace geometry {
+
+bool DualQuaternionPaletteJob::Validate() const {
+  // Don't need any early out, as jobs are valid in most of the performance
+  // critical cases.
+  // Tests are written in multiple lines in order to avoid branches.
+  bool valid = !joint_matrices.empty();
+  valid &= inverse_bind_poses.empty() ||
+           inverse_bind_poses.size() >= joint_matrices.size();
+  valid &= output.size() >= joint_matrices.size();
+  return valid;
+}
+
+namespace {
+// Converts 4 skinning matrices to dual quaternions, using SoA maths.
+void ToDualQuaternions(const math::Float4x4* const _matrices[4],
+                       DualQuaternion* _output[4]) {
+  using math::SimdFloat4;
+  using math::SimdInt4;
+  const SimdFloat4 zero = math::simd_float4::zero();
+  const SimdFloat4 one = math::simd_float4::one();
+  const SimdFloat4 half = math::simd_float4::Load1(.5f);
+
+  // Transposes matrices columns to SoA. m[c][r] is the row r component of
+  // column c, for the 4 matrices.
+  SimdFloat4 m[4][4];
+  for (int c = 0; c < 4; ++c) {
+    const SimdFloat4 cols[4] = {_matrices[0]->cols[c], _matrices[1]->cols[c],
+                                _matrices[2]->cols[c], _matrices[3]->cols[c]};
+    math::Transpose4x4(cols, m[c]);
+  }
+
+  // Removes scale, by normalizing rotation axes.
+  for (int c = 0; c < 3; ++c) {
+    const SimdFloat4 len2 =
+        m[c][0] * m[c][0] + m[c][1] * m[c][1] + m[c][2] * m[c][2];
+    const SimdFloat4 inv_len = one / math::Sqrt(len2);
+    m[c][0] = m[c][0] * inv_len;
+    m[c][1] = m[c][1] * inv_len;
+    m[c][2] = m[c][2] * inv_len;
+  }
+
+  // Converts rotation matrices to quaternions, branch-free. Every lane selects
+  // the most numerically stable of the 4 possible formulas, depending on the
+  // greatest of trace and diagonal elements.
+  const SimdFloat4 m00 = m[0][0];
+  const SimdFloat4 m11 = m[1][1];
+  const SimdFloat4 m22 = m[2][2];
+  const SimdFloat4 m01_p_m10 = m[1][0] + m[0][1];
+  const SimdFloat4 m02_p_m20 = m[2][0] + m[0][2];
+  const SimdFloat4 m12_p_m21 = m[2][1] + m[1][2];
+  const SimdFloat4 m21_m_m12 = m[1][2] - m[2][1];
+  const SimdFloat4 m02_m_m20 = m[2][0] - m[0][2];
+  const SimdFloat4 m10_m_m01 = m[0][1] - m[1][0];
+
+  const SimdInt4 z_negative = math::CmpLt(m22, zero);
+  const SimdInt4 x_gt_y = math::CmpGt(m00, m11);
+  const SimdInt4 x_lt_my = math::CmpLt(m00, -m11);
+  const SimdInt4 use_x = math::And(z_negative, x_gt_y);
+  const SimdInt4 use_y = math::AndNot(z_negative, x_gt_y);
+  const SimdInt4 use_z = math::AndNot(x_lt_my, z_negative);
+
+  // Radicands for w, x, y and z formulas.
+  const SimdFloat4 tw = one + m00 + m11 + m22;
+  const SimdFloat4 tx = one + m00 - m11 - m22;
+  const SimdFloat4 ty = one - m00 + m11 - m22;
+  const SimdFloat4 tz = one - m00 - m11 + m22;
+
+  // Selects w formula by default.
+  SimdFloat4 t = tw;
+  SimdFloat4 q[4] = {m21_m_m12, m02_m_m20, m10_m_m01, tw};
+  t = math::Select(use_x, tx, t);
+  q[0] = math::Select(use_x, tx, q[0]);
+  q[1] = math::Select(use_x, m01_p_m10, q[1]);
+  q[2] = math::Select(use_x, m02_p_m20, q[2]);
+  q[3] = math::Select(use_x, m21_m_m12, q[3]);
+  t = math::Select(use_y, ty, t);
+  q[0] = math::Select(use_y, m01_p_m10, q[0]);
+  q[1] = math::Select(use_y, ty, q[1]);
+  q[2] = math::Select(use_y, m12_p_m21, q[2]);
+  q[3] = math::Select(use_y, m02_m_m20, q[3]);
+  t = math::Select(use_z, tz, t);
+  q[0] = math::Select(use_z, m02_p_m20, q[0]);
+  q[1] = math::Select(use_z, m12_p_m21, q[1]);
+  q[2] = math::Select(use_z, tz, q[2]);
+  q[3] = math::Select(use_z, m10_m_m01, q[3]);
+
+  const SimdFloat4 scale = half / math::Sqrt(t);
+  for (int i = 0; i < 4; ++i) {
+    q[i] = q[i] * scale;
+  }
+
+  // Computes dual part: d = .5 * t * q, with t the translation pure
+  // quaternion.
+  const SimdFloat4* tr = m[3];
+  const SimdFloat4 d[4] = {
+      half * (q[3] * tr[0] + tr[1] * q[2] - tr[2] * q[1]),
+      half * (q[3] * tr[1] + tr[2] * q[0] - tr[0] * q[2]),
+      half * (q[3] * tr[2] + tr[0] * q[1] - tr[1] * q[0]),
+      -half * (tr[0] * q[0] + tr[1] * q[1] + tr[2] * q[2])};
+
+  // Transposes back to AoS.
+  SimdFloat4 reals[4];
+  SimdFloat4 duals[4];
+  math::Transpose4x4(q, reals);
+  math::Transpose4x4(d, duals);
+  for (int i = 0; i < 4; ++i) {
+    _output[i]->real = reals[i];
+    _output[i]->dual = duals[i];
+  }
+}
+}  // namespace
+
+bool DualQuaternionPaletteJob::Run() const {
+  if (!Validate()) {
+    return false;
+  }
+
+  const int num_joints = static_cast<int>(joint_matrices.size());
+  for (int i = 0; i < num_joints; i += 4) {
+    // Last batch might be incomplete, in which case the last joint is
+    // duplicated (and overwritten).
+    math::Float4x4 matrices[4];
+    const math::Float4x4* inputs[4];
+    DualQuaternion* outputs[4];
+    for (int j = 0; j < 4; ++j) {
+      const int joint = i + j < num_joints ? i + j : num_joints - 1;
+      if (inverse_bind_poses.empty()) {
+        inputs[j] = &joint_matrices[joint];
+      } else {
+        matrices[j] = joint_matrices[joint] * inverse_bind_poses[joint];
+        inputs[j] = &matrices[j];
+      }
+      outputs[j] = &output[joint];
+    }
+    ToDualQuaternions(inputs, outputs);
+  }
+  return true;
+}
+}  // namespace geometry
+}  // namespace ozz
@@ -28,24 +28,56 @@
 #include "ozz/geometry/runtime/skinning_job.h"
 
 #include <cassert>
+#include <limits>
 
+#include "ozz/base/maths/math_ex.h"
 #include "ozz/base/maths/simd_math.h"
+#include "ozz/base/maths/simd_quaternion.h"
+#include "ozz/geometry/runtime/dual_quaternion_palette_job.h"
 
 namespace ozz {
 namespace geometry {
 
 SkinningJob::SkinningJob()
-    : vertex_count(0),
+    : format(kFloat),
+      vertex_count(0),
       influences_count(0),
       joint_indices_stride(0),
       joint_weights_stride(0),
       in_positions_stride(0),
       in_normals_stride(0),
       in_tangents_stride(0),
+      in_positions_scale(math::Float3::one()),
+      in_positions_bias(math::Float3::zero()),
       out_positions_stride(0),
       out_normals_stride(0),
       out_tangents_stride(0) {}
 
+namespace {
+// Tests that _buffer is big enough for _count elements of _element_size bytes,
+// separated by _stride bytes.
+template <typename _Type>
+bool ValidateBuffer(span<_Type> _buffer, size_t _stride, size_t _element_size,
+                    int _count) {
+  if (_count <= 0) {
+    return true;
+  }
+  return _buffer.size_bytes() >= _stride * (_count - 1) + _element_size;
+}
+
+bool HasNormals(const SkinningJob& _job) {
+  return _job.format == SkinningJob::kFloat
+             ? !_job.in_normals.empty()
+             : !_job.in_normals_compact.empty();
+}
+
+bool HasTangents(const SkinningJob& _job) {
+  return _job.format == SkinningJob::kFloat
+             ? !_job.in_tangents.empty()
+             : !_job.in_tangents_compact.empty();
+}
+}  // namespace
+
 bool SkinningJob::Validate() const {
   // Start validation of all parameters.
   bool valid = true;
@@ -53,8 +85,12 @@ bool SkinningJob::Validate() const {
   // Checks influences bounds.
   valid &= influences_count > 0;
 
-  // Checks joints matrices, required.
-  valid &= !joint_matrices.empty();
+  // Checks joints matrices or dual quaternions, one of them is required.
+  if (joint_dual_quaternions.empty()) {
+    valid &= !joint_matrices.empty();
+  } else {
+    valid &= joint_matrices.empty() && joint_inverse_transpose_matrices.empty();
+  }
 
   // Prepares local variables used to compute buffer size.
   const int vertex_count_minus_1 = vertex_count > 0 ? vertex_count - 1 : 0;
@@ -65,38 +101,70 @@ bool SkinningJob::Validate() const {
            joint_indices_stride * vertex_count_minus_1 +
                sizeof(uint16_t) * influences_count * vertex_count_at_least_1;
 
+  // Checks format.
+  const bool compact = format != kFloat;
+  valid &= format >= kFloat && format <= kSnorm16Unorm16;
+
   // Checks weights, required if influences_count > 1.
   if (influences_count != 1) {
-    valid &=
-        joint_weights.size_bytes() >=
-        joint_weights_stride * vertex_count_minus_1 +
-            sizeof(float) * (influences_count - 1) * vertex_count_at_least_1;
+    const size_t weights_count = influences_count - 1;
+    switch (format) {
+      case kHalfUnorm8:
+      case kSnorm16Unorm8:
+        valid &= ValidateBuffer(joint_weights_unorm8, joint_weights_stride,
+                                sizeof(uint8_t) * weights_count, vertex_count);
+        break;
+      case kHalfUnorm16:
+      case kSnorm16Unorm16:
+        valid &= ValidateBuffer(joint_weights_unorm16, joint_weights_stride,
+                                sizeof(uint16_t) * weights_count, vertex_count);
+        break;
+      default:
+        valid &= ValidateBuffer(joint_weights, joint_weights_stride,
+                                sizeof(float) * weights_count, vertex_count);
+        break;
+    }
   }
 
   // Checks positions, mandatory.
-  valid &= in_positions.size_bytes() >=
-           in_positions_stride * vertex_count_minus_1 +
-               sizeof(float) * 3 * vertex_count_at_least_1;
+  if (compact) {
+    valid &= ValidateBuffer(in_positions_compact, in_positions_stride,
+                            sizeof(uint16_t) * 3, vertex_count);
+  } else {
+    valid &= in_positions.size_bytes() >=
+             in_positions_stride * vertex_count_minus_1 +
+                 sizeof(float) * 3 * vertex_count_at_least_1;
+  }
   valid &= !out_positions.empty();
   valid &= out_positions.size_bytes() >=
            out_positions_stride * vertex_count_minus_1 +
                sizeof(float) * 3 * vertex_count_at_least_1;
 
   // Checks normals, optional.
-  if (!in_normals.empty()) {
-    valid &= in_normals.size_bytes() >=
-             in_normals_stride * vertex_count_minus_1 +
-                 sizeof(float) * 3 * vertex_count_at_least_1;
+  if (HasNormals(*this)) {
+    if (compact) {
+      valid &= ValidateBuffer(in_normals_compact, in_normals_stride,
+                              sizeof(uint16_t) * 2, vertex_count);
+    } else {
+      valid &= in_normals.size_bytes() >=
+               in_normals_stride * vertex_count_minus_1 +
+                   sizeof(float) * 3 * vertex_count_at_least_1;
+    }
     valid &= !out_normals.empty();
     valid &= out_normals.size_bytes() >=
              out_normals_stride * vertex_count_minus_1 +
                  sizeof(float) * 3 * vertex_count_at_least_1;
 
     // Checks tangents, optional but requires normals.
-    if (!in_tangents.empty()) {
-      valid &= in_tangents.size_bytes() >=
-               in_tangents_stride * vertex_count_minus_1 +
-                   sizeof(float) * 3 * vertex_count_at_least_1;
+    if (HasTangents(*this)) {
+      if (compact) {
+        valid &= ValidateBuffer(in_tangents_compact, in_tangents_stride,
+                                sizeof(uint16_t) * 2, vertex_count);
+      } else {
+        valid &= in_tangents.size_bytes() >=
+                 in_tangents_stride * vertex_count_minus_1 +
+                     sizeof(float) * 3 * vertex_count_at_least_1;
+      }
       valid &= !out_tangents.empty();
       valid &= out_tangents.size_bytes() >=
                out_tangents_stride * vertex_count_minus_1 +
@@ -104,12 +172,307 @@ bool SkinningJob::Validate() const {
     }
   } else {
     // Tangents are not supported if normals are not there.
-    valid &= in_tangents.empty();
+    valid &= !HasTangents(*this);
   }
 
   return valid;
 }
 
+namespace {
+// Reads float vertex inputs. This is the default inputs policy of skinning
+// functions, which defines the types of input buffers, how to get them from
+// the job, and how to load them to SIMD registers:
+// - Position, Vector and Weights4 functions are intended to be used inside the
+// vertex loop, they can read a bit more data than required. Position3 and
+// Vector3 restrict access to data that are sure to be readable.
+// - Vectors loads normal and tangent at once, allowing to share decoding
+// instructions.
+// - TransformVector(s) functions load and transform vectors by a matrix, which
+// allows compact inputs to skip rebuilding decoded vectors.
+// - Weight loads the _j weight and splats it to all components.
+struct FloatInputs {
+  typedef float PositionType;
+  typedef float VectorType;
+  typedef float WeightType;
+
+  explicit FloatInputs(const SkinningJob&) {}
+
+  static const float* Positions(const SkinningJob& _job) {
+    return _job.in_positions.begin();
+  }
+  static const float* Normals(const SkinningJob& _job) {
+    return _job.in_normals.begin();
+  }
+  static const float* Tangents(const SkinningJob& _job) {
+    return _job.in_tangents.begin();
+  }
+  static const float* Weights(const SkinningJob& _job) {
+    return _job.joint_weights.begin();
+  }
+
+  math::SimdFloat4 Position(const float* _p) const {
+    return math::simd_float4::LoadPtrU(_p);
+  }
+  math::SimdFloat4 Position3(const float* _p) const {
+    return math::simd_float4::Load3PtrU(_p);
+  }
+  math::SimdFloat4 Vector(const float* _v) const {
+    return math::simd_float4::LoadPtrU(_v);
+  }
+  math::SimdFloat4 Vector3(const float* _v) const {
+    return math::simd_float4::Load3PtrU(_v);
+  }
+  void Vectors(const float* _n, const float* _t, math::SimdFloat4* _out_n,
+               math::SimdFloat4* _out_t) const {
+    *_out_n = Vector(_n);
+    *_out_t = Vector(_t);
+  }
+  void Vectors3(const float* _n, const float* _t, math::SimdFloat4* _out_n,
+                math::SimdFloat4* _out_t) const {
+    *_out_n = Vector3(_n);
+    *_out_t = Vector3(_t);
+  }
+  math::SimdFloat4 TransformVector(const math::Float4x4& _m,
+                                   const float* _v) const {
+    return math::TransformVector(_m, Vector(_v));
+  }
+  math::SimdFloat4 TransformVector3(const math::Float4x4& _m,
+                                    const float* _v) const {
+    return math::TransformVector(_m, Vector3(_v));
+  }
+  void TransformVectors(const math::Float4x4& _m, const float* _n,
+                        const float* _t, math::SimdFloat4* _out_n,
+                        math::SimdFloat4* _out_t) const {
+    *_out_n = math::TransformVector(_m, Vector(_n));
+    *_out_t = math::TransformVector(_m, Vector(_t));
+  }
+  void TransformVectors3(const math::Float4x4& _m, const float* _n,
+                         const float* _t, math::SimdFloat4* _out_n,
+                         math::SimdFloat4* _out_t) const {
+    *_out_n = math::TransformVector(_m, Vector3(_n));
+    *_out_t = math::TransformVector(_m, Vector3(_t));
+  }
+  math::SimdFloat4 Weight(const float* _w, int _j) const {
+    return math::simd_float4::Load1PtrU(_w + _j);
+  }
+  math::SimdFloat4 Weights4(const float* _w) const {
+    return math::simd_float4::LoadPtrU(_w);
+  }
+};
+
+// Gets compact weights buffer, according to weights type.
+inline const uint8_t* UnormWeights(const SkinningJob& _job, const uint8_t*) {
+  return _job.joint_weights_unorm8.begin();
+}
+inline const uint16_t* UnormWeights(const SkinningJob& _job, const uint16_t*) {
+  return _job.joint_weights_unorm16.begin();
+}
+
+// Reads and decodes compact vertex inputs: unorm8 or unorm16 weights (_Weight
+// being uint8_t or uint16_t), octahedral normals and tangents. Compact
+// positions decoding is implemented by HalfInputs and Snorm16Inputs. Inputs are
+// decoded while they are loaded, directly to SIMD registers.
+template <typename _Weight>
+class CompactInputs {
+ public:
+  typedef uint16_t VectorType;
+  typedef _Weight WeightType;
+
+  static const uint16_t* Normals(const SkinningJob& _job) {
+    return _job.in_normals_compact.begin();
+  }
+  static const uint16_t* Tangents(const SkinningJob& _job) {
+    return _job.in_tangents_compact.begin();
+  }
+  static const _Weight* Weights(const SkinningJob& _job) {
+    return UnormWeights(_job, static_cast<const _Weight*>(nullptr));
+  }
+
+  // Decodes an octahedral encoded vector and normalizes it. Only 2 values are
+  // read, so there's no _INNER version.
+  math::SimdFloat4 Vector(const uint16_t* _v) const {
+    math::SimdFloat4 xy;
+    math::SimdFloat4 z;
+    DecodeOctahedral(math::simd_int4::Load2PtrU(
+                         reinterpret_cast<const int16_t*>(_v)),
+                     &xy, &z);
+    return math::SetZ(xy, z);
+  }
+  math::SimdFloat4 Vector3(const uint16_t* _v) const { return Vector(_v); }
+
+  // Decodes normal and tangent at once, from xy and zw components.
+  void Vectors(const uint16_t* _n, const uint16_t* _t,
+               math::SimdFloat4* _out_n, math::SimdFloat4* _out_t) const {
+    math::SimdFloat4 xy;
+    math::SimdFloat4 z;
+    DecodeOctahedral(Pair(_n, _t), &xy, &z);
+    *_out_n = math::SetZ(xy, z);
+    *_out_t = math::SetZ(math::Swizzle<2, 3, 2, 3>(xy), math::SplatZ(z));
+  }
+  void Vectors3(const uint16_t* _n, const uint16_t* _t,
+                math::SimdFloat4* _out_n, math::SimdFloat4* _out_t) const {
+    Vectors(_n, _t, _out_n, _out_t);
+  }
+
+  // Transform functions don't rebuild decoded vectors, they splat decoded
+  // components to the transformation.
+  math::SimdFloat4 TransformVector(const math::Float4x4& _m,
+                                   const uint16_t* _v) const {
+    math::SimdFloat4 xy;
+    math::SimdFloat4 z;
+    DecodeOctahedral(math::simd_int4::Load2PtrU(
+                         reinterpret_cast<const int16_t*>(_v)),
+                     &xy, &z);
+    return Transform(_m, math::SplatX(xy), math::SplatY(xy), math::SplatX(z));
+  }
+  math::SimdFloat4 TransformVector3(const math::Float4x4& _m,
+                                    const uint16_t* _v) const {
+    return TransformVector(_m, _v);
+  }
+  void TransformVectors(const math::Float4x4& _m, const uint16_t* _n,
+                        const uint16_t* _t, math::SimdFloat4* _out_n,
+                        math::SimdFloat4* _out_t) const {
+    math::SimdFloat4 xy;
+    math::SimdFloat4 z;
+    DecodeOctahedral(Pair(_n, _t), &xy, &z);
+    *_out_n =
+        Transform(_m, math::SplatX(xy), math::SplatY(xy), math::SplatX(z));
+    *_out_t =
+        Transform(_m, math::SplatZ(xy), math::SplatW(xy), math::SplatZ(z));
+  }
+  void TransformVectors3(const math::Float4x4& _m, const uint16_t* _n,
+                         const uint16_t* _t, math::SimdFloat4* _out_n,
+                         math::SimdFloat4* _out_t) const {
+    TransformVectors(_m, _n, _t, _out_n, _out_t);
+  }
+
+  math::SimdFloat4 Weight(const _Weight* _w, int _j) const {
+    return math::simd_float4::Load1(static_cast<float>(_w[_j])) * Unorm();
+  }
+  math::SimdFloat4 Weights4(const _Weight* _w) const {
+    return math::simd_float4::FromInt(math::simd_int4::LoadPtrU(_w)) * Unorm();
+  }
+
+ protected:
+  // _normalize is the factor that restores position values in [-1,1], it's
+  // merged with in_positions_scale.
+  CompactInputs(const SkinningJob& _job, float _normalize)
+      : scale_(math::simd_float4::Load3PtrU(&_job.in_positions_scale.x) *
+               math::simd_float4::Load1(_normalize)),
+        bias_(math::simd_float4::Load3PtrU(&_job.in_positions_bias.x)) {}
+
+  const math::SimdFloat4 scale_;
+  const math::SimdFloat4 bias_;
+
+ private:
+  // Factor that restores unorm weights in [0,1].
+  static math::SimdFloat4 Unorm() {
+    return math::simd_float4::Load1(1.f / std::numeric_limits<_Weight>::max());
+  }
+
+  // Loads normal and tangent octahedral values to xy and zw components.
+  static math::SimdInt4 Pair(const uint16_t* _n, const uint16_t* _t) {
+    const math::SimdInt4 n =
+        math::simd_int4::Load2PtrU(reinterpret_cast<const int16_t*>(_n));
+    const math::SimdInt4 t =
+        math::simd_int4::Load2PtrU(reinterpret_cast<const int16_t*>(_t));
+    return math::Or(n, math::Swizzle<2, 3, 0, 1>(t));
+  }
+
+  // Decodes 2 octahedral encoded vectors, whose x and y are stored in xy and
+  // zw components of _v. Decoded vectors are normalized. Their x and y are
+  // output to xy and zw components of _xy, and their z to xy and zw components
+  // of _z.
+  static void DecodeOctahedral(math::_SimdInt4 _v, math::SimdFloat4* _xy,
+                               math::SimdFloat4* _z) {
+    // Snorm16 values aren't rescaled to [-1,1], as vectors are normalized
+    // afterward anyway.
+    const math::SimdFloat4 v = math::simd_float4::FromInt(_v);
+    const math::SimdFloat4 abs = math::Abs(v);
+    const math::SimdFloat4 neg_z = abs + math::Swizzle<1, 0, 3, 2>(abs) -
+                                   math::simd_float4::Load1(32767.f);
+
+    // Unfolds lower hemisphere.
+    const math::SimdFloat4 fold = math::Max0(neg_z);
+    const math::SimdFloat4 xy =
+        v - math::Or(fold, math::And(v, math::simd_int4::mask_sign()));
+
+    // Normalizes. Estimated reciprocal square root precision is enough
+    // compared to 16 bits encoding precision.
+    const math::SimdFloat4 sq = xy * xy;
+    const math::SimdFloat4 inv_len = math::RSqrtEst(
+        math::MAdd(neg_z, neg_z, sq + math::Swizzle<1, 0, 3, 2>(sq)));
+    *_xy = xy * inv_len;
+    *_z = -neg_z * inv_len;
+  }
+
+  // Transforms vector (_x, _y, _z) by _m. Vector components are splat.
+  static math::SimdFloat4 Transform(const math::Float4x4& _m,
+                                    math::_SimdFloat4 _x, math::_SimdFloat4 _y,
+                                    math::_SimdFloat4 _z) {
+    const math::SimdFloat4 a01 = math::MAdd(_m.cols[1], _y, _m.cols[0] * _x);
+    return math::MAdd(_m.cols[2], _z, a01);
+  }
+};
+
+// Reads compact inputs, with half float positions.
+template <typename _Weight>
+class HalfInputs : public CompactInputs<_Weight> {
+ public:
+  typedef uint16_t PositionType;
+
+  explicit HalfInputs(const SkinningJob& _job)
+      : CompactInputs<_Weight>(_job, 1.f) {}
+
+  static const uint16_t* Positions(const SkinningJob& _job) {
+    return _job.in_positions_compact.begin();
+  }
+
+  math::SimdFloat4 Position(const uint16_t* _p) const {
+    return Decode(math::simd_int4::LoadPtrU(_p));
+  }
+  math::SimdFloat4 Position3(const uint16_t* _p) const {
+    return Decode(math::simd_int4::Load3PtrU(_p));
+  }
+
+ private:
+  math::SimdFloat4 Decode(math::_SimdInt4 _h) const {
+    return math::MAdd(math::HalfToFloat(_h), this->scale_, this->bias_);
+  }
+};
+
+// Reads compact inputs, with snorm16 positions.
+template <typename _Weight>
+class Snorm16Inputs : public CompactInputs<_Weight> {
+ public:
+  typedef uint16_t PositionType;
+
+  explicit Snorm16Inputs(const SkinningJob& _job)
+      : CompactInputs<_Weight>(_job, 1.f / 32767.f) {}
+
+  static const uint16_t* Positions(const SkinningJob& _job) {
+    return _job.in_positions_compact.begin();
+  }
+
+  math::SimdFloat4 Position(const uint16_t* _p) const {
+    return Decode(
+        math::simd_int4::LoadPtrU(reinterpret_cast<const int16_t*>(_p)));
+  }
+  math::SimdFloat4 Position3(const uint16_t* _p) const {
+    return Decode(
+        math::simd_int4::Load3PtrU(reinterpret_cast<const int16_t*>(_p)));
+  }
+
+ private:
+  // -32768 is clamped to -32767, aka -1 once normalized.
+  math::SimdFloat4 Decode(math::_SimdInt4 _s) const {
+    const math::SimdFloat4 min = math::simd_float4::Load1(-32767.f);
+    return math::MAdd(math::Max(math::simd_float4::FromInt(_s), min),
+                      this->scale_, this->bias_);
+  }
+};
+}  // namespace
+
 // For performance optimization reasons, every skinning variants (positions,
 // positions + normals, 1 to n influences...) are implemented as separate
 // specialized functions.
@@ -117,8 +480,10 @@ bool SkinningJob::Validate() const {
 // define a skeleton code (SKINNING_FN) for the skinning loop, which internally
 // calls MACRO that are shared or specialized according to skinning variants.
 
-// Defines the skeleton code for the per vertex skinning loop.
+// Defines the skeleton code for the per vertex skinning loop. Input vertices
+// are read and decoded by _Inputs policy, see FloatInputs.
 #define SKINNING_FN(_type, _it, _inf)                                        \
+  template <typename _Inputs>                                                \
   void SKINNING_FN_NAME(_type, _it, _inf)(const SkinningJob& _job) {         \
     ASSERT_##_type() ASSERT_##_it() INIT_##_type() INIT_W##_inf()            \
         const int loops = _job.vertex_count - 1;                             \
@@ -133,17 +498,17 @@ bool SkinningJob::Validate() const {
 #define SKINNING_FN_NAME(_type, _it, _inf) Skinning##_type##_it##_inf
 
 // Implements pre-conditions assertions.
-#define ASSERT_P()                                          \
-  assert(_job.vertex_count && !_job.in_positions.empty() && \
-         _job.in_normals.empty());
+#define ASSERT_P()                                        \
+  assert(_job.vertex_count && _Inputs::Positions(_job) && \
+         !HasNormals(_job));
 
-#define ASSERT_PN()                                         \
-  assert(_job.vertex_count && !_job.in_positions.empty() && \
-         !_job.in_normals.empty() && _job.in_tangents.empty());
+#define ASSERT_PN()                                       \
+  assert(_job.vertex_count && _Inputs::Positions(_job) && \
+         HasNormals(_job) && !HasTangents(_job));
 
-#define ASSERT_PNT()                                        \
-  assert(_job.vertex_count && !_job.in_positions.empty() && \
-         !_job.in_normals.empty() && !_job.in_tangents.empty());
+#define ASSERT_PNT()                                      \
+  assert(_job.vertex_count && _Inputs::Positions(_job) && \
+         HasNormals(_job) && HasTangents(_job));
 
 #define ASSERT_NOIT()
 
@@ -151,18 +516,21 @@ bool SkinningJob::Validate() const {
 
 // Implements loop initializations for positions, ...
 #define INIT_P()                                              \
+  const _Inputs inputs(_job);                                 \
   const uint16_t* joint_indices = _job.joint_indices.begin(); \
-  const float* in_positions = _job.in_positions.begin();      \
+  const typename _Inputs::PositionType* in_positions =        \
+      _Inputs::Positions(_job);                               \
   float* out_positions = _job.out_positions.begin();
 
-#define INIT_PN()                                    \
-  INIT_P();                                          \
-  const float* in_normals = _job.in_normals.begin(); \
+#define INIT_PN()                                                          \
+  INIT_P();                                                                \
+  const typename _Inputs::VectorType* in_normals = _Inputs::Normals(_job); \
   float* out_normals = _job.out_normals.begin();
 
-#define INIT_PNT()                                     \
-  INIT_PN();                                           \
-  const float* in_tangents = _job.in_tangents.begin(); \
+#define INIT_PNT()                                  \
+  INIT_PN();                                        \
+  const typename _Inputs::VectorType* in_tangents = \
+      _Inputs::Tangents(_job);                      \
   float* out_tangents = _job.out_tangents.begin();
 
 // Implements loop initializations for weights.
@@ -172,7 +540,7 @@ bool SkinningJob::Validate() const {
 
 #define INIT_W2()                                        \
   const math::SimdFloat4 one = math::simd_float4::one(); \
-  const float* joint_weights = _job.joint_weights.begin();
+  const typename _Inputs::WeightType* joint_weights = _Inputs::Weights(_job);
 
 #define INIT_W3() INIT_W2()
 
@@ -186,8 +554,9 @@ bool SkinningJob::Validate() const {
 
 #define NEXT_W1()
 
-#define NEXT_W2() \
-  joint_weights = NEXT(const float*, joint_weights, _job.joint_weights_stride);
+#define NEXT_W2()                                                          \
+  joint_weights = NEXT(const typename _Inputs::WeightType*, joint_weights, \
+                       _job.joint_weights_stride);
 
 #define NEXT_W3() NEXT_W2()
 
@@ -195,20 +564,23 @@ bool SkinningJob::Validate() const {
 
 #define NEXT_WN() NEXT_W2()
 
-#define NEXT_P()                                                             \
-  joint_indices =                                                            \
-      NEXT(const uint16_t*, joint_indices, _job.joint_indices_stride);       \
-  in_positions = NEXT(const float*, in_positions, _job.in_positions_stride); \
+#define NEXT_P()                                                           \
+  joint_indices =                                                          \
+      NEXT(const uint16_t*, joint_indices, _job.joint_indices_stride);     \
+  in_positions = NEXT(const typename _Inputs::PositionType*, in_positions, \
+                      _job.in_positions_stride);                           \
   out_positions = NEXT(float*, out_positions, _job.out_positions_stride);
 
-#define NEXT_PN()                                                      \
-  NEXT_P();                                                            \
-  in_normals = NEXT(const float*, in_normals, _job.in_normals_stride); \
+#define NEXT_PN()                                                    \
+  NEXT_P();                                                          \
+  in_normals = NEXT(const typename _Inputs::VectorType*, in_normals, \
+                    _job.in_normals_stride);                         \
   out_normals = NEXT(float*, out_normals, _job.out_normals_stride);
 
-#define NEXT_PNT()                                                        \
-  NEXT_PN();                                                              \
-  in_tangents = NEXT(const float*, in_tangents, _job.in_tangents_stride); \
+#define NEXT_PNT()                                                     \
+  NEXT_PN();                                                           \
+  in_tangents = NEXT(const typename _Inputs::VectorType*, in_tangents, \
+                     _job.in_tangents_stride);                         \
   out_tangents = NEXT(float*, out_tangents, _job.out_tangents_stride);
 
 // Implements weighted matrix preparation.
@@ -234,15 +606,15 @@ bool SkinningJob::Validate() const {
   const math::Float4x4& it_transform = \
       _job.joint_inverse_transpose_matrices[i0];
 
-#define PREPARE_2_INNER(_it)                                                   \
-  const math::SimdFloat4 w0 = math::simd_float4::Load1PtrU(joint_weights + 0); \
-  const uint16_t i0 = joint_indices[0];                                        \
-  const uint16_t i1 = joint_indices[1];                                        \
-  const math::Float4x4& m0 = _job.joint_matrices[i0];                          \
-  const math::Float4x4& m1 = _job.joint_matrices[i1];                          \
-  const math::SimdFloat4 w1 = one - w0;                                        \
-  const math::Float4x4 transform =                                             \
-      math::ColumnMultiply(m0, w0) + math::ColumnMultiply(m1, w1);             \
+#define PREPARE_2_INNER(_it)                                       \
+  const math::SimdFloat4 w0 = inputs.Weight(joint_weights, 0);     \
+  const uint16_t i0 = joint_indices[0];                            \
+  const uint16_t i1 = joint_indices[1];                            \
+  const math::Float4x4& m0 = _job.joint_matrices[i0];              \
+  const math::Float4x4& m1 = _job.joint_matrices[i1];              \
+  const math::SimdFloat4 w1 = one - w0;                            \
+  const math::Float4x4 transform =                                 \
+      math::ColumnMultiply(m0, w0) + math::ColumnMultiply(m1, w1); \
   PREPARE_##_it##_2()
 
 #define PREPARE_NOIT_2() PREPARE_NOIT()
@@ -278,15 +650,15 @@ bool SkinningJob::Validate() const {
                                       math::ColumnMultiply(mit1, w1) +    \
                                       math::ColumnMultiply(mit2, w2);
 
-#define PREPARE_3_INNER(_it)                                             \
-  const math::SimdFloat4 w = math::simd_float4::LoadPtrU(joint_weights); \
-  const math::SimdFloat4 w0 = math::SplatX(w);                           \
-  const math::SimdFloat4 w1 = math::SplatY(w);                           \
+#define PREPARE_3_INNER(_it)                                 \
+  const math::SimdFloat4 w = inputs.Weights4(joint_weights); \
+  const math::SimdFloat4 w0 = math::SplatX(w);               \
+  const math::SimdFloat4 w1 = math::SplatY(w);               \
   PREPARE_3_CONCAT(_it)
 
-#define PREPARE_3_OUTER(_it)                                                   \
-  const math::SimdFloat4 w0 = math::simd_float4::Load1PtrU(joint_weights + 0); \
-  const math::SimdFloat4 w1 = math::simd_float4::Load1PtrU(joint_weights + 1); \
+#define PREPARE_3_OUTER(_it)                                   \
+  const math::SimdFloat4 w0 = inputs.Weight(joint_weights, 0); \
+  const math::SimdFloat4 w1 = inputs.Weight(joint_weights, 1); \
   PREPARE_3_CONCAT(_it)
 
 #define PREPARE_4_CONCAT(_it)                                       \
@@ -315,27 +687,27 @@ bool SkinningJob::Validate() const {
       math::ColumnMultiply(mit0, w0) + math::ColumnMultiply(mit1, w1) +   \
       math::ColumnMultiply(mit2, w2) + math::ColumnMultiply(mit3, w3);
 
-#define PREPARE_4_INNER(_it)                                             \
-  const math::SimdFloat4 w = math::simd_float4::LoadPtrU(joint_weights); \
-  const math::SimdFloat4 w0 = math::SplatX(w);                           \
-  const math::SimdFloat4 w1 = math::SplatY(w);                           \
-  const math::SimdFloat4 w2 = math::SplatZ(w);                           \
+#define PREPARE_4_INNER(_it)                                 \
+  const math::SimdFloat4 w = inputs.Weights4(joint_weights); \
+  const math::SimdFloat4 w0 = math::SplatX(w);               \
+  const math::SimdFloat4 w1 = math::SplatY(w);               \
+  const math::SimdFloat4 w2 = math::SplatZ(w);               \
   PREPARE_4_CONCAT(_it)
 
-#define PREPARE_4_OUTER(_it)                                                   \
-  const math::SimdFloat4 w0 = math::simd_float4::Load1PtrU(joint_weights + 0); \
-  const math::SimdFloat4 w1 = math::simd_float4::Load1PtrU(joint_weights + 1); \
-  const math::SimdFloat4 w2 = math::simd_float4::Load1PtrU(joint_weights + 2); \
+#define PREPARE_4_OUTER(_it)                                   \
+  const math::SimdFloat4 w0 = inputs.Weight(joint_weights, 0); \
+  const math::SimdFloat4 w1 = inputs.Weight(joint_weights, 1); \
+  const math::SimdFloat4 w2 = inputs.Weight(joint_weights, 2); \
   PREPARE_4_CONCAT(_it)
 
 #define PREPARE_NOIT_N()                                                     \
-  math::SimdFloat4 wsum = math::simd_float4::Load1PtrU(joint_weights + 0);   \
+  math::SimdFloat4 wsum = inputs.Weight(joint_weights, 0);                   \
   math::Float4x4 transform =                                                 \
       math::ColumnMultiply(_job.joint_matrices[joint_indices[0]], wsum);     \
   const int last = _job.influences_count - 1;                                \
   for (int j = 1; j < last; ++j) {                                           \
     const math::SimdFloat4 w =                                               \
-        math::simd_float4::Load1PtrU(joint_weights + j);                     \
+        inputs.Weight(joint_weights, j);                                     \
     wsum = wsum + w;                                                         \
     transform = transform + math::ColumnMultiply(                            \
                                 _job.joint_matrices[joint_indices[j]], w);   \
@@ -346,7 +718,7 @@ bool SkinningJob::Validate() const {
   PREPARE_NOIT()
 
 #define PREPARE_IT_N()                                                        \
-  math::SimdFloat4 wsum = math::simd_float4::Load1PtrU(joint_weights + 0);    \
+  math::SimdFloat4 wsum = inputs.Weight(joint_weights, 0);                    \
   const uint16_t i0 = joint_indices[0];                                       \
   math::Float4x4 transform =                                                  \
       math::ColumnMultiply(_job.joint_matrices[i0], wsum);                    \
@@ -356,7 +728,7 @@ bool SkinningJob::Validate() const {
   for (int j = 1; j < last; ++j) {                                            \
     const uint16_t ij = joint_indices[j];                                     \
     const math::SimdFloat4 w =                                                \
-        math::simd_float4::Load1PtrU(joint_weights + j);                      \
+        inputs.Weight(joint_weights, j);                                      \
     wsum = wsum + w;                                                          \
     transform = transform + math::ColumnMultiply(_job.joint_matrices[ij], w); \
     it_transform =                                                            \
@@ -377,38 +749,44 @@ bool SkinningJob::Validate() const {
 
 // Implement point and vector transformation. _INNER and _OUTER have the same
 // meaning as defined for the PREPARE functions.
-#define TRANSFORM_P_INNER()                                                \
-  const math::SimdFloat4 in_p = math::simd_float4::LoadPtrU(in_positions); \
-  const math::SimdFloat4 out_p = TransformPoint(transform, in_p);          \
+#define TRANSFORM_P_INNER()                                       \
+  const math::SimdFloat4 in_p = inputs.Position(in_positions);    \
+  const math::SimdFloat4 out_p = TransformPoint(transform, in_p); \
   math::Store3PtrU(out_p, out_positions);
 
-#define TRANSFORM_PN_INNER()                                             \
-  TRANSFORM_P_INNER();                                                   \
-  const math::SimdFloat4 in_n = math::simd_float4::LoadPtrU(in_normals); \
-  const math::SimdFloat4 out_n = TransformVector(it_transform, in_n);    \
+#define TRANSFORM_PN_INNER()                                          \
+  TRANSFORM_P_INNER();                                                \
+  const math::SimdFloat4 out_n =                                      \
+      inputs.TransformVector(it_transform, in_normals);               \
   math::Store3PtrU(out_n, out_normals);
 
-#define TRANSFORM_PNT_INNER()                                             \
-  TRANSFORM_PN_INNER();                                                   \
-  const math::SimdFloat4 in_t = math::simd_float4::LoadPtrU(in_tangents); \
-  const math::SimdFloat4 out_t = TransformVector(it_transform, in_t);     \
+#define TRANSFORM_PNT_INNER()                                         \
+  TRANSFORM_P_INNER();                                                \
+  math::SimdFloat4 out_n;                                             \
+  math::SimdFloat4 out_t;                                             \
+  inputs.TransformVectors(it_transform, in_normals, in_tangents,      \
+                          &out_n, &out_t);                            \
+  math::Store3PtrU(out_n, out_normals);                               \
   math::Store3PtrU(out_t, out_tangents);
 
-#define TRANSFORM_P_OUTER()                                                 \
-  const math::SimdFloat4 in_p = math::simd_float4::Load3PtrU(in_positions); \
-  const math::SimdFloat4 out_p = TransformPoint(transform, in_p);           \
+#define TRANSFORM_P_OUTER()                                       \
+  const math::SimdFloat4 in_p = inputs.Position3(in_positions);   \
+  const math::SimdFloat4 out_p = TransformPoint(transform, in_p); \
   math::Store3PtrU(out_p, out_positions);
 
-#define TRANSFORM_PN_OUTER()                                              \
-  TRANSFORM_P_OUTER();                                                    \
-  const math::SimdFloat4 in_n = math::simd_float4::Load3PtrU(in_normals); \
-  const math::SimdFloat4 out_n = TransformVector(it_transform, in_n);     \
+#define TRANSFORM_PN_OUTER()                                          \
+  TRANSFORM_P_OUTER();                                                \
+  const math::SimdFloat4 out_n =                                      \
+      inputs.TransformVector3(it_transform, in_normals);              \
   math::Store3PtrU(out_n, out_normals);
 
-#define TRANSFORM_PNT_OUTER()                                              \
-  TRANSFORM_PN_OUTER();                                                    \
-  const math::SimdFloat4 in_t = math::simd_float4::Load3PtrU(in_tangents); \
-  const math::SimdFloat4 out_t = TransformVector(it_transform, in_t);      \
+#define TRANSFORM_PNT_OUTER()                                         \
+  TRANSFORM_P_OUTER();                                                \
+  math::SimdFloat4 out_n;                                             \
+  math::SimdFloat4 out_t;                                             \
+  inputs.TransformVectors3(it_transform, in_normals, in_tangents,     \
+                           &out_n, &out_t);                           \
+  math::Store3PtrU(out_n, out_normals);                               \
   math::Store3PtrU(out_t, out_tangents);
 
 // Instantiates all skinning function variants.
@@ -438,35 +816,339 @@ SKINNING_FN(PNT, NOIT, N)
 SKINNING_FN(PN, IT, N)
 SKINNING_FN(PNT, IT, N)
 
-// Defines a matrix of skinning function pointers. This matrix will then be
-// indexed according to skinning jobs parameters.
+// Defines matrices of skinning function pointers, for each inputs policy.
+// These matrices will then be indexed according to skinning jobs parameters.
 typedef void (*SkiningFct)(const SkinningJob&);
-static const SkiningFct kSkinningFct[2][5][3] = {
+
+namespace {
+// Dual quaternion skinning variants are implemented with templates, using the
+// number of influences (0 for any) and the number of vectors (normals and
+// tangents) as parameters.
+
+// Loads a vertex point or vector, using _INNER or _OUTER inputs policy
+// functions, see FloatInputs.
+struct LoadInner {
+  template <typename _Inputs>
+  static math::SimdFloat4 Position(
+      const _Inputs& _inputs, const typename _Inputs::PositionType* _p) {
+    return _inputs.Position(_p);
+  }
+  template <typename _Inputs>
+  static math::SimdFloat4 Vector(const _Inputs& _inputs,
+                                 const typename _Inputs::VectorType* _v) {
+    return _inputs.Vector(_v);
+  }
+  template <typename _Inputs>
+  static void Vectors(const _Inputs& _inputs,
+                      const typename _Inputs::VectorType* _n,
+                      const typename _Inputs::VectorType* _t,
+                      math::SimdFloat4* _out_n, math::SimdFloat4* _out_t) {
+    _inputs.Vectors(_n, _t, _out_n, _out_t);
+  }
+};
+
+struct LoadOuter {
+  template <typename _Inputs>
+  static math::SimdFloat4 Position(
+      const _Inputs& _inputs, const typename _Inputs::PositionType* _p) {
+    return _inputs.Position3(_p);
+  }
+  template <typename _Inputs>
+  static math::SimdFloat4 Vector(const _Inputs& _inputs,
+                                 const typename _Inputs::VectorType* _v) {
+    return _inputs.Vector3(_v);
+  }
+  template <typename _Inputs>
+  static void Vectors(const _Inputs& _inputs,
+                      const typename _Inputs::VectorType* _n,
+                      const typename _Inputs::VectorType* _t,
+                      math::SimdFloat4* _out_n, math::SimdFloat4* _out_t) {
+    _inputs.Vectors3(_n, _t, _out_n, _out_t);
+  }
+};
+
+// Blends and normalizes the dual quaternions influencing a vertex. Weights
+// are negated for dual quaternions that aren't in the same hemisphere as the
+// first one, so that blending follows the shortest path.
+template <int _Influences, typename _Inputs>
+OZZ_INLINE void BlendDualQuaternions(
+    const SkinningJob& _job, const _Inputs& _inputs, const uint16_t* _indices,
+    const typename _Inputs::WeightType* _weights, math::SimdFloat4* _real,
+    math::SimdFloat4* _dual) {
+  const int influences = _Influences ? _Influences : _job.influences_count;
+  const DualQuaternion& dq0 = _job.joint_dual_quaternions[_indices[0]];
+  if (influences == 1) {
+    *_real = dq0.real;
+    *_dual = dq0.dual;
+    return;
+  }
+  const math::SimdFloat4 one = math::simd_float4::one();
+  const math::SimdFloat4 w0 = _inputs.Weight(_weights, 0);
+  math::SimdFloat4 wsum = w0;
+  math::SimdFloat4 real = dq0.real * w0;
+  math::SimdFloat4 dual = dq0.dual * w0;
+  const int last = influences - 1;
+  for (int j = 1; j < influences; ++j) {
+    const DualQuaternion& dq = _job.joint_dual_quaternions[_indices[j]];
+    math::SimdFloat4 w;
+    if (j < last) {
+      w = _inputs.Weight(_weights, j);
+      wsum = wsum + w;
+    } else {
+      w = one - wsum;
+    }
+    const math::SimdInt4 opposite =
+        math::Sign(math::SplatX(math::Dot4(dq0.real, dq.real)));
+    w = math::Xor(w, opposite);
+    real = math::MAdd(dq.real, w, real);
+    dual = math::MAdd(dq.dual, w, dual);
+  }
+  const math::SimdFloat4 inv_len =
+      math::SplatX(math::RSqrtEstXNR(math::Length4Sqr(real)));
+  *_real = real * inv_len;
+  *_dual = dual * inv_len;
+}
+
+// Iterates skinning job buffers.
+template <typename _Inputs>
+struct DualQuaternionStreams {
+  typedef typename _Inputs::PositionType PositionType;
+  typedef typename _Inputs::VectorType VectorType;
+  typedef typename _Inputs::WeightType WeightType;
+
+  explicit DualQuaternionStreams(const SkinningJob& _job)
+      : joint_indices(_job.joint_indices.begin()),
+        joint_weights(_Inputs::Weights(_job)),
+        in_positions(_Inputs::Positions(_job)),
+        in_normals(_Inputs::Normals(_job)),
+        in_tangents(_Inputs::Tangents(_job)),
+        out_positions(_job.out_positions.begin()),
+        out_normals(_job.out_normals.begin()),
+        out_tangents(_job.out_tangents.begin()) {}
+
+  void Next(const SkinningJob& _job) {
+    joint_indices =
+        NEXT(const uint16_t*, joint_indices, _job.joint_indices_stride);
+    joint_weights =
+        NEXT(const WeightType*, joint_weights, _job.joint_weights_stride);
+    in_positions =
+        NEXT(const PositionType*, in_positions, _job.in_positions_stride);
+    in_normals = NEXT(const VectorType*, in_normals, _job.in_normals_stride);
+    in_tangents =
+        NEXT(const VectorType*, in_tangents, _job.in_tangents_stride);
+    out_positions = NEXT(float*, out_positions, _job.out_positions_stride);
+    out_normals = NEXT(float*, out_normals, _job.out_normals_stride);
+    out_tangents = NEXT(float*, out_tangents, _job.out_tangents_stride);
+  }
+
+  const uint16_t* joint_indices;
+  const WeightType* joint_weights;
+  const PositionType* in_positions;
+  const VectorType* in_normals;
+  const VectorType* in_tangents;
+  float* out_positions;
+  float* out_normals;
+  float* out_tangents;
+};
+
+template <int _Influences, int _Vectors, typename _Load, typename _Inputs>
+OZZ_INLINE void SkinDualQuaternionVertex(
+    const SkinningJob& _job, const _Inputs& _inputs,
+    const DualQuaternionStreams<_Inputs>& _s) {
+  math::SimdFloat4 real;
+  math::SimdFloat4 dual;
+  BlendDualQuaternions<_Influences>(_job, _inputs, _s.joint_indices,
+                                    _s.joint_weights, &real, &dual);
+  const math::SimdQuaternion rotation = {real};
+
+  // Translation is 2 * (real.w * dual.xyz - dual.w * real.xyz +
+  // cross(real.xyz, dual.xyz)).
+  const math::SimdFloat4 translation =
+      math::MAdd(math::SplatW(real), dual,
+                 math::NMAdd(math::SplatW(dual), real,
+                             math::Cross3(real, dual)));
+  const math::SimdFloat4 in_p = _Load::Position(_inputs, _s.in_positions);
+  const math::SimdFloat4 out_p =
+      TransformVector(rotation, in_p) + translation + translation;
+  math::Store3PtrU(out_p, _s.out_positions);
+
+  if (_Vectors == 1) {
+    const math::SimdFloat4 in_n = _Load::Vector(_inputs, _s.in_normals);
+    math::Store3PtrU(TransformVector(rotation, in_n), _s.out_normals);
+  } else if (_Vectors == 2) {
+    math::SimdFloat4 in_n;
+    math::SimdFloat4 in_t;
+    _Load::Vectors(_inputs, _s.in_normals, _s.in_tangents, &in_n, &in_t);
+    math::Store3PtrU(TransformVector(rotation, in_n), _s.out_normals);
+    math::Store3PtrU(TransformVector(rotation, in_t), _s.out_tangents);
+  }
+}
+
+template <typename _Inputs, int _Influences, int _Vectors>
+void SkinningDualQuaternion(const SkinningJob& _job) {
+  assert(_job.vertex_count && !_job.joint_dual_quaternions.empty());
+  const _Inputs inputs(_job);
+  DualQuaternionStreams<_Inputs> streams(_job);
+  const int loops = _job.vertex_count - 1;
+  for (int i = 0; i < loops; ++i) {
+    SkinDualQuaternionVertex<_Influences, _Vectors, LoadInner>(_job, inputs,
+                                                               streams);
+    streams.Next(_job);
+  }
+  SkinDualQuaternionVertex<_Influences, _Vectors, LoadOuter>(_job, inputs,
+                                                             streams);
+}
+
+// Matrix and dual quaternion skinning function pointers for _Inputs policy.
+// Dual quaternion matrix is indexed the same way as kMatrix, without the
+// inverse transpose dimension.
+template <typename _Inputs>
+struct SkinningFcts {
+  static const SkiningFct kMatrix[2][5][3];
+  static const SkiningFct kDualQuaternion[5][3];
+};
+
+// Gets skinning function variant address, for _Inputs policy.
+#define SKINNING_FCT(_type, _it, _inf) \
+  &SKINNING_FN_NAME(_type, _it, _inf)<_Inputs>
+
+template <typename _Inputs>
+const SkiningFct SkinningFcts<_Inputs>::kMatrix[2][5][3] = {
     {
-        {&SKINNING_FN_NAME(P, NOIT, 1), &SKINNING_FN_NAME(PN, NOIT, 1),
-         &SKINNING_FN_NAME(PNT, NOIT, 1)},
-        {&SKINNING_FN_NAME(P, NOIT, 2), &SKINNING_FN_NAME(PN, NOIT, 2),
-         &SKINNING_FN_NAME(PNT, NOIT, 2)},
-        {&SKINNING_FN_NAME(P, NOIT, 3), &SKINNING_FN_NAME(PN, NOIT, 3),
-         &SKINNING_FN_NAME(PNT, NOIT, 3)},
-        {&SKINNING_FN_NAME(P, NOIT, 4), &SKINNING_FN_NAME(PN, NOIT, 4),
-         &SKINNING_FN_NAME(PNT, NOIT, 4)},
-        {&SKINNING_FN_NAME(P, NOIT, N), &SKINNING_FN_NAME(PN, NOIT, N),
-         &SKINNING_FN_NAME(PNT, NOIT, N)},
+        {SKINNING_FCT(P, NOIT, 1), SKINNING_FCT(PN, NOIT, 1),
+         SKINNING_FCT(PNT, NOIT, 1)},
+        {SKINNING_FCT(P, NOIT, 2), SKINNING_FCT(PN, NOIT, 2),
+         SKINNING_FCT(PNT, NOIT, 2)},
+        {SKINNING_FCT(P, NOIT, 3), SKINNING_FCT(PN, NOIT, 3),
+         SKINNING_FCT(PNT, NOIT, 3)},
+        {SKINNING_FCT(P, NOIT, 4), SKINNING_FCT(PN, NOIT, 4),
+         SKINNING_FCT(PNT, NOIT, 4)},
+        {SKINNING_FCT(P, NOIT, N), SKINNING_FCT(PN, NOIT, N),
+         SKINNING_FCT(PNT, NOIT, N)},
     },
     {
-        {&SKINNING_FN_NAME(P, NOIT, 1), &SKINNING_FN_NAME(PN, IT, 1),
-         &SKINNING_FN_NAME(PNT, IT, 1)},
-        {&SKINNING_FN_NAME(P, NOIT, 2), &SKINNING_FN_NAME(PN, IT, 2),
-         &SKINNING_FN_NAME(PNT, IT, 2)},
-        {&SKINNING_FN_NAME(P, NOIT, 3), &SKINNING_FN_NAME(PN, IT, 3),
-         &SKINNING_FN_NAME(PNT, IT, 3)},
-        {&SKINNING_FN_NAME(P, NOIT, 4), &SKINNING_FN_NAME(PN, IT, 4),
-         &SKINNING_FN_NAME(PNT, IT, 4)},
-        {&SKINNING_FN_NAME(P, NOIT, N), &SKINNING_FN_NAME(PN, IT, N),
-         &SKINNING_FN_NAME(PNT, IT, N)},
+        {SKINNING_FCT(P, NOIT, 1), SKINNING_FCT(PN, IT, 1),
+         SKINNING_FCT(PNT, IT, 1)},
+        {SKINNING_FCT(P, NOIT, 2), SKINNING_FCT(PN, IT, 2),
+         SKINNING_FCT(PNT, IT, 2)},
+        {SKINNING_FCT(P, NOIT, 3), SKINNING_FCT(PN, IT, 3),
+         SKINNING_FCT(PNT, IT, 3)},
+        {SKINNING_FCT(P, NOIT, 4), SKINNING_FCT(PN, IT, 4),
+         SKINNING_FCT(PNT, IT, 4)},
+        {SKINNING_FCT(P, NOIT, N), SKINNING_FCT(PN, IT, N),
+         SKINNING_FCT(PNT, IT, N)},
     }};
 
+template <typename _Inputs>
+const SkiningFct SkinningFcts<_Inputs>::kDualQuaternion[5][3] = {
+    {&SkinningDualQuaternion<_Inputs, 1, 0>,
+     &SkinningDualQuaternion<_Inputs, 1, 1>,
+     &SkinningDualQuaternion<_Inputs, 1, 2>},
+    {&SkinningDualQuaternion<_Inputs, 2, 0>,
+     &SkinningDualQuaternion<_Inputs, 2, 1>,
+     &SkinningDualQuaternion<_Inputs, 2, 2>},
+    {&SkinningDualQuaternion<_Inputs, 3, 0>,
+     &SkinningDualQuaternion<_Inputs, 3, 1>,
+     &SkinningDualQuaternion<_Inputs, 3, 2>},
+    {&SkinningDualQuaternion<_Inputs, 4, 0>,
+     &SkinningDualQuaternion<_Inputs, 4, 1>,
+     &SkinningDualQuaternion<_Inputs, 4, 2>},
+    {&SkinningDualQuaternion<_Inputs, 0, 0>,
+     &SkinningDualQuaternion<_Inputs, 0, 1>,
+     &SkinningDualQuaternion<_Inputs, 0, 2>}};
+
+// Offsets _span begin by _bytes.
+template <typename _Type>
+span<_Type> Advance(span<_Type> _span, size_t _bytes) {
+  if (_span.empty()) {
+    return _span;
+  }
+  return {NEXT(_Type*, _span.begin(), _bytes), _span.end()};
+}
+
+// Returns a copy of _job restricted to _count vertices, starting from vertex
+// _from. All vertex buffers are offset, whatever their format.
+SkinningJob VertexRange(const SkinningJob& _job, int _from, int _count) {
+  SkinningJob job = _job;
+  job.vertex_count = _count;
+  job.joint_indices =
+      Advance(_job.joint_indices, _job.joint_indices_stride * _from);
+  job.joint_weights =
+      Advance(_job.joint_weights, _job.joint_weights_stride * _from);
+  job.joint_weights_unorm8 =
+      Advance(_job.joint_weights_unorm8, _job.joint_weights_stride * _from);
+  job.joint_weights_unorm16 =
+      Advance(_job.joint_weights_unorm16, _job.joint_weights_stride * _from);
+  job.in_positions =
+      Advance(_job.in_positions, _job.in_positions_stride * _from);
+  job.in_positions_compact =
+      Advance(_job.in_positions_compact, _job.in_positions_stride * _from);
+  job.in_normals = Advance(_job.in_normals, _job.in_normals_stride * _from);
+  job.in_normals_compact =
+      Advance(_job.in_normals_compact, _job.in_normals_stride * _from);
+  job.in_tangents = Advance(_job.in_tangents, _job.in_tangents_stride * _from);
+  job.in_tangents_compact =
+      Advance(_job.in_tangents_compact, _job.in_tangents_stride * _from);
+  job.out_positions =
+      Advance(_job.out_positions, _job.out_positions_stride * _from);
+  job.out_normals = Advance(_job.out_normals, _job.out_normals_stride * _from);
+  job.out_tangents =
+      Advance(_job.out_tangents, _job.out_tangents_stride * _from);
+  return job;
+}
+
+// Finds skinning function for _Inputs policy.
+template <typename _Inputs>
+SkiningFct GetSkinningFct(const SkinningJob& _job) {
+  typedef SkinningFcts<_Inputs> Fcts;
+
+  // Find skinning function index.
+  const size_t it = !_job.joint_inverse_transpose_matrices.empty();
+  assert(it < OZZ_ARRAY_SIZE(Fcts::kMatrix));
+  const size_t inf = static_cast<size_t>(_job.influences_count) >
+                             OZZ_ARRAY_SIZE(Fcts::kMatrix[0])
+                         ? OZZ_ARRAY_SIZE(Fcts::kMatrix[0]) - 1
+                         : _job.influences_count - 1;
+  assert(inf < OZZ_ARRAY_SIZE(Fcts::kMatrix[0]));
+  const bool normals = HasNormals(_job);
+  const size_t fct = normals + (normals && HasTangents(_job));
+  assert(fct < OZZ_ARRAY_SIZE(Fcts::kMatrix[0][0]));
+
+  return _job.joint_dual_quaternions.empty() ? Fcts::kMatrix[it][inf][fct]
+                                             : Fcts::kDualQuaternion[inf][fct];
+}
+
+// Skins all vertices of a valid _job.
+void Skin(const SkinningJob& _job) {
+  assert(_job.vertex_count > 0);
+
+  // Compact inputs are decoded by the skinning function itself, while
+  // loading each vertex.
+  SkiningFct skinning_fct;
+  switch (_job.format) {
+    case SkinningJob::kHalfUnorm8:
+      skinning_fct = GetSkinningFct<HalfInputs<uint8_t> >(_job);
+      break;
+    case SkinningJob::kHalfUnorm16:
+      skinning_fct = GetSkinningFct<HalfInputs<uint16_t> >(_job);
+      break;
+    case SkinningJob::kSnorm16Unorm8:
+      skinning_fct = GetSkinningFct<Snorm16Inputs<uint8_t> >(_job);
+      break;
+    case SkinningJob::kSnorm16Unorm16:
+      skinning_fct = GetSkinningFct<Snorm16Inputs<uint16_t> >(_job);
+      break;
+    default:
+      assert(_job.format == SkinningJob::kFloat);
+      skinning_fct = GetSkinningFct<FloatInputs>(_job);
+      break;
+  }
+
+  // Calls skinning function. Cannot fail because job is valid.
+  skinning_fct(_job);
+}
+}  // namespace
+
 // Implements job Run function.
 bool SkinningJob::Run() const {
   // Exit with an error if job is invalid.
@@ -476,23 +1158,155 @@ bool SkinningJob::Run() const {
 
   // Early out if no vertex. This isn't an error.
   // Skinning function algorithm doesn't support the case.
+  if (vertex_count != 0) {
+    Skin(*this);
+  }
+
+  return true;
+}
+
+bool SkinningJob::Run(int _begin, int _end) const {
+  // Exit with an error if job or range is invalid.
+  if (!Validate() || _begin < 0 || _begin > _end || _end > vertex_count) {
+    return false;
+  }
+
+  // Empty ranges aren't an error.
+  if (_begin != _end) {
+    Skin(VertexRange(*this, _begin, _end - _begin));
+  }
+
+  return true;
+}
+
+ParallelSkinningJob::ParallelSkinningJob()
+    : max_task_count(1), min_task_vertex_count(1024) {}
+
+bool ParallelSkinningJob::Validate() const {
+  bool valid = job.Validate();
+  valid &= max_task_count > 0;
+  valid &= min_task_vertex_count > 0;
+  return valid;
+}
+
+namespace {
+// Assumed cache line size, in bytes. 64 bytes is the most common size, and a
+// divisor of bigger ones.
+const size_t kCacheLineSize = 64;
+
+// Returns the number of vertices of a _stride bytes buffer that are needed to
+// cover a whole number of cache lines.
+size_t CacheLineVertices(size_t _stride) {
+  size_t alignment = kCacheLineSize;
+  while (_stride % alignment) {
+    alignment /= 2;
+  }
+  return kCacheLineSize / alignment;
+}
+
+// Counts _job output buffers whose _vertex starts a cache line. Outputs
+// interleaved with a lower one (same stride, starting within its first vertex)
+// are written in the same cache lines, so only the lower one is tested.
+int LineStartOutputs(const SkinningJob& _job, size_t _vertex) {
+  const span<float> outputs[] = {_job.out_positions, _job.out_normals,
+                                 _job.out_tangents};
+  const size_t strides[] = {_job.out_positions_stride,
+                            _job.out_normals_stride,
+                            _job.out_tangents_stride};
+  int count = 0;
+  for (size_t i = 0; i < OZZ_ARRAY_SIZE(outputs); ++i) {
+    if (outputs[i].empty()) {
+      continue;
+    }
+    const uintptr_t begin = reinterpret_cast<uintptr_t>(outputs[i].begin());
+    bool interleaved = false;
+    for (size_t j = 0; j < OZZ_ARRAY_SIZE(outputs); ++j) {
+      const uintptr_t other = reinterpret_cast<uintptr_t>(outputs[j].begin());
+      interleaved |= !outputs[j].empty() && strides[j] == strides[i] &&
+                     other < begin && begin - other < strides[i];
+    }
+    const uintptr_t address = begin + _vertex * strides[i];
+    count += !interleaved && address % kCacheLineSize == 0;
+  }
+  return count;
+}
+
+// Skins a range of vertices. Ranges are [_index * size, (_index + 1) * size[,
+// offset by first (to align boundaries on cache lines), and clamped to job
+// vertices.
+class SkinningTask {
+ public:
+  SkinningTask(const SkinningJob& _job, int _first, int _size)
+      : job_(&_job), first_(_first), size_(_size) {}
+
+  void operator()(int _index) const {
+    const int begin = _index == 0 ? 0 : first_ + _index * size_;
+    const int end =
+        math::Min(first_ + (_index + 1) * size_, job_->vertex_count);
+    Skin(VertexRange(*job_, begin, end - begin));
+  }
+
+ private:
+  const SkinningJob* job_;
+  int first_;
+  int size_;
+};
+}  // namespace
+
+bool ParallelSkinningJob::Run() const {
+  if (!Validate()) {
+    return false;
+  }
+
+  // Early out if no vertex. This isn't an error.
+  const int vertex_count = job.vertex_count;
   if (vertex_count == 0) {
     return true;
   }
 
-  // Find skinning function index.
-  const size_t it = !joint_inverse_transpose_matrices.empty();
-  assert(it < OZZ_ARRAY_SIZE(kSkinningFct));
-  const size_t inf =
-      static_cast<size_t>(influences_count) > OZZ_ARRAY_SIZE(kSkinningFct[0])
-          ? OZZ_ARRAY_SIZE(kSkinningFct[0]) - 1
-          : influences_count - 1;
-  assert(inf < OZZ_ARRAY_SIZE(kSkinningFct[0]));
-  const size_t fct = !in_normals.empty() + !in_tangents.empty();
-  assert(fct < OZZ_ARRAY_SIZE(kSkinningFct[0][0]));
+  // Ranges size is a multiple of the number of vertices covering whole cache
+  // lines, for all outputs. These are all powers of 2, so the biggest one is a
+  // multiple of the others.
+  size_t line_vertices = CacheLineVertices(job.out_positions_stride);
+  if (!job.out_normals.empty()) {
+    line_vertices =
+        math::Max(line_vertices, CacheLineVertices(job.out_normals_stride));
+  }
+  if (!job.out_tangents.empty()) {
+    line_vertices =
+        math::Max(line_vertices, CacheLineVertices(job.out_tangents_stride));
+  }
 
-  // Calls skinning function. Cannot fail because job is valid.
-  kSkinningFct[it][inf][fct](*this);
+  // Finds the first vertex that starts a cache line in all outputs. Depending
+  // on outputs addresses and strides, there might be none, in which case the
+  // vertex that starts a cache line in most outputs is used.
+  int first = 0;
+  int best = 0;
+  for (size_t i = 0; i < line_vertices; ++i) {
+    const int aligned = LineStartOutputs(job, i);
+    if (aligned > best) {
+      first = static_cast<int>(i);
+      best = aligned;
+    }
+  }
+
+  // Computes ranges size, rounded up to whole cache lines.
+  const int max_tasks = math::Min(
+      max_task_count, math::Max(vertex_count / min_task_vertex_count, 1));
+  const int lines = static_cast<int>(line_vertices);
+  int size = (vertex_count + max_tasks - 1) / max_tasks;
+  size = (size + lines - 1) / lines * lines;
+  const int num_tasks =
+      vertex_count > first ? (vertex_count - first + size - 1) / size : 1;
+
+  const SkinningTask task(job, first, size);
+  if (task_runner && num_tasks > 1) {
+    task_runner(num_tasks, task);
+  } else {
+    for (int i = 0; i < num_tasks; ++i) {
+      task(i);
+    }
+  }
 
   return true;
 }
@@ -0,0 +1,210 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+
+#include "ozz/geometry/runtime/skinning_palette_job.h"
+
+#include <cassert>
+
+#include "ozz/base/maths/simd_float3x4.h"
+#include "ozz/base/maths/simd_math.h"
+
+namespace ozz {
+namespace geometry {
+
+bool SkinningPaletteJob::Validate() const {
+  // Don't need any early out, as jobs are valid in most of the performance
+  // critical cases.
+  // Tests are written in multiple lines in order to avoid branches.
+  // Exactly one of joint_matrices and joint_matrices_3x4 is set.
+  bool valid = joint_matrices.empty() != joint_matrices_3x4.empty();
+
+  const size_t num_joints = joint_matrices.empty() ? joint_matrices_3x4.size()
+                                                   : joint_matrices.size();
+  for (const uint16_t remap : joint_remaps) {
+    valid &= remap < num_joints;
+  }
+
+  const size_t palette_size =
+      joint_remaps.empty() ? num_joints : joint_remaps.size();
+  valid &= inverse_bind_poses.size() >= palette_size;
+
+  // Exactly one of output and output_3x4 is set.
+  valid &= output.empty() != output_3x4.empty();
+  valid &= output.empty() || output.size() >= palette_size;
+  valid &= output_3x4.empty() || output_3x4.size() >= palette_size;
+  valid &= output_inverse_transpose.empty() ||
+           output_inverse_transpose.size() >= palette_size;
+
+  return valid;
+}
+
+namespace {
+// Computes the inverse transpose of affine matrix _m.
+math::Float4x4 InverseTranspose(const math::Float4x4& _m) {
+  using math::SimdFloat4;
+  const SimdFloat4 zero = math::simd_float4::zero();
+
+  // Computes axes squared lengths (xyz) and dot products (xyz), with SoA
+  // horizontal sums.
+  const SimdFloat4 c0 = _m.cols[0];
+  const SimdFloat4 c1 = _m.cols[1];
+  const SimdFloat4 c2 = _m.cols[2];
+  const SimdFloat4 squares[4] = {c0 * c0, c1 * c1, c2 * c2, zero};
+  const SimdFloat4 dots[4] = {c0 * c1, c0 * c2, c1 * c2, zero};
+  SimdFloat4 tsquares[4];
+  SimdFloat4 tdots[4];
+  math::Transpose4x4(squares, tsquares);
+  math::Transpose4x4(dots, tdots);
+  const SimdFloat4 len2 = tsquares[0] + tsquares[1] + tsquares[2];
+  const SimdFloat4 dot = tdots[0] + tdots[1] + tdots[2];
+
+  // Axes are orthogonal if every dot(ci, cj)^2 is negligible compared to
+  // |ci|^2 * |cj|^2.
+  const SimdFloat4 len2_pairs = math::Swizzle<0, 0, 1, 3>(len2) *
+                                math::Swizzle<1, 2, 2, 3>(len2);
+  const SimdFloat4 tolerance = math::simd_float4::Load1(1e-8f);
+  const bool orthogonal =
+      math::AreAllTrue3(math::CmpLe(dot * dot, len2_pairs * tolerance)) &&
+      math::AreAllTrue3(math::CmpGt(len2, zero));
+  if (!orthogonal) {
+    return Transpose(Invert(_m));
+  }
+
+  // Fast path, when _m upper 3x3 is A = R * S, with R a rotation and S a
+  // scale. Rows of inv(A) = inv(S) * transpose(R) are A columns divided by
+  // their squared length.
+  const SimdFloat4 inv_len2 = math::simd_float4::one() / len2;
+  const SimdFloat4 inv_rows[4] = {c0 * math::SplatX(inv_len2),
+                                  c1 * math::SplatY(inv_len2),
+                                  c2 * math::SplatZ(inv_len2),
+                                  math::simd_float4::w_axis()};
+  math::Float4x4 inv;
+  math::Transpose4x4(inv_rows, inv.cols);
+
+  // Inverse translation is -inv(A) * t.
+  inv.cols[3] = math::simd_float4::w_axis() - TransformVector(inv, _m.cols[3]);
+  return Transpose(inv);
+}
+
+// Computes the skinning matrix of a palette entry, from its joint matrix.
+math::Float4x4 Skinning(const math::Float4x4& _joint,
+                        const math::Float4x4& _inverse_bind_pose) {
+  return _joint * _inverse_bind_pose;
+}
+
+// 3x4 joint matrices are multiplied by the 3x4 affine part of inverse bind
+// poses, which only requires a transposition.
+math::Float3x4 Skinning(const math::Float3x4& _joint,
+                        const math::Float4x4& _inverse_bind_pose) {
+  return _joint * math::Float3x4::FromFloat4x4(_inverse_bind_pose);
+}
+
+// Stores skinning matrix _m to _output, converting it if needed.
+void Store(const math::Float4x4& _m, math::Float4x4* _output) {
+  *_output = _m;
+}
+void Store(const math::Float4x4& _m, math::Float3x4* _output) {
+  *_output = math::Float3x4::FromFloat4x4(_m);
+}
+void Store(const math::Float3x4& _m, math::Float4x4* _output) {
+  *_output = math::ToFloat4x4(_m);
+}
+void Store(const math::Float3x4& _m, math::Float3x4* _output) {
+  *_output = _m;
+}
+
+math::Float4x4 InverseTranspose(const math::Float3x4& _m) {
+  return InverseTranspose(math::ToFloat4x4(_m));
+}
+
+// Builds the palette from _Joint matrices to _Output matrices, 4 entries per
+// iteration. Output selection is resolved by template arguments, out of the
+// loop.
+template <typename _Joint, typename _Output, bool _InverseTranspose>
+void BuildPalette(const SkinningPaletteJob& _job, span<const _Joint> _joints,
+                  span<_Output> _output) {
+  const span<const uint16_t>& remaps = _job.joint_remaps;
+  const int palette_size =
+      static_cast<int>(remaps.empty() ? _joints.size() : remaps.size());
+  for (int i = 0; i < palette_size; i += 4) {
+    // Last batch might be incomplete, in which case the last entry is
+    // duplicated (and overwritten).
+    int entries[4];
+    _Joint skinning[4];
+    for (int j = 0; j < 4; ++j) {
+      const int entry = i + j < palette_size ? i + j : palette_size - 1;
+      const int joint = remaps.empty() ? entry : remaps[entry];
+      entries[j] = entry;
+      skinning[j] = Skinning(_joints[joint], _job.inverse_bind_poses[entry]);
+    }
+    for (int j = 0; j < 4; ++j) {
+      Store(skinning[j], &_output[entries[j]]);
+    }
+    if (_InverseTranspose) {
+      for (int j = 0; j < 4; ++j) {
+        _job.output_inverse_transpose[entries[j]] =
+            InverseTranspose(skinning[j]);
+      }
+    }
+  }
+}
+
+template <typename _Joint, typename _Output>
+void BuildPalette(const SkinningPaletteJob& _job, span<const _Joint> _joints,
+                  span<_Output> _output) {
+  if (_job.output_inverse_transpose.empty()) {
+    BuildPalette<_Joint, _Output, false>(_job, _joints, _output);
+  } else {
+    BuildPalette<_Joint, _Output, true>(_job, _joints, _output);
+  }
+}
+
+template <typename _Joint>
+void BuildPalette(const SkinningPaletteJob& _job, span<const _Joint> _joints) {
+  if (!_job.output.empty()) {
+    BuildPalette(_job, _joints, _job.output);
+  } else {
+    BuildPalette(_job, _joints, _job.output_3x4);
+  }
+}
+}  // namespace
+
+bool SkinningPaletteJob::Run() const {
+  if (!Validate()) {
+    return false;
+  }
+
+  if (!joint_matrices.empty()) {
+    BuildPalette(*this, joint_matrices);
+  } else {
+    BuildPalette(*this, joint_matrices_3x4);
+  }
+  return true;
+}
+}  // namespace geometry
+}  // namespace ozz
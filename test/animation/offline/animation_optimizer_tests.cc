@@ -27,6 +27,11 @@
 
 #include "ozz/animation/offline/animation_optimizer.h"
 
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <thread>
+
 #include "gtest/gtest.h"
 
 #include "ozz/base/maths/math_constant.h"
@@ -670,3 +675,108 @@ TEST(OptimizeOverride, AnimationOptimizer) {
     input.tracks[4].scales.clear();
   }
 }
+
+namespace {
+// Compares all keys of _a and _b.
+void ExpectSameKeys(const RawAnimation& _a, const RawAnimation& _b) {
+  ASSERT_EQ(_a.num_tracks(), _b.num_tracks());
+  for (int i = 0; i < _a.num_tracks(); ++i) {
+    const RawAnimation::JointTrack& a = _a.tracks[i];
+    const RawAnimation::JointTrack& b = _b.tracks[i];
+    ASSERT_EQ(a.translations.size(), b.translations.size());
+    ASSERT_EQ(a.rotations.size(), b.rotations.size());
+    ASSERT_EQ(a.scales.size(), b.scales.size());
+    EXPECT_TRUE(a.translations.empty() ||
+                std::memcmp(a.translations.data(), b.translations.data(),
+                            a.translations.size() *
+                                sizeof(RawAnimation::TranslationKey)) == 0);
+    EXPECT_TRUE(a.rotations.empty() ||
+                std::memcmp(a.rotations.data(), b.rotations.data(),
+                            a.rotations.size() *
+                                sizeof(RawAnimation::RotationKey)) == 0);
+    EXPECT_TRUE(
+        a.scales.empty() ||
+        std::memcmp(a.scales.data(), b.scales.data(),
+                    a.scales.size() * sizeof(RawAnimation::ScaleKey)) == 0);
+  }
+}
+}  // namespace
+
+TEST(TaskRunner, AnimationOptimizer) {
+  // Builds a chain skeleton.
+  const int kNumJoints = 23;
+  RawSkeleton raw_skeleton;
+  raw_skeleton.roots.resize(1);
+  RawSkeleton::Joint* joint = &raw_skeleton.roots[0];
+  for (int i = 1; i < kNumJoints; ++i) {
+    joint->children.resize(1);
+    joint = &joint->children[0];
+  }
+  SkeletonBuilder skeleton_builder;
+  ozz::unique_ptr<Skeleton> skeleton(skeleton_builder(raw_skeleton));
+  ASSERT_TRUE(skeleton);
+  ASSERT_EQ(skeleton->num_joints(), kNumJoints);
+
+  // Builds a noisy animation, so that some keys are decimated and some aren't.
+  RawAnimation input;
+  input.duration = 1.f;
+  input.tracks.resize(kNumJoints);
+  for (int i = 0; i < kNumJoints; ++i) {
+    RawAnimation::JointTrack& track = input.tracks[i];
+    for (int k = 0; k < 100; ++k) {
+      const float time = k / 99.f;
+      const float noise = std::sin(k * 1.7f + i) * (i % 4) * 1e-3f;
+      const RawAnimation::TranslationKey tkey = {
+          time, ozz::math::Float3(time + noise, 1.f, noise)};
+      track.translations.push_back(tkey);
+      const RawAnimation::RotationKey rkey = {
+          time, ozz::math::Quaternion::FromAxisAngle(
+                    ozz::math::Float3::y_axis(), time + noise)};
+      track.rotations.push_back(rkey);
+      const RawAnimation::ScaleKey skey = {
+          time, ozz::math::Float3(1.f + noise, 1.f, 1.f)};
+      track.scales.push_back(skey);
+    }
+  }
+  ASSERT_TRUE(input.Validate());
+
+  AnimationOptimizer optimizer;
+  RawAnimation serial;
+  ASSERT_TRUE(optimizer(input, *skeleton, &serial));
+
+  {  // Runs tasks in reverse order.
+    int calls = 0;
+    optimizer.task_runner = [&calls](int _count,
+                                     const std::function<void(int)>& _task) {
+      ++calls;
+      for (int i = _count - 1; i >= 0; --i) {
+        _task(i);
+      }
+    };
+    RawAnimation output;
+    ASSERT_TRUE(optimizer(input, *skeleton, &output));
+    EXPECT_EQ(calls, 1);
+    ExpectSameKeys(serial, output);
+  }
+
+  {  // Runs tasks concurrently.
+    optimizer.task_runner = [](int _count,
+                               const std::function<void(int)>& _task) {
+      std::atomic_int next(0);
+      std::thread threads[4];
+      for (std::thread& thread : threads) {
+        thread = std::thread([&next, &_task, _count]() {
+          for (int i = next++; i < _count; i = next++) {
+            _task(i);
+          }
+        });
+      }
+      for (std::thread& thread : threads) {
+        thread.join();
+      }
+    };
+    RawAnimation output;
+    ASSERT_TRUE(optimizer(input, *skeleton, &output));
+    ExpectSameKeys(serial, output);
+  }
+}
@@ -0,0 +1,157 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+
+#include "ozz/animation/offline/float_curves_builder.h"
+
+#include "gtest/gtest.h"
+
+#include "ozz/base/io/archive.h"
+#include "ozz/base/io/stream.h"
+#include "ozz/base/memory/unique_ptr.h"
+
+#include "ozz/animation/offline/raw_float_curves.h"
+#include "ozz/animation/runtime/float_curves.h"
+
+using ozz::animation::FloatCurves;
+using ozz::animation::offline::FloatCurvesBuilder;
+using ozz::animation::offline::RawFloatCurves;
+using ozz::animation::offline::RawFloatTrack;
+using ozz::animation::offline::RawTrackInterpolation;
+
+TEST(Error, FloatCurvesBuilder) {
+  FloatCurvesBuilder builder;
+
+  {  // Building an empty RawFloatCurves succeeds.
+    RawFloatCurves raw_curves;
+    EXPECT_TRUE(raw_curves.Validate());
+    ozz::unique_ptr<FloatCurves> curves(builder(raw_curves));
+    ASSERT_TRUE(curves);
+    EXPECT_EQ(curves->num_curves(), 0);
+    EXPECT_EQ(curves->num_soa_curves(), 0);
+    EXPECT_EQ(curves->keys().size(), 0u);
+  }
+
+  {  // An invalid curve fails.
+    RawFloatCurves raw_curves;
+    raw_curves.curves.resize(2);
+    const RawFloatTrack::Keyframe key0 = {RawTrackInterpolation::kLinear, .8f,
+                                          0.f};
+    const RawFloatTrack::Keyframe key1 = {RawTrackInterpolation::kLinear, .2f,
+                                          0.f};
+    raw_curves.curves[1].keyframes.push_back(key0);
+    raw_curves.curves[1].keyframes.push_back(key1);
+    EXPECT_FALSE(raw_curves.Validate());
+    EXPECT_FALSE(builder(raw_curves));
+  }
+
+  {  // Too many curves fails.
+    RawFloatCurves raw_curves;
+    raw_curves.curves.resize(FloatCurves::kMaxCurves + 1);
+    EXPECT_FALSE(raw_curves.Validate());
+    EXPECT_FALSE(builder(raw_curves));
+
+    raw_curves.curves.resize(FloatCurves::kMaxCurves);
+    EXPECT_TRUE(raw_curves.Validate());
+    ozz::unique_ptr<FloatCurves> curves(builder(raw_curves));
+    ASSERT_TRUE(curves);
+    EXPECT_EQ(curves->num_curves(), FloatCurves::kMaxCurves);
+  }
+}
+
+TEST(Build, FloatCurvesBuilder) {
+  FloatCurvesBuilder builder;
+  RawFloatCurves raw_curves;
+  raw_curves.name = "curves";
+  raw_curves.curves.resize(5);
+
+  // Curve 2 needs no first or last key.
+  const RawFloatTrack::Keyframe key0 = {RawTrackInterpolation::kLinear, 0.f,
+                                        1.f};
+  const RawFloatTrack::Keyframe key1 = {RawTrackInterpolation::kStep, .5f,
+                                        2.f};
+  const RawFloatTrack::Keyframe key2 = {RawTrackInterpolation::kLinear, 1.f,
+                                        3.f};
+  raw_curves.curves[2].keyframes.push_back(key0);
+  raw_curves.curves[2].keyframes.push_back(key1);
+  raw_curves.curves[2].keyframes.push_back(key2);
+
+  // Curve 3 needs both.
+  raw_curves.curves[3].keyframes.push_back(key1);
+  const RawFloatTrack::Keyframe key3 = {RawTrackInterpolation::kLinear, .7f,
+                                        4.f};
+  raw_curves.curves[3].keyframes.push_back(key3);
+
+  ozz::unique_ptr<FloatCurves> curves(builder(raw_curves));
+  ASSERT_TRUE(curves);
+
+  EXPECT_STREQ(curves->name(), "curves");
+  EXPECT_EQ(curves->num_curves(), 5);
+  EXPECT_EQ(curves->num_soa_curves(), 2);
+
+  // 2 keys for each of the 8 soa curves, plus 1 for curve 2 and 2 for curve
+  // 3.
+  EXPECT_EQ(curves->keys().size(), 8u * 2u + 1u + 2u);
+  EXPECT_LT(curves->size(), sizeof(FloatCurves) + 19 * 16);
+}
+
+TEST(Serialize, RawFloatCurves) {
+  RawFloatCurves o_curves;
+  o_curves.name = "raw curves";
+  o_curves.curves.resize(3);
+  const RawFloatTrack::Keyframe key = {RawTrackInterpolation::kStep, .5f,
+                                       46.f};
+  o_curves.curves[1].keyframes.push_back(key);
+  o_curves.curves[1].name = "curve 1";
+
+  for (int e = 0; e < 2; ++e) {
+    ozz::Endianness endianess = e == 0 ? ozz::kBigEndian : ozz::kLittleEndian;
+
+    ozz::io::MemoryStream stream;
+
+    // Streams out.
+    ozz::io::OArchive o(&stream, endianess);
+    o << o_curves;
+
+    // Streams in.
+    stream.Seek(0, ozz::io::Stream::kSet);
+    ozz::io::IArchive i(&stream);
+
+    RawFloatCurves i_curves;
+    i >> i_curves;
+
+    EXPECT_EQ(i_curves.name, "raw curves");
+    ASSERT_EQ(i_curves.num_curves(), 3);
+    EXPECT_EQ(i_curves.curves[0].keyframes.size(), 0u);
+    ASSERT_EQ(i_curves.curves[1].keyframes.size(), 1u);
+    EXPECT_EQ(i_curves.curves[1].keyframes[0].interpolation,
+              RawTrackInterpolation::kStep);
+    EXPECT_FLOAT_EQ(i_curves.curves[1].keyframes[0].ratio, .5f);
+    EXPECT_FLOAT_EQ(i_curves.curves[1].keyframes[0].value, 46.f);
+    EXPECT_EQ(i_curves.curves[1].name, "curve 1");
+  }
+}
@@ -33,6 +33,7 @@
 #include "gtest/gtest.h"
 
 #include "ozz/animation/runtime/skeleton.h"
+#include "ozz/animation/runtime/skeleton_utils.h"
 #include "ozz/base/maths/simd_math.h"
 #include "ozz/base/maths/soa_transform.h"
 #include "ozz/base/memory/unique_ptr.h"
@@ -551,6 +552,83 @@ TEST(JointOrder, SkeletonBuilder) {
   EXPECT_STREQ(skeleton->joint_names()[6], "j6");
 }
 
+TEST(LevelOrder, SkeletonBuilder) {
+  /*
+   8 joints
+
+        *
+        |
+        j0
+     /  |  \
+   j1   j2  j3
+    |  / \
+   j4 j5 j6
+         |
+         j7
+  */
+  RawSkeleton raw_skeleton;
+  raw_skeleton.roots.resize(1);
+  RawSkeleton::Joint& root = raw_skeleton.roots[0];
+  root.name = "j0";
+
+  root.children.resize(3);
+  root.children[0].name = "j1";
+  root.children[1].name = "j2";
+  root.children[2].name = "j3";
+
+  root.children[0].children.resize(1);
+  root.children[0].children[0].name = "j4";
+
+  root.children[1].children.resize(2);
+  root.children[1].children[0].name = "j5";
+  root.children[1].children[1].name = "j6";
+  root.children[1].children[1].transform.translation =
+      ozz::math::Float3(46.f, 0.f, 0.f);
+
+  root.children[1].children[1].children.resize(1);
+  root.children[1].children[1].children[0].name = "j7";
+
+  EXPECT_TRUE(raw_skeleton.Validate());
+  EXPECT_EQ(raw_skeleton.num_joints(), 8);
+
+  {  // Default depth-first order isn't level ordered.
+    SkeletonBuilder builder;
+    EXPECT_FALSE(builder.level_order);
+    ozz::unique_ptr<Skeleton> skeleton(builder(raw_skeleton));
+    ASSERT_TRUE(skeleton);
+    EXPECT_STREQ(skeleton->joint_names()[2], "j4");
+    EXPECT_EQ(skeleton->joint_levels().size(), 0u);
+  }
+
+  {  // Level order.
+    SkeletonBuilder builder;
+    builder.level_order = true;
+    ozz::unique_ptr<Skeleton> skeleton(builder(raw_skeleton));
+    ASSERT_TRUE(skeleton);
+    ASSERT_EQ(skeleton->num_joints(), 8);
+
+    // Joints are sorted level by level, and maintain original children order.
+    const int16_t parents[] = {Skeleton::kNoParent, 0, 0, 0, 1, 2, 2, 6};
+    for (int i = 0; i < 8; ++i) {
+      char name[3] = {'j', static_cast<char>('0' + i), 0};
+      EXPECT_STREQ(skeleton->joint_names()[i], name);
+      EXPECT_EQ(skeleton->joint_parents()[i], parents[i]);
+    }
+
+    // Bind poses follow joints.
+    const ozz::math::Transform j6 =
+        ozz::animation::GetJointLocalBindPose(*skeleton, 6);
+    EXPECT_FLOAT3_EQ(j6.translation, 46.f, 0.f, 0.f);
+
+    // Levels ranges.
+    const int16_t levels[] = {0, 1, 4, 7, 8};
+    ASSERT_EQ(skeleton->joint_levels().size(), 5u);
+    for (int i = 0; i < 5; ++i) {
+      EXPECT_EQ(skeleton->joint_levels()[i], levels[i]);
+    }
+  }
+}
+
 TEST(MultiRoots, SkeletonBuilder) {
   // Instantiates a builder objects with default parameters.
   SkeletonBuilder builder;
@@ -1051,3 +1051,136 @@ TEST(Quaternion, TrackBuilder) {
     EXPECT_QUATERNION_EQ(result, 0.f, .70710677f, 0.f, .70710677f);
   }
 }
+
+TEST(EdgeIndex, TrackBuilder) {
+  RawFloatTrack raw_track;
+  const RawFloatTrack::Keyframe key0 = {RawTrackInterpolation::kLinear, 0.f,
+                                        0.f};
+  raw_track.keyframes.push_back(key0);
+  const RawFloatTrack::Keyframe key1 = {RawTrackInterpolation::kStep, .5f,
+                                        2.f};
+  raw_track.keyframes.push_back(key1);
+  const RawFloatTrack::Keyframe key2 = {RawTrackInterpolation::kLinear, .7f,
+                                        0.f};
+  raw_track.keyframes.push_back(key2);
+
+  TrackBuilder builder;
+  EXPECT_FALSE(builder.edge_index);
+
+  {  // No index by default.
+    ozz::unique_ptr<FloatTrack> track(builder(raw_track));
+    ASSERT_TRUE(track);
+    EXPECT_FALSE(track->has_edge_index());
+    EXPECT_EQ(track->edge_ratios().size(), 0u);
+    EXPECT_EQ(track->edge_rising().size(), 0u);
+  }
+
+  builder.edge_index = true;
+  builder.edge_threshold = 1.f;
+
+  {  // Linear rising edge, and falling step edge.
+    ozz::unique_ptr<FloatTrack> track(builder(raw_track));
+    ASSERT_TRUE(track);
+    EXPECT_TRUE(track->has_edge_index());
+    EXPECT_FLOAT_EQ(track->edge_threshold(), 1.f);
+    ASSERT_EQ(track->edge_ratios().size(), 2u);
+    EXPECT_FLOAT_EQ(track->edge_ratios()[0], .25f);
+    EXPECT_FLOAT_EQ(track->edge_ratios()[1], .7f);
+    ASSERT_EQ(track->edge_rising().size(), 1u);
+    EXPECT_EQ(track->edge_rising()[0], 1);
+    EXPECT_LT(sizeof(FloatTrack) + track->ratios().size_bytes() +
+                  track->values().size_bytes() + track->steps().size_bytes(),
+              track->size());
+  }
+
+  {  // Threshold out of values range, indexed without any edge.
+    builder.edge_threshold = 3.f;
+    ozz::unique_ptr<FloatTrack> track(builder(raw_track));
+    ASSERT_TRUE(track);
+    EXPECT_TRUE(track->has_edge_index());
+    EXPECT_EQ(track->edge_ratios().size(), 0u);
+  }
+
+  {  // Other track types aren't indexed.
+    ozz::animation::offline::RawFloat2Track raw_float2_track;
+    ozz::unique_ptr<Float2Track> track(builder(raw_float2_track));
+    ASSERT_TRUE(track);
+    EXPECT_FALSE(track->has_edge_index());
+    EXPECT_EQ(track->edge_ratios().size(), 0u);
+  }
+}
+
+TEST(Quantization, TrackBuilder) {
+  ozz::animation::offline::RawFloat3Track raw_track;
+  for (int i = 0; i < 16; ++i) {
+    const ozz::animation::offline::RawFloat3Track::Keyframe key = {
+        RawTrackInterpolation::kLinear, i / 15.f,
+        ozz::math::Float3(i * .5f, -i * 2.f, 46.f)};
+    raw_track.keyframes.push_back(key);
+  }
+
+  TrackBuilder builder;
+  EXPECT_FALSE(builder.quantize_ratios);
+  EXPECT_FALSE(builder.quantize_values);
+
+  ozz::unique_ptr<Float3Track> full(builder(raw_track));
+  ASSERT_TRUE(full);
+  EXPECT_EQ(full->num_keys(), 16u);
+  EXPECT_EQ(full->ratios().size(), 16u);
+  EXPECT_EQ(full->values().size(), 16u);
+  EXPECT_EQ(full->quantized_ratios().size(), 0u);
+  EXPECT_EQ(full->quantized_values().size(), 0u);
+
+  builder.quantize_ratios = true;
+  builder.quantize_values = true;
+
+  {  // Ratios and values are stored as 16 bits components.
+    ozz::unique_ptr<Float3Track> track(builder(raw_track));
+    ASSERT_TRUE(track);
+    EXPECT_EQ(track->num_keys(), 16u);
+    EXPECT_EQ(track->ratios().size(), 0u);
+    EXPECT_EQ(track->values().size(), 0u);
+    ASSERT_EQ(track->quantized_ratios().size(), 16u);
+    EXPECT_EQ(track->quantized_values().size(), 16u * 3u);
+    EXPECT_EQ(track->quantized_ratios()[0], 0);
+    EXPECT_EQ(track->quantized_ratios()[15], 65535);
+    EXPECT_EQ(track->quantized_ratios().size_bytes() +
+                  track->quantized_values().size_bytes(),
+              (full->ratios().size_bytes() + full->values().size_bytes()) / 2);
+    EXPECT_LT(track->size(), full->size());
+  }
+
+  {  // Quaternions are stored as 3 components.
+    ozz::animation::offline::RawQuaternionTrack raw_quat_track;
+    const ozz::animation::offline::RawQuaternionTrack::Keyframe key = {
+        RawTrackInterpolation::kLinear, .5f,
+        ozz::math::Quaternion(0.f, .70710677f, 0.f, .70710677f)};
+    raw_quat_track.keyframes.push_back(key);
+    ozz::unique_ptr<QuaternionTrack> track(builder(raw_quat_track));
+    ASSERT_TRUE(track);
+    EXPECT_EQ(track->num_keys(), 2u);
+    EXPECT_EQ(track->values().size(), 0u);
+    EXPECT_EQ(track->quantized_values().size(), 2u * 3u);
+  }
+
+  {  // Float tracks aren't quantized.
+    RawFloatTrack raw_float_track;
+    ozz::unique_ptr<FloatTrack> track(builder(raw_float_track));
+    ASSERT_TRUE(track);
+    EXPECT_EQ(track->ratios().size(), 2u);
+    EXPECT_EQ(track->values().size(), 2u);
+    EXPECT_EQ(track->quantized_ratios().size(), 0u);
+    EXPECT_EQ(track->quantized_values().size(), 0u);
+  }
+
+  {  // Ratios too close to be quantized fall back to floats.
+    const ozz::animation::offline::RawFloat3Track::Keyframe key = {
+        RawTrackInterpolation::kLinear, 1e-6f, ozz::math::Float3::one()};
+    raw_track.keyframes.insert(raw_track.keyframes.begin() + 1, key);
+    ozz::unique_ptr<Float3Track> track(builder(raw_track));
+    ASSERT_TRUE(track);
+    EXPECT_EQ(track->ratios().size(), 17u);
+    EXPECT_EQ(track->quantized_ratios().size(), 0u);
+    EXPECT_EQ(track->quantized_values().size(), 17u * 3u);
+  }
+}
@@ -30,8 +30,11 @@
 #include "gtest/gtest.h"
 #include "ozz/base/maths/gtest_math_helper.h"
 
+#include <cstring>
+
 #include "ozz/base/io/archive.h"
 #include "ozz/base/io/stream.h"
+#include "ozz/base/memory/allocator.h"
 #include "ozz/base/memory/unique_ptr.h"
 
 #include "ozz/base/maths/soa_transform.h"
@@ -183,3 +186,120 @@ TEST(AlreadyInitialized, AnimationSerialize) {
     ASSERT_EQ(i_animation.num_tracks(), 2);
   }
 }
+
+TEST(View, AnimationSerialize) {
+  // Builds an animation with a name and a seeking index.
+  RawAnimation raw_animation;
+  raw_animation.duration = 2.f;
+  raw_animation.name = "view";
+  raw_animation.tracks.resize(3);
+  for (int i = 0; i < 3; ++i) {
+    for (int k = 0; k < 100; ++k) {
+      const float time = k * 2.f / 99.f;
+      const RawAnimation::TranslationKey key = {
+          time, ozz::math::Float3(time, static_cast<float>(i), 0.f)};
+      raw_animation.tracks[i].translations.push_back(key);
+    }
+  }
+  AnimationBuilder builder;
+  ozz::unique_ptr<Animation> o_animation(builder(raw_animation));
+  ASSERT_TRUE(o_animation);
+  ASSERT_GT(o_animation->num_seek_segments(), 0);
+
+  ozz::memory::Allocator* allocator = ozz::memory::default_allocator();
+  const size_t view_size = o_animation->view_size();
+  char* memory = static_cast<char*>(allocator->Allocate(view_size + 16, 16));
+
+  // Invalid buffers.
+  EXPECT_FALSE(o_animation->SaveView({memory, view_size - 1}));
+  EXPECT_FALSE(o_animation->SaveView({memory + 1, view_size}));
+
+  ASSERT_TRUE(o_animation->SaveView({memory, view_size}));
+
+  {  // Valid view.
+    Animation i_animation;
+    ASSERT_TRUE(i_animation.LoadView({memory, view_size}));
+    EXPECT_FLOAT_EQ(i_animation.duration(), 2.f);
+    EXPECT_EQ(i_animation.num_tracks(), 3);
+    EXPECT_STREQ(i_animation.name(), "view");
+    EXPECT_EQ(i_animation.num_seek_segments(),
+              o_animation->num_seek_segments());
+    EXPECT_EQ(i_animation.size(), o_animation->size());
+    EXPECT_EQ(i_animation.view_size(), view_size);
+
+    // Data aren't copied.
+    EXPECT_TRUE(reinterpret_cast<const char*>(
+                    i_animation.translations().data()) > memory &&
+                reinterpret_cast<const char*>(
+                    i_animation.translations().data()) < memory + view_size);
+
+    // Samples and compares the two animations.
+    ozz::animation::SamplingCache o_cache(3);
+    ozz::animation::SamplingCache i_cache(3);
+    ozz::math::SoaTransform o_output[1];
+    ozz::math::SoaTransform i_output[1];
+    ozz::animation::SamplingJob job;
+    const float ratios[] = {0.f, .5f, .2f, .99f, 1.f};
+    for (size_t r = 0; r < OZZ_ARRAY_SIZE(ratios); ++r) {
+      job.ratio = ratios[r];
+      job.animation = o_animation.get();
+      job.cache = &o_cache;
+      job.output = o_output;
+      ASSERT_TRUE(job.Run());
+      job.animation = &i_animation;
+      job.cache = &i_cache;
+      job.output = i_output;
+      ASSERT_TRUE(job.Run());
+      EXPECT_TRUE(ozz::math::AreAllTrue(o_output[0].translation ==
+                                        i_output[0].translation));
+    }
+
+    // A view can be saved again.
+    char* copy = static_cast<char*>(allocator->Allocate(view_size, 16));
+    ASSERT_TRUE(i_animation.SaveView({copy, view_size}));
+    EXPECT_EQ(std::memcmp(copy, memory, view_size), 0);
+    allocator->Deallocate(copy);
+  }
+
+  {  // Misaligned or truncated views.
+    Animation i_animation;
+    std::memmove(memory + 1, memory, view_size);
+    EXPECT_FALSE(i_animation.LoadView({memory + 1, view_size}));
+    std::memmove(memory, memory + 1, view_size);
+    EXPECT_FALSE(i_animation.LoadView({memory, view_size - 1}));
+    EXPECT_EQ(i_animation.num_tracks(), 0);
+  }
+
+  {  // Corrupted tag.
+    Animation i_animation;
+    memory[0] = 'x';
+    EXPECT_FALSE(i_animation.LoadView({memory, view_size}));
+    EXPECT_EQ(i_animation.num_tracks(), 0);
+  }
+
+  allocator->Deallocate(memory);
+}
+
+TEST(EmptyView, AnimationSerialize) {
+  Animation o_animation;
+  ozz::memory::Allocator* allocator = ozz::memory::default_allocator();
+  const size_t view_size = o_animation.view_size();
+  char* memory = static_cast<char*>(allocator->Allocate(view_size, 16));
+  ASSERT_TRUE(o_animation.SaveView({memory, view_size}));
+
+  Animation i_animation;
+  ASSERT_TRUE(i_animation.LoadView({memory, view_size}));
+  EXPECT_EQ(i_animation.num_tracks(), 0);
+  EXPECT_STREQ(i_animation.name(), "");
+
+  // Animation can be loaded again from an archive after being bound to a view.
+  ozz::io::MemoryStream stream;
+  ozz::io::OArchive o(&stream);
+  o << o_animation;
+  stream.Seek(0, ozz::io::Stream::kSet);
+  ozz::io::IArchive i(&stream);
+  i >> i_animation;
+  EXPECT_EQ(i_animation.num_tracks(), 0);
+
+  allocator->Deallocate(memory);
+}
@@ -25,6 +25,8 @@
 //                                                                            //
 //----------------------------------------------------------------------------//
 
+#include <cmath>
+
 #include "gtest/gtest.h"
 #include "ozz/animation/runtime/blending_job.h"
 #include "ozz/base/maths/gtest_math_helper.h"
@@ -869,3 +871,141 @@ TEST(AdditiveJointWeight, BlendingJob) {
                             1.f / 20.f, 1.f / 11.f, 1.f, 1.f);
   }
 }
+
+namespace {
+// Expects every component of soa transforms _a and _b to be near.
+void ExpectSoaTransformNear(const ozz::math::SoaTransform& _a,
+                            const ozz::math::SoaTransform& _b) {
+  const float* a = reinterpret_cast<const float*>(&_a);
+  const float* b = reinterpret_cast<const float*>(&_b);
+  for (size_t i = 0; i < sizeof(ozz::math::SoaTransform) / sizeof(float);
+       ++i) {
+    EXPECT_NEAR(a[i], b[i], 1e-5f) << i;
+  }
+}
+
+// Interpolates quaternion between identity and _q, the way additive blending
+// does.
+ozz::math::SoaQuaternion WeightAdditiveRotation(
+    const ozz::math::SoaQuaternion& _q, ozz::math::SimdFloat4 _weight) {
+  const ozz::math::SimdFloat4 one = ozz::math::simd_float4::one();
+  const ozz::math::SimdInt4 sign = ozz::math::Sign(_q.w);
+  const ozz::math::SoaQuaternion q = {
+      ozz::math::Xor(_q.x, sign), ozz::math::Xor(_q.y, sign),
+      ozz::math::Xor(_q.z, sign), ozz::math::Xor(_q.w, sign)};
+  const ozz::math::SoaQuaternion interp = {
+      q.x * _weight, q.y * _weight, q.z * _weight,
+      (q.w - one) * _weight + one};
+  return NormalizeEst(interp);
+}
+}  // namespace
+
+TEST(SoaMaths, BlendingJob) {
+  // Blending passes can use wider simd instructions than soa maths. This test
+  // compares job output with the same blending computed with 4-wide soa maths,
+  // for a few soa transforms with different values.
+  const int kNumSoa = 3;
+  ozz::math::SoaTransform inputs[4][kNumSoa];
+  ozz::math::SimdFloat4 joint_weights[kNumSoa];
+  ozz::math::SoaTransform bind_poses[kNumSoa];
+  for (int i = 0; i < 4; ++i) {
+    for (int j = 0; j < kNumSoa; ++j) {
+      const float f = static_cast<float>(i * kNumSoa + j);
+      ozz::math::SoaTransform& input = inputs[i][j];
+      input.translation = ozz::math::SoaFloat3::Load(
+          ozz::math::simd_float4::Load(f, -f, 1.f, 2.f),
+          ozz::math::simd_float4::Load(3.f, f * .5f, -4.f, f),
+          ozz::math::simd_float4::Load(-f, 5.f, f * 2.f, 6.f));
+      const float c = std::cos(f * .3f), s = std::sin(f * .3f);
+      input.rotation = ozz::math::SoaQuaternion::Load(
+          ozz::math::simd_float4::Load(s, 0.f, s * .6f, -s),
+          ozz::math::simd_float4::Load(0.f, s, s * .8f, 0.f),
+          ozz::math::simd_float4::Load(0.f, 0.f, 0.f, 0.f),
+          ozz::math::simd_float4::Load(c, -c, c, c));
+      input.scale = ozz::math::SoaFloat3::Load(
+          ozz::math::simd_float4::Load(1.f, 2.f, 1.f + f * .1f, .5f),
+          ozz::math::simd_float4::Load(1.f + f * .2f, 1.f, 3.f, 1.f),
+          ozz::math::simd_float4::Load(2.f, 1.f, 1.f, 1.f + f * .3f));
+    }
+  }
+  for (int j = 0; j < kNumSoa; ++j) {
+    const float f = static_cast<float>(j);
+    joint_weights[j] = ozz::math::simd_float4::Load(1.f, .5f, f * .2f, -1.f);
+    bind_poses[j] = ozz::math::SoaTransform::identity();
+  }
+
+  BlendingJob::Layer layers[2];
+  layers[0].weight = .6f;
+  layers[0].transform = inputs[0];
+  layers[1].weight = .3f;
+  layers[1].transform = inputs[1];
+  layers[1].joint_weights = joint_weights;
+
+  BlendingJob::Layer additive_layers[2];
+  additive_layers[0].weight = .5f;
+  additive_layers[0].transform = inputs[2];
+  additive_layers[1].weight = -.4f;
+  additive_layers[1].transform = inputs[3];
+  additive_layers[1].joint_weights = joint_weights;
+
+  ozz::math::SoaTransform output[kNumSoa];
+  BlendingJob job;
+  job.layers = layers;
+  job.additive_layers = additive_layers;
+  job.bind_pose = bind_poses;
+  job.output = output;
+  ASSERT_TRUE(job.Run());
+
+  const ozz::math::SimdFloat4 zero = ozz::math::simd_float4::zero();
+  const ozz::math::SimdFloat4 one = ozz::math::simd_float4::one();
+  for (int j = 0; j < kNumSoa; ++j) {
+    // Blends layers, bind pose has no weight as threshold is reached.
+    const ozz::math::SimdFloat4 w0 = ozz::math::simd_float4::Load1(.6f);
+    const ozz::math::SimdFloat4 w1 = ozz::math::simd_float4::Load1(.3f) *
+                                     ozz::math::Max(zero, joint_weights[j]);
+    const ozz::math::SoaTransform& in0 = inputs[0][j];
+    const ozz::math::SoaTransform& in1 = inputs[1][j];
+    ozz::math::SoaTransform expected;
+    expected.translation = in0.translation * w0 + in1.translation * w1;
+    const ozz::math::SimdInt4 sign =
+        ozz::math::Sign(Dot(in0.rotation * w0, in1.rotation));
+    const ozz::math::SoaQuaternion rotation1 = {
+        ozz::math::Xor(in1.rotation.x, sign),
+        ozz::math::Xor(in1.rotation.y, sign),
+        ozz::math::Xor(in1.rotation.z, sign),
+        ozz::math::Xor(in1.rotation.w, sign)};
+    expected.rotation = in0.rotation * w0 + rotation1 * w1;
+    expected.scale = in0.scale * w0 + in1.scale * w1;
+
+    // Normalizes.
+    const ozz::math::SimdFloat4 ratio = one / (w0 + w1);
+    expected.translation = expected.translation * ratio;
+    expected.rotation = NormalizeEst(expected.rotation);
+    expected.scale = expected.scale * ratio;
+
+    // Adds the first additive layer.
+    const ozz::math::SimdFloat4 aw0 = ozz::math::simd_float4::Load1(.5f);
+    const ozz::math::SoaTransform& add0 = inputs[2][j];
+    expected.translation = expected.translation + add0.translation * aw0;
+    expected.rotation =
+        WeightAdditiveRotation(add0.rotation, aw0) * expected.rotation;
+    const ozz::math::SoaFloat3 one_minus_aw0 = {one - aw0, one - aw0,
+                                                one - aw0};
+    expected.scale = expected.scale * (one_minus_aw0 + add0.scale * aw0);
+
+    // Subtracts the second one.
+    const ozz::math::SimdFloat4 aw1 = ozz::math::simd_float4::Load1(.4f) *
+                                      ozz::math::Max(zero, joint_weights[j]);
+    const ozz::math::SoaTransform& sub1 = inputs[3][j];
+    expected.translation = expected.translation - sub1.translation * aw1;
+    expected.rotation = Conjugate(WeightAdditiveRotation(sub1.rotation, aw1)) *
+                        expected.rotation;
+    const ozz::math::SoaFloat3 rcp_scale = {
+        ozz::math::RcpEst(ozz::math::MAdd(sub1.scale.x, aw1, one - aw1)),
+        ozz::math::RcpEst(ozz::math::MAdd(sub1.scale.y, aw1, one - aw1)),
+        ozz::math::RcpEst(ozz::math::MAdd(sub1.scale.z, aw1, one - aw1))};
+    expected.scale = expected.scale * rcp_scale;
+
+    ExpectSoaTransformNear(output[j], expected);
+  }
+}
@@ -0,0 +1,158 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+
+#include "ozz/animation/runtime/float_curves.h"
+
+#include "gtest/gtest.h"
+
+#include "ozz/base/io/archive.h"
+#include "ozz/base/io/stream.h"
+#include "ozz/base/memory/unique_ptr.h"
+
+#include "ozz/animation/offline/float_curves_builder.h"
+#include "ozz/animation/offline/raw_float_curves.h"
+#include "ozz/animation/runtime/float_curves_sampling_job.h"
+
+using ozz::animation::FloatCurves;
+using ozz::animation::FloatCurvesSamplingCache;
+using ozz::animation::FloatCurvesSamplingJob;
+using ozz::animation::offline::FloatCurvesBuilder;
+using ozz::animation::offline::RawFloatCurves;
+using ozz::animation::offline::RawFloatTrack;
+using ozz::animation::offline::RawTrackInterpolation;
+
+TEST(Empty, FloatCurvesSerialize) {
+  ozz::io::MemoryStream stream;
+
+  // Streams out.
+  ozz::io::OArchive o(&stream, ozz::GetNativeEndianness());
+
+  FloatCurves o_curves;
+  o << o_curves;
+
+  // Streams in.
+  stream.Seek(0, ozz::io::Stream::kSet);
+  ozz::io::IArchive i(&stream);
+
+  FloatCurves i_curves;
+  i >> i_curves;
+
+  EXPECT_EQ(o_curves.size(), i_curves.size());
+  EXPECT_EQ(i_curves.num_curves(), 0);
+  EXPECT_STREQ(i_curves.name(), "");
+}
+
+TEST(Filled, FloatCurvesSerialize) {
+  RawFloatCurves raw_curves;
+  raw_curves.name = "test curves";
+  raw_curves.curves.resize(5);
+  const RawFloatTrack::Keyframe key0 = {RawTrackInterpolation::kLinear, .2f,
+                                        -3.f};
+  const RawFloatTrack::Keyframe key1 = {RawTrackInterpolation::kStep, .6f,
+                                        7.f};
+  const RawFloatTrack::Keyframe key2 = {RawTrackInterpolation::kLinear, .8f,
+                                        1.f};
+  raw_curves.curves[1].keyframes.push_back(key0);
+  raw_curves.curves[1].keyframes.push_back(key1);
+  raw_curves.curves[4].keyframes.push_back(key0);
+  raw_curves.curves[4].keyframes.push_back(key2);
+
+  FloatCurvesBuilder builder;
+  ozz::unique_ptr<FloatCurves> o_curves(builder(raw_curves));
+  ASSERT_TRUE(o_curves);
+
+  for (int e = 0; e < 2; ++e) {
+    ozz::Endianness endianess = e == 0 ? ozz::kBigEndian : ozz::kLittleEndian;
+
+    ozz::io::MemoryStream stream;
+
+    // Streams out.
+    ozz::io::OArchive o(&stream, endianess);
+    o << *o_curves;
+
+    // Streams in.
+    stream.Seek(0, ozz::io::Stream::kSet);
+    ozz::io::IArchive i(&stream);
+
+    FloatCurves i_curves;
+    i >> i_curves;
+
+    EXPECT_EQ(o_curves->size(), i_curves.size());
+    EXPECT_EQ(i_curves.num_curves(), 5);
+    EXPECT_STREQ(i_curves.name(), "test curves");
+
+    // Samples both curves.
+    FloatCurvesSamplingCache o_cache(5);
+    FloatCurvesSamplingCache i_cache(5);
+    float o_output[5];
+    float i_output[5];
+    FloatCurvesSamplingJob job;
+    for (float ratio = 0.f; ratio <= 1.f; ratio += .05f) {
+      job.ratio = ratio;
+      job.curves = o_curves.get();
+      job.cache = &o_cache;
+      job.output = o_output;
+      ASSERT_TRUE(job.Run());
+      job.curves = &i_curves;
+      job.cache = &i_cache;
+      job.output = i_output;
+      ASSERT_TRUE(job.Run());
+      for (int c = 0; c < 5; ++c) {
+        EXPECT_FLOAT_EQ(o_output[c], i_output[c]);
+      }
+    }
+  }
+}
+
+TEST(AlreadyInitialized, FloatCurvesSerialize) {
+  RawFloatCurves raw_curves;
+  raw_curves.curves.resize(1);
+
+  FloatCurvesBuilder builder;
+  ozz::unique_ptr<FloatCurves> o_curves(builder(raw_curves));
+  ASSERT_TRUE(o_curves);
+
+  ozz::io::MemoryStream stream;
+  ozz::io::OArchive o(&stream, ozz::GetNativeEndianness());
+  o << *o_curves;
+  raw_curves.curves.resize(9);
+  o_curves = builder(raw_curves);
+  ASSERT_TRUE(o_curves);
+  o << *o_curves;
+
+  // Streams in twice in the same object.
+  stream.Seek(0, ozz::io::Stream::kSet);
+  ozz::io::IArchive i(&stream);
+
+  FloatCurves i_curves;
+  i >> i_curves;
+  EXPECT_EQ(i_curves.num_curves(), 1);
+  i >> i_curves;
+  EXPECT_EQ(i_curves.num_curves(), 9);
+  EXPECT_EQ(i_curves.keys().size(), o_curves->keys().size());
+}
@@ -0,0 +1,302 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+
+#include "ozz/animation/runtime/float_curves_sampling_job.h"
+
+#include <cstdlib>
+
+#include "gtest/gtest.h"
+
+#include "ozz/base/containers/vector.h"
+#include "ozz/base/memory/unique_ptr.h"
+
+#include "ozz/animation/offline/float_curves_builder.h"
+#include "ozz/animation/offline/raw_float_curves.h"
+#include "ozz/animation/offline/track_builder.h"
+
+#include "ozz/animation/runtime/float_curves.h"
+#include "ozz/animation/runtime/track.h"
+#include "ozz/animation/runtime/track_sampling_job.h"
+
+using ozz::animation::FloatCurves;
+using ozz::animation::FloatCurvesSamplingCache;
+using ozz::animation::FloatCurvesSamplingJob;
+using ozz::animation::FloatTrack;
+using ozz::animation::FloatTrackSamplingJob;
+using ozz::animation::offline::FloatCurvesBuilder;
+using ozz::animation::offline::RawFloatCurves;
+using ozz::animation::offline::RawFloatTrack;
+using ozz::animation::offline::RawTrackInterpolation;
+using ozz::animation::offline::TrackBuilder;
+
+TEST(JobValidity, FloatCurvesSamplingJob) {
+  RawFloatCurves raw_curves;
+  raw_curves.curves.resize(5);
+  FloatCurvesBuilder builder;
+  ozz::unique_ptr<FloatCurves> curves(builder(raw_curves));
+  ASSERT_TRUE(curves);
+
+  FloatCurvesSamplingCache cache(5);
+  FloatCurvesSamplingCache small_cache(4);
+  float output[5];
+
+  {  // Empty/default job
+    FloatCurvesSamplingJob job;
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+
+  {  // Invalid curves.
+    FloatCurvesSamplingJob job;
+    job.cache = &cache;
+    job.output = output;
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+
+  {  // Invalid cache.
+    FloatCurvesSamplingJob job;
+    job.curves = curves.get();
+    job.output = output;
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+
+  {  // Invalid cache size.
+    FloatCurvesSamplingJob job;
+    job.curves = curves.get();
+    job.cache = &small_cache;
+    job.output = output;
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+
+  {  // Invalid output size.
+    FloatCurvesSamplingJob job;
+    job.curves = curves.get();
+    job.cache = &cache;
+    job.output = {output, 4};
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+
+  {  // Valid
+    FloatCurvesSamplingJob job;
+    job.curves = curves.get();
+    job.cache = &cache;
+    job.output = output;
+    EXPECT_TRUE(job.Validate());
+    EXPECT_TRUE(job.Run());
+  }
+
+  {  // Valid, default curves.
+    FloatCurves default_curves;
+    FloatCurvesSamplingCache default_cache;
+    FloatCurvesSamplingJob job;
+    job.curves = &default_curves;
+    job.cache = &default_cache;
+    EXPECT_TRUE(job.Validate());
+    EXPECT_TRUE(job.Run());
+  }
+}
+
+TEST(Sampling, FloatCurvesSamplingJob) {
+  RawFloatCurves raw_curves;
+  raw_curves.curves.resize(4);
+
+  // Curve 0 is empty. Curve 1 has a single key.
+  const RawFloatTrack::Keyframe single = {RawTrackInterpolation::kStep, .5f,
+                                          46.f};
+  raw_curves.curves[1].keyframes.push_back(single);
+
+  // Curve 2 mixes linear and step keys.
+  const RawFloatTrack::Keyframe keys[] = {
+      {RawTrackInterpolation::kLinear, .2f, 0.f},
+      {RawTrackInterpolation::kStep, .4f, 10.f},
+      {RawTrackInterpolation::kLinear, .6f, 20.f},
+      {RawTrackInterpolation::kLinear, .8f, 0.f}};
+  raw_curves.curves[2].keyframes.assign(keys, keys + 4);
+
+  // Curve 3 steps up to its last key, at ratio 1.
+  const RawFloatTrack::Keyframe last_keys[] = {
+      {RawTrackInterpolation::kStep, .5f, 1.f},
+      {RawTrackInterpolation::kLinear, 1.f, 2.f}};
+  raw_curves.curves[3].keyframes.assign(last_keys, last_keys + 2);
+
+  FloatCurvesBuilder builder;
+  ozz::unique_ptr<FloatCurves> curves(builder(raw_curves));
+  ASSERT_TRUE(curves);
+
+  FloatCurvesSamplingCache cache(4);
+  float output[5] = {-1.f, -1.f, -1.f, -1.f, -1.f};
+
+  FloatCurvesSamplingJob job;
+  job.curves = curves.get();
+  job.cache = &cache;
+  job.output = {output, 4};
+
+  const struct {
+    float ratio;
+    float value2;
+    float value3;
+  } expected[] = {{-1.f, 0.f, 1.f}, {0.f, 0.f, 1.f},  {.1f, 0.f, 1.f},
+                  {.3f, 5.f, 1.f},  {.4f, 10.f, 1.f}, {.5f, 10.f, 1.f},
+                  {.6f, 20.f, 1.f}, {.7f, 10.f, 1.f}, {.9f, 0.f, 1.f},
+                  {1.f, 0.f, 2.f},  {2.f, 0.f, 2.f},  {.5f, 10.f, 1.f}};
+  for (size_t i = 0; i < OZZ_ARRAY_SIZE(expected); ++i) {
+    job.ratio = expected[i].ratio;
+    ASSERT_TRUE(job.Run());
+    EXPECT_FLOAT_EQ(output[0], 0.f);
+    EXPECT_FLOAT_EQ(output[1], 46.f);
+    EXPECT_FLOAT_EQ(output[2], expected[i].value2);
+    EXPECT_FLOAT_EQ(output[3], expected[i].value3);
+
+    // Output beyond the number of curves isn't written.
+    EXPECT_FLOAT_EQ(output[4], -1.f);
+  }
+}
+
+TEST(Compare, FloatCurvesSamplingJob) {
+  // Compares curves sampling with FloatTrack sampling of the same raw tracks,
+  // for random curves sampled forward, backward and with jumps.
+  srand(0);
+  const int kMaxCurves = 11;
+  for (int num_curves = 0; num_curves <= kMaxCurves; ++num_curves) {
+    RawFloatCurves raw_curves;
+    raw_curves.curves.resize(num_curves);
+    for (int c = 0; c < num_curves; ++c) {
+      RawFloatTrack& raw_track = raw_curves.curves[c];
+      const int num_keys = rand() % 12;
+      float ratio = 0.f;
+      for (int k = 0; k < num_keys; ++k) {
+        ratio += (1.f + rand() % 8) / (8.f * num_keys);
+        if (ratio > 1.f) {
+          break;
+        }
+        const RawFloatTrack::Keyframe key = {
+            rand() % 3 == 0 ? RawTrackInterpolation::kStep
+                            : RawTrackInterpolation::kLinear,
+            k == 0 && rand() % 2 ? 0.f : ratio,
+            (rand() % 200) / 10.f - 10.f};
+        raw_track.keyframes.push_back(key);
+      }
+      ASSERT_TRUE(raw_track.Validate());
+    }
+
+    FloatCurvesBuilder curves_builder;
+    ozz::unique_ptr<FloatCurves> curves(curves_builder(raw_curves));
+    ASSERT_TRUE(curves);
+    EXPECT_EQ(curves->num_curves(), num_curves);
+
+    TrackBuilder track_builder;
+    ozz::vector<ozz::unique_ptr<FloatTrack>> tracks;
+    for (int c = 0; c < num_curves; ++c) {
+      tracks.push_back(track_builder(raw_curves.curves[c]));
+      ASSERT_TRUE(tracks.back());
+    }
+
+    FloatCurvesSamplingCache cache(kMaxCurves);
+    ozz::vector<float> output(kMaxCurves + 1, 0.f);
+    FloatCurvesSamplingJob job;
+    job.curves = curves.get();
+    job.cache = &cache;
+    job.output = make_span(output);
+
+    const float kSteps = 97.f;
+    for (int s = 0; s < 400; ++s) {
+      float ratio;
+      if (s < 100) {  // Forward.
+        ratio = s / kSteps - .01f;
+      } else if (s < 200) {  // Backward.
+        ratio = (200 - s) / kSteps;
+      } else {  // Random jumps.
+        ratio = (rand() % 1000) / 900.f;
+      }
+      job.ratio = ratio;
+      ASSERT_TRUE(job.Run());
+
+      for (int c = 0; c < num_curves; ++c) {
+        float expected;
+        FloatTrackSamplingJob track_job;
+        track_job.track = tracks[c].get();
+        track_job.ratio = ratio;
+        track_job.result = &expected;
+        ASSERT_TRUE(track_job.Run());
+        EXPECT_NEAR(output[c], expected, 1e-5f)
+            << "curve " << c << " ratio " << ratio;
+      }
+    }
+  }
+}
+
+TEST(Cache, FloatCurvesSamplingJob) {
+  RawFloatCurves raw_curves;
+  raw_curves.curves.resize(2);
+  const RawFloatTrack::Keyframe key0 = {RawTrackInterpolation::kLinear, 0.f,
+                                        0.f};
+  const RawFloatTrack::Keyframe key1 = {RawTrackInterpolation::kLinear, 1.f,
+                                        10.f};
+  raw_curves.curves[0].keyframes.push_back(key0);
+  raw_curves.curves[0].keyframes.push_back(key1);
+
+  FloatCurvesBuilder builder;
+  ozz::unique_ptr<FloatCurves> curves0(builder(raw_curves));
+  ASSERT_TRUE(curves0);
+  raw_curves.curves[0].keyframes[1].value = -10.f;
+  ozz::unique_ptr<FloatCurves> curves1(builder(raw_curves));
+  ASSERT_TRUE(curves1);
+
+  FloatCurvesSamplingCache cache(2);
+  float output[2];
+  FloatCurvesSamplingJob job;
+  job.cache = &cache;
+  job.output = output;
+  job.ratio = .5f;
+
+  // Alternates curves with the same cache.
+  job.curves = curves0.get();
+  ASSERT_TRUE(job.Run());
+  EXPECT_FLOAT_EQ(output[0], 5.f);
+  job.curves = curves1.get();
+  ASSERT_TRUE(job.Run());
+  EXPECT_FLOAT_EQ(output[0], -5.f);
+
+  // Invalidates and resizes.
+  cache.Invalidate();
+  job.curves = curves0.get();
+  ASSERT_TRUE(job.Run());
+  EXPECT_FLOAT_EQ(output[0], 5.f);
+
+  cache.Resize(1);
+  EXPECT_EQ(cache.max_curves(), 4);
+  ASSERT_TRUE(job.Run());
+  EXPECT_FLOAT_EQ(output[0], 5.f);
+
+  cache.Resize(0);
+  EXPECT_FALSE(job.Run());
+}
@@ -0,0 +1,321 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+
+#include "ozz/animation/runtime/ik_chain_job.h"
+
+#include "ozz/base/maths/math_constant.h"
+#include "ozz/base/maths/simd_math.h"
+#include "ozz/base/maths/simd_quaternion.h"
+
+#include "gtest/gtest.h"
+#include "ozz/base/maths/gtest_math_helper.h"
+
+using ozz::animation::IKChainJob;
+
+namespace {
+// A 7 joints hierarchy (each joint is the parent of the next one), with a
+// scaled and rotated root. The chain skips joints 0 (root) and 3, which isn't
+// a chain joint but is in-between joints 2 and 4.
+struct Chain {
+  Chain() {
+    const ozz::math::SimdFloat4 root_rotation =
+        ozz::math::SimdQuaternion::FromAxisAngle(
+            ozz::math::simd_float4::y_axis(),
+            ozz::math::simd_float4::Load1(ozz::math::kPi_4))
+            .xyzw;
+    models[0] = ozz::math::Float4x4::FromAffine(
+        ozz::math::simd_float4::Load(1.f, 2.f, 3.f, 0.f), root_rotation,
+        ozz::math::simd_float4::Load1(2.f));
+    for (int i = 1; i < kNumModels; ++i) {
+      const ozz::math::SimdFloat4 rotation =
+          ozz::math::SimdQuaternion::FromAxisAngle(
+              ozz::math::simd_float4::z_axis(),
+              ozz::math::simd_float4::Load1(.1f * i))
+              .xyzw;
+      models[i] =
+          models[i - 1] *
+          ozz::math::Float4x4::FromAffine(
+              ozz::math::simd_float4::Load(.5f, .1f, 0.f, 0.f), rotation,
+              ozz::math::simd_float4::one());
+    }
+  }
+
+  // Rebuilds corrected model-space matrices of the chain, and returns end
+  // joint position.
+  ozz::math::SimdFloat4 End(const ozz::math::SimdQuaternion* _corrections) {
+    ozz::math::Float4x4 corrected =
+        models[joints[0]] *
+        ozz::math::Float4x4::FromQuaternion(_corrections[0].xyzw);
+    for (int i = 1; i < kNumJoints; ++i) {
+      const ozz::math::Float4x4 local =
+          Invert(models[joints[i - 1]]) * models[joints[i]];
+      corrected = corrected * local *
+                  ozz::math::Float4x4::FromQuaternion(_corrections[i].xyzw);
+    }
+    return corrected.cols[3];
+  }
+
+  ozz::math::SimdFloat4 Position(int _joint) const {
+    return models[joints[_joint]].cols[3];
+  }
+
+  enum { kNumModels = 7, kNumJoints = 5 };
+  ozz::math::Float4x4 models[kNumModels];
+  const int16_t joints[kNumJoints] = {1, 2, 4, 5, 6};
+};
+
+float Distance(ozz::math::SimdFloat4 _a, ozz::math::SimdFloat4 _b) {
+  return ozz::math::GetX(ozz::math::Length3(_a - _b));
+}
+}  // namespace
+
+TEST(JobValidity, IKChainJob) {
+  const Chain chain;
+  ozz::math::SimdQuaternion corrections[Chain::kNumJoints];
+
+  {  // Default is invalid
+    IKChainJob job;
+    EXPECT_FALSE(job.Validate());
+  }
+
+  IKChainJob valid;
+  valid.joints = chain.joints;
+  valid.models = chain.models;
+  valid.joint_corrections = corrections;
+  EXPECT_TRUE(valid.Validate());
+
+  {  // Not enough joints.
+    IKChainJob job = valid;
+    job.joints = {chain.joints, 1};
+    EXPECT_FALSE(job.Validate());
+  }
+
+  {  // Too many joints.
+    int16_t joints[IKChainJob::kMaxJoints + 1] = {0};
+    ozz::math::SimdQuaternion big_corrections[IKChainJob::kMaxJoints + 1];
+    IKChainJob job = valid;
+    job.joints = joints;
+    job.joint_corrections = big_corrections;
+    EXPECT_FALSE(job.Validate());
+    job.joints = {joints, IKChainJob::kMaxJoints};
+    EXPECT_TRUE(job.Validate());
+  }
+
+  {  // Joint out of models range.
+    IKChainJob job = valid;
+    job.models = {chain.models, 6};
+    EXPECT_FALSE(job.Validate());
+    const int16_t joints[] = {1, -1};
+    job = valid;
+    job.joints = joints;
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+
+  {  // Output too small.
+    IKChainJob job = valid;
+    job.joint_corrections = {corrections, Chain::kNumJoints - 1};
+    EXPECT_FALSE(job.Validate());
+  }
+
+  {  // Invalid convergence settings.
+    IKChainJob job = valid;
+    job.max_iterations = -1;
+    EXPECT_FALSE(job.Validate());
+    job = valid;
+    job.tolerance = -1.f;
+    EXPECT_FALSE(job.Validate());
+  }
+}
+
+TEST(Reach, IKChainJob) {
+  Chain chain;
+  const ozz::math::SimdFloat4 targets[] = {
+      chain.Position(Chain::kNumJoints - 1) +
+          ozz::math::simd_float4::Load(.1f, .2f, .3f, 0.f),
+      chain.Position(0) + ozz::math::simd_float4::Load(1.f, -2.f, 1.f, 0.f),
+      chain.Position(0) + ozz::math::simd_float4::Load(-.5f, .5f, -1.f, 0.f),
+      chain.Position(2)};
+
+  for (int s = 0; s < 2; ++s) {
+    for (size_t t = 0; t < OZZ_ARRAY_SIZE(targets); ++t) {
+      SCOPED_TRACE(s * 10 + static_cast<int>(t));
+      ozz::math::SimdQuaternion corrections[Chain::kNumJoints];
+      bool reached;
+      IKChainJob job;
+      job.solver = s == 0 ? IKChainJob::kFabrik : IKChainJob::kCcd;
+      job.max_iterations = 50;
+      job.target = targets[t];
+      job.joints = chain.joints;
+      job.models = chain.models;
+      job.joint_corrections = corrections;
+      job.reached = &reached;
+      ASSERT_TRUE(job.Run());
+
+      EXPECT_TRUE(reached);
+      EXPECT_LT(Distance(chain.End(corrections), targets[t]), 2e-3f);
+      EXPECT_SIMDQUATERNION_EQ_EST(corrections[Chain::kNumJoints - 1], 0.f,
+                                   0.f, 0.f, 1.f);
+    }
+  }
+}
+
+TEST(Unreachable, IKChainJob) {
+  Chain chain;
+  const ozz::math::SimdFloat4 target =
+      chain.Position(0) + ozz::math::simd_float4::Load(10.f, 5.f, 0.f, 0.f);
+  const float initial_distance =
+      Distance(chain.Position(Chain::kNumJoints - 1), target);
+
+  float chain_length = 0.f;
+  for (int i = 1; i < Chain::kNumJoints; ++i) {
+    chain_length += Distance(chain.Position(i - 1), chain.Position(i));
+  }
+
+  for (int s = 0; s < 2; ++s) {
+    SCOPED_TRACE(s);
+    ozz::math::SimdQuaternion corrections[Chain::kNumJoints];
+    bool reached;
+    IKChainJob job;
+    job.solver = s == 0 ? IKChainJob::kFabrik : IKChainJob::kCcd;
+    job.max_iterations = 50;
+    job.target = target;
+    job.joints = chain.joints;
+    job.models = chain.models;
+    job.joint_corrections = corrections;
+    job.reached = &reached;
+    ASSERT_TRUE(job.Run());
+
+    // Chain is stretched toward the target.
+    EXPECT_FALSE(reached);
+    const float distance = Distance(chain.End(corrections), target);
+    EXPECT_LT(distance, initial_distance);
+    EXPECT_NEAR(distance, Distance(chain.Position(0), target) - chain_length,
+                s == 0 ? 1e-3f : 2e-2f);
+  }
+}
+
+TEST(Iterations, IKChainJob) {
+  Chain chain;
+  const ozz::math::SimdFloat4 target =
+      chain.Position(0) + ozz::math::simd_float4::Load(1.f, -2.f, 1.f, 0.f);
+  const float initial_distance =
+      Distance(chain.Position(Chain::kNumJoints - 1), target);
+
+  for (int s = 0; s < 2; ++s) {
+    SCOPED_TRACE(s);
+    ozz::math::SimdQuaternion corrections[Chain::kNumJoints];
+    bool reached;
+    IKChainJob job;
+    job.solver = s == 0 ? IKChainJob::kFabrik : IKChainJob::kCcd;
+    job.target = target;
+    job.joints = chain.joints;
+    job.models = chain.models;
+    job.joint_corrections = corrections;
+    job.reached = &reached;
+
+    {  // No iteration, no correction.
+      job.max_iterations = 0;
+      ASSERT_TRUE(job.Run());
+      EXPECT_FALSE(reached);
+      for (int i = 0; i < Chain::kNumJoints; ++i) {
+        EXPECT_SIMDQUATERNION_EQ(corrections[i], 0.f, 0.f, 0.f, 1.f);
+      }
+    }
+
+    {  // A single iteration gets closer.
+      job.max_iterations = 1;
+      ASSERT_TRUE(job.Run());
+      const float distance = Distance(chain.End(corrections), target);
+      EXPECT_LT(distance, initial_distance);
+
+      // More iterations get even closer.
+      job.max_iterations = 50;
+      ASSERT_TRUE(job.Run());
+      EXPECT_TRUE(reached);
+      EXPECT_LT(Distance(chain.End(corrections), target), distance);
+    }
+
+    {  // Large tolerance stops iterations early.
+      job.tolerance = initial_distance * 1.01f;
+      ASSERT_TRUE(job.Run());
+      EXPECT_TRUE(reached);
+      for (int i = 0; i < Chain::kNumJoints; ++i) {
+        EXPECT_SIMDQUATERNION_EQ(corrections[i], 0.f, 0.f, 0.f, 1.f);
+      }
+    }
+  }
+}
+
+TEST(Weight, IKChainJob) {
+  Chain chain;
+  const ozz::math::SimdFloat4 target =
+      chain.Position(0) + ozz::math::simd_float4::Load(1.f, -2.f, 1.f, 0.f);
+
+  ozz::math::SimdQuaternion corrections[Chain::kNumJoints];
+  bool reached;
+  IKChainJob job;
+  job.max_iterations = 50;
+  job.target = target;
+  job.joints = chain.joints;
+  job.models = chain.models;
+  job.joint_corrections = corrections;
+  job.reached = &reached;
+
+  // Full weight.
+  ASSERT_TRUE(job.Run());
+  EXPECT_TRUE(reached);
+  ozz::math::SimdQuaternion full[Chain::kNumJoints];
+  for (int i = 0; i < Chain::kNumJoints; ++i) {
+    full[i] = corrections[i];
+  }
+
+  {  // No weight.
+    job.weight = 0.f;
+    ASSERT_TRUE(job.Run());
+    EXPECT_FALSE(reached);
+    for (int i = 0; i < Chain::kNumJoints; ++i) {
+      EXPECT_SIMDQUATERNION_EQ(corrections[i], 0.f, 0.f, 0.f, 1.f);
+    }
+  }
+
+  {  // Half weight, corrections are half way to full weight ones.
+    job.weight = .5f;
+    ASSERT_TRUE(job.Run());
+    EXPECT_FALSE(reached);
+    for (int i = 0; i < Chain::kNumJoints; ++i) {
+      const ozz::math::SimdQuaternion expected = {ozz::math::Normalize4(
+          ozz::math::Lerp(ozz::math::simd_float4::w_axis(), full[i].xyzw,
+                          ozz::math::simd_float4::Load1(.5f)))};
+      EXPECT_SIMDQUATERNION_EQ_TOL(
+          corrections[i], ozz::math::GetX(expected.xyzw),
+          ozz::math::GetY(expected.xyzw), ozz::math::GetZ(expected.xyzw),
+          ozz::math::GetW(expected.xyzw), 1e-4f);
+    }
+  }
+}
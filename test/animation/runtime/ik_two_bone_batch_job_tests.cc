@@ -0,0 +1,307 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+
+#include "ozz/animation/runtime/ik_two_bone_batch_job.h"
+
+#include <cstdlib>
+
+#include "ozz/animation/runtime/ik_two_bone_job.h"
+#include "ozz/base/maths/math_constant.h"
+#include "ozz/base/maths/simd_math.h"
+#include "ozz/base/maths/simd_quaternion.h"
+#include "ozz/base/maths/soa_quaternion.h"
+#include "ozz/base/memory/allocator.h"
+
+#include "gtest/gtest.h"
+#include "ozz/base/maths/gtest_math_helper.h"
+
+using ozz::animation::IKTwoBoneBatchJob;
+using ozz::animation::IKTwoBoneJob;
+
+TEST(JobValidity, IKTwoBoneBatchJob) {
+  const ozz::math::Float4x4 matrices[5] = {
+      ozz::math::Float4x4::identity(), ozz::math::Float4x4::identity(),
+      ozz::math::Float4x4::identity(), ozz::math::Float4x4::identity(),
+      ozz::math::Float4x4::identity()};
+  const ozz::math::SimdFloat4 vectors[5] = {
+      ozz::math::simd_float4::y_axis(), ozz::math::simd_float4::y_axis(),
+      ozz::math::simd_float4::y_axis(), ozz::math::simd_float4::y_axis(),
+      ozz::math::simd_float4::y_axis()};
+  ozz::math::SoaQuaternion start_corrections[2];
+  ozz::math::SoaQuaternion mid_corrections[2];
+  bool reached[5];
+
+  {  // Default is valid, as there's no chain.
+    IKTwoBoneBatchJob job;
+    EXPECT_TRUE(job.Validate());
+    EXPECT_TRUE(job.Run());
+  }
+
+  IKTwoBoneBatchJob valid;
+  valid.start_joints = matrices;
+  valid.mid_joints = matrices;
+  valid.end_joints = matrices;
+  valid.targets = vectors;
+  valid.pole_vectors = vectors;
+  valid.start_joint_corrections = start_corrections;
+  valid.mid_joint_corrections = mid_corrections;
+  EXPECT_TRUE(valid.Validate());
+
+  {  // Optional reached output.
+    IKTwoBoneBatchJob job = valid;
+    job.reached = reached;
+    EXPECT_TRUE(job.Validate());
+  }
+
+  {  // Invalid input sizes.
+    IKTwoBoneBatchJob job = valid;
+    job.mid_joints = {matrices, 4};
+    EXPECT_FALSE(job.Validate());
+    job = valid;
+    job.end_joints = {matrices, 4};
+    EXPECT_FALSE(job.Validate());
+    job = valid;
+    job.targets = {vectors, 4};
+    EXPECT_FALSE(job.Validate());
+    job = valid;
+    job.pole_vectors = {vectors, 4};
+    EXPECT_FALSE(job.Validate());
+  }
+
+  {  // Too small outputs.
+    IKTwoBoneBatchJob job = valid;
+    job.start_joint_corrections = {start_corrections, 1};
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+    job = valid;
+    job.mid_joint_corrections = {mid_corrections, 1};
+    EXPECT_FALSE(job.Validate());
+    job = valid;
+    job.reached = {reached, 4};
+    EXPECT_FALSE(job.Validate());
+  }
+
+  {  // Smaller chains count.
+    IKTwoBoneBatchJob job = valid;
+    job.start_joints = {matrices, 4};
+    job.mid_joints = {matrices, 4};
+    job.end_joints = {matrices, 4};
+    job.targets = {vectors, 4};
+    job.pole_vectors = {vectors, 4};
+    job.start_joint_corrections = {start_corrections, 1};
+    job.mid_joint_corrections = {mid_corrections, 1};
+    job.reached = {reached, 4};
+    EXPECT_TRUE(job.Validate());
+  }
+
+  {  // Unnormalized mid axis
+    IKTwoBoneBatchJob job = valid;
+    job.mid_axis =
+        ozz::math::simd_float4::Load(0.f, .70710678f, 0.f, .70710678f);
+    EXPECT_FALSE(job.Validate());
+  }
+}
+
+namespace {
+// Deterministic pseudo random number in range [_min,_max].
+float Random(float _min, float _max) {
+  static unsigned int seed = 46;
+  seed = seed * 1103515245u + 12345u;
+  return _min + (_max - _min) * ((seed >> 8) & 0xffff) / 65535.f;
+}
+
+ozz::math::SimdFloat4 RandomVector(float _range) {
+  return ozz::math::simd_float4::Load(Random(-_range, _range),
+                                      Random(-_range, _range),
+                                      Random(-_range, _range), 0.f);
+}
+
+ozz::math::SimdFloat4 RandomRotation() {
+  return ozz::math::SimdQuaternion::FromAxisAngle(
+             ozz::math::Normalize3(RandomVector(1.f) +
+                                   ozz::math::simd_float4::x_axis()),
+             ozz::math::simd_float4::Load1(Random(-ozz::math::kPi,
+                                                  ozz::math::kPi)))
+      .xyzw;
+}
+
+// Chains setup.
+struct Chains {
+  explicit Chains(int _count) {
+    for (int i = 0; i < _count; ++i) {
+      // Mid joint bends around its z axis (job default mid axis), and is bent
+      // backward for some chains.
+      const ozz::math::SimdFloat4 scale =
+          i % 5 == 4 ? ozz::math::simd_float4::Load(1.f, 2.f, .5f, 0.f)
+                     : ozz::math::simd_float4::one();
+      // Start joint is identity for chains with a target at start joint
+      // position, so the degenerate start to target vector is exactly 0.
+      start[i] = ozz::math::Float4x4::FromAffine(RandomVector(2.f),
+                                                 RandomRotation(), scale);
+      if (i % 8 == 3) {
+        start[i] = ozz::math::Float4x4::identity();
+      }
+      const ozz::math::SimdFloat4 mid_rotation =
+          ozz::math::SimdQuaternion::FromAxisAngle(
+              ozz::math::simd_float4::z_axis(),
+              ozz::math::simd_float4::Load1(Random(-1.5f, 1.5f)))
+              .xyzw;
+      mid[i] = start[i] * ozz::math::Float4x4::FromAffine(
+                              ozz::math::simd_float4::Load(
+                                  Random(.2f, 1.f), 0.f, 0.f, 0.f),
+                              mid_rotation, ozz::math::simd_float4::one());
+      end[i] = mid[i] * ozz::math::Float4x4::Translation(
+                            ozz::math::simd_float4::Load(Random(.2f, 1.f), 0.f,
+                                                         0.f, 0.f));
+
+      // Targets close to start joint (unreachable), within or out of reach.
+      const ozz::math::SimdFloat4 start_position = start[i].cols[3];
+      switch (i % 4) {
+        case 0:
+          target[i] = start_position + RandomVector(.5f);
+          break;
+        case 1:
+          target[i] = start_position + RandomVector(1.5f);
+          break;
+        case 2:
+          target[i] = start_position + RandomVector(3.f);
+          break;
+        default:
+          target[i] = i % 8 == 3 ? start_position
+                                 : mid[i].cols[3] + RandomVector(.1f);
+          break;
+      }
+      pole[i] = RandomVector(1.f) + ozz::math::simd_float4::y_axis();
+    }
+  }
+  enum { kMaxChains = 37 };
+  ozz::math::Float4x4 start[kMaxChains];
+  ozz::math::Float4x4 mid[kMaxChains];
+  ozz::math::Float4x4 end[kMaxChains];
+  ozz::math::SimdFloat4 target[kMaxChains];
+  ozz::math::SimdFloat4 pole[kMaxChains];
+};
+
+// Compares batch job results with IKTwoBoneJob ones, for _count chains.
+void CompareWithIKTwoBoneJob(const Chains& _chains, int _count, float _soften,
+                             float _twist_angle, float _weight) {
+  ozz::math::SoaQuaternion start_corrections[(Chains::kMaxChains + 3) / 4];
+  ozz::math::SoaQuaternion mid_corrections[(Chains::kMaxChains + 3) / 4];
+  bool reached[Chains::kMaxChains];
+
+  IKTwoBoneBatchJob batch;
+  batch.start_joints = {_chains.start, static_cast<size_t>(_count)};
+  batch.mid_joints = {_chains.mid, static_cast<size_t>(_count)};
+  batch.end_joints = {_chains.end, static_cast<size_t>(_count)};
+  batch.targets = {_chains.target, static_cast<size_t>(_count)};
+  batch.pole_vectors = {_chains.pole, static_cast<size_t>(_count)};
+  batch.soften = _soften;
+  batch.twist_angle = _twist_angle;
+  batch.weight = _weight;
+  batch.start_joint_corrections = start_corrections;
+  batch.mid_joint_corrections = mid_corrections;
+  batch.reached = reached;
+  ASSERT_TRUE(batch.Run());
+
+  int num_reached = 0;
+  for (int i = 0; i < (_count + 3) / 4 * 4; ++i) {
+    const ozz::math::SoaQuaternion* soas[2] = {&start_corrections[i / 4],
+                                               &mid_corrections[i / 4]};
+    ozz::math::SimdQuaternion results[2];
+    for (int j = 0; j < 2; ++j) {
+      float x[4], y[4], z[4], w[4];
+      ozz::math::StorePtrU(soas[j]->x, x);
+      ozz::math::StorePtrU(soas[j]->y, y);
+      ozz::math::StorePtrU(soas[j]->z, z);
+      ozz::math::StorePtrU(soas[j]->w, w);
+      results[j].xyzw = ozz::math::simd_float4::Load(x[i % 4], y[i % 4],
+                                                     z[i % 4], w[i % 4]);
+    }
+
+    if (i >= _count) {  // Unused lanes are identity.
+      EXPECT_SIMDQUATERNION_EQ(results[0], 0.f, 0.f, 0.f, 1.f);
+      EXPECT_SIMDQUATERNION_EQ(results[1], 0.f, 0.f, 0.f, 1.f);
+      continue;
+    }
+
+    ozz::math::SimdQuaternion start_correction, mid_correction;
+    bool chain_reached;
+    IKTwoBoneJob job;
+    job.start_joint = &_chains.start[i];
+    job.mid_joint = &_chains.mid[i];
+    job.end_joint = &_chains.end[i];
+    job.target = _chains.target[i];
+    job.pole_vector = _chains.pole[i];
+    job.soften = _soften;
+    job.twist_angle = _twist_angle;
+    job.weight = _weight;
+    job.start_joint_correction = &start_correction;
+    job.mid_joint_correction = &mid_correction;
+    job.reached = &chain_reached;
+    ASSERT_TRUE(job.Run());
+
+    SCOPED_TRACE(i);
+    EXPECT_EQ(reached[i], chain_reached);
+    num_reached += chain_reached;
+    EXPECT_SIMDQUATERNION_EQ_TOL(
+        results[0], ozz::math::GetX(start_correction.xyzw),
+        ozz::math::GetY(start_correction.xyzw),
+        ozz::math::GetZ(start_correction.xyzw),
+        ozz::math::GetW(start_correction.xyzw), 1e-4f);
+    EXPECT_SIMDQUATERNION_EQ_TOL(
+        results[1], ozz::math::GetX(mid_correction.xyzw),
+        ozz::math::GetY(mid_correction.xyzw),
+        ozz::math::GetZ(mid_correction.xyzw),
+        ozz::math::GetW(mid_correction.xyzw), 1e-4f);
+  }
+
+  // Reached and unreached chains are tested.
+  if (_weight >= 1.f && _soften >= 1.f && _count == Chains::kMaxChains) {
+    EXPECT_GT(num_reached, 0);
+    EXPECT_LT(num_reached, _count);
+  }
+}
+}  // namespace
+
+TEST(Compare, IKTwoBoneBatchJob) {
+  const Chains chains(Chains::kMaxChains);
+
+  // All chains counts up to a few SoA batches, to test partial batches.
+  for (int count = 1; count <= 9; ++count) {
+    CompareWithIKTwoBoneJob(chains, count, 1.f, 0.f, 1.f);
+  }
+
+  // Settings.
+  CompareWithIKTwoBoneJob(chains, Chains::kMaxChains, 1.f, 0.f, 1.f);
+  CompareWithIKTwoBoneJob(chains, Chains::kMaxChains, .5f, 0.f, 1.f);
+  CompareWithIKTwoBoneJob(chains, Chains::kMaxChains, 0.f, 0.f, 1.f);
+  CompareWithIKTwoBoneJob(chains, Chains::kMaxChains, 1.f, 1.2f, 1.f);
+  CompareWithIKTwoBoneJob(chains, Chains::kMaxChains, .8f, -.6f, .6f);
+  CompareWithIKTwoBoneJob(chains, Chains::kMaxChains, 1.f, 0.f, 0.f);
+  CompareWithIKTwoBoneJob(chains, Chains::kMaxChains, 1.f, 0.f, -1.f);
+}
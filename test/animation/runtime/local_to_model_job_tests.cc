@@ -25,17 +25,30 @@
 //                                                                            //
 //----------------------------------------------------------------------------//
 
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <thread>
+
 #include "gtest/gtest.h"
 #include "ozz/animation/offline/raw_skeleton.h"
 #include "ozz/animation/offline/skeleton_builder.h"
 #include "ozz/animation/runtime/local_to_model_job.h"
 #include "ozz/animation/runtime/skeleton.h"
+#include "ozz/animation/runtime/skeleton_partition.h"
+#include "ozz/base/containers/vector.h"
 #include "ozz/base/maths/gtest_math_helper.h"
+#include "ozz/base/maths/simd_float3x4.h"
 #include "ozz/base/maths/soa_transform.h"
 #include "ozz/base/memory/unique_ptr.h"
 
 using ozz::animation::LocalToModelJob;
+using ozz::animation::ParallelLocalToModelJob;
 using ozz::animation::Skeleton;
+using ozz::animation::SkeletonPartition;
 using ozz::animation::offline::RawSkeleton;
 using ozz::animation::offline::SkeletonBuilder;
 
@@ -59,6 +72,7 @@ TEST(JobValidity, LocalToModel) {
   ozz::math::SoaTransform input[2] = {ozz::math::SoaTransform::identity(),
                                       ozz::math::SoaTransform::identity()};
   ozz::math::Float4x4 output[5];
+  ozz::math::Float3x4 output_3x4[5];
 
   // Default job
   {
@@ -189,6 +203,41 @@ TEST(JobValidity, LocalToModel) {
     EXPECT_TRUE(job.Validate());
     EXPECT_TRUE(job.Run());
   }
+  // Invalid input dirty range: too small.
+  {
+    bool input_dirty[1] = {true};
+    LocalToModelJob job;
+    job.skeleton = skeleton.get();
+    job.input = input;
+    job.input_dirty = input_dirty;
+    job.output = output;
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+  // Invalid output dirty range: too small.
+  {
+    bool output_dirty[1];
+    LocalToModelJob job;
+    job.skeleton = skeleton.get();
+    job.input = input;
+    job.output = output;
+    job.output_dirty = output_dirty;
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+  // Valid job with dirty ranges.
+  {
+    bool input_dirty[2] = {true, false};
+    bool output_dirty[3];
+    LocalToModelJob job;
+    job.skeleton = skeleton.get();
+    job.input = input;
+    job.input_dirty = input_dirty;
+    job.output = output;
+    job.output_dirty = output_dirty;
+    EXPECT_TRUE(job.Validate());
+    EXPECT_TRUE(job.Run());
+  }
   // Valid job. Bigger input & output
   {
     LocalToModelJob job;
@@ -198,6 +247,34 @@ TEST(JobValidity, LocalToModel) {
     EXPECT_TRUE(job.Validate());
     EXPECT_TRUE(job.Run());
   }
+  // Invalid 3x4 output range: too small.
+  {
+    LocalToModelJob job;
+    job.skeleton = skeleton.get();
+    job.input = input;
+    job.output_3x4 = {output_3x4, output_3x4 + 1};
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+  // Invalid job with both outputs.
+  {
+    LocalToModelJob job;
+    job.skeleton = skeleton.get();
+    job.input = input;
+    job.output = output;
+    job.output_3x4 = output_3x4;
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+  // Valid job with 3x4 output.
+  {
+    LocalToModelJob job;
+    job.skeleton = skeleton.get();
+    job.input = input;
+    job.output_3x4 = output_3x4;
+    EXPECT_TRUE(job.Validate());
+    EXPECT_TRUE(job.Run());
+  }
 }
 
 TEST(Transformation, LocalToModel) {
@@ -1026,3 +1103,741 @@ TEST(Empty, LocalToModel) {
     EXPECT_TRUE(job.Run());
   }
 }
+
+namespace {
+void ExpectFloat4x4Near(const ozz::math::Float4x4& _a,
+                        const ozz::math::Float4x4& _b) {
+  float a[16], b[16];
+  for (int c = 0; c < 4; ++c) {
+    ozz::math::StorePtrU(_a.cols[c], a + c * 4);
+    ozz::math::StorePtrU(_b.cols[c], b + c * 4);
+  }
+  for (int i = 0; i < 16; ++i) {
+    EXPECT_NEAR(a[i], b[i], 1e-5f);
+  }
+}
+}  // namespace
+
+TEST(Incremental, LocalToModel) {
+  // Builds the skeleton
+  /*
+   9 joints
+         *
+       /   \
+     j0    j7
+    /  \    |
+   j1  j3  j8
+    |  / \
+   j2 j4 j6
+       |
+      j5
+  */
+  RawSkeleton raw_skeleton;
+  raw_skeleton.roots.resize(2);
+  RawSkeleton::Joint& j0 = raw_skeleton.roots[0];
+  j0.name = "j0";
+  j0.children.resize(2);
+  j0.children[0].name = "j1";
+  j0.children[0].children.resize(1);
+  j0.children[0].children[0].name = "j2";
+  j0.children[1].name = "j3";
+  j0.children[1].children.resize(2);
+  j0.children[1].children[0].name = "j4";
+  j0.children[1].children[0].children.resize(1);
+  j0.children[1].children[0].children[0].name = "j5";
+  j0.children[1].children[1].name = "j6";
+  RawSkeleton::Joint& j7 = raw_skeleton.roots[1];
+  j7.name = "j7";
+  j7.children.resize(1);
+  j7.children[0].name = "j8";
+
+  SkeletonBuilder builder;
+  ozz::unique_ptr<Skeleton> skeleton(builder(raw_skeleton));
+  ASSERT_TRUE(skeleton);
+  ASSERT_EQ(skeleton->num_joints(), 9);
+
+  // Every joint has a different translation, rotation and scale.
+  ozz::math::SoaTransform input[3];
+  for (int i = 0; i < 3; ++i) {
+    const float f = i * 4.f;
+    input[i].translation = ozz::math::SoaFloat3::Load(
+        ozz::math::simd_float4::Load(f, f + 1.f, f + 2.f, f + 3.f),
+        ozz::math::simd_float4::Load(1.f, 2.f, 3.f, 4.f),
+        ozz::math::simd_float4::Load(-1.f, -2.f, -3.f, -4.f));
+    input[i].rotation = ozz::math::SoaQuaternion::Load(
+        ozz::math::simd_float4::Load(.70710677f, 0.f, 0.f, .6f),
+        ozz::math::simd_float4::zero(), ozz::math::simd_float4::zero(),
+        ozz::math::simd_float4::Load(.70710677f, 1.f, 1.f, .8f));
+    input[i].scale = ozz::math::SoaFloat3::Load(
+        ozz::math::simd_float4::Load(1.f, 2.f, 1.f, .5f),
+        ozz::math::simd_float4::one(), ozz::math::simd_float4::one());
+  }
+
+  // Reference full update.
+  ozz::math::Float4x4 reference[9];
+  LocalToModelJob full;
+  full.skeleton = skeleton.get();
+  full.input = input;
+  full.output = reference;
+  ASSERT_TRUE(full.Run());
+
+  {  // Full update reports all joints as recomputed.
+    ozz::math::Float4x4 output[9];
+    bool output_dirty[9] = {false};
+    LocalToModelJob job;
+    job.skeleton = skeleton.get();
+    job.input = input;
+    job.output = output;
+    job.output_dirty = output_dirty;
+    ASSERT_TRUE(job.Run());
+    for (int i = 0; i < 9; ++i) {
+      EXPECT_TRUE(output_dirty[i]);
+    }
+  }
+
+  {  // Nothing dirty, nothing is updated.
+    ozz::math::Float4x4 output[9];
+    for (int i = 0; i < 9; ++i) {
+      output[i] = ozz::math::Float4x4::Scaling(
+          ozz::math::simd_float4::Load1(46.f));
+    }
+    const bool input_dirty[9] = {false};
+    bool output_dirty[9];
+    LocalToModelJob job;
+    job.skeleton = skeleton.get();
+    job.input = input;
+    job.input_dirty = input_dirty;
+    job.output = output;
+    job.output_dirty = output_dirty;
+    ASSERT_TRUE(job.Run());
+    for (int i = 0; i < 9; ++i) {
+      EXPECT_FALSE(output_dirty[i]);
+      EXPECT_FLOAT4x4_EQ(output[i], 46.f, 0.f, 0.f, 0.f, 0.f, 46.f, 0.f, 0.f,
+                         0.f, 0.f, 46.f, 0.f, 0.f, 0.f, 0.f, 1.f);
+    }
+  }
+
+  // Changes j3 and j8 local transforms.
+  ozz::math::SoaTransform changed[3] = {input[0], input[1], input[2]};
+  changed[0].translation.x = ozz::math::simd_float4::Load(0.f, 1.f, 2.f, 46.f);
+  changed[2].scale.y = ozz::math::simd_float4::Load(2.f, 1.f, 1.f, 1.f);
+  full.input = changed;
+  ASSERT_TRUE(full.Run());
+
+  {  // Incremental update from a previous valid output.
+    ozz::math::Float4x4 output[9];
+    LocalToModelJob initial;
+    initial.skeleton = skeleton.get();
+    initial.input = input;
+    initial.output = output;
+    ASSERT_TRUE(initial.Run());
+
+    const bool input_dirty[9] = {false, false, false, true, false,
+                                 false, false, false, true};
+    bool output_dirty[9];
+    LocalToModelJob job;
+    job.skeleton = skeleton.get();
+    job.input = changed;
+    job.input_dirty = input_dirty;
+    job.output = output;
+    job.output_dirty = output_dirty;
+    ASSERT_TRUE(job.Run());
+
+    // j3 and its descendants, and j8.
+    const bool expected[9] = {false, false, false, true, true,
+                              true,  true,  false, true};
+    for (int i = 0; i < 9; ++i) {
+      EXPECT_EQ(output_dirty[i], expected[i]) << i;
+      ExpectFloat4x4Near(output[i], reference[i]);
+    }
+  }
+
+  {  // Incremental update limited to j0 hierarchy, without output flags.
+    ozz::math::Float4x4 output[9];
+    LocalToModelJob initial;
+    initial.skeleton = skeleton.get();
+    initial.input = input;
+    initial.output = output;
+    ASSERT_TRUE(initial.Run());
+    const ozz::math::Float4x4 j8 = output[8];
+
+    const bool input_dirty[9] = {false, false, false, true, false,
+                                 false, false, false, true};
+    LocalToModelJob job;
+    job.skeleton = skeleton.get();
+    job.from = 0;
+    job.input = changed;
+    job.input_dirty = input_dirty;
+    job.output = output;
+    ASSERT_TRUE(job.Run());
+
+    // j5 is updated, j8 isn't as it's out of range.
+    ExpectFloat4x4Near(output[5], reference[5]);
+    ExpectFloat4x4Near(output[8], j8);
+  }
+
+  {  // Excluded "from" is considered dirty.
+    ozz::math::Float4x4 output[9];
+    LocalToModelJob initial;
+    initial.skeleton = skeleton.get();
+    initial.input = input;
+    initial.output = output;
+    ASSERT_TRUE(initial.Run());
+
+    // Changes j1 model-space matrix.
+    output[1] = ozz::math::Float4x4::identity();
+
+    const bool input_dirty[9] = {false};
+    bool output_dirty[9];
+    LocalToModelJob job;
+    job.skeleton = skeleton.get();
+    job.from = 1;
+    job.from_excluded = true;
+    job.input = input;
+    job.input_dirty = input_dirty;
+    job.output = output;
+    job.output_dirty = output_dirty;
+    ASSERT_TRUE(job.Run());
+
+    // Only j2 is updated, from identity.
+    const bool expected[9] = {false, false, true,  false, false,
+                              false, false, false, false};
+    for (int i = 0; i < 9; ++i) {
+      EXPECT_EQ(output_dirty[i], expected[i]) << i;
+    }
+    EXPECT_SIMDFLOAT_EQ(output[2].cols[3], 2.f, 3.f, -3.f, 1.f);
+  }
+}
+
+TEST(Affine3x4, LocalToModel) {
+  // Builds the skeleton
+  /*
+   6 joints
+         *
+       /   \
+     j0    j4
+    /  \    |
+   j1  j3  j5
+    |
+   j2
+  */
+  RawSkeleton raw_skeleton;
+  raw_skeleton.roots.resize(2);
+  RawSkeleton::Joint& j0 = raw_skeleton.roots[0];
+  j0.name = "j0";
+  j0.children.resize(2);
+  j0.children[0].name = "j1";
+  j0.children[0].children.resize(1);
+  j0.children[0].children[0].name = "j2";
+  j0.children[1].name = "j3";
+  RawSkeleton::Joint& j4 = raw_skeleton.roots[1];
+  j4.name = "j4";
+  j4.children.resize(1);
+  j4.children[0].name = "j5";
+
+  SkeletonBuilder builder;
+  ozz::unique_ptr<Skeleton> skeleton(builder(raw_skeleton));
+  ASSERT_TRUE(skeleton);
+  ASSERT_EQ(skeleton->num_joints(), 6);
+
+  // Every joint has a different translation, rotation and scale.
+  ozz::math::SoaTransform input[2];
+  for (int i = 0; i < 2; ++i) {
+    const float f = i * 4.f;
+    input[i].translation = ozz::math::SoaFloat3::Load(
+        ozz::math::simd_float4::Load(f, f + 1.f, f + 2.f, f + 3.f),
+        ozz::math::simd_float4::Load(1.f, 2.f, 3.f, 4.f),
+        ozz::math::simd_float4::Load(-1.f, -2.f, -3.f, -4.f));
+    input[i].rotation = ozz::math::SoaQuaternion::Load(
+        ozz::math::simd_float4::Load(.70710677f, 0.f, 0.f, .6f),
+        ozz::math::simd_float4::zero(), ozz::math::simd_float4::zero(),
+        ozz::math::simd_float4::Load(.70710677f, 1.f, 1.f, .8f));
+    input[i].scale = ozz::math::SoaFloat3::Load(
+        ozz::math::simd_float4::Load(1.f, 2.f, 1.f, .5f),
+        ozz::math::simd_float4::one(), ozz::math::simd_float4::one());
+  }
+  const ozz::math::Float4x4 root = ozz::math::Float4x4::FromAffine(
+      ozz::math::simd_float4::Load(1.f, 2.f, 3.f, 0.f),
+      ozz::math::simd_float4::Load(0.f, .70710677f, 0.f, .70710677f),
+      ozz::math::simd_float4::Load(2.f, 2.f, 2.f, 0.f));
+
+  // Reference Float4x4 update.
+  ozz::math::Float4x4 reference[6];
+  LocalToModelJob job4x4;
+  job4x4.skeleton = skeleton.get();
+  job4x4.root = &root;
+  job4x4.input = input;
+  job4x4.output = reference;
+  ASSERT_TRUE(job4x4.Run());
+
+  {  // Full update matches Float4x4 output.
+    ozz::math::Float3x4 output[6];
+    LocalToModelJob job;
+    job.skeleton = skeleton.get();
+    job.root = &root;
+    job.input = input;
+    job.output_3x4 = output;
+    ASSERT_TRUE(job.Run());
+    for (int i = 0; i < 6; ++i) {
+      ExpectFloat4x4Near(ToFloat4x4(output[i]), reference[i]);
+    }
+  }
+
+  {  // Partial and incremental update.
+    ozz::math::Float3x4 output[6];
+    for (int i = 0; i < 6; ++i) {
+      output[i] = ozz::math::Float3x4::identity();
+    }
+
+    // Updates j0 hierarchy only.
+    LocalToModelJob job;
+    job.skeleton = skeleton.get();
+    job.root = &root;
+    job.from = 0;
+    job.input = input;
+    job.output_3x4 = output;
+    ASSERT_TRUE(job.Run());
+    for (int i = 0; i < 4; ++i) {
+      ExpectFloat4x4Near(ToFloat4x4(output[i]), reference[i]);
+    }
+    ExpectFloat4x4Near(ToFloat4x4(output[4]), ozz::math::Float4x4::identity());
+
+    // Then j4 hierarchy, incrementally.
+    const bool input_dirty[6] = {false, false, false, false, true, false};
+    bool output_dirty[6];
+    job.from = Skeleton::kNoParent;
+    job.input_dirty = input_dirty;
+    job.output_dirty = output_dirty;
+    ASSERT_TRUE(job.Run());
+    for (int i = 0; i < 6; ++i) {
+      EXPECT_EQ(output_dirty[i], i >= 4) << i;
+      ExpectFloat4x4Near(ToFloat4x4(output[i]), reference[i]);
+    }
+  }
+}
+
+namespace {
+// Gives every joint of _joints hierarchy a different transform.
+void SetupLevelOrderJoints(RawSkeleton::Joint::Children* _joints,
+                           int* _index) {
+  for (RawSkeleton::Joint& joint : *_joints) {
+    const float f = static_cast<float>((*_index)++);
+    joint.transform.translation = ozz::math::Float3(f, f * .5f, -f);
+    joint.transform.rotation = ozz::math::Quaternion::FromAxisAngle(
+        ozz::math::Float3::y_axis(), f * .3f);
+    joint.transform.scale = ozz::math::Float3(1.f + f * .1f, 1.f, 1.f);
+    SetupLevelOrderJoints(&joint.children, _index);
+  }
+}
+}  // namespace
+
+TEST(LevelOrder, LocalToModel) {
+  /*
+   14 joints
+           r
+     / / / | \ \
+   c0 c1 c2 c3 c4 c5
+   /|\  |\      |
+  a0 a1 a2 b0 b1 d0
+                |
+                d1
+  */
+  RawSkeleton raw_skeleton;
+  raw_skeleton.roots.resize(1);
+  RawSkeleton::Joint& r = raw_skeleton.roots[0];
+  r.name = "r";
+  r.children.resize(6);
+  const char* children_names[] = {"c0", "c1", "c2", "c3", "c4", "c5"};
+  for (int i = 0; i < 6; ++i) {
+    r.children[i].name = children_names[i];
+  }
+  r.children[0].children.resize(3);
+  r.children[0].children[0].name = "a0";
+  r.children[0].children[1].name = "a1";
+  r.children[0].children[2].name = "a2";
+  r.children[1].children.resize(2);
+  r.children[1].children[0].name = "b0";
+  r.children[1].children[1].name = "b1";
+  r.children[4].children.resize(1);
+  r.children[4].children[0].name = "d0";
+  r.children[4].children[0].children.resize(1);
+  r.children[4].children[0].children[0].name = "d1";
+
+  // Every joint has a different bind pose, used as job input.
+  int index = 0;
+  SetupLevelOrderJoints(&raw_skeleton.roots, &index);
+
+  SkeletonBuilder builder;
+  ozz::unique_ptr<Skeleton> df_skeleton(builder(raw_skeleton));
+  ASSERT_TRUE(df_skeleton);
+  EXPECT_EQ(df_skeleton->joint_levels().size(), 0u);
+  builder.level_order = true;
+  ozz::unique_ptr<Skeleton> skeleton(builder(raw_skeleton));
+  ASSERT_TRUE(skeleton);
+  ASSERT_EQ(skeleton->num_joints(), 14);
+  ASSERT_EQ(skeleton->joint_levels().size(), 5u);
+
+  // Finds depth-first skeleton joint matching level ordered joint _i.
+  struct Remap {
+    int operator()(int _i) const {
+      for (int j = 0; j < df->num_joints(); ++j) {
+        if (std::strcmp(df->joint_names()[j], lo->joint_names()[_i]) == 0) {
+          return j;
+        }
+      }
+      return -1;
+    }
+    const Skeleton* df;
+    const Skeleton* lo;
+  } remap = {df_skeleton.get(), skeleton.get()};
+
+  const ozz::math::Float4x4 root = ozz::math::Float4x4::Translation(
+      ozz::math::simd_float4::Load(1.f, 2.f, 3.f, 0.f));
+
+  // Depth-first reference.
+  ozz::math::Float4x4 reference[14];
+  LocalToModelJob df_job;
+  df_job.skeleton = df_skeleton.get();
+  df_job.root = &root;
+  df_job.input = df_skeleton->joint_bind_poses();
+  df_job.output = reference;
+  ASSERT_TRUE(df_job.Run());
+
+  {  // Full update.
+    ozz::math::Float4x4 output[14];
+    ozz::math::Float3x4 output_3x4[14];
+    LocalToModelJob job;
+    job.skeleton = skeleton.get();
+    job.root = &root;
+    job.input = skeleton->joint_bind_poses();
+    job.output = output;
+    ASSERT_TRUE(job.Run());
+    job.output = {};
+    job.output_3x4 = output_3x4;
+    ASSERT_TRUE(job.Run());
+    for (int i = 0; i < 14; ++i) {
+      ExpectFloat4x4Near(output[i], reference[remap(i)]);
+      ExpectFloat4x4Near(ToFloat4x4(output_3x4[i]), reference[remap(i)]);
+    }
+  }
+
+  {  // Hierarchy of c1 only, which isn't contiguous.
+    ozz::math::Float4x4 output[14];
+    for (int i = 0; i < 14; ++i) {
+      output[i] = ozz::math::Float4x4::identity();
+    }
+    output[0] = reference[remap(0)];
+
+    bool output_dirty[14];
+    LocalToModelJob job;
+    job.skeleton = skeleton.get();
+    job.root = &root;
+    job.from = 2;
+    job.input = skeleton->joint_bind_poses();
+    job.output = output;
+    job.output_dirty = output_dirty;
+    ASSERT_TRUE(job.Run());
+
+    // c1, b0 and b1.
+    ASSERT_STREQ(skeleton->joint_names()[2], "c1");
+    for (int i = 0; i < 14; ++i) {
+      const bool expected = i == 2 || i == 10 || i == 11;
+      EXPECT_EQ(output_dirty[i], expected) << i;
+      ExpectFloat4x4Near(output[i], expected || i == 0
+                                        ? reference[remap(i)]
+                                        : ozz::math::Float4x4::identity());
+    }
+
+    // c4 children only, up to d0.
+    job.from = 5;
+    job.from_excluded = true;
+    job.to = 12;
+    output[5] = reference[remap(5)];
+    ASSERT_TRUE(job.Run());
+    for (int i = 0; i < 14; ++i) {
+      EXPECT_EQ(output_dirty[i], i == 12) << i;
+    }
+    ExpectFloat4x4Near(output[12], reference[remap(12)]);
+    ExpectFloat4x4Near(output[13], ozz::math::Float4x4::identity());
+  }
+
+  {  // Incremental update.
+    ozz::math::Float4x4 output[14];
+    LocalToModelJob job;
+    job.skeleton = skeleton.get();
+    job.root = &root;
+    job.input = skeleton->joint_bind_poses();
+    job.output = output;
+    ASSERT_TRUE(job.Run());
+
+    // Changes c0 and d0 inputs.
+    ozz::math::SoaTransform input[4];
+    std::copy(skeleton->joint_bind_poses().begin(),
+              skeleton->joint_bind_poses().end(), input);
+    input[0].translation.x = ozz::math::SetY(
+        input[0].translation.x, ozz::math::simd_float4::Load1(46.f));
+    input[3].scale.y =
+        ozz::math::SetX(input[3].scale.y, ozz::math::simd_float4::Load1(2.f));
+    ozz::math::Float4x4 expected_output[14];
+    job.input = input;
+    job.output = expected_output;
+    ASSERT_TRUE(job.Run());
+
+    bool input_dirty[14] = {false};
+    input_dirty[1] = true;
+    input_dirty[12] = true;
+    bool output_dirty[14];
+    job.input_dirty = input_dirty;
+    job.output = output;
+    job.output_dirty = output_dirty;
+    ASSERT_TRUE(job.Run());
+
+    // c0, its children, d0 and d1.
+    for (int i = 0; i < 14; ++i) {
+      const bool expected = i == 1 || (i >= 7 && i <= 9) || i >= 12;
+      EXPECT_EQ(output_dirty[i], expected) << i;
+      ExpectFloat4x4Near(output[i], expected_output[i]);
+    }
+  }
+}
+
+namespace {
+// Builds a tree where the number of children depends on joint index. Every
+// joint has a different transform.
+void SetupParallelJoints(RawSkeleton::Joint::Children* _joints, int _depth,
+                         int* _index) {
+  _joints->resize(1 + (*_index * 7) % 4);
+  for (RawSkeleton::Joint& joint : *_joints) {
+    const float f = static_cast<float>(*_index % 10);
+    ++*_index;
+    joint.transform.translation = ozz::math::Float3(f, 1.f, -f * .5f);
+    joint.transform.rotation = ozz::math::Quaternion::FromAxisAngle(
+        ozz::math::Float3::x_axis(), f * .2f);
+    joint.transform.scale = ozz::math::Float3(1.f, 1.f + f * .01f, 1.f);
+    if (_depth > 0) {
+      SetupParallelJoints(&joint.children, _depth - 1, _index);
+    }
+  }
+}
+}  // namespace
+
+TEST(SoaGroups, LocalToModel) {
+  // Local matrices of consecutive soa transforms can be built with wider simd
+  // instructions. This test builds a 3 soa groups skeleton, whose joints are
+  // all roots, and compares its output with each soa group transformed alone.
+  const int kNumSoa = 3;
+  RawSkeleton raw_skeleton;
+  raw_skeleton.roots.resize(kNumSoa * 4);
+  for (int i = 0; i < kNumSoa * 4; ++i) {
+    raw_skeleton.roots[i].name = std::to_string(i).c_str();
+  }
+  SkeletonBuilder builder;
+  ozz::unique_ptr<Skeleton> skeleton(builder(raw_skeleton));
+  ASSERT_TRUE(skeleton);
+  raw_skeleton.roots.resize(4);
+  ozz::unique_ptr<Skeleton> soa_skeleton(builder(raw_skeleton));
+  ASSERT_TRUE(soa_skeleton);
+
+  // Every joint has a different translation, rotation and scale.
+  ozz::math::SoaTransform input[kNumSoa];
+  for (int i = 0; i < kNumSoa; ++i) {
+    const float f = i * 4.f;
+    const float c = std::cos(f * .1f), s = std::sin(f * .1f);
+    input[i].translation = ozz::math::SoaFloat3::Load(
+        ozz::math::simd_float4::Load(f, f + 1.f, f + 2.f, f + 3.f),
+        ozz::math::simd_float4::Load(1.f, -f, 3.f, 4.f),
+        ozz::math::simd_float4::Load(-1.f, -2.f, f, -4.f));
+    input[i].rotation = ozz::math::SoaQuaternion::Load(
+        ozz::math::simd_float4::Load(s, 0.f, 0.f, s * .6f),
+        ozz::math::simd_float4::Load(0.f, s, 0.f, s * .8f),
+        ozz::math::simd_float4::Load(0.f, 0.f, s, 0.f),
+        ozz::math::simd_float4::Load(c, c, c, c));
+    input[i].scale = ozz::math::SoaFloat3::Load(
+        ozz::math::simd_float4::Load(1.f, 2.f, 1.f, .5f + f * .1f),
+        ozz::math::simd_float4::Load(1.f + f * .1f, 1.f, 1.f, 1.f),
+        ozz::math::simd_float4::one());
+  }
+
+  ozz::math::Float4x4 output[kNumSoa * 4];
+  LocalToModelJob job;
+  job.skeleton = skeleton.get();
+  job.input = input;
+  job.output = output;
+  ASSERT_TRUE(job.Run());
+
+  ozz::math::Float3x4 output_3x4[kNumSoa * 4];
+  job.output = {};
+  job.output_3x4 = output_3x4;
+  ASSERT_TRUE(job.Run());
+
+  for (int i = 0; i < kNumSoa; ++i) {
+    ozz::math::Float4x4 soa_output[4];
+    LocalToModelJob soa_job;
+    soa_job.skeleton = soa_skeleton.get();
+    soa_job.input = ozz::span<const ozz::math::SoaTransform>(&input[i], 1);
+    soa_job.output = soa_output;
+    ASSERT_TRUE(soa_job.Run());
+    for (int j = 0; j < 4; ++j) {
+      ExpectFloat4x4Near(output[i * 4 + j], soa_output[j]);
+      ExpectFloat4x4Near(ToFloat4x4(output_3x4[i * 4 + j]), soa_output[j]);
+    }
+  }
+}
+
+TEST(JobValidity, ParallelLocalToModel) {
+  RawSkeleton raw_skeleton;
+  raw_skeleton.roots.resize(1);
+  raw_skeleton.roots[0].children.resize(3);
+  SkeletonBuilder builder;
+  ozz::unique_ptr<Skeleton> skeleton(builder(raw_skeleton));
+  ASSERT_TRUE(skeleton);
+  const SkeletonPartition partition(*skeleton, 2);
+  const SkeletonPartition empty_partition;
+
+  ozz::math::SoaTransform input[1] = {ozz::math::SoaTransform::identity()};
+  ozz::math::Float4x4 output[4];
+  ozz::math::Float3x4 output_3x4[4];
+
+  {  // Default job.
+    ParallelLocalToModelJob job;
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+
+  {  // No partition.
+    ParallelLocalToModelJob job;
+    job.skeleton = skeleton.get();
+    job.input = input;
+    job.output = output;
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+
+  {  // Partition doesn't match skeleton.
+    ParallelLocalToModelJob job;
+    job.skeleton = skeleton.get();
+    job.partition = &empty_partition;
+    job.input = input;
+    job.output = output;
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+
+  {  // Output too small.
+    ParallelLocalToModelJob job;
+    job.skeleton = skeleton.get();
+    job.partition = &partition;
+    job.input = input;
+    job.output = {output, 3};
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+
+  {  // Both outputs.
+    ParallelLocalToModelJob job;
+    job.skeleton = skeleton.get();
+    job.partition = &partition;
+    job.input = input;
+    job.output = output;
+    job.output_3x4 = output_3x4;
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+
+  {  // Valid.
+    ParallelLocalToModelJob job;
+    job.skeleton = skeleton.get();
+    job.partition = &partition;
+    job.input = input;
+    job.output = output;
+    EXPECT_TRUE(job.Validate());
+    EXPECT_TRUE(job.Run());
+    job.output = {};
+    job.output_3x4 = output_3x4;
+    EXPECT_TRUE(job.Validate());
+    EXPECT_TRUE(job.Run());
+  }
+
+  {  // Valid empty skeleton.
+    const Skeleton empty_skeleton;
+    ParallelLocalToModelJob job;
+    job.skeleton = &empty_skeleton;
+    job.partition = &empty_partition;
+    EXPECT_TRUE(job.Validate());
+    EXPECT_TRUE(job.Run());
+  }
+}
+
+TEST(Transformation, ParallelLocalToModel) {
+  RawSkeleton raw_skeleton;
+  int index = 0;
+  SetupParallelJoints(&raw_skeleton.roots, 5, &index);
+  raw_skeleton.roots.resize(2);
+
+  const ozz::math::Float4x4 root = ozz::math::Float4x4::Translation(
+      ozz::math::simd_float4::Load(1.f, 2.f, 3.f, 0.f));
+
+  // Task runners, serial in reverse order and concurrent.
+  const ozz::TaskRunner runners[] = {
+      nullptr,
+      [](int _count, const std::function<void(int)>& _task) {
+        for (int i = _count - 1; i >= 0; --i) {
+          _task(i);
+        }
+      },
+      [](int _count, const std::function<void(int)>& _task) {
+        std::atomic_int next(0);
+        std::thread threads[4];
+        for (std::thread& thread : threads) {
+          thread = std::thread([&next, &_task, _count]() {
+            for (int i = next++; i < _count; i = next++) {
+              _task(i);
+            }
+          });
+        }
+        for (std::thread& thread : threads) {
+          thread.join();
+        }
+      }};
+
+  for (int order = 0; order < 2; ++order) {
+    SkeletonBuilder builder;
+    builder.level_order = order == 1;
+    ozz::unique_ptr<Skeleton> skeleton(builder(raw_skeleton));
+    ASSERT_TRUE(skeleton);
+    const int num_joints = skeleton->num_joints();
+    ASSERT_GT(num_joints, 200);
+
+    // Serial reference.
+    ozz::vector<ozz::math::Float4x4> reference(num_joints);
+    LocalToModelJob reference_job;
+    reference_job.skeleton = skeleton.get();
+    reference_job.root = &root;
+    reference_job.input = skeleton->joint_bind_poses();
+    reference_job.output = ozz::make_span(reference);
+    ASSERT_TRUE(reference_job.Run());
+
+    for (int max_partitions = 1; max_partitions <= 16; max_partitions *= 4) {
+      const SkeletonPartition partition(*skeleton, max_partitions);
+      for (const ozz::TaskRunner& runner : runners) {
+        ozz::vector<ozz::math::Float4x4> output(num_joints);
+        ozz::vector<ozz::math::Float3x4> output_3x4(num_joints);
+        ParallelLocalToModelJob job;
+        job.skeleton = skeleton.get();
+        job.partition = &partition;
+        job.root = &root;
+        job.input = skeleton->joint_bind_poses();
+        job.task_runner = runner;
+        job.output = ozz::make_span(output);
+        ASSERT_TRUE(job.Run());
+        job.output = {};
+        job.output_3x4 = ozz::make_span(output_3x4);
+        ASSERT_TRUE(job.Run());
+        for (int i = 0; i < num_joints; ++i) {
+          ExpectFloat4x4Near(output[i], reference[i]);
+          ExpectFloat4x4Near(ToFloat4x4(output_3x4[i]), reference[i]);
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,335 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#include "ozz/animation/runtime/sampling_blending_job.h"
+
+#include "gtest/gtest.h"
+#include "ozz/animation/offline/animation_builder.h"
+#include "ozz/animation/offline/raw_animation.h"
+#include "ozz/animation/runtime/animation.h"
+#include "ozz/animation/runtime/blending_job.h"
+#include "ozz/animation/runtime/sampling_job.h"
+#include "ozz/base/maths/gtest_math_helper.h"
+#include "ozz/base/maths/soa_transform.h"
+#include "ozz/base/memory/unique_ptr.h"
+
+using ozz::animation::Animation;
+using ozz::animation::BlendingJob;
+using ozz::animation::SamplingBlendingJob;
+using ozz::animation::SamplingCache;
+using ozz::animation::SamplingJob;
+using ozz::animation::offline::AnimationBuilder;
+using ozz::animation::offline::RawAnimation;
+
+namespace {
+// Builds an animation whose keys depend on _seed.
+ozz::unique_ptr<Animation> BuildAnimation(int _num_tracks, float _seed) {
+  RawAnimation raw_animation;
+  raw_animation.duration = 1.f;
+  raw_animation.tracks.resize(_num_tracks);
+  for (int i = 0; i < _num_tracks; ++i) {
+    RawAnimation::JointTrack& track = raw_animation.tracks[i];
+    for (int k = 0; k < 4; ++k) {
+      const float time = k / 3.f;
+      const float value = _seed * (i + 1) + k;
+      const RawAnimation::TranslationKey tkey = {
+          time, ozz::math::Float3(value, -value, value * .5f)};
+      track.translations.push_back(tkey);
+      const RawAnimation::RotationKey rkey = {
+          time, ozz::math::Quaternion::FromAxisAngle(
+                    ozz::math::Float3::x_axis(), value * .1f)};
+      track.rotations.push_back(rkey);
+      const RawAnimation::ScaleKey skey = {
+          time, ozz::math::Float3(1.f + value * .1f, 2.f, .5f)};
+      track.scales.push_back(skey);
+    }
+  }
+  AnimationBuilder builder;
+  return builder(raw_animation);
+}
+
+// Compares SamplingBlendingJob output with SamplingJob + BlendingJob output.
+void CompareWithBlendingJob(const SamplingBlendingJob& _job) {
+  const size_t num_soa_joints = _job.bind_pose.size();
+
+  // Samples layers to intermediate buffers.
+  ozz::vector<ozz::vector<ozz::math::SoaTransform>> buffers;
+  ozz::vector<BlendingJob::Layer> layers[2];
+  const ozz::span<const SamplingBlendingJob::Layer> src_layers[2] = {
+      _job.layers, _job.additive_layers};
+  for (int l = 0; l < 2; ++l) {
+    for (const SamplingBlendingJob::Layer& src : src_layers[l]) {
+      buffers.emplace_back(src.animation->num_soa_tracks());
+      SamplingCache cache(src.animation->num_tracks());
+      SamplingJob sampling_job;
+      sampling_job.animation = src.animation;
+      sampling_job.cache = &cache;
+      sampling_job.ratio = src.ratio;
+      sampling_job.output = make_span(buffers.back());
+      ASSERT_TRUE(sampling_job.Run());
+    }
+  }
+  size_t buffer = 0;
+  for (int l = 0; l < 2; ++l) {
+    for (const SamplingBlendingJob::Layer& src : src_layers[l]) {
+      BlendingJob::Layer layer;
+      layer.weight = src.weight;
+      layer.transform = make_span(buffers[buffer++]);
+      layer.joint_weights = src.joint_weights;
+      layers[l].push_back(layer);
+    }
+  }
+
+  ozz::vector<ozz::math::SoaTransform> expected(num_soa_joints);
+  BlendingJob blending_job;
+  blending_job.threshold = _job.threshold;
+  blending_job.layers = make_span(layers[0]);
+  blending_job.additive_layers = make_span(layers[1]);
+  blending_job.bind_pose = _job.bind_pose;
+  blending_job.output = make_span(expected);
+  ASSERT_TRUE(blending_job.Run());
+
+  ASSERT_TRUE(_job.Run());
+
+  const float* a = reinterpret_cast<const float*>(expected.data());
+  const float* b = reinterpret_cast<const float*>(_job.output.data());
+  const size_t num_floats =
+      num_soa_joints * sizeof(ozz::math::SoaTransform) / sizeof(float);
+  for (size_t i = 0; i < num_floats; ++i) {
+    ExpectFloatNear(a[i], b[i]);
+  }
+}
+}  // namespace
+
+TEST(JobValidity, SamplingBlendingJob) {
+  ozz::unique_ptr<Animation> animation = BuildAnimation(5, 1.f);
+  ASSERT_TRUE(animation);
+  SamplingCache cache(5);
+  SamplingCache small_cache(1);
+
+  const ozz::math::SoaTransform identity = ozz::math::SoaTransform::identity();
+  const ozz::math::SimdFloat4 zero = ozz::math::simd_float4::zero();
+  const ozz::math::SoaTransform bind_poses[3] = {identity, identity, identity};
+  ozz::math::SoaTransform output[3];
+  const ozz::math::SimdFloat4 joint_weights[2] = {zero, zero};
+
+  SamplingBlendingJob::Layer layers[1];
+  layers[0].animation = animation.get();
+  layers[0].cache = &cache;
+  layers[0].weight = 1.f;
+
+  {  // Empty/default job.
+    SamplingBlendingJob job;
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+
+  {  // Invalid output.
+    SamplingBlendingJob job;
+    job.layers = layers;
+    job.bind_pose = {bind_poses, 2};
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+
+  {  // Invalid threshold.
+    SamplingBlendingJob job;
+    job.threshold = 0.f;
+    job.layers = layers;
+    job.bind_pose = {bind_poses, 2};
+    job.output = output;
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+
+  {  // Animation has less tracks than bind pose.
+    SamplingBlendingJob job;
+    job.layers = layers;
+    job.bind_pose = bind_poses;
+    job.output = output;
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+
+  {  // Invalid layer animation.
+    SamplingBlendingJob::Layer invalid_layers[1];
+    invalid_layers[0].cache = &cache;
+    SamplingBlendingJob job;
+    job.layers = invalid_layers;
+    job.bind_pose = {bind_poses, 2};
+    job.output = output;
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+
+  {  // Invalid layer cache.
+    SamplingBlendingJob::Layer invalid_layers[1];
+    invalid_layers[0].animation = animation.get();
+    SamplingBlendingJob job;
+    job.layers = invalid_layers;
+    job.bind_pose = {bind_poses, 2};
+    job.output = output;
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+
+  {  // Invalid additive layer cache size.
+    SamplingBlendingJob::Layer invalid_layers[1];
+    invalid_layers[0].animation = animation.get();
+    invalid_layers[0].cache = &small_cache;
+    SamplingBlendingJob job;
+    job.additive_layers = invalid_layers;
+    job.bind_pose = {bind_poses, 2};
+    job.output = output;
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+
+  {  // Invalid joint weights range.
+    SamplingBlendingJob::Layer invalid_layers[1];
+    invalid_layers[0].animation = animation.get();
+    invalid_layers[0].cache = &cache;
+    invalid_layers[0].joint_weights = {joint_weights, 1};
+    SamplingBlendingJob job;
+    job.layers = invalid_layers;
+    job.bind_pose = {bind_poses, 2};
+    job.output = output;
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+
+  {  // Valid job.
+    SamplingBlendingJob job;
+    job.layers = layers;
+    job.additive_layers = layers;
+    job.bind_pose = {bind_poses, 2};
+    job.output = output;
+    EXPECT_TRUE(job.Validate());
+    EXPECT_TRUE(job.Run());
+  }
+
+  {  // Valid job, no layer.
+    SamplingBlendingJob job;
+    job.bind_pose = {bind_poses, 2};
+    job.output = output;
+    EXPECT_TRUE(job.Validate());
+    EXPECT_TRUE(job.Run());
+  }
+}
+
+TEST(Blend, SamplingBlendingJob) {
+  // Uses more joints than a single processing batch.
+  const int kNumJoints = 150;
+  const int kNumSoaJoints = (kNumJoints + 3) / 4;
+  ozz::unique_ptr<Animation> animations[3] = {BuildAnimation(kNumJoints, 1.f),
+                                              BuildAnimation(kNumJoints, -2.f),
+                                              BuildAnimation(kNumJoints, .3f)};
+  SamplingCache caches[3];
+  for (int i = 0; i < 3; ++i) {
+    ASSERT_TRUE(animations[i]);
+    caches[i].Resize(kNumJoints);
+  }
+
+  ozz::vector<ozz::math::SoaTransform> bind_pose(kNumSoaJoints);
+  ozz::vector<ozz::math::SimdFloat4> joint_weights(kNumSoaJoints);
+  for (int i = 0; i < kNumSoaJoints; ++i) {
+    const float v = static_cast<float>(i);
+    bind_pose[i] = ozz::math::SoaTransform::identity();
+    bind_pose[i].translation.x = ozz::math::simd_float4::Load1(v);
+    joint_weights[i] = ozz::math::simd_float4::Load(
+        0.f, .05f, (i % 5) * .2f, i > kNumSoaJoints / 2 ? 1.f : .5f);
+  }
+  ozz::vector<ozz::math::SoaTransform> output(kNumSoaJoints);
+
+  SamplingBlendingJob::Layer layers[2];
+  layers[0].animation = animations[0].get();
+  layers[0].cache = &caches[0];
+  layers[0].ratio = .2f;
+  layers[1].animation = animations[1].get();
+  layers[1].cache = &caches[1];
+  layers[1].ratio = .7f;
+  SamplingBlendingJob::Layer additive_layers[1];
+  additive_layers[0].animation = animations[2].get();
+  additive_layers[0].cache = &caches[2];
+  additive_layers[0].ratio = .5f;
+
+  SamplingBlendingJob job;
+  job.layers = layers;
+  job.bind_pose = make_span(bind_pose);
+  job.output = make_span(output);
+
+  {  // Full layers.
+    layers[0].weight = .3f;
+    layers[1].weight = .7f;
+    CompareWithBlendingJob(job);
+  }
+
+  {  // Single layer, other is skipped.
+    layers[0].weight = 0.f;
+    layers[1].weight = 2.f;
+    CompareWithBlendingJob(job);
+  }
+
+  {  // Bind pose fallback.
+    layers[0].weight = .01f;
+    layers[1].weight = .02f;
+    CompareWithBlendingJob(job);
+  }
+
+  {  // Bind pose only.
+    layers[0].weight = 0.f;
+    layers[1].weight = 0.f;
+    CompareWithBlendingJob(job);
+  }
+
+  {  // Partial blending, including bind pose fallback.
+    layers[0].weight = .8f;
+    layers[0].joint_weights = make_span(joint_weights);
+    layers[1].weight = .1f;
+    CompareWithBlendingJob(job);
+    layers[0].joint_weights = {};
+  }
+
+  {  // Additive blending.
+    layers[0].weight = .5f;
+    layers[1].weight = .5f;
+    job.additive_layers = additive_layers;
+    additive_layers[0].weight = .6f;
+    CompareWithBlendingJob(job);
+
+    // Subtractive with joint weights.
+    additive_layers[0].weight = -.4f;
+    additive_layers[0].joint_weights = make_span(joint_weights);
+    CompareWithBlendingJob(job);
+
+    // Changes time.
+    layers[0].ratio = .9f;
+    layers[1].ratio = .1f;
+    additive_layers[0].ratio = 1.f;
+    CompareWithBlendingJob(job);
+  }
+}
@@ -25,6 +25,8 @@
 //                                                                            //
 //----------------------------------------------------------------------------//
 
+#include <cstring>
+
 #include "gtest/gtest.h"
 #include "ozz/animation/offline/animation_builder.h"
 #include "ozz/animation/offline/raw_animation.h"
@@ -35,6 +37,7 @@
 #include "ozz/base/memory/unique_ptr.h"
 
 using ozz::animation::Animation;
+using ozz::animation::BatchSamplingJob;
 using ozz::animation::SamplingCache;
 using ozz::animation::SamplingJob;
 using ozz::animation::offline::AnimationBuilder;
@@ -154,6 +157,20 @@ TEST(JobValidity, SamplingJob) {
     EXPECT_TRUE(job.Validate());
     EXPECT_TRUE(job.Run());
   }
+
+  {  // Mask.
+    ozz::math::SoaTransform output[1];
+    SamplingJob job;
+    job.animation = animation.get();
+    job.cache = &cache;
+    job.output = output;
+    const bool mask[1] = {false};
+    job.soa_mask = ozz::span<const bool>(mask, static_cast<size_t>(0));
+    EXPECT_TRUE(job.Validate());  // Empty mask is valid.
+    job.soa_mask = mask;
+    EXPECT_TRUE(job.Validate());
+    EXPECT_TRUE(job.Run());
+  }
 }
 
 TEST(Sampling, SamplingJob) {
@@ -638,3 +655,365 @@ TEST(CacheResize, SamplingJob) {
   cache.Resize(1);
   EXPECT_FALSE(job.Validate());
 }
+
+TEST(Seek, SamplingJob) {
+  // Builds an animation with enough keys to have a seeking index.
+  RawAnimation raw_animation;
+  raw_animation.duration = 1.f;
+  raw_animation.tracks.resize(6);
+  const int kNumKeys = 100;
+  for (int i = 0; i < 6; ++i) {
+    RawAnimation::JointTrack& track = raw_animation.tracks[i];
+    for (int k = 0; k < kNumKeys; ++k) {
+      const float time = k / (kNumKeys - 1.f);
+      const RawAnimation::TranslationKey key = {
+          time, ozz::math::Float3(time, static_cast<float>(i), -time)};
+      track.translations.push_back(key);
+    }
+  }
+
+  AnimationBuilder builder;
+  ozz::unique_ptr<Animation> animation(builder(raw_animation));
+  ASSERT_TRUE(animation);
+  ASSERT_GT(animation->num_seek_segments(), 1);
+  EXPECT_EQ(animation->translations_seek().size(),
+            static_cast<size_t>(animation->num_seek_segments() *
+                                (animation->num_soa_tracks() * 4 * 2 + 1)));
+
+  SamplingCache cache(6);
+  ozz::math::SoaTransform output[2];
+
+  SamplingJob job;
+  job.animation = animation.get();
+  job.cache = &cache;
+  job.output = output;
+
+  // Forward, backward, and random jumps.
+  const float ratios[] = {0.f,  .1f, .2f,  .99f, 1.f,  .5f, .49f, .51f,
+                          .25f, .7f, .01f, .75f, .74f, 0.f, 1.f,  .33f};
+  for (size_t i = 0; i < OZZ_ARRAY_SIZE(ratios); ++i) {
+    const float r = ratios[i];
+    job.ratio = r;
+    ASSERT_TRUE(job.Run());
+    EXPECT_SOAFLOAT3_EQ_EST(output[0].translation, r, r, r, r, 0.f, 1.f, 2.f,
+                            3.f, -r, -r, -r, -r);
+    EXPECT_SOAFLOAT3_EQ_EST(output[1].translation, r, r, 0.f, 0.f, 4.f, 5.f,
+                            0.f, 0.f, -r, -r, 0.f, 0.f);
+  }
+}
+
+TEST(Mask, SamplingJob) {
+  RawAnimation raw_animation;
+  raw_animation.duration = 1.f;
+  raw_animation.tracks.resize(6);
+  for (int i = 0; i < 6; ++i) {
+    RawAnimation::JointTrack& track = raw_animation.tracks[i];
+    const RawAnimation::TranslationKey first = {
+        0.f, ozz::math::Float3(0.f, static_cast<float>(i), 0.f)};
+    track.translations.push_back(first);
+    const RawAnimation::TranslationKey last = {
+        1.f, ozz::math::Float3(1.f, static_cast<float>(i), -1.f)};
+    track.translations.push_back(last);
+  }
+
+  AnimationBuilder builder;
+  ozz::unique_ptr<Animation> animation(builder(raw_animation));
+  ASSERT_TRUE(animation);
+
+  SamplingCache cache(6);
+  ozz::math::SoaTransform output[2];
+  output[1] = ozz::math::SoaTransform::identity();
+
+  // Only the first soa track is enabled.
+  bool mask[2] = {true, false};
+
+  SamplingJob job;
+  job.animation = animation.get();
+  job.cache = &cache;
+  job.output = output;
+  job.soa_mask = mask;
+
+  const float ratios[] = {0.f, .5f, .25f, 1.f};
+  for (size_t i = 0; i < OZZ_ARRAY_SIZE(ratios); ++i) {
+    const float r = ratios[i];
+    job.ratio = r;
+    ASSERT_TRUE(job.Run());
+    EXPECT_SOAFLOAT3_EQ_EST(output[0].translation, r, r, r, r, 0.f, 1.f, 2.f,
+                            3.f, -r, -r, -r, -r);
+    // Disabled track output is left unchanged.
+    EXPECT_SOAFLOAT3_EQ(output[1].translation, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f,
+                        0.f, 0.f, 0.f, 0.f, 0.f, 0.f);
+  }
+
+  // Enables second track at the same ratio, which must be decompressed even
+  // if keys haven't changed since last sampling.
+  mask[1] = true;
+  ASSERT_TRUE(job.Run());
+  EXPECT_SOAFLOAT3_EQ_EST(output[0].translation, 1.f, 1.f, 1.f, 1.f, 0.f, 1.f,
+                          2.f, 3.f, -1.f, -1.f, -1.f, -1.f);
+  EXPECT_SOAFLOAT3_EQ_EST(output[1].translation, 1.f, 1.f, 0.f, 0.f, 4.f, 5.f,
+                          0.f, 0.f, -1.f, -1.f, 0.f, 0.f);
+}
+
+namespace {
+// Expects every component of soa transforms _a and _b to be near.
+void ExpectSoaTransformNear(const ozz::math::SoaTransform& _a,
+                            const ozz::math::SoaTransform& _b) {
+  const float* a = reinterpret_cast<const float*>(&_a);
+  const float* b = reinterpret_cast<const float*>(&_b);
+  for (size_t i = 0; i < sizeof(ozz::math::SoaTransform) / sizeof(float);
+       ++i) {
+    EXPECT_NEAR(a[i], b[i], 1e-5f) << i;
+  }
+}
+
+// Fills _track with keys that depend on _index.
+void SetupSoaTrack(int _index, RawAnimation::JointTrack* _track) {
+  const float f = static_cast<float>(_index);
+  for (int k = 0; k < 4; ++k) {
+    const float time = k / 3.f + (k == 1 || k == 2 ? f * .01f : 0.f);
+    const float v = f + k;
+    const RawAnimation::TranslationKey tkey = {
+        time, ozz::math::Float3(v, -v * .5f, 1.f + v * .1f)};
+    _track->translations.push_back(tkey);
+    const RawAnimation::RotationKey rkey = {
+        time, ozz::math::Quaternion::FromAxisAngle(
+                  Normalize(ozz::math::Float3(1.f, f, -.5f)), v * .4f)};
+    _track->rotations.push_back(rkey);
+    const RawAnimation::ScaleKey skey = {
+        time, ozz::math::Float3(1.f + v * .1f, 2.f - v * .1f, 1.f)};
+    _track->scales.push_back(skey);
+  }
+}
+}  // namespace
+
+TEST(SoaTracks, SamplingJob) {
+  // Soa tracks can be decompressed and interpolated with wider simd
+  // instructions. This test samples a 3 soa tracks animation, and compares
+  // its output with animations made of each soa track alone.
+  const int kNumSoa = 3;
+  RawAnimation raw_animation;
+  raw_animation.duration = 1.f;
+  raw_animation.tracks.resize(kNumSoa * 4);
+  for (int i = 0; i < kNumSoa * 4; ++i) {
+    SetupSoaTrack(i, &raw_animation.tracks[i]);
+  }
+  AnimationBuilder builder;
+  ozz::unique_ptr<Animation> animation(builder(raw_animation));
+  ASSERT_TRUE(animation);
+
+  ozz::unique_ptr<Animation> soa_animations[kNumSoa];
+  for (int i = 0; i < kNumSoa; ++i) {
+    RawAnimation raw_soa_animation;
+    raw_soa_animation.duration = 1.f;
+    raw_soa_animation.tracks.resize(4);
+    for (int j = 0; j < 4; ++j) {
+      SetupSoaTrack(i * 4 + j, &raw_soa_animation.tracks[j]);
+    }
+    soa_animations[i] = builder(raw_soa_animation);
+    ASSERT_TRUE(soa_animations[i]);
+  }
+
+  SamplingCache cache(kNumSoa * 4);
+  ozz::math::SoaTransform output[kNumSoa];
+  SamplingJob job;
+  job.animation = animation.get();
+  job.cache = &cache;
+  job.output = output;
+
+  SamplingCache soa_caches[kNumSoa];
+  for (int i = 0; i < kNumSoa; ++i) {
+    soa_caches[i].Resize(4);
+  }
+
+  // Samples forward then backward.
+  const float ratios[] = {0.f, .1f, .3f, .35f, .5f, .7f, 1.f, .6f, .2f, 0.f};
+  for (size_t r = 0; r < OZZ_ARRAY_SIZE(ratios); ++r) {
+    job.ratio = ratios[r];
+    ASSERT_TRUE(job.Run());
+
+    for (int i = 0; i < kNumSoa; ++i) {
+      ozz::math::SoaTransform soa_output[1];
+      SamplingJob soa_job;
+      soa_job.animation = soa_animations[i].get();
+      soa_job.cache = &soa_caches[i];
+      soa_job.output = soa_output;
+      soa_job.ratio = ratios[r];
+      ASSERT_TRUE(soa_job.Run());
+      ExpectSoaTransformNear(output[i], soa_output[0]);
+    }
+  }
+
+  // Masks the second soa track, which doesn't prevent others from being
+  // sampled.
+  const ozz::math::SoaTransform identity = ozz::math::SoaTransform::identity();
+  output[1] = identity;
+  const bool mask[kNumSoa] = {true, false, true};
+  job.soa_mask = mask;
+  job.ratio = .4f;
+  ASSERT_TRUE(job.Run());
+  ExpectSoaTransformNear(output[1], identity);
+  for (int i = 0; i < kNumSoa; i += 2) {
+    ozz::math::SoaTransform soa_output[1];
+    SamplingJob soa_job;
+    soa_job.animation = soa_animations[i].get();
+    soa_job.cache = &soa_caches[i];
+    soa_job.output = soa_output;
+    soa_job.ratio = .4f;
+    ASSERT_TRUE(soa_job.Run());
+    ExpectSoaTransformNear(output[i], soa_output[0]);
+  }
+}
+
+TEST(JobValidity, BatchSamplingJob) {
+  RawAnimation raw_animation;
+  raw_animation.duration = 1.f;
+  raw_animation.tracks.resize(1);
+
+  AnimationBuilder builder;
+  ozz::unique_ptr<Animation> animation(builder(raw_animation));
+  ASSERT_TRUE(animation);
+
+  SamplingCache cache0(1);
+  SamplingCache cache1(1);
+  SamplingCache* caches[] = {&cache0, &cache1};
+  const float ratios[] = {0.f, .5f};
+  ozz::math::SoaTransform output0[1];
+  ozz::math::SoaTransform output1[1];
+  const ozz::span<ozz::math::SoaTransform> outputs[] = {output0, output1};
+
+  {  // Empty/default job
+    BatchSamplingJob job;
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+
+  {  // Empty batch.
+    BatchSamplingJob job;
+    job.animation = animation.get();
+    EXPECT_TRUE(job.Validate());
+    EXPECT_TRUE(job.Run());
+  }
+
+  {  // Ranges size mismatch.
+    BatchSamplingJob job;
+    job.animation = animation.get();
+    job.ratios = ratios;
+    job.caches = caches;
+    job.outputs = ozz::span<const ozz::span<ozz::math::SoaTransform>>(
+        outputs, size_t(1));
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+
+  {  // Invalid cache.
+    SamplingCache* invalid_caches[] = {&cache0, nullptr};
+    BatchSamplingJob job;
+    job.animation = animation.get();
+    job.ratios = ratios;
+    job.caches = invalid_caches;
+    job.outputs = outputs;
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+
+  {  // Invalid cache size.
+    SamplingCache zero_cache(0);
+    SamplingCache* invalid_caches[] = {&cache0, &zero_cache};
+    BatchSamplingJob job;
+    job.animation = animation.get();
+    job.ratios = ratios;
+    job.caches = invalid_caches;
+    job.outputs = outputs;
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+
+  {  // Invalid output.
+    const ozz::span<ozz::math::SoaTransform> invalid_outputs[] = {
+        output0, ozz::span<ozz::math::SoaTransform>()};
+    BatchSamplingJob job;
+    job.animation = animation.get();
+    job.ratios = ratios;
+    job.caches = caches;
+    job.outputs = invalid_outputs;
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+
+  {  // Valid job.
+    BatchSamplingJob job;
+    job.animation = animation.get();
+    job.ratios = ratios;
+    job.caches = caches;
+    job.outputs = outputs;
+    EXPECT_TRUE(job.Validate());
+    EXPECT_TRUE(job.Run());
+  }
+}
+
+TEST(Batch, BatchSamplingJob) {
+  RawAnimation raw_animation;
+  raw_animation.duration = 1.f;
+  raw_animation.tracks.resize(5);
+  for (int i = 0; i < 5; ++i) {
+    RawAnimation::JointTrack& track = raw_animation.tracks[i];
+    for (int k = 0; k < 20; ++k) {
+      const float time = k / 19.f;
+      const RawAnimation::TranslationKey tkey = {
+          time, ozz::math::Float3(time * i, static_cast<float>(k), -time)};
+      track.translations.push_back(tkey);
+      const RawAnimation::RotationKey rkey = {
+          time, ozz::math::Quaternion::FromAxisAngle(
+                    ozz::math::Float3::y_axis(), time * i)};
+      track.rotations.push_back(rkey);
+      const RawAnimation::ScaleKey skey = {
+          time, ozz::math::Float3(1.f + time, 2.f, 1.f + k)};
+      track.scales.push_back(skey);
+    }
+  }
+
+  AnimationBuilder builder;
+  ozz::unique_ptr<Animation> animation(builder(raw_animation));
+  ASSERT_TRUE(animation);
+
+  // Some instances share the same ratio or key interval, some don't.
+  const float ratios[][6] = {{0.f, 0.f, .01f, .3f, .31f, 1.f},
+                             {.1f, .02f, .5f, .5f, .9f, .2f},
+                             {.11f, .9f, .51f, .6f, .95f, .21f}};
+  const int kInstances = OZZ_ARRAY_SIZE(ratios[0]);
+  SamplingCache batch_caches[kInstances];
+  SamplingCache caches[kInstances];
+  SamplingCache* batch_caches_ptr[kInstances];
+  ozz::math::SoaTransform batch_outputs[kInstances][2];
+  ozz::math::SoaTransform outputs[kInstances][2];
+  ozz::span<ozz::math::SoaTransform> batch_outputs_span[kInstances];
+  for (int i = 0; i < kInstances; ++i) {
+    batch_caches[i].Resize(5);
+    caches[i].Resize(5);
+    batch_caches_ptr[i] = &batch_caches[i];
+    batch_outputs_span[i] = batch_outputs[i];
+  }
+
+  for (size_t f = 0; f < OZZ_ARRAY_SIZE(ratios); ++f) {
+    BatchSamplingJob batch_job;
+    batch_job.animation = animation.get();
+    batch_job.ratios = ratios[f];
+    batch_job.caches = batch_caches_ptr;
+    batch_job.outputs = batch_outputs_span;
+    ASSERT_TRUE(batch_job.Run());
+
+    for (int i = 0; i < kInstances; ++i) {
+      SamplingJob job;
+      job.animation = animation.get();
+      job.cache = &caches[i];
+      job.ratio = ratios[f][i];
+      job.output = outputs[i];
+      ASSERT_TRUE(job.Run());
+
+      // Batch and single jobs must output exactly the same result.
+      EXPECT_EQ(std::memcmp(outputs[i], batch_outputs[i], sizeof(outputs[i])),
+                0);
+    }
+  }
+}
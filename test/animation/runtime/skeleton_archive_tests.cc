@@ -26,6 +26,7 @@
 //----------------------------------------------------------------------------//
 
 #include "ozz/animation/runtime/skeleton.h"
+#include "ozz/animation/runtime/track.h"
 
 #include "gtest/gtest.h"
 
@@ -37,6 +38,7 @@
 
 #include "ozz/base/maths/soa_transform.h"
 
+#include "ozz/base/memory/allocator.h"
 #include "ozz/base/memory/unique_ptr.h"
 
 using ozz::animation::Skeleton;
@@ -113,6 +115,12 @@ TEST(Filled, SkeletonSerialize) {
                 o_skeleton->joint_parents()[i]);
       EXPECT_STREQ(i_skeleton.joint_names()[i], o_skeleton->joint_names()[i]);
     }
+
+    // Levels are restored from parents.
+    ASSERT_EQ(i_skeleton.joint_levels().size(), 3u);
+    for (int i = 0; i < 3; ++i) {
+      EXPECT_EQ(i_skeleton.joint_levels()[i], o_skeleton->joint_levels()[i]);
+    }
     for (int i = 0; i < (i_skeleton.num_joints() + 3) / 4; ++i) {
       EXPECT_TRUE(ozz::math::AreAllTrue(
           i_skeleton.joint_bind_poses()[i].translation ==
@@ -177,3 +185,79 @@ TEST(AlreadyInitialized, SkeletonSerialize) {
     EXPECT_STREQ(i_skeleton.joint_names()[1], o_skeleton[1]->joint_names()[1]);
   }
 }
+
+TEST(View, SkeletonSerialize) {
+  RawSkeleton raw_skeleton;
+  raw_skeleton.roots.resize(1);
+  RawSkeleton::Joint& root = raw_skeleton.roots[0];
+  root.name = "root";
+  root.transform.translation = ozz::math::Float3(1.f, 2.f, 3.f);
+  root.children.resize(2);
+  root.children[0].name = "j0";
+  root.children[1].name = "";  // Empty names are supported.
+
+  SkeletonBuilder builder;
+  ozz::unique_ptr<Skeleton> o_skeleton(builder(raw_skeleton));
+  ASSERT_TRUE(o_skeleton);
+
+  ozz::memory::Allocator* allocator = ozz::memory::default_allocator();
+  const size_t view_size = o_skeleton->view_size();
+  char* memory = static_cast<char*>(allocator->Allocate(view_size, 16));
+
+  EXPECT_FALSE(o_skeleton->SaveView({memory, view_size - 1}));
+  ASSERT_TRUE(o_skeleton->SaveView({memory, view_size}));
+
+  {
+    Skeleton i_skeleton;
+    ASSERT_TRUE(i_skeleton.LoadView({memory, view_size}));
+    EXPECT_EQ(i_skeleton.view_size(), view_size);
+    ASSERT_EQ(o_skeleton->num_joints(), i_skeleton.num_joints());
+    for (int i = 0; i < i_skeleton.num_joints(); ++i) {
+      EXPECT_EQ(i_skeleton.joint_parents()[i],
+                o_skeleton->joint_parents()[i]);
+      EXPECT_STREQ(i_skeleton.joint_names()[i], o_skeleton->joint_names()[i]);
+    }
+    EXPECT_EQ(i_skeleton.joint_levels().size(), 3u);
+    EXPECT_TRUE(ozz::math::AreAllTrue(
+        i_skeleton.joint_bind_poses()[0].translation ==
+        o_skeleton->joint_bind_poses()[0].translation));
+
+    // Data aren't copied.
+    const char* bind_poses =
+        reinterpret_cast<const char*>(i_skeleton.joint_bind_poses().data());
+    EXPECT_TRUE(bind_poses > memory && bind_poses < memory + view_size);
+  }
+
+  {  // Truncated view.
+    Skeleton i_skeleton;
+    EXPECT_FALSE(i_skeleton.LoadView({memory, view_size - 1}));
+    EXPECT_EQ(i_skeleton.num_joints(), 0);
+  }
+
+  {  // Names characters aren't null terminated.
+    Skeleton i_skeleton;
+    memory[view_size - 1] = 'x';
+    EXPECT_FALSE(i_skeleton.LoadView({memory, view_size}));
+    EXPECT_EQ(i_skeleton.num_joints(), 0);
+  }
+
+  allocator->Deallocate(memory);
+}
+
+TEST(EmptyView, SkeletonSerialize) {
+  Skeleton o_skeleton;
+  ozz::memory::Allocator* allocator = ozz::memory::default_allocator();
+  const size_t view_size = o_skeleton.view_size();
+  char* memory = static_cast<char*>(allocator->Allocate(view_size, 16));
+  ASSERT_TRUE(o_skeleton.SaveView({memory, view_size}));
+
+  Skeleton i_skeleton;
+  ASSERT_TRUE(i_skeleton.LoadView({memory, view_size}));
+  EXPECT_EQ(i_skeleton.num_joints(), 0);
+
+  // Wrong type.
+  ozz::animation::FloatTrack track;
+  EXPECT_FALSE(track.LoadView({memory, view_size}));
+
+  allocator->Deallocate(memory);
+}
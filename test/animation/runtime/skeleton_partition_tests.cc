@@ -0,0 +1,276 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+
+#include "ozz/animation/runtime/skeleton_partition.h"
+
+#include "gtest/gtest.h"
+#include "ozz/animation/offline/raw_skeleton.h"
+#include "ozz/animation/offline/skeleton_builder.h"
+#include "ozz/animation/runtime/skeleton.h"
+#include "ozz/base/memory/unique_ptr.h"
+
+using ozz::animation::Skeleton;
+using ozz::animation::SkeletonPartition;
+using ozz::animation::offline::RawSkeleton;
+using ozz::animation::offline::SkeletonBuilder;
+
+namespace {
+// Adds _count children to _joints, each with a chain of _depth descendants.
+void AddChains(RawSkeleton::Joint::Children* _joints, int _count, int _depth) {
+  for (int i = 0; i < _count; ++i) {
+    _joints->resize(_joints->size() + 1);
+    RawSkeleton::Joint::Children* chain = &_joints->back().children;
+    for (int j = 0; j < _depth; ++j) {
+      chain->resize(1);
+      chain = &chain->back().children;
+    }
+  }
+}
+
+// Builds a tree where the number of children depends on joint index.
+void AddTree(RawSkeleton::Joint::Children* _joints, int _depth, int* _index) {
+  const int count = 1 + (*_index * 7) % 4;
+  _joints->resize(count);
+  for (RawSkeleton::Joint& joint : *_joints) {
+    ++*_index;
+    if (_depth > 0) {
+      AddTree(&joint.children, _depth - 1, _index);
+    }
+  }
+}
+
+// Checks that every joint belongs either to a shared range or to a single
+// partition, and that every joint parent is computed before the joint itself.
+void ExpectValidPartition(const Skeleton& _skeleton,
+                          const SkeletonPartition& _partition) {
+  const int num_joints = _skeleton.num_joints();
+  ASSERT_EQ(_partition.num_joints(), num_joints);
+  const ozz::span<const int16_t>& parents = _skeleton.joint_parents();
+
+  bool shared[Skeleton::kMaxJoints] = {};
+  int coverage[Skeleton::kMaxJoints] = {};
+  int last = -1;
+  for (const SkeletonPartition::JointRange& range :
+       _partition.shared_joints()) {
+    EXPECT_GT(range.from, last);
+    EXPECT_LE(range.from, range.to);
+    last = range.to;
+    for (int i = range.from; i <= range.to; ++i) {
+      EXPECT_TRUE(parents[i] == Skeleton::kNoParent || shared[parents[i]]);
+      shared[i] = true;
+      ++coverage[i];
+    }
+  }
+
+  for (int p = 0; p < _partition.num_partitions(); ++p) {
+    EXPECT_FALSE(_partition.joints(p).empty());
+    bool computed[Skeleton::kMaxJoints] = {};
+    last = -1;
+    for (const SkeletonPartition::JointRange& range : _partition.joints(p)) {
+      EXPECT_GT(range.from, last);
+      EXPECT_LE(range.from, range.to);
+      last = range.to;
+      for (int i = range.from; i <= range.to; ++i) {
+        const int parent = parents[i];
+        EXPECT_TRUE(parent == Skeleton::kNoParent || shared[parent] ||
+                    computed[parent]);
+        computed[i] = true;
+        ++coverage[i];
+      }
+    }
+  }
+
+  for (int i = 0; i < num_joints; ++i) {
+    EXPECT_EQ(coverage[i], 1) << i;
+  }
+}
+
+// Returns the number of joints of partition _p.
+int PartitionLoad(const SkeletonPartition& _partition, int _p) {
+  int load = 0;
+  for (const SkeletonPartition::JointRange& range : _partition.joints(_p)) {
+    load += range.to - range.from + 1;
+  }
+  return load;
+}
+
+// Expects _range to be [_from,_to].
+void ExpectRange(const SkeletonPartition::JointRange& _range, int _from,
+                 int _to) {
+  EXPECT_EQ(_range.from, _from);
+  EXPECT_EQ(_range.to, _to);
+}
+}  // namespace
+
+TEST(Empty, SkeletonPartition) {
+  SkeletonPartition partition;
+  EXPECT_EQ(partition.num_joints(), 0);
+  EXPECT_EQ(partition.num_partitions(), 0);
+  EXPECT_TRUE(partition.shared_joints().empty());
+
+  Skeleton skeleton;
+  partition.Build(skeleton, 4);
+  EXPECT_EQ(partition.num_joints(), 0);
+  EXPECT_EQ(partition.num_partitions(), 0);
+  EXPECT_TRUE(partition.shared_joints().empty());
+}
+
+TEST(Balanced, SkeletonPartition) {
+  // A root with 4 chains of 3 joints.
+  RawSkeleton raw_skeleton;
+  raw_skeleton.roots.resize(1);
+  AddChains(&raw_skeleton.roots[0].children, 4, 2);
+
+  SkeletonBuilder builder;
+  ozz::unique_ptr<Skeleton> skeleton(builder(raw_skeleton));
+  ASSERT_TRUE(skeleton);
+  ASSERT_EQ(skeleton->num_joints(), 13);
+
+  {  // Every chain in its own partition.
+    const SkeletonPartition partition(*skeleton, 4);
+    ExpectValidPartition(*skeleton, partition);
+    ASSERT_EQ(partition.shared_joints().size(), 1u);
+    ExpectRange(partition.shared_joints()[0], 0, 0);
+    ASSERT_EQ(partition.num_partitions(), 4);
+    for (int p = 0; p < 4; ++p) {
+      ASSERT_EQ(partition.joints(p).size(), 1u);
+      ExpectRange(partition.joints(p)[0], 1 + p * 3, 3 + p * 3);
+    }
+  }
+
+  {  // 2 contiguous chains per partition.
+    const SkeletonPartition partition(*skeleton, 2);
+    ExpectValidPartition(*skeleton, partition);
+    EXPECT_EQ(partition.shared_joints().size(), 1u);
+    ASSERT_EQ(partition.num_partitions(), 2);
+    ASSERT_EQ(partition.joints(0).size(), 1u);
+    ExpectRange(partition.joints(0)[0], 1, 6);
+    ASSERT_EQ(partition.joints(1).size(), 1u);
+    ExpectRange(partition.joints(1)[0], 7, 12);
+  }
+
+  {  // Chains heads are shared if partitions are smaller than chains.
+    const SkeletonPartition partition(*skeleton, 8);
+    ExpectValidPartition(*skeleton, partition);
+    ASSERT_EQ(partition.shared_joints().size(), 4u);
+    ExpectRange(partition.shared_joints()[0], 0, 1);
+    ExpectRange(partition.shared_joints()[1], 4, 4);
+    ExpectRange(partition.shared_joints()[2], 7, 7);
+    ExpectRange(partition.shared_joints()[3], 10, 10);
+    EXPECT_EQ(partition.num_partitions(), 4);
+  }
+
+  {  // A single partition has no shared joint.
+    for (int max_partitions = -1; max_partitions <= 1; ++max_partitions) {
+      SkeletonPartition partition;
+      partition.Build(*skeleton, max_partitions);
+      ExpectValidPartition(*skeleton, partition);
+      EXPECT_TRUE(partition.shared_joints().empty());
+      ASSERT_EQ(partition.num_partitions(), 1);
+      ASSERT_EQ(partition.joints(0).size(), 1u);
+      ExpectRange(partition.joints(0)[0], 0, 12);
+    }
+  }
+}
+
+TEST(Chain, SkeletonPartition) {
+  RawSkeleton raw_skeleton;
+  AddChains(&raw_skeleton.roots, 1, 7);
+
+  SkeletonBuilder builder;
+  ozz::unique_ptr<Skeleton> skeleton(builder(raw_skeleton));
+  ASSERT_TRUE(skeleton);
+  ASSERT_EQ(skeleton->num_joints(), 8);
+
+  // A chain can't be split, all joints but the last subtree are shared.
+  const SkeletonPartition partition(*skeleton, 4);
+  ExpectValidPartition(*skeleton, partition);
+  ASSERT_EQ(partition.shared_joints().size(), 1u);
+  ExpectRange(partition.shared_joints()[0], 0, 5);
+  ASSERT_EQ(partition.num_partitions(), 1);
+  ASSERT_EQ(partition.joints(0).size(), 1u);
+  ExpectRange(partition.joints(0)[0], 6, 7);
+}
+
+TEST(MultipleRoots, SkeletonPartition) {
+  // Two roots with 2 chains of 2 joints each.
+  RawSkeleton raw_skeleton;
+  raw_skeleton.roots.resize(2);
+  AddChains(&raw_skeleton.roots[0].children, 2, 1);
+  AddChains(&raw_skeleton.roots[1].children, 2, 1);
+
+  SkeletonBuilder builder;
+  ozz::unique_ptr<Skeleton> skeleton(builder(raw_skeleton));
+  ASSERT_TRUE(skeleton);
+  ASSERT_EQ(skeleton->num_joints(), 10);
+
+  {
+    const SkeletonPartition partition(*skeleton, 2);
+    ExpectValidPartition(*skeleton, partition);
+    EXPECT_TRUE(partition.shared_joints().empty());
+    ASSERT_EQ(partition.num_partitions(), 2);
+    ExpectRange(partition.joints(0)[0], 0, 4);
+    ExpectRange(partition.joints(1)[0], 5, 9);
+  }
+
+  {
+    const SkeletonPartition partition(*skeleton, 4);
+    ExpectValidPartition(*skeleton, partition);
+    ASSERT_EQ(partition.shared_joints().size(), 2u);
+    ExpectRange(partition.shared_joints()[0], 0, 0);
+    ExpectRange(partition.shared_joints()[1], 5, 5);
+    EXPECT_EQ(partition.num_partitions(), 4);
+  }
+}
+
+TEST(Tree, SkeletonPartition) {
+  RawSkeleton raw_skeleton;
+  int index = 0;
+  AddTree(&raw_skeleton.roots, 5, &index);
+
+  for (int order = 0; order < 2; ++order) {
+    SkeletonBuilder builder;
+    builder.level_order = order == 1;
+    ozz::unique_ptr<Skeleton> skeleton(builder(raw_skeleton));
+    ASSERT_TRUE(skeleton);
+    const int num_joints = skeleton->num_joints();
+    ASSERT_GT(num_joints, 200);
+
+    for (int max_partitions = 1; max_partitions <= 16; max_partitions *= 2) {
+      const SkeletonPartition partition(*skeleton, max_partitions);
+      ExpectValidPartition(*skeleton, partition);
+      EXPECT_LE(partition.num_partitions(), max_partitions);
+
+      // No partition is more than twice a perfectly balanced partition.
+      const int balanced = (num_joints + max_partitions - 1) / max_partitions;
+      for (int p = 0; p < partition.num_partitions(); ++p) {
+        EXPECT_LE(PartitionLoad(partition, p), balanced * 2);
+      }
+    }
+  }
+}
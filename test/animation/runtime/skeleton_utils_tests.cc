@@ -30,6 +30,7 @@
 
 #include <algorithm>
 #include <cstring>
+#include <vector>
 
 #include "gtest/gtest.h"
 #include "ozz/base/gtest_helper.h"
@@ -415,3 +416,116 @@ TEST(IsLeaf, SkeletonUtils) {
   EXPECT_FALSE(IsLeaf(*skeleton, 8));
   EXPECT_TRUE(IsLeaf(*skeleton, 9));
 }
+
+namespace {
+// Stores iterated joints, and checks parents are iterated before children.
+class LevelOrderVisitor {
+ public:
+  explicit LevelOrderVisitor(const ozz::animation::Skeleton* _skeleton)
+      : skeleton_(_skeleton), visited_(0) {}
+
+  void operator()(int _current, int _parent) {
+    EXPECT_EQ(skeleton_->joint_parents()[_current], _parent);
+    EXPECT_TRUE(joints_.empty() || _parent == Skeleton::kNoParent ||
+                (visited_ & (1 << _parent)) != 0);
+    visited_ |= 1 << _current;
+    joints_.push_back(_current);
+  }
+
+  const std::vector<int>& joints() const { return joints_; }
+
+  // Tests iterated joints against _expected ones.
+  template <size_t _Size>
+  bool Matches(const int (&_expected)[_Size]) const {
+    return joints_.size() == _Size &&
+           std::equal(_expected, _expected + _Size, joints_.begin());
+  }
+
+ private:
+  const ozz::animation::Skeleton* skeleton_;
+  int visited_;
+  std::vector<int> joints_;
+};
+}  // namespace
+
+TEST(LevelOrder, SkeletonUtils) {
+  SkeletonBuilder builder;
+  builder.level_order = true;
+
+  /*
+   10 joints, level ordered
+
+       *
+     /   \
+    j0    j1
+   /  \    |
+  j2  j3  j4
+   |  / \
+  j5 j6 j7
+   |
+  j8
+   |
+  j9
+  */
+  RawSkeleton raw_skeleton;
+  raw_skeleton.roots.resize(2);
+  RawSkeleton::Joint& j0 = raw_skeleton.roots[0];
+  j0.name = "j0";
+  RawSkeleton::Joint& j1 = raw_skeleton.roots[1];
+  j1.name = "j1";
+  j0.children.resize(2);
+  j0.children[0].name = "j2";
+  j0.children[1].name = "j3";
+  j0.children[0].children.resize(1);
+  j0.children[0].children[0].name = "j5";
+  j0.children[0].children[0].children.resize(1);
+  j0.children[0].children[0].children[0].name = "j8";
+  j0.children[0].children[0].children[0].children.resize(1);
+  j0.children[0].children[0].children[0].children[0].name = "j9";
+  j0.children[1].children.resize(2);
+  j0.children[1].children[0].name = "j6";
+  j0.children[1].children[1].name = "j7";
+  j1.children.resize(1);
+  j1.children[0].name = "j4";
+
+  ozz::unique_ptr<Skeleton> skeleton(builder(raw_skeleton));
+  ASSERT_TRUE(skeleton);
+  ASSERT_EQ(skeleton->num_joints(), 10);
+  ASSERT_EQ(skeleton->joint_levels().size(), 6u);
+  for (int i = 0; i < 10; ++i) {
+    char name[3] = {'j', static_cast<char>('0' + i), 0};
+    ASSERT_STREQ(skeleton->joint_names()[i], name);
+  }
+
+  // Leaves aren't followed by their children.
+  const bool leaves[] = {false, false, false, false, true,
+                         false, true,  true,  false, true};
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_EQ(IsLeaf(*skeleton, i), leaves[i]) << i;
+  }
+
+  // Iterating a hierarchy visits all its joints, parents first.
+  {
+    const LevelOrderVisitor visitor =
+        IterateJointsDF(*skeleton, LevelOrderVisitor(skeleton.get()), 0);
+    const int expected[] = {0, 2, 3, 5, 6, 7, 8, 9};
+    EXPECT_TRUE(visitor.Matches(expected));
+  }
+  {
+    const LevelOrderVisitor visitor =
+        IterateJointsDF(*skeleton, LevelOrderVisitor(skeleton.get()), 2);
+    const int expected[] = {2, 5, 8, 9};
+    EXPECT_TRUE(visitor.Matches(expected));
+  }
+  {
+    const LevelOrderVisitor visitor =
+        IterateJointsDF(*skeleton, LevelOrderVisitor(skeleton.get()), 1);
+    const int expected[] = {1, 4};
+    EXPECT_TRUE(visitor.Matches(expected));
+  }
+  {
+    const LevelOrderVisitor visitor =
+        IterateJointsDF(*skeleton, LevelOrderVisitor(skeleton.get()));
+    EXPECT_EQ(visitor.joints().size(), 10u);
+  }
+}
@@ -27,11 +27,14 @@
 
 #include "ozz/animation/runtime/track.h"
 
+#include <cstring>
+
 #include "gtest/gtest.h"
 #include "ozz/base/maths/gtest_math_helper.h"
 
 #include "ozz/base/io/archive.h"
 #include "ozz/base/io/stream.h"
+#include "ozz/base/memory/allocator.h"
 #include "ozz/base/memory/unique_ptr.h"
 
 #include "ozz/animation/runtime/track_sampling_job.h"
@@ -452,3 +455,241 @@ TEST(AlreadyInitialized, TrackSerialize) {
     ASSERT_TRUE(i_track.size() > size);
   }
 }
+
+TEST(View, TrackSerialize) {
+  ozz::unique_ptr<Float3Track> o_track;
+  {
+    TrackBuilder builder;
+    RawFloat3Track raw_track;
+    raw_track.name = "view";
+    const RawFloat3Track::Keyframe key0 = {RawTrackInterpolation::kLinear, 0.f,
+                                           ozz::math::Float3(0.f, 1.f, 2.f)};
+    raw_track.keyframes.push_back(key0);
+    const RawFloat3Track::Keyframe key1 = {RawTrackInterpolation::kStep, .5f,
+                                           ozz::math::Float3(46.f, 0.f, 1.f)};
+    raw_track.keyframes.push_back(key1);
+    o_track = builder(raw_track);
+    ASSERT_TRUE(o_track);
+  }
+
+  ozz::memory::Allocator* allocator = ozz::memory::default_allocator();
+  const size_t view_size = o_track->view_size();
+  char* memory = static_cast<char*>(allocator->Allocate(view_size, 16));
+
+  EXPECT_FALSE(o_track->SaveView({memory, view_size - 1}));
+  ASSERT_TRUE(o_track->SaveView({memory, view_size}));
+
+  {
+    Float3Track i_track;
+    ASSERT_TRUE(i_track.LoadView({memory, view_size}));
+    EXPECT_EQ(o_track->size(), i_track.size());
+    EXPECT_STREQ(i_track.name(), "view");
+
+    // Data aren't copied.
+    const char* ratios = reinterpret_cast<const char*>(i_track.ratios().data());
+    EXPECT_TRUE(ratios > memory && ratios < memory + view_size);
+
+    Float3TrackSamplingJob sampling;
+    sampling.track = &i_track;
+    ozz::math::Float3 result;
+    sampling.result = &result;
+
+    sampling.ratio = .25f;
+    ASSERT_TRUE(sampling.Run());
+    EXPECT_FLOAT3_EQ(result, 23.f, .5f, 1.5f);
+
+    sampling.ratio = .75f;
+    ASSERT_TRUE(sampling.Run());
+    EXPECT_FLOAT3_EQ(result, 46.f, 0.f, 1.f);
+  }
+
+  {  // Wrong track type.
+    FloatTrack i_track;
+    EXPECT_FALSE(i_track.LoadView({memory, view_size}));
+  }
+
+  {  // Truncated view.
+    Float3Track i_track;
+    EXPECT_FALSE(i_track.LoadView({memory, view_size - 1}));
+    EXPECT_EQ(i_track.ratios().size(), 0u);
+  }
+
+  allocator->Deallocate(memory);
+}
+
+TEST(EdgeIndex, TrackSerialize) {
+  ozz::unique_ptr<FloatTrack> o_track;
+  {
+    TrackBuilder builder;
+    builder.edge_index = true;
+    builder.edge_threshold = 1.f;
+    RawFloatTrack raw_track;
+    const RawFloatTrack::Keyframe key0 = {RawTrackInterpolation::kLinear, 0.f,
+                                          0.f};
+    raw_track.keyframes.push_back(key0);
+    const RawFloatTrack::Keyframe key1 = {RawTrackInterpolation::kStep, .5f,
+                                          2.f};
+    raw_track.keyframes.push_back(key1);
+    const RawFloatTrack::Keyframe key2 = {RawTrackInterpolation::kLinear, .7f,
+                                          0.f};
+    raw_track.keyframes.push_back(key2);
+    o_track = builder(raw_track);
+    ASSERT_TRUE(o_track);
+    ASSERT_TRUE(o_track->has_edge_index());
+    ASSERT_EQ(o_track->edge_ratios().size(), 2u);
+  }
+
+  // Compares edge indices.
+  auto expect_same_index = [&o_track](const FloatTrack& _track) {
+    EXPECT_EQ(_track.has_edge_index(), o_track->has_edge_index());
+    EXPECT_EQ(_track.edge_threshold(), o_track->edge_threshold());
+    ASSERT_EQ(_track.edge_ratios().size(), o_track->edge_ratios().size());
+    for (size_t i = 0; i < _track.edge_ratios().size(); ++i) {
+      EXPECT_EQ(_track.edge_ratios()[i], o_track->edge_ratios()[i]);
+    }
+    ASSERT_EQ(_track.edge_rising().size(), o_track->edge_rising().size());
+    for (size_t i = 0; i < _track.edge_rising().size(); ++i) {
+      EXPECT_EQ(_track.edge_rising()[i], o_track->edge_rising()[i]);
+    }
+  };
+
+  for (int e = 0; e < 2; ++e) {
+    ozz::Endianness endianess = e == 0 ? ozz::kBigEndian : ozz::kLittleEndian;
+    ozz::io::MemoryStream stream;
+
+    // Streams out.
+    ozz::io::OArchive o(&stream, endianess);
+    o << *o_track;
+
+    // Streams in.
+    stream.Seek(0, ozz::io::Stream::kSet);
+    ozz::io::IArchive i(&stream);
+
+    FloatTrack i_track;
+    i >> i_track;
+    EXPECT_EQ(o_track->size(), i_track.size());
+    expect_same_index(i_track);
+  }
+
+  {  // Views.
+    ozz::memory::Allocator* allocator = ozz::memory::default_allocator();
+    const size_t view_size = o_track->view_size();
+    char* memory = static_cast<char*>(allocator->Allocate(view_size, 16));
+    ASSERT_TRUE(o_track->SaveView({memory, view_size}));
+
+    FloatTrack i_track;
+    ASSERT_TRUE(i_track.LoadView({memory, view_size}));
+    EXPECT_EQ(o_track->size(), i_track.size());
+    expect_same_index(i_track);
+
+    allocator->Deallocate(memory);
+  }
+}
+
+namespace {
+// Compares quantized buffers and sampling results.
+template <typename _Track, typename _Job>
+void ExpectSameQuantizedTrack(const _Track& _track, const _Track& _expected) {
+  ASSERT_EQ(_track.ratios().size(), _expected.ratios().size());
+  ASSERT_EQ(_track.quantized_ratios().size(),
+            _expected.quantized_ratios().size());
+  for (size_t i = 0; i < _track.quantized_ratios().size(); ++i) {
+    EXPECT_EQ(_track.quantized_ratios()[i], _expected.quantized_ratios()[i]);
+  }
+  ASSERT_EQ(_track.quantized_values().size(),
+            _expected.quantized_values().size());
+  for (size_t i = 0; i < _track.quantized_values().size(); ++i) {
+    EXPECT_EQ(_track.quantized_values()[i], _expected.quantized_values()[i]);
+  }
+  for (float ratio = 0.f; ratio <= 1.f; ratio += .05f) {
+    typename _Job::ValueType result, expected;
+    _Job job;
+    job.ratio = ratio;
+    job.track = &_track;
+    job.result = &result;
+    ASSERT_TRUE(job.Run());
+    job.track = &_expected;
+    job.result = &expected;
+    ASSERT_TRUE(job.Run());
+    EXPECT_TRUE(std::memcmp(&result, &expected, sizeof(result)) == 0);
+  }
+}
+}  // namespace
+
+TEST(Quantization, TrackSerialize) {
+  ozz::unique_ptr<Float3Track> o_track;
+  ozz::unique_ptr<QuaternionTrack> o_quat_track;
+  {
+    TrackBuilder builder;
+    builder.quantize_ratios = true;
+    builder.quantize_values = true;
+    RawFloat3Track raw_track;
+    const RawFloat3Track::Keyframe key0 = {
+        RawTrackInterpolation::kLinear, .3f, ozz::math::Float3(1.f, 2.f, 4.f)};
+    raw_track.keyframes.push_back(key0);
+    const RawFloat3Track::Keyframe key1 = {RawTrackInterpolation::kStep, .7f,
+                                           ozz::math::Float3(-1.f, 0.f, 9.f)};
+    raw_track.keyframes.push_back(key1);
+    o_track = builder(raw_track);
+    ASSERT_TRUE(o_track);
+    ASSERT_EQ(o_track->quantized_ratios().size(), 4u);
+    ASSERT_EQ(o_track->quantized_values().size(), 4u * 3u);
+
+    // Only values are quantized.
+    builder.quantize_ratios = false;
+    RawQuaternionTrack raw_quat_track;
+    const RawQuaternionTrack::Keyframe qkey0 = {
+        RawTrackInterpolation::kLinear, .2f,
+        ozz::math::Quaternion(0.f, .70710677f, 0.f, .70710677f)};
+    raw_quat_track.keyframes.push_back(qkey0);
+    const RawQuaternionTrack::Keyframe qkey1 = {
+        RawTrackInterpolation::kLinear, .6f,
+        ozz::math::Quaternion(-.70710677f, 0.f, 0.f, .70710677f)};
+    raw_quat_track.keyframes.push_back(qkey1);
+    o_quat_track = builder(raw_quat_track);
+    ASSERT_TRUE(o_quat_track);
+    ASSERT_EQ(o_quat_track->ratios().size(), 4u);
+    ASSERT_EQ(o_quat_track->quantized_values().size(), 4u * 3u);
+  }
+
+  for (int e = 0; e < 2; ++e) {
+    ozz::Endianness endianess = e == 0 ? ozz::kBigEndian : ozz::kLittleEndian;
+    ozz::io::MemoryStream stream;
+
+    // Streams out.
+    ozz::io::OArchive o(&stream, endianess);
+    o << *o_track;
+    o << *o_quat_track;
+
+    // Streams in.
+    stream.Seek(0, ozz::io::Stream::kSet);
+    ozz::io::IArchive i(&stream);
+
+    Float3Track i_track;
+    i >> i_track;
+    EXPECT_EQ(o_track->size(), i_track.size());
+    ExpectSameQuantizedTrack<Float3Track, Float3TrackSamplingJob>(i_track,
+                                                                  *o_track);
+
+    QuaternionTrack i_quat_track;
+    i >> i_quat_track;
+    EXPECT_EQ(o_quat_track->size(), i_quat_track.size());
+    ExpectSameQuantizedTrack<QuaternionTrack, QuaternionTrackSamplingJob>(
+        i_quat_track, *o_quat_track);
+  }
+
+  {  // Views.
+    ozz::memory::Allocator* allocator = ozz::memory::default_allocator();
+    const size_t view_size = o_track->view_size();
+    char* memory = static_cast<char*>(allocator->Allocate(view_size, 16));
+    ASSERT_TRUE(o_track->SaveView({memory, view_size}));
+
+    Float3Track i_track;
+    ASSERT_TRUE(i_track.LoadView({memory, view_size}));
+    EXPECT_EQ(o_track->size(), i_track.size());
+    ExpectSameQuantizedTrack<Float3Track, Float3TrackSamplingJob>(i_track,
+                                                                  *o_track);
+
+    allocator->Deallocate(memory);
+  }
+}
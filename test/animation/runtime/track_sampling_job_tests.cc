@@ -27,6 +27,9 @@
 
 #include "ozz/animation/runtime/track_sampling_job.h"
 
+#include <cmath>
+#include <cstring>
+
 #include "gtest/gtest.h"
 
 #include "ozz/base/maths/gtest_math_helper.h"
@@ -43,6 +46,7 @@ using ozz::animation::Float3Track;
 using ozz::animation::Float4Track;
 using ozz::animation::QuaternionTrack;
 using ozz::animation::FloatTrackSamplingJob;
+using ozz::animation::TrackSamplingCache;
 using ozz::animation::offline::RawFloatTrack;
 using ozz::animation::offline::TrackBuilder;
 using ozz::animation::offline::RawTrackInterpolation;
@@ -212,6 +216,77 @@ TEST(Float, TrackSamplingJob) {
   EXPECT_FLOAT_EQ(result, 0.f);
 }
 
+TEST(Cache, TrackSamplingJob) {
+  TrackBuilder builder;
+
+  // A track with many keys, and a smaller one.
+  RawFloatTrack raw_track;
+  for (int i = 0; i < 50; ++i) {
+    const RawFloatTrack::Keyframe key = {
+        i % 3 == 0 ? RawTrackInterpolation::kStep
+                   : RawTrackInterpolation::kLinear,
+        i / 49.f, static_cast<float>(i * i % 17)};
+    raw_track.keyframes.push_back(key);
+  }
+  ozz::unique_ptr<FloatTrack> track(builder(raw_track));
+  ASSERT_TRUE(track);
+
+  raw_track.keyframes.resize(3);
+  ozz::unique_ptr<FloatTrack> small_track(builder(raw_track));
+  ASSERT_TRUE(small_track);
+
+  const FloatTrack default_track;
+
+  // Sequence of ratios and tracks: forward with small and big steps, on keys,
+  // backward, out of bounds, and switching tracks.
+  struct {
+    const FloatTrack* track;
+    float ratio;
+  } samples[] = {{track.get(), 0.f},          {track.get(), .001f},
+                 {track.get(), .002f},        {track.get(), 1.f / 49.f},
+                 {track.get(), .05f},         {track.get(), .06f},
+                 {track.get(), .5f},          {track.get(), 10.f / 49.f},
+                 {track.get(), .9f},          {track.get(), .95f},
+                 {track.get(), 1.f},          {track.get(), 1.5f},
+                 {track.get(), .99f},         {track.get(), .1f},
+                 {track.get(), -1.f},         {track.get(), .3f},
+                 {small_track.get(), .7f},    {small_track.get(), .01f},
+                 {small_track.get(), 1.f},    {&default_track, .5f},
+                 {track.get(), .62f},         {track.get(), .63f},
+                 {small_track.get(), 2.f / 49.f}};
+
+  TrackSamplingCache cache;
+  for (size_t i = 0; i < OZZ_ARRAY_SIZE(samples); ++i) {
+    float expected;
+    FloatTrackSamplingJob job;
+    job.track = samples[i].track;
+    job.ratio = samples[i].ratio;
+    job.result = &expected;
+    ASSERT_TRUE(job.Run());
+
+    float result;
+    job.result = &result;
+    job.cache = &cache;
+    ASSERT_TRUE(job.Run());
+    EXPECT_EQ(result, expected) << "sample " << i;
+  }
+
+  // Invalidation.
+  cache.Invalidate();
+  float result;
+  FloatTrackSamplingJob job;
+  job.track = track.get();
+  job.ratio = .5f;
+  job.result = &result;
+  job.cache = &cache;
+  ASSERT_TRUE(job.Run());
+  float expected;
+  job.result = &expected;
+  job.cache = nullptr;
+  ASSERT_TRUE(job.Run());
+  EXPECT_EQ(result, expected);
+}
+
 TEST(Float2, TrackSamplingJob) {
   TrackBuilder builder;
   ozz::math::Float2 result;
@@ -465,3 +540,133 @@ TEST(Quaternion, TrackSamplingJob) {
   ASSERT_TRUE(sampling.Run());
   EXPECT_QUATERNION_EQ(result, 0.f, 0.f, 0.f, 1.f);
 }
+
+namespace {
+// Deterministic key values for quantization tests.
+template <typename _ValueType>
+_ValueType QuantizationTestValue(int _i);
+
+template <>
+ozz::math::Float2 QuantizationTestValue(int _i) {
+  return ozz::math::Float2(std::sin(_i * 1.3f) * 10.f, _i * .25f);
+}
+
+template <>
+ozz::math::Float3 QuantizationTestValue(int _i) {
+  return ozz::math::Float3(std::sin(_i * 1.3f) * 10.f, _i * -.25f,
+                           std::cos(_i * .7f));
+}
+
+template <>
+ozz::math::Float4 QuantizationTestValue(int _i) {
+  return ozz::math::Float4(std::sin(_i * 1.3f) * 10.f, _i * -.25f,
+                           std::cos(_i * .7f), 1e-3f * _i);
+}
+
+template <>
+ozz::math::Quaternion QuantizationTestValue(int _i) {
+  return ozz::math::Quaternion::FromEuler(std::sin(_i * 1.3f) * 3.f, _i * .4f,
+                                          std::cos(_i * .7f));
+}
+
+void ExpectQuantizedNear(const ozz::math::Float2& _q,
+                         const ozz::math::Float2& _f) {
+  EXPECT_NEAR(_q.x, _f.x, 1e-2f);
+  EXPECT_NEAR(_q.y, _f.y, 1e-2f);
+}
+
+void ExpectQuantizedNear(const ozz::math::Float3& _q,
+                         const ozz::math::Float3& _f) {
+  EXPECT_NEAR(_q.x, _f.x, 1e-2f);
+  EXPECT_NEAR(_q.y, _f.y, 1e-2f);
+  EXPECT_NEAR(_q.z, _f.z, 1e-2f);
+}
+
+void ExpectQuantizedNear(const ozz::math::Float4& _q,
+                         const ozz::math::Float4& _f) {
+  EXPECT_NEAR(_q.x, _f.x, 1e-2f);
+  EXPECT_NEAR(_q.y, _f.y, 1e-2f);
+  EXPECT_NEAR(_q.z, _f.z, 1e-2f);
+  EXPECT_NEAR(_q.w, _f.w, 1e-2f);
+}
+
+void ExpectQuantizedNear(const ozz::math::Quaternion& _q,
+                         const ozz::math::Quaternion& _f) {
+  EXPECT_NEAR(_q.x, _f.x, 1e-3f);
+  EXPECT_NEAR(_q.y, _f.y, 1e-3f);
+  EXPECT_NEAR(_q.z, _f.z, 1e-3f);
+  EXPECT_NEAR(_q.w, _f.w, 1e-3f);
+}
+
+// Samples a track built with and without quantization, forward and backward,
+// with and without cache, and compares results.
+template <typename _RawTrack, typename _Track, typename _Job>
+void TestQuantizedSampling() {
+  typedef typename _RawTrack::ValueType ValueType;
+  _RawTrack raw_track;
+  for (int i = 0; i <= 16; ++i) {
+    const typename _RawTrack::Keyframe key = {
+        i % 3 == 0 ? RawTrackInterpolation::kStep
+                   : RawTrackInterpolation::kLinear,
+        i / 16.f, QuantizationTestValue<ValueType>(i)};
+    raw_track.keyframes.push_back(key);
+  }
+
+  TrackBuilder builder;
+  const ozz::unique_ptr<_Track> track(builder(raw_track));
+  ASSERT_TRUE(track);
+
+  builder.quantize_ratios = true;
+  builder.quantize_values = true;
+  const ozz::unique_ptr<_Track> quantized(builder(raw_track));
+  ASSERT_TRUE(quantized);
+  ASSERT_TRUE(quantized->ratios().empty());
+  ASSERT_TRUE(quantized->values().empty());
+
+  TrackSamplingCache cache;
+  const int kSamples = 997;
+  for (int j = 0; j <= kSamples * 2 + 16; ++j) {
+    // Forward, backward, then exactly on keys.
+    const float ratio =
+        j <= kSamples
+            ? static_cast<float>(j) / kSamples
+            : j <= kSamples * 2 ? static_cast<float>(kSamples * 2 - j) /
+                                      kSamples
+                                : (j - kSamples * 2) / 16.f;
+    ValueType expected;
+    _Job job;
+    job.track = track.get();
+    job.ratio = ratio;
+    job.result = &expected;
+    ASSERT_TRUE(job.Run());
+
+    ValueType result;
+    job.track = quantized.get();
+    job.result = &result;
+    ASSERT_TRUE(job.Run());
+    ExpectQuantizedNear(result, expected);
+
+    ValueType cached;
+    job.result = &cached;
+    job.cache = &cache;
+    ASSERT_TRUE(job.Run());
+    EXPECT_TRUE(std::memcmp(&cached, &result, sizeof(ValueType)) == 0)
+        << "ratio " << ratio;
+  }
+}
+}  // namespace
+
+TEST(Quantization, TrackSamplingJob) {
+  TestQuantizedSampling<ozz::animation::offline::RawFloat2Track,
+                        ozz::animation::Float2Track,
+                        ozz::animation::Float2TrackSamplingJob>();
+  TestQuantizedSampling<ozz::animation::offline::RawFloat3Track,
+                        ozz::animation::Float3Track,
+                        ozz::animation::Float3TrackSamplingJob>();
+  TestQuantizedSampling<ozz::animation::offline::RawFloat4Track,
+                        ozz::animation::Float4Track,
+                        ozz::animation::Float4TrackSamplingJob>();
+  TestQuantizedSampling<ozz::animation::offline::RawQuaternionTrack,
+                        ozz::animation::QuaternionTrack,
+                        ozz::animation::QuaternionTrackSamplingJob>();
+}
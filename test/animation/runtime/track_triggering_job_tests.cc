@@ -1401,3 +1401,92 @@ TEST(LinearThreshold, TrackEdgeTriggerJob) {
     ASSERT_EQ(CountEdges(iterator, job.end()), 0u);
   }
 }
+
+// Collects all edges triggered by _job.
+static ozz::vector<TrackTriggeringJob::Edge> CollectEdges(
+    const TrackTriggeringJob& _job) {
+  ozz::vector<TrackTriggeringJob::Edge> edges;
+  TrackTriggeringJob job = _job;
+  TrackTriggeringJob::Iterator iterator;
+  job.iterator = &iterator;
+  EXPECT_TRUE(job.Run());
+  for (; iterator != job.end(); ++iterator) {
+    edges.push_back(*iterator);
+  }
+  return edges;
+}
+
+TEST(EdgeIndex, TrackEdgeTriggerJob) {
+  // Tracks with linear, step and mixed keys, and values that are exactly the
+  // threshold.
+  RawFloatTrack raw_tracks[5];
+  const float values[] = {0.f, 2.f, 1.f, 1.f, -1.f, 3.f, 0.f, 1.f, 2.f, 0.f};
+  for (int t = 0; t < 4; ++t) {
+    const int num_keys = t == 0 ? 2 : 10;
+    for (int i = 0; i < num_keys; ++i) {
+      const RawFloatTrack::Keyframe key = {
+          (t == 1 || (t == 2 && i % 3 == 0)) ? RawTrackInterpolation::kStep
+                                             : RawTrackInterpolation::kLinear,
+          t == 3 ? i * i / 81.f : i / (num_keys - 1.f), values[i]};
+      raw_tracks[t].keyframes.push_back(key);
+    }
+  }
+  // Last raw track is left empty, which builds a constant track.
+
+  const float ranges[][2] = {
+      {0.f, 1.f},       {0.f, .5f},         {.1f, .9f},     {.25f, .25f},
+      {-.3f, .4f},      {.5f, 3.25f},       {-2.f, 2.f},    {1.f, 0.f},
+      {.9f, .1f},       {3.25f, .5f},       {2.f, -2.f},    {.4f, -.3f},
+      {1.f, 2.f},       {2.f, 1.f},         {1.f / 9.f, 1.f},
+      {0.f, 1.f / 9.f}, {4.f / 81.f, 3.5f}, {-5.1f, -4.2f}, {-4.2f, -5.1f}};
+  const float thresholds[] = {1.f, 0.f, .5f, -1.f, 3.f};
+
+  for (RawFloatTrack& raw_track : raw_tracks) {
+    for (float threshold : thresholds) {
+      TrackBuilder builder;
+      ozz::unique_ptr<FloatTrack> track(builder(raw_track));
+      ASSERT_TRUE(track);
+      EXPECT_FALSE(track->has_edge_index());
+
+      builder.edge_index = true;
+      builder.edge_threshold = threshold;
+      ozz::unique_ptr<FloatTrack> indexed_track(builder(raw_track));
+      ASSERT_TRUE(indexed_track);
+      EXPECT_TRUE(indexed_track->has_edge_index());
+      EXPECT_EQ(indexed_track->edge_threshold(), threshold);
+
+      for (const float* range : ranges) {
+        TrackTriggeringJob job;
+        job.threshold = threshold;
+        job.from = range[0];
+        job.to = range[1];
+        job.track = track.get();
+        const ozz::vector<TrackTriggeringJob::Edge> expected =
+            CollectEdges(job);
+
+        job.track = indexed_track.get();
+        const ozz::vector<TrackTriggeringJob::Edge> edges = CollectEdges(job);
+
+        ASSERT_EQ(edges.size(), expected.size())
+            << "range [" << range[0] << "," << range[1] << "]";
+        for (size_t i = 0; i < edges.size(); ++i) {
+          EXPECT_EQ(edges[i].ratio, expected[i].ratio);
+          EXPECT_EQ(edges[i].rising, expected[i].rising);
+        }
+
+        // Another threshold doesn't use the index.
+        job.threshold = threshold + .25f;
+        const ozz::vector<TrackTriggeringJob::Edge> other_edges =
+            CollectEdges(job);
+        job.track = track.get();
+        const ozz::vector<TrackTriggeringJob::Edge> other_expected =
+            CollectEdges(job);
+        ASSERT_EQ(other_edges.size(), other_expected.size());
+        for (size_t i = 0; i < other_edges.size(); ++i) {
+          EXPECT_EQ(other_edges[i].ratio, other_expected[i].ratio);
+          EXPECT_EQ(other_edges[i].rising, other_expected[i].rising);
+        }
+      }
+    }
+  }
+}
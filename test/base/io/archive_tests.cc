@@ -194,6 +194,43 @@ TEST(PrimitiveArrays, Archive) {
   }
 }
 
+TEST(LargePrimitiveArrays, Archive) {
+  // Arrays are large enough to span multiple endian swapping chunks.
+  const size_t kCount = 1029;
+  for (int e = 0; e < 2; ++e) {
+    ozz::Endianness endianess = e == 0 ? ozz::kBigEndian : ozz::kLittleEndian;
+
+    ozz::io::MemoryStream stream;
+    ASSERT_TRUE(stream.opened());
+
+    uint16_t ui16o[kCount];
+    uint32_t ui32o[kCount];
+    uint64_t ui64o[kCount];
+    for (size_t j = 0; j < kCount; ++j) {
+      ui16o[j] = static_cast<uint16_t>(j * 0x0301);
+      ui32o[j] = static_cast<uint32_t>(j * 0x07050301);
+      ui64o[j] = static_cast<uint64_t>(j) * 0x0f0d0b0907050301ull;
+    }
+
+    ozz::io::OArchive o(&stream, endianess);
+    o << ozz::io::MakeArray(ui16o);
+    o << ozz::io::MakeArray(ui32o);
+    o << ozz::io::MakeArray(ui64o);
+
+    stream.Seek(0, ozz::io::Stream::kSet);
+    ozz::io::IArchive i(&stream);
+    uint16_t ui16i[kCount];
+    i >> ozz::io::MakeArray(ui16i);
+    EXPECT_EQ(std::memcmp(ui16i, ui16o, sizeof(ui16o)), 0);
+    uint32_t ui32i[kCount];
+    i >> ozz::io::MakeArray(ui32i);
+    EXPECT_EQ(std::memcmp(ui32i, ui32o, sizeof(ui32o)), 0);
+    uint64_t ui64i[kCount];
+    i >> ozz::io::MakeArray(ui64i);
+    EXPECT_EQ(std::memcmp(ui64i, ui64o, sizeof(ui64o)), 0);
+  }
+}
+
 TEST(Class, Archive) {
   for (int e = 0; e < 2; ++e) {
     ozz::Endianness endianess = e == 0 ? ozz::kBigEndian : ozz::kLittleEndian;
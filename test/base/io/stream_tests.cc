@@ -28,8 +28,16 @@
 #include "ozz/base/io/stream.h"
 
 #include <stdint.h>
+#include <cstdio>
 #include <limits>
 
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#else  // _WIN32
+#include <unistd.h>
+#endif  // _WIN32
+
 #include "gtest/gtest.h"
 
 #include "ozz/base/platform.h"
@@ -185,3 +193,195 @@ TEST(MemoryStream, Stream) {
     TestTooBigStream(&stream);
   }
 }
+
+TEST(BufferedFile, Stream) {
+  {
+    ozz::io::BufferedFile file(nullptr);
+    EXPECT_FALSE(file.opened());
+  }
+  {
+    ozz::io::BufferedFile file("unexisting.file", "rb");
+    EXPECT_FALSE(file.opened());
+  }
+
+  // Tests all buffer sizes, including smaller than tested primitives and
+  // unbuffered.
+  const size_t buffer_sizes[] = {0, 1, 3, 4, 7, 64,
+                                 ozz::io::BufferedFile::kDefaultBufferSize};
+  for (size_t i = 0; i < OZZ_ARRAY_SIZE(buffer_sizes); ++i) {
+    {
+      ozz::io::BufferedFile file("test_buffered.bin", "w+b", buffer_sizes[i]);
+      TestStream(&file);
+    }
+    {
+      ozz::io::BufferedFile file("test_buffered.bin", "w+b", buffer_sizes[i]);
+      TestSeek(&file);
+    }
+  }
+}
+
+TEST(BufferedFileInterleaved, Stream) {
+  // Writes a reference content, then reads and overwrites it with interleaved
+  // operations that cross buffer boundaries.
+  const int kCount = 1000;
+  {
+    ozz::io::BufferedFile file("test_buffered.bin", "wb", 64);
+    ASSERT_TRUE(file.opened());
+    for (int i = 0; i < kCount; ++i) {
+      EXPECT_EQ(file.Write(&i, sizeof(i)), sizeof(i));
+      EXPECT_EQ(file.Tell(), static_cast<int>(sizeof(i)) * (i + 1));
+    }
+    EXPECT_EQ(file.Size(), sizeof(int) * kCount);
+  }
+  {
+    ozz::io::BufferedFile file("test_buffered.bin", "r+b", 64);
+    ASSERT_TRUE(file.opened());
+    EXPECT_EQ(file.Size(), sizeof(int) * kCount);
+    for (int i = 0; i < kCount; i += 2) {
+      int value = -1;
+      EXPECT_EQ(file.Read(&value, sizeof(value)), sizeof(value));
+      EXPECT_EQ(value, i);
+      // Overwrites next value with its opposite.
+      const int opposite = -(i + 1);
+      EXPECT_EQ(file.Write(&opposite, sizeof(opposite)), sizeof(opposite));
+      EXPECT_EQ(file.Tell(), static_cast<int>(sizeof(int)) * (i + 2));
+    }
+
+    // Reads back everything with a single big read.
+    EXPECT_EQ(file.Seek(0, ozz::io::Stream::kSet), 0);
+    int values[kCount];
+    EXPECT_EQ(file.Read(values, sizeof(values)), sizeof(values));
+    for (int i = 0; i < kCount; ++i) {
+      EXPECT_EQ(values[i], i & 1 ? -i : i);
+    }
+    EXPECT_EQ(file.Read(values, sizeof(int)), 0u);
+  }
+}
+
+TEST(BufferedFileReadWrite, Stream) {
+  // Alternates writes and reads on the same file without any explicit seek,
+  // which requires a positioning call on every direction change.
+  const size_t buffer_sizes[] = {0, 1, 4, 7, 64,
+                                 ozz::io::BufferedFile::kDefaultBufferSize};
+  for (size_t i = 0; i < OZZ_ARRAY_SIZE(buffer_sizes); ++i) {
+    ozz::io::BufferedFile file("test_buffered.bin", "w+b", buffer_sizes[i]);
+    ASSERT_TRUE(file.opened());
+    const int kCount = 100;
+    for (int j = 0; j < kCount; ++j) {
+      EXPECT_EQ(file.Write(&j, sizeof(j)), sizeof(j));
+    }
+
+    // Write/Read/Write sequence, overwriting even values with their opposite.
+    EXPECT_EQ(file.Seek(0, ozz::io::Stream::kSet), 0);
+    for (int j = 0; j < kCount; j += 2) {
+      const int opposite = -j;
+      EXPECT_EQ(file.Write(&opposite, sizeof(opposite)), sizeof(opposite));
+      int value = -1;
+      EXPECT_EQ(file.Read(&value, sizeof(value)), sizeof(value));
+      EXPECT_EQ(value, j + 1);
+    }
+
+    // Reaches end of file, then appends.
+    int value = -1;
+    EXPECT_EQ(file.Read(&value, sizeof(value)), 0u);
+    EXPECT_EQ(file.Write(&kCount, sizeof(kCount)), sizeof(kCount));
+    EXPECT_EQ(file.Tell(), static_cast<int>(sizeof(int)) * (kCount + 1));
+
+    EXPECT_EQ(file.Seek(0, ozz::io::Stream::kSet), 0);
+    int values[kCount + 1];
+    EXPECT_EQ(file.Read(values, sizeof(values)), sizeof(values));
+    for (int j = 0; j < kCount; ++j) {
+      EXPECT_EQ(values[j], j & 1 ? j : -j);
+    }
+    EXPECT_EQ(values[kCount], kCount);
+  }
+}
+
+TEST(BufferedFileNonSeekable, Stream) {
+  // Pipes can't seek, so a BufferedFile that only writes, or only reads, must
+  // never reposition them.
+  int fds[2];
+#ifdef _WIN32
+  ASSERT_EQ(_pipe(fds, 4096, _O_BINARY), 0);
+  std::FILE* write_end = _fdopen(fds[1], "wb");
+  std::FILE* read_end = _fdopen(fds[0], "rb");
+#else   // _WIN32
+  ASSERT_EQ(pipe(fds), 0);
+  std::FILE* write_end = fdopen(fds[1], "wb");
+  std::FILE* read_end = fdopen(fds[0], "rb");
+#endif  // _WIN32
+  ASSERT_TRUE(write_end != nullptr && read_end != nullptr);
+
+  // Written content is smaller than pipe capacity, so writing doesn't block.
+  const int kCount = 100;
+  {
+    ozz::io::BufferedFile file(write_end, 64);
+    ASSERT_TRUE(file.opened());
+    for (int i = 0; i < kCount; ++i) {
+      EXPECT_EQ(file.Write(&i, sizeof(i)), sizeof(i));
+    }
+    EXPECT_TRUE(file.Flush());
+  }  // Closes write end.
+  {
+    ozz::io::BufferedFile file(read_end, 64);
+    ASSERT_TRUE(file.opened());
+    for (int i = 0; i < kCount; ++i) {
+      int value = -1;
+      EXPECT_EQ(file.Read(&value, sizeof(value)), sizeof(value));
+      EXPECT_EQ(value, i);
+    }
+    int value = -1;
+    EXPECT_EQ(file.Read(&value, sizeof(value)), 0u);
+  }
+}
+
+TEST(ReadOnlyMemoryStream, Stream) {
+  {  // Empty buffer.
+    ozz::io::ReadOnlyMemoryStream stream(ozz::span<const char>{});
+    EXPECT_TRUE(stream.opened());
+    EXPECT_EQ(stream.Size(), 0u);
+    EXPECT_EQ(stream.Tell(), 0);
+    char c;
+    EXPECT_EQ(stream.Read(&c, 1), 0u);
+    EXPECT_EQ(stream.Write(&c, 1), 0u);
+  }
+  {
+    const int buffer[] = {46, 27, 58, 99};
+    ozz::io::ReadOnlyMemoryStream stream(ozz::span<const char>(
+        reinterpret_cast<const char*>(buffer), sizeof(buffer)));
+    EXPECT_TRUE(stream.opened());
+    EXPECT_EQ(stream.Size(), sizeof(buffer));
+    EXPECT_EQ(stream.Tell(), 0);
+
+    // Writing is not allowed.
+    const int to_write = 14;
+    EXPECT_EQ(stream.Write(&to_write, sizeof(int)), 0u);
+    EXPECT_EQ(stream.Tell(), 0);
+
+    int to_read = 0;
+    EXPECT_EQ(stream.Read(&to_read, sizeof(int)), sizeof(int));
+    EXPECT_EQ(to_read, 46);
+    EXPECT_EQ(stream.Tell(), static_cast<int>(sizeof(int)));
+
+    // Seeking.
+    EXPECT_NE(stream.Seek(-1, ozz::io::Stream::kSet), 0);
+    EXPECT_EQ(stream.Seek(46, ozz::io::Stream::Origin(27)), -1);
+    EXPECT_EQ(stream.Tell(), static_cast<int>(sizeof(int)));
+    EXPECT_EQ(
+        stream.Seek(-static_cast<int>(sizeof(int)), ozz::io::Stream::kEnd), 0);
+    EXPECT_EQ(stream.Read(&to_read, sizeof(int)), sizeof(int));
+    EXPECT_EQ(to_read, 99);
+    EXPECT_EQ(stream.Tell(), static_cast<int>(sizeof(buffer)));
+
+    // Reading at and beyond the end.
+    EXPECT_EQ(stream.Read(&to_read, sizeof(int)), 0u);
+    EXPECT_EQ(stream.Seek(4, ozz::io::Stream::kCurrent), 0);
+    EXPECT_EQ(stream.Read(&to_read, sizeof(int)), 0u);
+    EXPECT_EQ(stream.Tell(), static_cast<int>(sizeof(buffer)) + 4);
+
+    // Partial read.
+    EXPECT_EQ(stream.Seek(sizeof(buffer) - 1, ozz::io::Stream::kSet), 0);
+    EXPECT_EQ(stream.Read(&to_read, sizeof(int)), 1u);
+    EXPECT_EQ(stream.Size(), sizeof(buffer));
+  }
+}
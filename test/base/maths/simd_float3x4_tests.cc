@@ -0,0 +1,84 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+
+#include "ozz/base/maths/simd_float3x4.h"
+
+#include "gtest/gtest.h"
+
+#include "ozz/base/gtest_helper.h"
+#include "ozz/base/maths/gtest_math_helper.h"
+
+using ozz::math::Float3x4;
+using ozz::math::Float4x4;
+
+TEST(Float3x4Constant, ozz_simd_math) {
+  const Float3x4 identity = Float3x4::identity();
+  EXPECT_FLOAT3x4_EQ(identity, 1.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f, 0.f,
+                     1.f, 0.f);
+}
+
+TEST(Float3x4Conversion, ozz_simd_math) {
+  const Float4x4 m = {{ozz::math::simd_float4::Load(0.f, 1.f, 2.f, 0.f),
+                       ozz::math::simd_float4::Load(4.f, 5.f, 6.f, 0.f),
+                       ozz::math::simd_float4::Load(8.f, 9.f, 10.f, 0.f),
+                       ozz::math::simd_float4::Load(12.f, 13.f, 14.f, 1.f)}};
+
+  const Float3x4 affine = Float3x4::FromFloat4x4(m);
+  EXPECT_FLOAT3x4_EQ(affine, 0.f, 4.f, 8.f, 12.f, 1.f, 5.f, 9.f, 13.f, 2.f, 6.f,
+                     10.f, 14.f);
+
+  const Float4x4 back = ToFloat4x4(affine);
+  EXPECT_FLOAT4x4_EQ(back, 0.f, 1.f, 2.f, 0.f, 4.f, 5.f, 6.f, 0.f, 8.f, 9.f,
+                     10.f, 0.f, 12.f, 13.f, 14.f, 1.f);
+}
+
+TEST(Float3x4Arithmetic, ozz_simd_math) {
+  const Float4x4 m0 = {{ozz::math::simd_float4::Load(0.f, 1.f, 2.f, 0.f),
+                        ozz::math::simd_float4::Load(4.f, 5.f, 6.f, 0.f),
+                        ozz::math::simd_float4::Load(8.f, 9.f, 10.f, 0.f),
+                        ozz::math::simd_float4::Load(12.f, 13.f, 14.f, 1.f)}};
+  const Float4x4 m1 = {
+      {ozz::math::simd_float4::Load(-0.f, -1.f, 2.f, 0.f),
+       ozz::math::simd_float4::Load(-4.f, 5.f, -6.f, 0.f),
+       ozz::math::simd_float4::Load(8.f, -9.f, -10.f, 0.f),
+       ozz::math::simd_float4::Load(-12.f, 13.f, 14.f, 1.f)}};
+
+  // Affine multiplication matches Float4x4 one.
+  const Float3x4 mul = Float3x4::FromFloat4x4(m0) * Float3x4::FromFloat4x4(m1);
+  const Float4x4 mul_4x4 = m0 * m1;
+  EXPECT_FLOAT4x4_EQ(mul_4x4, 12.f, 13.f, 14.f, 0.f, -28.f, -33.f, -38.f,
+                     0.f, -116.f, -127.f, -138.f, 0.f, 176.f, 192.f, 208.f,
+                     1.f);
+  EXPECT_FLOAT3x4_EQ(mul, 12.f, -28.f, -116.f, 176.f, 13.f, -33.f, -127.f,
+                     192.f, 14.f, -38.f, -138.f, 208.f);
+
+  const Float3x4 mul_identity =
+      Float3x4::FromFloat4x4(m0) * Float3x4::identity();
+  EXPECT_FLOAT3x4_EQ(mul_identity, 0.f, 4.f, 8.f, 12.f, 1.f, 5.f, 9.f, 13.f,
+                     2.f, 6.f, 10.f, 14.f);
+}
@@ -0,0 +1,234 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#include "ozz/base/maths/simd_math8.h"
+
+#include <cstring>
+
+#include "gtest/gtest.h"
+
+#include "ozz/base/maths/gtest_math_helper.h"
+
+// 8-wide maths are only available with AVX2. Every test compares 8-wide
+// results with the 4-wide ones computed for the low and high halves.
+#if defined(OZZ_SIMD_AVX2)
+
+using ozz::math::SimdFloat4;
+using ozz::math::SimdFloat8;
+using ozz::math::SimdInt4;
+using ozz::math::SimdInt8;
+
+namespace {
+void ExpectSimdFloat8Eq(SimdFloat8 _v, SimdFloat4 _lo, SimdFloat4 _hi) {
+  float expected[8];
+  ozz::math::StorePtrU(_lo, expected);
+  ozz::math::StorePtrU(_hi, expected + 4);
+  float result[8];
+  ozz::math::StorePtrU(_v, result);
+  for (int i = 0; i < 8; ++i) {
+    // Bitwise comparison handles infinites and nans of logical operations.
+    if (std::memcmp(&expected[i], &result[i], sizeof(float)) != 0) {
+      ExpectFloatNear(expected[i], result[i], kFloatNearTolerance);
+    }
+  }
+}
+
+void ExpectSimdInt8Eq(SimdInt8 _v, SimdInt4 _lo, SimdInt4 _hi) {
+  EXPECT_TRUE(
+      ozz::math::AreAllTrue(ozz::math::CmpEq(ozz::math::GetLo(_v), _lo)));
+  EXPECT_TRUE(
+      ozz::math::AreAllTrue(ozz::math::CmpEq(ozz::math::GetHi(_v), _hi)));
+}
+}  // namespace
+
+TEST(LoadFloat8, ozz_simd_math) {
+  ExpectSimdFloat8Eq(ozz::math::simd_float8::zero(),
+                     ozz::math::simd_float4::zero(),
+                     ozz::math::simd_float4::zero());
+  ExpectSimdFloat8Eq(ozz::math::simd_float8::one(),
+                     ozz::math::simd_float4::one(),
+                     ozz::math::simd_float4::one());
+  ExpectSimdFloat8Eq(ozz::math::simd_float8::Load1(46.f),
+                     ozz::math::simd_float4::Load1(46.f),
+                     ozz::math::simd_float4::Load1(46.f));
+
+  const SimdFloat4 lo = ozz::math::simd_float4::Load(0.f, 1.f, 2.f, 3.f);
+  const SimdFloat4 hi = ozz::math::simd_float4::Load(4.f, 5.f, 6.f, 7.f);
+  const SimdFloat8 v = ozz::math::simd_float8::Load(lo, hi);
+  ExpectSimdFloat8Eq(v, lo, hi);
+  EXPECT_SIMDFLOAT_EQ(ozz::math::GetLo(v), 0.f, 1.f, 2.f, 3.f);
+  EXPECT_SIMDFLOAT_EQ(ozz::math::GetHi(v), 4.f, 5.f, 6.f, 7.f);
+
+  const float f[9] = {-1.f, 0.f, 1.f, 2.f, 3.f, 4.f, 5.f, 6.f, 7.f};
+  ExpectSimdFloat8Eq(ozz::math::simd_float8::LoadPtrU(f + 1), lo, hi);
+
+  ExpectSimdFloat8Eq(ozz::math::simd_float8::FromInt(
+                         ozz::math::simd_int8::Load(0, 1, 2, 3, 4, 5, 6, 7)),
+                     lo, hi);
+}
+
+TEST(StoreFloat8, ozz_simd_math) {
+  const SimdFloat4 lo = ozz::math::simd_float4::Load(0.f, 1.f, 2.f, 3.f);
+  const SimdFloat4 hi = ozz::math::simd_float4::Load(4.f, 5.f, 6.f, 7.f);
+  const SimdFloat8 v = ozz::math::simd_float8::Load(lo, hi);
+
+  SimdFloat4 out[2];
+  ozz::math::Store(v, &out[0], &out[1]);
+  EXPECT_SIMDFLOAT_EQ(out[0], 0.f, 1.f, 2.f, 3.f);
+  EXPECT_SIMDFLOAT_EQ(out[1], 4.f, 5.f, 6.f, 7.f);
+
+  float f[9] = {-1.f, -1.f, -1.f, -1.f, -1.f, -1.f, -1.f, -1.f, -1.f};
+  ozz::math::StorePtrU(v, f + 1);
+  EXPECT_FLOAT_EQ(f[0], -1.f);
+  for (int i = 0; i < 8; ++i) {
+    EXPECT_FLOAT_EQ(f[i + 1], static_cast<float>(i));
+  }
+}
+
+TEST(TransposeFloat8, ozz_simd_math) {
+  SimdFloat4 lo[4];
+  SimdFloat4 hi[4];
+  SimdFloat8 in[4];
+  for (int i = 0; i < 4; ++i) {
+    const float f = static_cast<float>(i * 4);
+    lo[i] = ozz::math::simd_float4::Load(f, f + 1.f, f + 2.f, f + 3.f);
+    hi[i] = ozz::math::simd_float4::Load(-f, -f - 1.f, -f - 2.f, -f - 3.f);
+    in[i] = ozz::math::simd_float8::Load(lo[i], hi[i]);
+  }
+
+  SimdFloat4 lo_t[4];
+  SimdFloat4 hi_t[4];
+  ozz::math::Transpose4x4(lo, lo_t);
+  ozz::math::Transpose4x4(hi, hi_t);
+  SimdFloat8 out[4];
+  ozz::math::Transpose4x4(in, out);
+  for (int i = 0; i < 4; ++i) {
+    ExpectSimdFloat8Eq(out[i], lo_t[i], hi_t[i]);
+  }
+}
+
+TEST(LoadInt8, ozz_simd_math) {
+  const SimdInt4 lo = ozz::math::simd_int4::Load(0, 1, 2, 3);
+  const SimdInt4 hi = ozz::math::simd_int4::Load(4, 5, 6, 7);
+  ExpectSimdInt8Eq(ozz::math::simd_int8::Load1(46),
+                   ozz::math::simd_int4::Load1(46),
+                   ozz::math::simd_int4::Load1(46));
+  ExpectSimdInt8Eq(ozz::math::simd_int8::Load(0, 1, 2, 3, 4, 5, 6, 7), lo, hi);
+  ExpectSimdInt8Eq(ozz::math::simd_int8::Load(lo, hi), lo, hi);
+
+  alignas(32) const int i[8] = {0, 1, 2, 3, 4, 5, 6, 7};
+  ExpectSimdInt8Eq(ozz::math::simd_int8::LoadPtr(i), lo, hi);
+}
+
+TEST(ArithmeticFloat8, ozz_simd_math) {
+  const SimdFloat4 a_lo = ozz::math::simd_float4::Load(.5f, 1.f, 2.f, 3.f);
+  const SimdFloat4 a_hi = ozz::math::simd_float4::Load(4.f, 5.f, 6.f, 7.f);
+  const SimdFloat4 b_lo = ozz::math::simd_float4::Load(-1.f, 2.f, -3.f, 4.f);
+  const SimdFloat4 b_hi = ozz::math::simd_float4::Load(5.f, -6.f, 7.f, -8.f);
+  const SimdFloat4 c_lo = ozz::math::simd_float4::Load(9.f, 10.f, 11.f, 12.f);
+  const SimdFloat4 c_hi = ozz::math::simd_float4::Load(13.f, 14.f, 15.f, 16.f);
+  const SimdFloat8 a = ozz::math::simd_float8::Load(a_lo, a_hi);
+  const SimdFloat8 b = ozz::math::simd_float8::Load(b_lo, b_hi);
+  const SimdFloat8 c = ozz::math::simd_float8::Load(c_lo, c_hi);
+
+  ExpectSimdFloat8Eq(a + b, a_lo + b_lo, a_hi + b_hi);
+  ExpectSimdFloat8Eq(a - b, a_lo - b_lo, a_hi - b_hi);
+  ExpectSimdFloat8Eq(-a, -a_lo, -a_hi);
+  ExpectSimdFloat8Eq(a * b, a_lo * b_lo, a_hi * b_hi);
+  ExpectSimdFloat8Eq(a / b, a_lo / b_lo, a_hi / b_hi);
+  ExpectSimdFloat8Eq(ozz::math::MAdd(a, b, c),
+                     ozz::math::MAdd(a_lo, b_lo, c_lo),
+                     ozz::math::MAdd(a_hi, b_hi, c_hi));
+  ExpectSimdFloat8Eq(ozz::math::RcpEst(a), ozz::math::RcpEst(a_lo),
+                     ozz::math::RcpEst(a_hi));
+  ExpectSimdFloat8Eq(ozz::math::Sqrt(a), ozz::math::Sqrt(a_lo),
+                     ozz::math::Sqrt(a_hi));
+  ExpectSimdFloat8Eq(ozz::math::RSqrtEst(a), ozz::math::RSqrtEst(a_lo),
+                     ozz::math::RSqrtEst(a_hi));
+  ExpectSimdFloat8Eq(ozz::math::RSqrtEstNR(a), ozz::math::RSqrtEstNR(a_lo),
+                     ozz::math::RSqrtEstNR(a_hi));
+  ExpectSimdFloat8Eq(ozz::math::Max(a, b), ozz::math::Max(a_lo, b_lo),
+                     ozz::math::Max(a_hi, b_hi));
+  ExpectSimdFloat8Eq(ozz::math::Min(a, b), ozz::math::Min(a_lo, b_lo),
+                     ozz::math::Min(a_hi, b_hi));
+  ExpectSimdFloat8Eq(ozz::math::Max0(b), ozz::math::Max0(b_lo),
+                     ozz::math::Max0(b_hi));
+}
+
+TEST(LogicalFloat8, ozz_simd_math) {
+  const SimdFloat4 a_lo = ozz::math::simd_float4::Load(.5f, -1.f, 2.f, -3.f);
+  const SimdFloat4 a_hi = ozz::math::simd_float4::Load(-4.f, 5.f, -6.f, 7.f);
+  const SimdFloat4 b_lo = ozz::math::simd_float4::Load(-1.f, 2.f, -3.f, 4.f);
+  const SimdFloat4 b_hi = ozz::math::simd_float4::Load(5.f, -6.f, 7.f, -8.f);
+  const SimdInt4 i_lo =
+      ozz::math::simd_int4::Load(0, -1, static_cast<int>(0x80000000), 46);
+  const SimdInt4 i_hi = ozz::math::simd_int4::Load(0x7fffffff, 0, -1, 93);
+  const SimdFloat8 a = ozz::math::simd_float8::Load(a_lo, a_hi);
+  const SimdFloat8 b = ozz::math::simd_float8::Load(b_lo, b_hi);
+  const SimdInt8 i = ozz::math::simd_int8::Load(i_lo, i_hi);
+
+  ExpectSimdInt8Eq(ozz::math::Sign(a), ozz::math::Sign(a_lo),
+                   ozz::math::Sign(a_hi));
+  ExpectSimdFloat8Eq(ozz::math::And(a, b), ozz::math::And(a_lo, b_lo),
+                     ozz::math::And(a_hi, b_hi));
+  ExpectSimdFloat8Eq(ozz::math::Or(a, b), ozz::math::Or(a_lo, b_lo),
+                     ozz::math::Or(a_hi, b_hi));
+  ExpectSimdFloat8Eq(ozz::math::Xor(a, b), ozz::math::Xor(a_lo, b_lo),
+                     ozz::math::Xor(a_hi, b_hi));
+  ExpectSimdFloat8Eq(ozz::math::And(a, i), ozz::math::And(a_lo, i_lo),
+                     ozz::math::And(a_hi, i_hi));
+  ExpectSimdFloat8Eq(ozz::math::Or(a, i), ozz::math::Or(a_lo, i_lo),
+                     ozz::math::Or(a_hi, i_hi));
+  ExpectSimdFloat8Eq(ozz::math::Xor(a, i), ozz::math::Xor(a_lo, i_lo),
+                     ozz::math::Xor(a_hi, i_hi));
+}
+
+TEST(Int8, ozz_simd_math) {
+  const SimdInt4 a_lo = ozz::math::simd_int4::Load(0, 1, -2, 3);
+  const SimdInt4 a_hi = ozz::math::simd_int4::Load(4, -5, 6, 0x7fffffff);
+  const SimdInt4 b_lo = ozz::math::simd_int4::Load(0, 2, -2, 4);
+  const SimdInt4 b_hi = ozz::math::simd_int4::Load(4, 5, 7, 0x7fffffff);
+  const SimdInt8 a = ozz::math::simd_int8::Load(a_lo, a_hi);
+  const SimdInt8 b = ozz::math::simd_int8::Load(b_lo, b_hi);
+
+  ExpectSimdInt8Eq(ozz::math::ShiftL(a, 3), ozz::math::ShiftL(a_lo, 3),
+                   ozz::math::ShiftL(a_hi, 3));
+  ExpectSimdInt8Eq(ozz::math::CmpEq(a, b), ozz::math::CmpEq(a_lo, b_lo),
+                   ozz::math::CmpEq(a_hi, b_hi));
+}
+
+TEST(HalfToFloat8, ozz_simd_math) {
+  // 0, 1, -2, 65504, min subnormal, -0, +inf, 0.5.
+  const SimdInt4 lo =
+      ozz::math::simd_int4::Load(0x0000, 0x3c00, 0xc000, 0x7bff);
+  const SimdInt4 hi =
+      ozz::math::simd_int4::Load(0x0001, 0x8000, 0x7c00, 0x3800);
+  ExpectSimdFloat8Eq(
+      ozz::math::HalfToFloat(ozz::math::simd_int8::Load(lo, hi)),
+      ozz::math::HalfToFloat(lo), ozz::math::HalfToFloat(hi));
+}
+#endif  // OZZ_SIMD_AVX2
@@ -837,3 +837,25 @@ TEST(SimdHalf, ozz_simd_math) {
     }
   }
 }
+
+TEST(SimdHalfExhaustive, ozz_simd_math) {
+  // Compares simd conversion (which can be hardware accelerated) against
+  // scalar conversion for all half values, excluding NaNs whose payload isn't
+  // required to be preserved.
+  for (int i = 0; i < 0x10000; i += 4) {
+    const SimdFloat4 f = ozz::math::HalfToFloat(
+        ozz::math::simd_int4::Load(i, i + 1, i + 2, i + 3));
+    float results[4];
+    ozz::math::StorePtrU(f, results);
+    for (int j = 0; j < 4; ++j) {
+      const uint16_t h = static_cast<uint16_t>(i + j);
+      const float expected = ozz::math::HalfToFloat(h);
+      if (expected != expected) {  // NaN
+        EXPECT_FALSE(results[j] == results[j]);
+      } else {
+        EXPECT_EQ(expected, results[j]);
+        EXPECT_EQ(std::signbit(expected), std::signbit(results[j]));
+      }
+    }
+  }
+}
@@ -141,6 +141,47 @@ TEST(LoadIntPtr, ozz_simd_math) {
       "alignment");
 }
 
+TEST(LoadPackedIntPtr, ozz_simd_math) {
+  const uint8_t u8[5] = {0, 1, 127, 128, 255};
+  EXPECT_SIMDINT_EQ(ozz::math::simd_int4::LoadPtrU(u8), 0, 1, 127, 128);
+  EXPECT_SIMDINT_EQ(ozz::math::simd_int4::LoadPtrU(u8 + 1), 1, 127, 128, 255);
+
+  alignas(4) const uint16_t u16[6] = {0, 1, 32767, 32768, 65535, 0};
+  EXPECT_SIMDINT_EQ(ozz::math::simd_int4::LoadPtrU(u16), 0, 1, 32767, 32768);
+  EXPECT_SIMDINT_EQ(ozz::math::simd_int4::LoadPtrU(u16 + 1), 1, 32767, 32768,
+                    65535);
+  EXPECT_SIMDINT_EQ(ozz::math::simd_int4::Load3PtrU(u16 + 2), 32767, 32768,
+                    65535, 0);
+  EXPECT_ASSERTION(ozz::math::simd_int4::LoadPtrU(
+                       reinterpret_cast<const uint16_t*>(
+                           reinterpret_cast<const char*>(u16) + 1)),
+                   "alignment");
+  EXPECT_ASSERTION(ozz::math::simd_int4::Load3PtrU(
+                       reinterpret_cast<const uint16_t*>(
+                           reinterpret_cast<const char*>(u16) + 1)),
+                   "alignment");
+
+  alignas(4) const int16_t i16[6] = {-32768, -1, 0, 1, 32767, 0};
+  EXPECT_SIMDINT_EQ(ozz::math::simd_int4::LoadPtrU(i16), -32768, -1, 0, 1);
+  EXPECT_SIMDINT_EQ(ozz::math::simd_int4::LoadPtrU(i16 + 1), -1, 0, 1, 32767);
+  EXPECT_SIMDINT_EQ(ozz::math::simd_int4::Load2PtrU(i16), -32768, -1, 0, 0);
+  EXPECT_SIMDINT_EQ(ozz::math::simd_int4::Load2PtrU(i16 + 3), 1, 32767, 0, 0);
+  EXPECT_SIMDINT_EQ(ozz::math::simd_int4::Load3PtrU(i16), -32768, -1, 0, 0);
+  EXPECT_SIMDINT_EQ(ozz::math::simd_int4::Load3PtrU(i16 + 2), 0, 1, 32767, 0);
+  EXPECT_ASSERTION(ozz::math::simd_int4::LoadPtrU(
+                       reinterpret_cast<const int16_t*>(
+                           reinterpret_cast<const char*>(i16) + 1)),
+                   "alignment");
+  EXPECT_ASSERTION(ozz::math::simd_int4::Load2PtrU(
+                       reinterpret_cast<const int16_t*>(
+                           reinterpret_cast<const char*>(i16) + 1)),
+                   "alignment");
+  EXPECT_ASSERTION(ozz::math::simd_int4::Load3PtrU(
+                       reinterpret_cast<const int16_t*>(
+                           reinterpret_cast<const char*>(i16) + 1)),
+                   "alignment");
+}
+
 TEST(GetInt, ozz_simd_math) {
   const SimdInt4 i = ozz::math::simd_int4::Load(1, 2, 3, 4);
 
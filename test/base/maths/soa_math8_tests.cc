@@ -0,0 +1,201 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#include "ozz/base/maths/soa_math8.h"
+
+#include "gtest/gtest.h"
+
+#include "ozz/base/maths/gtest_math_helper.h"
+
+// 8-wide soa maths are only available with AVX2. Every test compares 8-wide
+// results with the 4-wide ones computed for the low and high halves.
+#if defined(OZZ_SIMD_AVX2)
+
+using ozz::math::SimdFloat4;
+using ozz::math::Soa8Float3;
+using ozz::math::Soa8Float4x4;
+using ozz::math::Soa8Quaternion;
+using ozz::math::Soa8Transform;
+using ozz::math::SoaFloat3;
+using ozz::math::SoaFloat4;
+using ozz::math::SoaFloat4x4;
+using ozz::math::SoaQuaternion;
+using ozz::math::SoaTransform;
+
+namespace {
+void ExpectSimdFloat4Eq(SimdFloat4 _v, SimdFloat4 _expected) {
+  float expected[4];
+  ozz::math::StorePtrU(_expected, expected);
+  EXPECT_SIMDFLOAT_EQ(_v, expected[0], expected[1], expected[2], expected[3]);
+}
+
+void ExpectSoaFloat3Eq(const SoaFloat3& _v, const SoaFloat3& _expected) {
+  ExpectSimdFloat4Eq(_v.x, _expected.x);
+  ExpectSimdFloat4Eq(_v.y, _expected.y);
+  ExpectSimdFloat4Eq(_v.z, _expected.z);
+}
+
+void ExpectSoaFloat4Eq(const SoaFloat4& _v, const SoaFloat4& _expected) {
+  ExpectSimdFloat4Eq(_v.x, _expected.x);
+  ExpectSimdFloat4Eq(_v.y, _expected.y);
+  ExpectSimdFloat4Eq(_v.z, _expected.z);
+  ExpectSimdFloat4Eq(_v.w, _expected.w);
+}
+
+void ExpectSoaQuaternionEq(const SoaQuaternion& _v,
+                           const SoaQuaternion& _expected) {
+  ExpectSimdFloat4Eq(_v.x, _expected.x);
+  ExpectSimdFloat4Eq(_v.y, _expected.y);
+  ExpectSimdFloat4Eq(_v.z, _expected.z);
+  ExpectSimdFloat4Eq(_v.w, _expected.w);
+}
+
+// Two different soa transforms, with normalized quaternions.
+const SoaTransform kTransforms[2] = {
+    {{ozz::math::simd_float4::Load(0.f, 1.f, 2.f, 3.f),
+      ozz::math::simd_float4::Load(4.f, 5.f, 6.f, 7.f),
+      ozz::math::simd_float4::Load(8.f, 9.f, 10.f, 11.f)},
+     {ozz::math::simd_float4::Load(.70710677f, 0.f, 0.f, .382683432f),
+      ozz::math::simd_float4::Load(0.f, 0.f, .70710677f, 0.f),
+      ozz::math::simd_float4::Load(0.f, 0.f, 0.f, 0.f),
+      ozz::math::simd_float4::Load(.70710677f, 1.f, .70710677f, .9238795f)},
+     {ozz::math::simd_float4::Load(1.f, 2.f, 3.f, 4.f),
+      ozz::math::simd_float4::Load(-1.f, 1.f, .5f, 2.f),
+      ozz::math::simd_float4::Load(1.f, -2.f, 3.f, 1.f)}},
+    {{ozz::math::simd_float4::Load(-1.f, 2.f, -3.f, 4.f),
+      ozz::math::simd_float4::Load(5.f, -6.f, 7.f, -8.f),
+      ozz::math::simd_float4::Load(9.f, -10.f, 11.f, -12.f)},
+     {ozz::math::simd_float4::Load(0.f, .5f, 0.f, -.70710677f),
+      ozz::math::simd_float4::Load(-.70710677f, .5f, 0.f, 0.f),
+      ozz::math::simd_float4::Load(0.f, .5f, -.382683432f, 0.f),
+      ozz::math::simd_float4::Load(.70710677f, .5f, .9238795f, -.70710677f)},
+     {ozz::math::simd_float4::Load(2.f, 1.f, 1.f, 1.f),
+      ozz::math::simd_float4::Load(1.f, 3.f, 1.f, 1.f),
+      ozz::math::simd_float4::Load(1.f, 1.f, 4.f, -1.f)}}};
+}  // namespace
+
+TEST(Soa8LoadStore, ozz_soa_math) {
+  const Soa8Transform transform =
+      Soa8Transform::Load(kTransforms[0], kTransforms[1]);
+
+  SoaFloat3 float3[2];
+  ozz::math::Store(transform.translation, &float3[0], &float3[1]);
+  ExpectSoaFloat3Eq(float3[0], kTransforms[0].translation);
+  ExpectSoaFloat3Eq(float3[1], kTransforms[1].translation);
+
+  SoaQuaternion quaternion[2];
+  ozz::math::Store(transform.rotation, &quaternion[0], &quaternion[1]);
+  ExpectSoaQuaternionEq(quaternion[0], kTransforms[0].rotation);
+  ExpectSoaQuaternionEq(quaternion[1], kTransforms[1].rotation);
+
+  ozz::math::Store(transform.scale, &float3[0], &float3[1]);
+  ExpectSoaFloat3Eq(float3[0], kTransforms[0].scale);
+  ExpectSoaFloat3Eq(float3[1], kTransforms[1].scale);
+
+  const SoaFloat4 float4[2] = {
+      SoaFloat4::Load(kTransforms[0].translation, kTransforms[0].scale.x),
+      SoaFloat4::Load(kTransforms[1].translation, kTransforms[1].scale.x)};
+  SoaFloat4 float4_out[2];
+  ozz::math::Store(ozz::math::Soa8Float4::Load(float4[0], float4[1]),
+                   &float4_out[0], &float4_out[1]);
+  ExpectSoaFloat4Eq(float4_out[0], float4[0]);
+  ExpectSoaFloat4Eq(float4_out[1], float4[1]);
+}
+
+TEST(Soa8Lerp, ozz_soa_math) {
+  const SimdFloat4 alpha[2] = {
+      ozz::math::simd_float4::Load(0.f, .1f, .5f, 1.f),
+      ozz::math::simd_float4::Load(.7f, .3f, 0.f, .99f)};
+  const ozz::math::SimdFloat8 alpha8 =
+      ozz::math::simd_float8::Load(alpha[0], alpha[1]);
+
+  // Float3.
+  SoaFloat3 float3[2];
+  ozz::math::Store(
+      Lerp(Soa8Float3::Load(kTransforms[0].translation,
+                            kTransforms[1].translation),
+           Soa8Float3::Load(kTransforms[0].scale, kTransforms[1].scale),
+           alpha8),
+      &float3[0], &float3[1]);
+  for (int i = 0; i < 2; ++i) {
+    ExpectSoaFloat3Eq(float3[i], Lerp(kTransforms[i].translation,
+                                      kTransforms[i].scale, alpha[i]));
+  }
+
+  // Quaternion.
+  SoaQuaternion quaternion[2];
+  ozz::math::Store(
+      NLerpEst(Soa8Quaternion::Load(kTransforms[0].rotation,
+                                    kTransforms[1].rotation),
+               Soa8Quaternion::Load(kTransforms[1].rotation,
+                                    kTransforms[1].rotation),
+               alpha8),
+      &quaternion[0], &quaternion[1]);
+  ExpectSoaQuaternionEq(quaternion[0],
+                        NLerpEst(kTransforms[0].rotation,
+                                 kTransforms[1].rotation, alpha[0]));
+  ExpectSoaQuaternionEq(quaternion[1],
+                        NLerpEst(kTransforms[1].rotation,
+                                 kTransforms[1].rotation, alpha[1]));
+
+  // Normalization.
+  const Soa8Quaternion unnormalized = {
+      ozz::math::simd_float8::Load(kTransforms[0].translation.x,
+                                   kTransforms[1].translation.x),
+      ozz::math::simd_float8::Load(kTransforms[0].translation.y,
+                                   kTransforms[1].translation.y),
+      ozz::math::simd_float8::Load(kTransforms[0].translation.z,
+                                   kTransforms[1].translation.z),
+      ozz::math::simd_float8::Load(kTransforms[0].scale.x,
+                                   kTransforms[1].scale.x)};
+  ozz::math::Store(NormalizeEst(unnormalized), &quaternion[0], &quaternion[1]);
+  for (int i = 0; i < 2; ++i) {
+    const SoaQuaternion expected = {
+        kTransforms[i].translation.x, kTransforms[i].translation.y,
+        kTransforms[i].translation.z, kTransforms[i].scale.x};
+    ExpectSoaQuaternionEq(quaternion[i], NormalizeEst(expected));
+  }
+}
+
+TEST(Soa8FromAffine, ozz_soa_math) {
+  const Soa8Transform transform =
+      Soa8Transform::Load(kTransforms[0], kTransforms[1]);
+  SoaFloat4x4 matrices[2];
+  ozz::math::Store(
+      Soa8Float4x4::FromAffine(transform.translation, transform.rotation,
+                               transform.scale),
+      &matrices[0], &matrices[1]);
+  for (int i = 0; i < 2; ++i) {
+    const SoaFloat4x4 expected = SoaFloat4x4::FromAffine(
+        kTransforms[i].translation, kTransforms[i].rotation,
+        kTransforms[i].scale);
+    for (int c = 0; c < 4; ++c) {
+      ExpectSoaFloat4Eq(matrices[i].cols[c], expected.cols[c]);
+    }
+  }
+}
+#endif  // OZZ_SIMD_AVX2
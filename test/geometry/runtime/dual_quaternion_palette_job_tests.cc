@@ -0,0 +1,179 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+
+#include "ozz/geometry/runtime/dual_quaternion_palette_job.h"
+
+#include "gtest/gtest.h"
+#include "ozz/base/maths/gtest_math_helper.h"
+#include "ozz/base/maths/simd_math.h"
+#include "ozz/base/maths/simd_quaternion.h"
+
+using ozz::geometry::DualQuaternion;
+using ozz::geometry::DualQuaternionPaletteJob;
+
+TEST(JobValidity, DualQuaternionPaletteJob) {
+  ozz::math::Float4x4 matrices[3];
+  ozz::math::Float4x4 inverse_bind_poses[3];
+  DualQuaternion output[3];
+
+  {  // Default is invalid.
+    DualQuaternionPaletteJob job;
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+  {  // Missing output.
+    DualQuaternionPaletteJob job;
+    job.joint_matrices = matrices;
+    EXPECT_FALSE(job.Validate());
+  }
+  {  // Output too small.
+    DualQuaternionPaletteJob job;
+    job.joint_matrices = matrices;
+    job.output = {output, 2};
+    EXPECT_FALSE(job.Validate());
+  }
+  {  // Inverse bind poses too small.
+    DualQuaternionPaletteJob job;
+    job.joint_matrices = matrices;
+    job.inverse_bind_poses = {inverse_bind_poses, 2};
+    job.output = output;
+    EXPECT_FALSE(job.Validate());
+  }
+  {  // Valid.
+    DualQuaternionPaletteJob job;
+    job.joint_matrices = matrices;
+    job.output = output;
+    EXPECT_TRUE(job.Validate());
+    job.inverse_bind_poses = inverse_bind_poses;
+    EXPECT_TRUE(job.Validate());
+  }
+}
+
+namespace {
+// Expects _dq to represent _rotation followed by _translation. Quaternions _q
+// and -_q represent the same rotation.
+void ExpectDualQuaternion(const DualQuaternion& _dq,
+                          const ozz::math::SimdFloat4& _rotation,
+                          const ozz::math::SimdFloat4& _translation) {
+  float real[4];
+  float dual[4];
+  float rotation[4];
+  float translation[4];
+  ozz::math::StorePtrU(_dq.real, real);
+  ozz::math::StorePtrU(_dq.dual, dual);
+  ozz::math::StorePtrU(_rotation, rotation);
+  ozz::math::StorePtrU(_translation, translation);
+
+  const float dot = real[0] * rotation[0] + real[1] * rotation[1] +
+                    real[2] * rotation[2] + real[3] * rotation[3];
+  const float sign = dot < 0.f ? -1.f : 1.f;
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_NEAR(real[i] * sign, rotation[i], 1e-5f);
+  }
+
+  // Translation is 2 * dual * conjugate(real).
+  const ozz::math::SimdQuaternion t =
+      ozz::math::SimdQuaternion{_dq.dual} *
+      Conjugate(ozz::math::SimdQuaternion{_dq.real});
+  float recovered[4];
+  ozz::math::StorePtrU(t.xyzw, recovered);
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_NEAR(recovered[i] * 2.f, translation[i], 1e-4f);
+  }
+  EXPECT_NEAR(recovered[3], 0.f, 1e-5f);
+  (void)dual;
+}
+}  // namespace
+
+TEST(JobResult, DualQuaternionPaletteJob) {
+  // Covers every conversion formula (identity, rotations by pi around each
+  // axis), generic rotations, scaling, and an incomplete SoA batch.
+  const float kPi = 3.14159265f;
+  const ozz::math::SimdFloat4 eulers[] = {
+      ozz::math::simd_float4::Load(0.f, 0.f, 0.f, 0.f),
+      ozz::math::simd_float4::Load(kPi, 0.f, 0.f, 0.f),
+      ozz::math::simd_float4::Load(0.f, kPi, 0.f, 0.f),
+      ozz::math::simd_float4::Load(0.f, 0.f, kPi, 0.f),
+      ozz::math::simd_float4::Load(.5f, -1.f, 2.f, 0.f),
+      ozz::math::simd_float4::Load(-2.5f, 1.2f, .3f, 0.f),
+      ozz::math::simd_float4::Load(3.f, 1.5f, -3.f, 0.f)};
+  const int num_joints = OZZ_ARRAY_SIZE(eulers);
+
+  ozz::math::Float4x4 matrices[num_joints];
+  ozz::math::Float4x4 inverse_bind_poses[num_joints];
+  ozz::math::SimdFloat4 translations[num_joints];
+  ozz::math::SimdFloat4 rotations[num_joints];
+  for (int i = 0; i < num_joints; ++i) {
+    const float f = static_cast<float>(i);
+    translations[i] = ozz::math::simd_float4::Load(f, -2.f * f, 3.f, 0.f);
+    const ozz::math::Float4x4 rotation =
+        ozz::math::Float4x4::FromEuler(eulers[i]);
+    rotations[i] = ToQuaternion(rotation);
+    matrices[i] = ozz::math::Float4x4::Translation(translations[i]) *
+                  rotation *
+                  ozz::math::Float4x4::Scaling(ozz::math::simd_float4::Load(
+                      1.f + f * .5f, 1.f, 2.f, 0.f));
+    inverse_bind_poses[i] = Invert(ozz::math::Float4x4::Translation(
+        ozz::math::simd_float4::Load(0.f, 1.f, f, 0.f)));
+  }
+
+  {  // Without inverse bind poses.
+    DualQuaternion output[num_joints];
+    DualQuaternionPaletteJob job;
+    job.joint_matrices = matrices;
+    job.output = output;
+    ASSERT_TRUE(job.Run());
+    for (int i = 0; i < num_joints; ++i) {
+      ExpectDualQuaternion(output[i], rotations[i], translations[i]);
+    }
+  }
+
+  {  // With inverse bind poses.
+    DualQuaternion output[num_joints];
+    DualQuaternionPaletteJob job;
+    job.joint_matrices = matrices;
+    job.inverse_bind_poses = inverse_bind_poses;
+    job.output = output;
+    ASSERT_TRUE(job.Run());
+    for (int i = 0; i < num_joints; ++i) {
+      const ozz::math::Float4x4 skinning =
+          matrices[i] * inverse_bind_poses[i];
+      ExpectDualQuaternion(output[i], rotations[i], skinning.cols[3]);
+    }
+  }
+
+  {  // Output bigger than input is only written up to input size.
+    DualQuaternion output[num_joints + 1];
+    output[num_joints].real = ozz::math::simd_float4::Load1(46.f);
+    DualQuaternionPaletteJob job;
+    job.joint_matrices = matrices;
+    job.output = output;
+    ASSERT_TRUE(job.Run());
+    EXPECT_SIMDFLOAT_EQ(output[num_joints].real, 46.f, 46.f, 46.f, 46.f);
+  }
+}
@@ -25,13 +25,20 @@
 //                                                                            //
 //----------------------------------------------------------------------------//
 
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <thread>
+
 #include "gtest/gtest.h"
 #include "ozz/base/containers/vector.h"
 #include "ozz/base/log.h"
 #include "ozz/base/maths/gtest_math_helper.h"
 #include "ozz/base/maths/simd_math.h"
+#include "ozz/geometry/runtime/dual_quaternion_palette_job.h"
 #include "ozz/geometry/runtime/skinning_job.h"
 
+using ozz::geometry::ParallelSkinningJob;
 using ozz::geometry::SkinningJob;
 
 TEST(JobValidity, SkinningJob) {
@@ -417,6 +424,108 @@ TEST(JobValidity, SkinningJob) {
   }
 }
 
+TEST(JobValidity, SkinningJobCompact) {
+  ozz::math::Float4x4 matrices[2];
+  uint16_t joint_indices[8];
+  uint8_t weights8[4];
+  uint16_t weights16[4];
+  uint16_t positions[6];
+  uint16_t normals[4];
+  uint16_t tangents[4];
+  float out_positions[6];
+  float out_normals[6];
+  float out_tangents[6];
+
+  SkinningJob base_job;
+  base_job.format = SkinningJob::kHalfUnorm8;
+  base_job.vertex_count = 2;
+  base_job.influences_count = 2;
+  base_job.joint_matrices = matrices;
+  base_job.joint_indices = joint_indices;
+  base_job.joint_indices_stride = sizeof(uint16_t) * 2;
+  base_job.joint_weights_unorm8 = weights8;
+  base_job.joint_weights_stride = sizeof(uint8_t);
+  base_job.in_positions_compact = positions;
+  base_job.in_positions_stride = sizeof(uint16_t) * 3;
+  base_job.out_positions = out_positions;
+  base_job.out_positions_stride = sizeof(float) * 3;
+
+  {  // Valid compact positions and weights.
+    SkinningJob job = base_job;
+    EXPECT_TRUE(job.Validate());
+    job.format = SkinningJob::kSnorm16Unorm8;
+    EXPECT_TRUE(job.Validate());
+  }
+
+  {  // Unorm16 weights.
+    SkinningJob job = base_job;
+    job.format = SkinningJob::kHalfUnorm16;
+    EXPECT_FALSE(job.Validate());  // Missing unorm16 weights.
+    job.joint_weights_unorm16 = weights16;
+    job.joint_weights_stride = sizeof(uint16_t);
+    EXPECT_TRUE(job.Validate());
+    job.format = SkinningJob::kSnorm16Unorm16;
+    EXPECT_TRUE(job.Validate());
+    job.joint_weights_unorm16 = {weights16, 1};
+    EXPECT_FALSE(job.Validate());
+  }
+
+  {  // Invalid format.
+    SkinningJob job = base_job;
+    job.format =
+        static_cast<SkinningJob::Format>(SkinningJob::kSnorm16Unorm16 + 1);
+    EXPECT_FALSE(job.Validate());
+  }
+  {  // Float format doesn't read compact buffers.
+    SkinningJob job = base_job;
+    job.format = SkinningJob::kFloat;
+    EXPECT_FALSE(job.Validate());
+  }
+  {  // Weights aren't needed with a single influence.
+    SkinningJob job = base_job;
+    job.influences_count = 1;
+    job.joint_weights_unorm8 = {};
+    EXPECT_TRUE(job.Validate());
+  }
+
+  {  // Compact buffers too small.
+    SkinningJob job = base_job;
+    job.in_positions_compact = {positions, 5};
+    EXPECT_FALSE(job.Validate());
+  }
+  {
+    SkinningJob job = base_job;
+    job.joint_weights_stride = sizeof(uint8_t) * 4;
+    EXPECT_FALSE(job.Validate());
+  }
+
+  {  // Octahedral normals and tangents.
+    SkinningJob job = base_job;
+    job.in_normals_compact = normals;
+    job.in_normals_stride = sizeof(uint16_t) * 2;
+    EXPECT_FALSE(job.Validate());  // Missing output normals.
+    job.out_normals = out_normals;
+    job.out_normals_stride = sizeof(float) * 3;
+    EXPECT_TRUE(job.Validate());
+
+    job.in_tangents_compact = tangents;
+    job.in_tangents_stride = sizeof(uint16_t) * 2;
+    EXPECT_FALSE(job.Validate());  // Missing output tangents.
+    job.out_tangents = out_tangents;
+    job.out_tangents_stride = sizeof(float) * 3;
+    EXPECT_TRUE(job.Validate());
+
+    job.in_tangents_compact = {tangents, 3};
+    EXPECT_FALSE(job.Validate());
+    job.in_tangents_compact = tangents;
+
+    job.in_normals_compact = {normals, 3};
+    EXPECT_FALSE(job.Validate());
+    job.in_normals_compact = {};
+    EXPECT_FALSE(job.Validate());  // Tangents without normals.
+  }
+}
+
 TEST(JobResult, SkinningJob) {
   ozz::math::Float4x4 matrices[4] = {
       {{ozz::math::simd_float4::Load(-1.f, 0.f, 0.f, 0.f),
@@ -1101,6 +1210,677 @@ struct BenchVertexOut {
   float tangents[3];
 };
 
+TEST(JobValidity, SkinningJobDualQuaternion) {
+  ozz::math::Float4x4 matrices[2];
+  ozz::geometry::DualQuaternion dual_quaternions[2];
+  uint16_t joint_indices[2];
+  float in_positions[6];
+  float out_positions[6];
+
+  SkinningJob base_job;
+  base_job.vertex_count = 2;
+  base_job.influences_count = 1;
+  base_job.joint_dual_quaternions = dual_quaternions;
+  base_job.joint_indices = joint_indices;
+  base_job.joint_indices_stride = sizeof(uint16_t);
+  base_job.in_positions = in_positions;
+  base_job.in_positions_stride = sizeof(float) * 3;
+  base_job.out_positions = out_positions;
+  base_job.out_positions_stride = sizeof(float) * 3;
+
+  {  // Valid dual quaternions job.
+    SkinningJob job = base_job;
+    EXPECT_TRUE(job.Validate());
+  }
+  {  // Matrices and dual quaternions are exclusive.
+    SkinningJob job = base_job;
+    job.joint_matrices = matrices;
+    EXPECT_FALSE(job.Validate());
+  }
+  {
+    SkinningJob job = base_job;
+    job.joint_inverse_transpose_matrices = matrices;
+    EXPECT_FALSE(job.Validate());
+  }
+}
+
+TEST(JobResult, SkinningJobDualQuaternion) {
+  const float kPi_2 = 1.57079633f;
+  ozz::math::Float4x4 matrices[3] = {
+      ozz::math::Float4x4::identity(),
+      ozz::math::Float4x4::FromEuler(
+          ozz::math::simd_float4::Load(kPi_2, 0.f, 0.f, 0.f)),
+      ozz::math::Float4x4::Translation(
+          ozz::math::simd_float4::Load(1.f, 2.f, 3.f, 0.f)) *
+          ozz::math::Float4x4::FromEuler(
+              ozz::math::simd_float4::Load(.5f, .2f, -1.f, 0.f))};
+  ozz::geometry::DualQuaternion dual_quaternions[3];
+  ozz::geometry::DualQuaternionPaletteJob palette_job;
+  palette_job.joint_matrices = matrices;
+  palette_job.output = dual_quaternions;
+  ASSERT_TRUE(palette_job.Run());
+
+  uint16_t joint_indices[6] = {2, 0, 0, 1, 1, 2};
+  float joint_weights[3] = {1.f, .5f, .3f};
+  float in_positions[9] = {1.f, 2.f, 3.f, 1.f, 0.f, 0.f, 0.f, 1.f, 0.f};
+  float in_normals[9] = {0.f, 0.f, 1.f, 0.f, 1.f, 0.f, 1.f, 0.f, 0.f};
+  float out_positions[9];
+  float out_normals[9];
+
+  SkinningJob base_job;
+  base_job.vertex_count = 3;
+  base_job.joint_indices = joint_indices;
+  base_job.joint_indices_stride = sizeof(uint16_t) * 2;
+  base_job.joint_weights = joint_weights;
+  base_job.joint_weights_stride = sizeof(float);
+  base_job.in_positions = in_positions;
+  base_job.in_positions_stride = sizeof(float) * 3;
+  base_job.out_positions = out_positions;
+  base_job.out_positions_stride = sizeof(float) * 3;
+  base_job.in_normals = in_normals;
+  base_job.in_normals_stride = sizeof(float) * 3;
+  base_job.out_normals = out_normals;
+  base_job.out_normals_stride = sizeof(float) * 3;
+
+  // Vertex 0 is fully influenced by joint 2, vertex 1 equally by joints 0 and
+  // 1, and vertex 2 by joint 1 (30%) and 2 (70%).
+  base_job.influences_count = 2;
+
+  {  // Rigid transformations match linear blend skinning with 1 influence.
+    float expected_positions[3];
+    float expected_normals[3];
+    SkinningJob job = base_job;
+    job.vertex_count = 1;
+    job.joint_matrices = matrices;
+    job.out_positions = expected_positions;
+    job.out_normals = expected_normals;
+    ASSERT_TRUE(job.Run());
+
+    job.joint_matrices = {};
+    job.joint_dual_quaternions = dual_quaternions;
+    job.out_positions = out_positions;
+    job.out_normals = out_normals;
+    ASSERT_TRUE(job.Run());
+    for (int i = 0; i < 3; ++i) {
+      EXPECT_NEAR(expected_positions[i], out_positions[i], 1e-5f);
+      EXPECT_NEAR(expected_normals[i], out_normals[i], 1e-5f);
+    }
+  }
+
+  {  // Blending preserves distance to joint, unlike linear blend skinning.
+    SkinningJob job = base_job;
+    job.joint_dual_quaternions = dual_quaternions;
+    ASSERT_TRUE(job.Run());
+
+    // Halfway between identity and a quarter turn around y axis.
+    const float c = std::sqrt(.5f);
+    EXPECT_NEAR(out_positions[3], c, 1e-5f);
+    EXPECT_NEAR(out_positions[4], 0.f, 1e-5f);
+    EXPECT_NEAR(out_positions[5], c, 1e-5f);
+    EXPECT_NEAR(out_normals[3], 0.f, 1e-5f);
+    EXPECT_NEAR(out_normals[4], 1.f, 1e-5f);
+    EXPECT_NEAR(out_normals[5], 0.f, 1e-5f);
+
+    // Output vectors are unit length.
+    const float* n = out_normals + 6;
+    EXPECT_NEAR(n[0] * n[0] + n[1] * n[1] + n[2] * n[2], 1.f, 1e-5f);
+  }
+
+  {  // Any number of influences.
+    float n_out_positions[9];
+    SkinningJob job = base_job;
+    job.joint_dual_quaternions = dual_quaternions;
+    job.in_normals = {};
+    job.out_normals = {};
+    job.out_positions = n_out_positions;
+    for (int influences = 2; influences <= 6; ++influences) {
+      // Duplicates influences, with null weights.
+      uint16_t indices[3 * 6];
+      float weights[3 * 5];
+      for (int v = 0; v < 3; ++v) {
+        for (int i = 0; i < influences; ++i) {
+          indices[v * influences + i] = joint_indices[v * 2 + (i ? 1 : 0)];
+        }
+        for (int i = 0; i < influences - 1; ++i) {
+          weights[v * (influences - 1) + i] = i ? 0.f : joint_weights[v];
+        }
+      }
+      job.influences_count = influences;
+      job.joint_indices = {indices, static_cast<size_t>(3 * influences)};
+      job.joint_indices_stride = sizeof(uint16_t) * influences;
+      job.joint_weights = {weights, static_cast<size_t>(3 * (influences - 1))};
+      job.joint_weights_stride = sizeof(float) * (influences - 1);
+      ASSERT_TRUE(job.Run());
+      for (int i = 0; i < 9; ++i) {
+        EXPECT_NEAR(n_out_positions[i], out_positions[i], 1e-5f);
+      }
+    }
+  }
+}
+
+// Skins a vertex with the straightforward per-influence transform-and-sum
+// formulation, used as a reference for the optimized job loops.
+static void ReferenceSkinning(const BenchVertexIn& _in, int _influences,
+                              const ozz::math::Float4x4* _matrices,
+                              const ozz::math::Float4x4* _it_matrices,
+                              BenchVertexOut* _out) {
+  using ozz::math::SimdFloat4;
+  const SimdFloat4 pos = ozz::math::simd_float4::LoadPtrU(_in.pos);
+  const SimdFloat4 normal = ozz::math::simd_float4::LoadPtrU(_in.normals);
+  const SimdFloat4 tangent = ozz::math::simd_float4::LoadPtrU(_in.tangents);
+  SimdFloat4 out_pos = ozz::math::simd_float4::zero();
+  SimdFloat4 out_normal = ozz::math::simd_float4::zero();
+  SimdFloat4 out_tangent = ozz::math::simd_float4::zero();
+  float remaining = 1.f;
+  for (int i = 0; i < _influences; ++i) {
+    const float weight = i < _influences - 1 ? _in.weights[i] : remaining;
+    remaining -= weight;
+    const SimdFloat4 w = ozz::math::simd_float4::Load1(weight);
+    const ozz::math::Float4x4& m = _matrices[_in.indices[i]];
+    const ozz::math::Float4x4& it = _it_matrices[_in.indices[i]];
+    out_pos = out_pos + TransformPoint(m, pos) * w;
+    out_normal = out_normal + TransformVector(it, normal) * w;
+    out_tangent = out_tangent + TransformVector(it, tangent) * w;
+  }
+  ozz::math::Store3PtrU(out_pos, _out->pos);
+  ozz::math::Store3PtrU(out_normal, _out->normals);
+  ozz::math::Store3PtrU(out_tangent, _out->tangents);
+}
+
+TEST(JobResult, SkinningJobReference) {
+  // Odd vertex count, so that any batched loop has to handle a remainder.
+  const int vertex_count = 37;
+  const int joint_count = 5;
+
+  ozz::math::Float4x4 matrices[joint_count];
+  ozz::math::Float4x4 it_matrices[joint_count];
+  for (int i = 0; i < joint_count; ++i) {
+    const float f = static_cast<float>(i);
+    matrices[i] =
+        ozz::math::Float4x4::Translation(
+            ozz::math::simd_float4::Load(f, -f, 2.f * f, 0.f)) *
+        ozz::math::Float4x4::FromEuler(
+            ozz::math::simd_float4::Load(.3f * f, -.2f * f, .1f * f, 0.f)) *
+        ozz::math::Float4x4::Scaling(
+            ozz::math::simd_float4::Load(1.f + f, 1.f, 2.f - f * .2f, 0.f));
+    it_matrices[i] = Transpose(Invert(matrices[i]));
+  }
+
+  ozz::vector<BenchVertexIn> in_vertices(vertex_count);
+  for (int i = 0; i < vertex_count; ++i) {
+    BenchVertexIn& vertex = in_vertices[i];
+    for (size_t j = 0; j < OZZ_ARRAY_SIZE(vertex.indices); ++j) {
+      vertex.indices[j] = static_cast<uint16_t>((i + j * 3) % joint_count);
+    }
+    for (size_t j = 0; j < OZZ_ARRAY_SIZE(vertex.weights); ++j) {
+      vertex.weights[j] = ((i + j) % 4) * .04f;
+    }
+    for (int j = 0; j < 3; ++j) {
+      const float f = static_cast<float>(i * 3 + j);
+      vertex.pos[j] = f * .1f - 2.f;
+      vertex.normals[j] = (j == i % 3) ? 1.f : 0.f;
+      vertex.tangents[j] = (j == (i + 1) % 3) ? 1.f : 0.f;
+    }
+  }
+
+  const float* in_end = reinterpret_cast<const float*>(array_end(in_vertices));
+  for (int influences = 1; influences <= 8; ++influences) {
+    ozz::vector<BenchVertexOut> out_vertices(vertex_count);
+    float* out_end = reinterpret_cast<float*>(array_end(out_vertices));
+
+    SkinningJob job;
+    job.vertex_count = vertex_count;
+    job.influences_count = influences;
+    job.joint_matrices = matrices;
+    job.joint_inverse_transpose_matrices = it_matrices;
+    job.joint_indices = {in_vertices.data()->indices,
+                         reinterpret_cast<const uint16_t*>(in_end)};
+    job.joint_indices_stride = sizeof(BenchVertexIn);
+    job.joint_weights = {in_vertices.data()->weights, in_end};
+    job.joint_weights_stride = sizeof(BenchVertexIn);
+    job.in_positions = {in_vertices.data()->pos, in_end};
+    job.in_positions_stride = sizeof(BenchVertexIn);
+    job.in_normals = {in_vertices.data()->normals, in_end};
+    job.in_normals_stride = sizeof(BenchVertexIn);
+    job.in_tangents = {in_vertices.data()->tangents, in_end};
+    job.in_tangents_stride = sizeof(BenchVertexIn);
+    job.out_positions = {out_vertices.data()->pos, out_end};
+    job.out_positions_stride = sizeof(BenchVertexOut);
+    job.out_normals = {out_vertices.data()->normals, out_end};
+    job.out_normals_stride = sizeof(BenchVertexOut);
+    job.out_tangents = {out_vertices.data()->tangents, out_end};
+    job.out_tangents_stride = sizeof(BenchVertexOut);
+    ASSERT_TRUE(job.Run());
+
+    for (int i = 0; i < vertex_count; ++i) {
+      BenchVertexOut ref;
+      ReferenceSkinning(in_vertices[i], influences, matrices, it_matrices,
+                        &ref);
+      const BenchVertexOut& out = out_vertices[i];
+      for (int j = 0; j < 3; ++j) {
+        EXPECT_NEAR(ref.pos[j], out.pos[j], 1e-4f);
+        EXPECT_NEAR(ref.normals[j], out.normals[j], 1e-4f);
+        EXPECT_NEAR(ref.tangents[j], out.tangents[j], 1e-4f);
+      }
+    }
+  }
+}
+
+// Encodes a unit vector with 16 bits octahedral encoding.
+static void EncodeOctahedral(const float* _v, uint16_t* _out) {
+  const float l1 = std::abs(_v[0]) + std::abs(_v[1]) + std::abs(_v[2]);
+  float x = _v[0] / l1;
+  float y = _v[1] / l1;
+  if (_v[2] < 0.f) {
+    const float fx = (1.f - std::abs(y)) * (x >= 0.f ? 1.f : -1.f);
+    const float fy = (1.f - std::abs(x)) * (y >= 0.f ? 1.f : -1.f);
+    x = fx;
+    y = fy;
+  }
+  _out[0] = static_cast<uint16_t>(std::lround(x * 32767.f));
+  _out[1] = static_cast<uint16_t>(std::lround(y * 32767.f));
+}
+
+struct CompactVertexIn {
+  uint16_t half_pos[3];
+  uint16_t snorm_pos[3];
+  uint16_t normal[2];
+  uint16_t tangent[2];
+  uint16_t indices[5];
+  uint8_t weights8[4];
+  uint16_t weights16[4];
+};
+
+TEST(JobResult, SkinningJobCompact) {
+  const int vertex_count = 150;
+  const int joint_count = 3;
+
+  ozz::math::Float4x4 matrices[joint_count];
+  ozz::math::Float4x4 it_matrices[joint_count];
+  ozz::math::Float4x4 rigid_matrices[joint_count];
+  for (int i = 0; i < joint_count; ++i) {
+    const float f = static_cast<float>(i);
+    rigid_matrices[i] =
+        ozz::math::Float4x4::Translation(
+            ozz::math::simd_float4::Load(f, 1.f, -f, 0.f)) *
+        ozz::math::Float4x4::FromEuler(
+            ozz::math::simd_float4::Load(.5f * f, .2f, -.3f * f, 0.f));
+    matrices[i] = rigid_matrices[i] *
+                  ozz::math::Float4x4::Scaling(
+                      ozz::math::simd_float4::Load(1.f, 1.f + f, 2.f, 0.f));
+    it_matrices[i] = Transpose(Invert(matrices[i]));
+  }
+  ozz::geometry::DualQuaternion dual_quaternions[joint_count];
+  ozz::geometry::DualQuaternionPaletteJob palette_job;
+  palette_job.joint_matrices = rigid_matrices;
+  palette_job.output = dual_quaternions;
+  ASSERT_TRUE(palette_job.Run());
+
+  // Compact vertices, and their float equivalent.
+  const float scale[3] = {2.f, 4.f, 8.f};
+  const float bias[3] = {-1.f, 0.f, 1.f};
+  ozz::vector<CompactVertexIn> compact(vertex_count);
+  ozz::vector<BenchVertexIn> half_floats(vertex_count);
+  ozz::vector<BenchVertexIn> snorm_floats(vertex_count);
+  for (int i = 0; i < vertex_count; ++i) {
+    CompactVertexIn& vertex = compact[i];
+    for (int j = 0; j < 3; ++j) {
+      // Positions are exactly representable as halves.
+      const float p = (i * 3 + j) * .25f - 50.f;
+      vertex.half_pos[j] = ozz::math::FloatToHalf(p);
+      half_floats[i].pos[j] = p;
+      const int s = (i * 3 + j) * 431 % 65535 - 32767;
+      vertex.snorm_pos[j] = static_cast<uint16_t>(s);
+      snorm_floats[i].pos[j] = s / 32767.f * scale[j] + bias[j];
+    }
+
+    float normal[3] = {std::sin(i * .1f), std::cos(i * .1f),
+                       (i % 7 - 3) * .4f};
+    const float len = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] +
+                                normal[2] * normal[2]);
+    float tangent[3] = {normal[1] / len, normal[2] / len, normal[0] / len};
+    for (int j = 0; j < 3; ++j) {
+      normal[j] /= len;
+      half_floats[i].normals[j] = normal[j];
+      half_floats[i].tangents[j] = tangent[j];
+    }
+    EncodeOctahedral(normal, vertex.normal);
+    EncodeOctahedral(tangent, vertex.tangent);
+
+    for (int j = 0; j < 5; ++j) {
+      vertex.indices[j] = static_cast<uint16_t>((i + j) % joint_count);
+      half_floats[i].indices[j] = vertex.indices[j];
+      snorm_floats[i].indices[j] = vertex.indices[j];
+    }
+    for (int j = 0; j < 4; ++j) {
+      vertex.weights8[j] = static_cast<uint8_t>((i * 7 + j * 31) % 60);
+      // Same normalized value as the unorm8 weight.
+      vertex.weights16[j] = static_cast<uint16_t>(vertex.weights8[j] * 257);
+      half_floats[i].weights[j] = vertex.weights8[j] / 255.f;
+      snorm_floats[i].weights[j] = half_floats[i].weights[j];
+    }
+    for (int j = 0; j < 3; ++j) {
+      snorm_floats[i].normals[j] = half_floats[i].normals[j];
+      snorm_floats[i].tangents[j] = half_floats[i].tangents[j];
+    }
+  }
+
+  const CompactVertexIn* compact_end = array_end(compact);
+  // Covers all specialized loops, with matrices (including inverse transpose)
+  // and dual quaternions.
+  for (int influences = 1; influences <= 5; ++influences) {
+    for (int format = 0; format < 8; ++format) {
+      const bool half = (format & 1) == 0;
+      const bool dual_quaternion = (format & 2) != 0;
+      const bool unorm16 = (format & 4) != 0;
+      const ozz::vector<BenchVertexIn>& floats =
+          half ? half_floats : snorm_floats;
+      const float* in_end = reinterpret_cast<const float*>(array_end(floats));
+
+      ozz::vector<BenchVertexOut> expected_out(vertex_count);
+      ozz::vector<BenchVertexOut> compact_out(vertex_count);
+
+      SkinningJob float_job;
+      float_job.vertex_count = vertex_count;
+      float_job.influences_count = influences;
+      if (dual_quaternion) {
+        float_job.joint_dual_quaternions = dual_quaternions;
+      } else {
+        float_job.joint_matrices = matrices;
+        float_job.joint_inverse_transpose_matrices = it_matrices;
+      }
+      float_job.joint_indices = {floats.data()->indices,
+                                 reinterpret_cast<const uint16_t*>(in_end)};
+      float_job.joint_indices_stride = sizeof(BenchVertexIn);
+      float_job.joint_weights = {floats.data()->weights, in_end};
+      float_job.joint_weights_stride = sizeof(BenchVertexIn);
+      float_job.in_positions = {floats.data()->pos, in_end};
+      float_job.in_positions_stride = sizeof(BenchVertexIn);
+      float_job.in_normals = {floats.data()->normals, in_end};
+      float_job.in_normals_stride = sizeof(BenchVertexIn);
+      float_job.in_tangents = {floats.data()->tangents, in_end};
+      float_job.in_tangents_stride = sizeof(BenchVertexIn);
+      float_job.out_positions_stride = sizeof(BenchVertexOut);
+      float_job.out_normals_stride = sizeof(BenchVertexOut);
+      float_job.out_tangents_stride = sizeof(BenchVertexOut);
+
+      SkinningJob compact_job = float_job;
+      compact_job.joint_indices = {
+          compact.data()->indices,
+          reinterpret_cast<const uint16_t*>(compact_end)};
+      compact_job.joint_indices_stride = sizeof(CompactVertexIn);
+      compact_job.joint_weights = {};
+      compact_job.joint_weights_stride = sizeof(CompactVertexIn);
+      compact_job.in_positions = {};
+      compact_job.in_positions_stride = sizeof(CompactVertexIn);
+      compact_job.in_normals = {};
+      compact_job.in_normals_stride = sizeof(CompactVertexIn);
+      compact_job.in_tangents = {};
+      compact_job.in_tangents_stride = sizeof(CompactVertexIn);
+      compact_job.in_normals_compact = {
+          compact.data()->normal,
+          reinterpret_cast<const uint16_t*>(compact_end)};
+      compact_job.in_tangents_compact = {
+          compact.data()->tangent,
+          reinterpret_cast<const uint16_t*>(compact_end)};
+      compact_job.joint_weights_unorm8 = {
+          compact.data()->weights8,
+          reinterpret_cast<const uint8_t*>(compact_end)};
+      compact_job.joint_weights_unorm16 = {
+          compact.data()->weights16,
+          reinterpret_cast<const uint16_t*>(compact_end)};
+      if (half) {
+        compact_job.format = unorm16 ? SkinningJob::kHalfUnorm16
+                                     : SkinningJob::kHalfUnorm8;
+        compact_job.in_positions_compact = {
+            compact.data()->half_pos,
+            reinterpret_cast<const uint16_t*>(compact_end)};
+      } else {
+        compact_job.format = unorm16 ? SkinningJob::kSnorm16Unorm16
+                                     : SkinningJob::kSnorm16Unorm8;
+        compact_job.in_positions_compact = {
+            compact.data()->snorm_pos,
+            reinterpret_cast<const uint16_t*>(compact_end)};
+        compact_job.in_positions_scale = ozz::math::Float3(2.f, 4.f, 8.f);
+        compact_job.in_positions_bias = ozz::math::Float3(-1.f, 0.f, 1.f);
+      }
+
+      float* expected_end = reinterpret_cast<float*>(array_end(expected_out));
+      float_job.out_positions = {expected_out.data()->pos, expected_end};
+      float_job.out_normals = {expected_out.data()->normals, expected_end};
+      float_job.out_tangents = {expected_out.data()->tangents, expected_end};
+      ASSERT_TRUE(float_job.Run());
+
+      float* compact_out_end = reinterpret_cast<float*>(array_end(compact_out));
+      compact_job.out_positions = {compact_out.data()->pos, compact_out_end};
+      compact_job.out_normals = {compact_out.data()->normals, compact_out_end};
+      compact_job.out_tangents = {compact_out.data()->tangents,
+                                  compact_out_end};
+      ASSERT_TRUE(compact_job.Run());
+
+      for (int i = 0; i < vertex_count; ++i) {
+        for (int j = 0; j < 3; ++j) {
+          EXPECT_NEAR(expected_out[i].pos[j], compact_out[i].pos[j], 1e-3f);
+          EXPECT_NEAR(expected_out[i].normals[j], compact_out[i].normals[j],
+                      2e-3f);
+          EXPECT_NEAR(expected_out[i].tangents[j], compact_out[i].tangents[j],
+                      2e-3f);
+        }
+      }
+    }
+  }
+}
+
+// Builds a job skinning _in vertices to _out, or _compact vertices (snorm16
+// positions and unorm16 weights) if _use_compact is true.
+static SkinningJob RangeTestJob(const ozz::vector<BenchVertexIn>& _in,
+                                const ozz::vector<CompactVertexIn>& _compact,
+                                bool _use_compact,
+                                ozz::span<const ozz::math::Float4x4> _matrices,
+                                ozz::vector<BenchVertexOut>* _out) {
+  const float* in_end = reinterpret_cast<const float*>(array_end(_in));
+  float* out_end = reinterpret_cast<float*>(array_end(*_out));
+
+  SkinningJob job;
+  job.vertex_count = static_cast<int>(_in.size());
+  job.influences_count = 3;
+  job.joint_matrices = _matrices;
+  job.joint_indices = {_in.data()->indices,
+                       reinterpret_cast<const uint16_t*>(in_end)};
+  job.joint_indices_stride = sizeof(BenchVertexIn);
+  if (_use_compact) {
+    const CompactVertexIn* compact_end = array_end(_compact);
+    job.format = SkinningJob::kSnorm16Unorm16;
+    job.joint_weights_unorm16 = {
+        _compact.data()->weights16,
+        reinterpret_cast<const uint16_t*>(compact_end)};
+    job.joint_weights_stride = sizeof(CompactVertexIn);
+    job.in_positions_compact = {
+        _compact.data()->snorm_pos,
+        reinterpret_cast<const uint16_t*>(compact_end)};
+    job.in_positions_stride = sizeof(CompactVertexIn);
+    job.in_normals_compact = {_compact.data()->normal,
+                              reinterpret_cast<const uint16_t*>(compact_end)};
+    job.in_normals_stride = sizeof(CompactVertexIn);
+  } else {
+    job.joint_weights = {_in.data()->weights, in_end};
+    job.joint_weights_stride = sizeof(BenchVertexIn);
+    job.in_positions = {_in.data()->pos, in_end};
+    job.in_positions_stride = sizeof(BenchVertexIn);
+    job.in_normals = {_in.data()->normals, in_end};
+    job.in_normals_stride = sizeof(BenchVertexIn);
+  }
+  job.out_positions = {_out->data()->pos, out_end};
+  job.out_positions_stride = sizeof(BenchVertexOut);
+  job.out_normals = {_out->data()->normals, out_end};
+  job.out_normals_stride = sizeof(BenchVertexOut);
+  return job;
+}
+
+TEST(JobValidity, SkinningJobRange) {
+  const int vertex_count = 10;
+  const ozz::math::Float4x4 matrices[3] = {ozz::math::Float4x4::identity(),
+                                           ozz::math::Float4x4::identity(),
+                                           ozz::math::Float4x4::identity()};
+  ozz::vector<BenchVertexIn> in(vertex_count);
+  ozz::vector<CompactVertexIn> compact(vertex_count);
+  ozz::vector<BenchVertexOut> out(vertex_count);
+  for (int i = 0; i < vertex_count; ++i) {
+    for (int j = 0; j < 3; ++j) {
+      in[i].pos[j] = static_cast<float>(i + j);
+      in[i].normals[j] = static_cast<float>(j);
+      in[i].indices[j] = static_cast<uint16_t>(j);
+      in[i].weights[j] = .25f;
+      out[i].pos[j] = -1.f;
+    }
+  }
+
+  SkinningJob job = RangeTestJob(in, compact, false, matrices, &out);
+
+  // Invalid ranges.
+  EXPECT_FALSE(job.Run(-1, 2));
+  EXPECT_FALSE(job.Run(3, 2));
+  EXPECT_FALSE(job.Run(0, vertex_count + 1));
+
+  // Invalid job.
+  {
+    SkinningJob invalid = job;
+    invalid.influences_count = 0;
+    EXPECT_FALSE(invalid.Run(0, 1));
+  }
+
+  // Empty ranges are valid.
+  EXPECT_TRUE(job.Run(0, 0));
+  EXPECT_TRUE(job.Run(vertex_count, vertex_count));
+  for (int i = 0; i < vertex_count; ++i) {
+    EXPECT_FLOAT_EQ(out[i].pos[0], -1.f);
+  }
+
+  // Only range vertices are written.
+  EXPECT_TRUE(job.Run(3, 7));
+  for (int i = 0; i < vertex_count; ++i) {
+    const bool in_range = i >= 3 && i < 7;
+    EXPECT_FLOAT_EQ(out[i].pos[0], in_range ? static_cast<float>(i) : -1.f);
+  }
+
+  // Validity of parallel job.
+  {
+    ParallelSkinningJob parallel_job;
+    EXPECT_FALSE(parallel_job.Validate());
+    EXPECT_FALSE(parallel_job.Run());
+
+    parallel_job.job = job;
+    EXPECT_TRUE(parallel_job.Validate());
+    EXPECT_TRUE(parallel_job.Run());
+
+    parallel_job.max_task_count = 0;
+    EXPECT_FALSE(parallel_job.Validate());
+    parallel_job.max_task_count = 1;
+    parallel_job.min_task_vertex_count = 0;
+    EXPECT_FALSE(parallel_job.Validate());
+    parallel_job.min_task_vertex_count = 1;
+    EXPECT_TRUE(parallel_job.Validate());
+
+    // No vertex.
+    parallel_job.job.vertex_count = 0;
+    EXPECT_TRUE(parallel_job.Run());
+  }
+}
+
+TEST(JobResult, ParallelSkinningJob) {
+  const int vertex_count = 1001;
+  const int joint_count = 4;
+
+  ozz::math::Float4x4 matrices[joint_count];
+  for (int i = 0; i < joint_count; ++i) {
+    const float f = static_cast<float>(i);
+    matrices[i] =
+        ozz::math::Float4x4::Translation(
+            ozz::math::simd_float4::Load(f, -f, 1.f, 0.f)) *
+        ozz::math::Float4x4::FromEuler(
+            ozz::math::simd_float4::Load(.2f * f, .1f, -.3f * f, 0.f));
+  }
+
+  ozz::vector<BenchVertexIn> in(vertex_count);
+  ozz::vector<CompactVertexIn> compact(vertex_count);
+  for (int i = 0; i < vertex_count; ++i) {
+    for (int j = 0; j < 3; ++j) {
+      in[i].pos[j] = (i * 3 + j) * .01f - 5.f;
+      in[i].normals[j] = (j == i % 3) ? 1.f : 0.f;
+      in[i].indices[j] = static_cast<uint16_t>((i + j) % joint_count);
+      in[i].weights[j] = ((i + j) % 3) * .1f;
+      compact[i].snorm_pos[j] =
+          static_cast<uint16_t>((i * 3 + j) * 97 % 65535 - 32767);
+      compact[i].weights16[j] = static_cast<uint16_t>(((i + j) % 3) * 6400);
+    }
+    EncodeOctahedral(in[i].normals, compact[i].normal);
+  }
+
+  // Task runners, serial in reverse order and concurrent.
+  const ozz::TaskRunner runners[] = {
+      nullptr,
+      [](int _count, const std::function<void(int)>& _task) {
+        for (int i = _count - 1; i >= 0; --i) {
+          _task(i);
+        }
+      },
+      [](int _count, const std::function<void(int)>& _task) {
+        std::atomic_int next(0);
+        std::thread threads[4];
+        for (std::thread& thread : threads) {
+          thread = std::thread([&next, &_task, _count]() {
+            for (int i = next++; i < _count; i = next++) {
+              _task(i);
+            }
+          });
+        }
+        for (std::thread& thread : threads) {
+          thread.join();
+        }
+      }};
+
+  for (int format = 0; format < 2; ++format) {
+    ozz::vector<BenchVertexOut> expected(vertex_count);
+    const SkinningJob job =
+        RangeTestJob(in, compact, format == 1, matrices, &expected);
+    ASSERT_TRUE(job.Run());
+
+    for (const ozz::TaskRunner& runner : runners) {
+      for (int tasks = 1; tasks <= 9; tasks += 2) {
+        ozz::vector<BenchVertexOut> out(vertex_count);
+        ParallelSkinningJob parallel_job;
+        parallel_job.job =
+            RangeTestJob(in, compact, format == 1, matrices, &out);
+        parallel_job.max_task_count = tasks;
+        parallel_job.min_task_vertex_count = 50;
+        int task_count = 0;
+        parallel_job.task_runner =
+            [&runner, &task_count](int _count,
+                                   const std::function<void(int)>& _task) {
+              task_count = _count;
+              if (runner) {
+                runner(_count, _task);
+              } else {
+                for (int i = 0; i < _count; ++i) {
+                  _task(i);
+                }
+              }
+            };
+        ASSERT_TRUE(parallel_job.Run());
+
+        // Tasks count is limited, but the job is split if asked.
+        EXPECT_LE(task_count, tasks);
+        EXPECT_EQ(task_count > 1, tasks > 1);
+
+        // Results are identical to a single job.
+        EXPECT_EQ(std::memcmp(expected.data(), out.data(),
+                              sizeof(BenchVertexOut) * vertex_count),
+                  0);
+      }
+    }
+  }
+}
+
 TEST(Benchmark, SkinningJob) {
   const int vertex_count = 10000;
   const int joint_count = 100;
@@ -1198,3 +1978,68 @@ TEST(Benchmark, SkinningJob) {
     }
   }
 }
+
+TEST(JobResult, ParallelSkinningJobAlignment) {
+  // Output positions and normals are separate buffers, with different strides
+  // and cache line offsets. Positions start a cache line every 4 vertices,
+  // from vertex 0, while normals start a cache line every 16 vertices, from
+  // vertex 4.
+  const int vertex_count = 200;
+  const ozz::math::Float4x4 matrices[1] = {ozz::math::Float4x4::identity()};
+  uint16_t indices[vertex_count] = {};
+  float in_positions[vertex_count * 3];
+  for (float& value : in_positions) {
+    value = 1.f;
+  }
+  alignas(64) float out_positions[vertex_count * 4];
+  alignas(64) float out_normals[vertex_count * 3 + 4];
+
+  SkinningJob job;
+  job.vertex_count = vertex_count;
+  job.influences_count = 1;
+  job.joint_matrices = matrices;
+  job.joint_indices = indices;
+  job.joint_indices_stride = sizeof(uint16_t);
+  job.in_positions = in_positions;
+  job.in_positions_stride = sizeof(float) * 3;
+  job.in_normals = in_positions;
+  job.in_normals_stride = sizeof(float) * 3;
+  job.out_positions = out_positions;
+  job.out_positions_stride = sizeof(float) * 4;
+  job.out_normals = {out_normals + 4, vertex_count * 3};
+  job.out_normals_stride = sizeof(float) * 3;
+
+  for (int tasks = 2; tasks <= 5; ++tasks) {
+    for (float& value : out_positions) {
+      value = 0.f;
+    }
+    for (float& value : out_normals) {
+      value = 0.f;
+    }
+
+    // Only runs the second task, whose first vertex is a range boundary.
+    ParallelSkinningJob parallel_job;
+    parallel_job.job = job;
+    parallel_job.max_task_count = tasks;
+    parallel_job.min_task_vertex_count = 1;
+    parallel_job.task_runner =
+        [](int _count, const std::function<void(int)>& _task) {
+          ASSERT_GT(_count, 1);
+          _task(1);
+        };
+    ASSERT_TRUE(parallel_job.Run());
+
+    int boundary = 0;
+    while (boundary < vertex_count && out_positions[boundary * 4] == 0.f) {
+      ++boundary;
+    }
+    ASSERT_LT(boundary, vertex_count);
+    EXPECT_EQ(boundary % 16, 4);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(&out_positions[boundary * 4]) % 64,
+              0u);
+    EXPECT_EQ(
+        reinterpret_cast<uintptr_t>(&job.out_normals[boundary * 3]) % 64, 0u);
+    EXPECT_FLOAT_EQ(job.out_normals[boundary * 3], 1.f);
+    EXPECT_FLOAT_EQ(job.out_normals[boundary * 3 - 3], 0.f);
+  }
+}
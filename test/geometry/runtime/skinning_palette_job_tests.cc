@@ -0,0 +1,305 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+
+#include "ozz/geometry/runtime/skinning_palette_job.h"
+
+#include "gtest/gtest.h"
+#include "ozz/animation/offline/raw_skeleton.h"
+#include "ozz/animation/offline/skeleton_builder.h"
+#include "ozz/animation/runtime/local_to_model_job.h"
+#include "ozz/animation/runtime/skeleton.h"
+#include "ozz/base/maths/gtest_math_helper.h"
+#include "ozz/base/maths/simd_float3x4.h"
+#include "ozz/base/maths/simd_math.h"
+#include "ozz/base/memory/unique_ptr.h"
+
+using ozz::geometry::SkinningPaletteJob;
+
+TEST(JobValidity, SkinningPaletteJob) {
+  ozz::math::Float4x4 joint_matrices[3];
+  ozz::math::Float3x4 joint_matrices_3x4[3];
+  ozz::math::Float4x4 inverse_bind_poses[3];
+  ozz::math::Float4x4 output[3];
+  ozz::math::Float3x4 output_3x4[3];
+  ozz::math::Float4x4 output_it[3];
+  const uint16_t remaps[2] = {2, 0};
+  const uint16_t invalid_remaps[2] = {3, 0};
+
+  {  // Default is invalid.
+    SkinningPaletteJob job;
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+
+  SkinningPaletteJob base_job;
+  base_job.joint_matrices = joint_matrices;
+  base_job.inverse_bind_poses = inverse_bind_poses;
+  base_job.output = output;
+
+  {  // Valid.
+    SkinningPaletteJob job = base_job;
+    EXPECT_TRUE(job.Validate());
+    job.output_inverse_transpose = output_it;
+    EXPECT_TRUE(job.Validate());
+  }
+  {  // Missing output.
+    SkinningPaletteJob job = base_job;
+    job.output = {};
+    EXPECT_FALSE(job.Validate());
+  }
+  {  // Exclusive joint matrices.
+    SkinningPaletteJob job = base_job;
+    job.joint_matrices_3x4 = joint_matrices_3x4;
+    EXPECT_FALSE(job.Validate());
+    job.joint_matrices = {};
+    EXPECT_TRUE(job.Validate());
+  }
+  {  // Remap out of 3x4 joint matrices range.
+    SkinningPaletteJob job = base_job;
+    job.joint_matrices = {};
+    job.joint_matrices_3x4 = {joint_matrices_3x4, 2};
+    job.joint_remaps = remaps;
+    EXPECT_FALSE(job.Validate());
+    job.joint_matrices_3x4 = joint_matrices_3x4;
+    EXPECT_TRUE(job.Validate());
+  }
+  {  // Exclusive outputs.
+    SkinningPaletteJob job = base_job;
+    job.output_3x4 = output_3x4;
+    EXPECT_FALSE(job.Validate());
+    job.output = {};
+    EXPECT_TRUE(job.Validate());
+  }
+  {  // Outputs too small.
+    SkinningPaletteJob job = base_job;
+    job.output = {output, 2};
+    EXPECT_FALSE(job.Validate());
+  }
+  {
+    SkinningPaletteJob job = base_job;
+    job.output_inverse_transpose = {output_it, 2};
+    EXPECT_FALSE(job.Validate());
+  }
+  {  // Inverse bind poses too small.
+    SkinningPaletteJob job = base_job;
+    job.inverse_bind_poses = {inverse_bind_poses, 2};
+    EXPECT_FALSE(job.Validate());
+  }
+  {  // Remapped palette size is remaps size.
+    SkinningPaletteJob job = base_job;
+    job.joint_remaps = remaps;
+    job.inverse_bind_poses = {inverse_bind_poses, 2};
+    job.output = {output, 2};
+    EXPECT_TRUE(job.Validate());
+  }
+  {  // Remap out of range.
+    SkinningPaletteJob job = base_job;
+    job.joint_remaps = invalid_remaps;
+    EXPECT_FALSE(job.Validate());
+  }
+}
+
+namespace {
+void ExpectFloat4x4Near(const ozz::math::Float4x4& _a,
+                        const ozz::math::Float4x4& _b, float _tolerance) {
+  for (int c = 0; c < 4; ++c) {
+    float a[4];
+    float b[4];
+    ozz::math::StorePtrU(_a.cols[c], a);
+    ozz::math::StorePtrU(_b.cols[c], b);
+    for (int r = 0; r < 4; ++r) {
+      EXPECT_NEAR(a[r], b[r], _tolerance) << "col " << c << " row " << r;
+    }
+  }
+}
+}  // namespace
+
+TEST(JobResult, SkinningPaletteJob) {
+  const ozz::math::SimdFloat4 x = ozz::math::simd_float4::x_axis();
+  const ozz::math::SimdFloat4 y = ozz::math::simd_float4::y_axis();
+  const ozz::math::Float4x4 rotation =
+      ozz::math::Float4x4::FromEuler(
+          ozz::math::simd_float4::Load(.5f, -1.2f, 2.f, 0.f));
+  const ozz::math::Float4x4 translation = ozz::math::Float4x4::Translation(
+      ozz::math::simd_float4::Load(1.f, -2.f, 3.f, 0.f));
+
+  // Covers rigid, uniform and non-uniform scale (fast path), and shearing
+  // (general path) transformations.
+  const ozz::math::Float4x4 shear = {
+      {x, ozz::math::simd_float4::Load(.5f, 1.f, 0.f, 0.f),
+       ozz::math::simd_float4::z_axis(), ozz::math::simd_float4::w_axis()}};
+  const ozz::math::Float4x4 joint_matrices[5] = {
+      translation * rotation,
+      translation * rotation *
+          ozz::math::Float4x4::Scaling(ozz::math::simd_float4::Load1(2.f)),
+      rotation * ozz::math::Float4x4::Scaling(
+                     ozz::math::simd_float4::Load(.1f, 3.f, 1.f, 0.f)),
+      translation * shear * rotation,
+      ozz::math::Float4x4::identity()};
+  const ozz::math::Float4x4 inverse_bind_poses[4] = {
+      ozz::math::Float4x4::identity(),
+      Invert(ozz::math::Float4x4::Translation(y)),
+      Invert(ozz::math::Float4x4::FromAxisAngle(
+          x, ozz::math::simd_float4::Load1(1.f))),
+      Invert(translation)};
+
+  {  // Without remapping.
+    ozz::math::Float4x4 output[4];
+    ozz::math::Float4x4 output_it[4];
+    SkinningPaletteJob job;
+    job.joint_matrices = {joint_matrices, 4};
+    job.inverse_bind_poses = inverse_bind_poses;
+    job.output = output;
+    job.output_inverse_transpose = output_it;
+    ASSERT_TRUE(job.Run());
+    for (int i = 0; i < 4; ++i) {
+      const ozz::math::Float4x4 skinning =
+          joint_matrices[i] * inverse_bind_poses[i];
+      ExpectFloat4x4Near(output[i], skinning, 1e-6f);
+      ExpectFloat4x4Near(output_it[i], Transpose(Invert(skinning)), 1e-4f);
+    }
+  }
+
+  {  // With remapping and 3x4 output.
+    const uint16_t remaps[4] = {4, 3, 0, 3};
+    ozz::math::Float3x4 output[4];
+    ozz::math::Float4x4 output_it[4];
+    SkinningPaletteJob job;
+    job.joint_matrices = joint_matrices;
+    job.joint_remaps = remaps;
+    job.inverse_bind_poses = inverse_bind_poses;
+    job.output_3x4 = output;
+    job.output_inverse_transpose = output_it;
+    ASSERT_TRUE(job.Run());
+    for (int i = 0; i < 4; ++i) {
+      const ozz::math::Float4x4 skinning =
+          joint_matrices[remaps[i]] * inverse_bind_poses[i];
+      ExpectFloat4x4Near(ToFloat4x4(output[i]), skinning, 1e-6f);
+      ExpectFloat4x4Near(output_it[i], Transpose(Invert(skinning)), 1e-4f);
+    }
+  }
+}
+
+TEST(JobResult, SkinningPaletteJob3x4) {
+  // Builds a 5 joints skeleton, whose model-space matrices are output by
+  // LocalToModelJob as both Float4x4 and Float3x4.
+  using ozz::animation::offline::RawSkeleton;
+  RawSkeleton raw_skeleton;
+  raw_skeleton.roots.resize(1);
+  RawSkeleton::Joint& root = raw_skeleton.roots[0];
+  root.transform = ozz::math::Transform::identity();
+  root.transform.translation = ozz::math::Float3(1.f, -2.f, 3.f);
+  root.transform.rotation = ozz::math::Quaternion::FromAxisAngle(
+      ozz::math::Float3(0.f, 1.f, 0.f), .7f);
+  root.children.resize(2);
+  for (RawSkeleton::Joint& child : root.children) {
+    child.transform = ozz::math::Transform::identity();
+    child.transform.translation = ozz::math::Float3(0.f, 2.f, -1.f);
+    child.transform.scale = ozz::math::Float3(1.f, 2.f, .5f);
+    child.children.resize(1);
+    RawSkeleton::Joint& leaf = child.children[0];
+    leaf.transform = ozz::math::Transform::identity();
+    leaf.transform.rotation = ozz::math::Quaternion::FromAxisAngle(
+        ozz::math::Float3(1.f, 0.f, 0.f), -1.2f);
+    leaf.transform.scale = ozz::math::Float3(3.f, 3.f, 3.f);
+  }
+  root.children[1].transform.translation = ozz::math::Float3(4.f, 0.f, 1.f);
+
+  ozz::animation::offline::SkeletonBuilder builder;
+  const ozz::unique_ptr<ozz::animation::Skeleton> skeleton(
+      builder(raw_skeleton));
+  ASSERT_TRUE(skeleton);
+  ASSERT_EQ(skeleton->num_joints(), 5);
+
+  ozz::math::Float4x4 models[5];
+  ozz::math::Float3x4 models_3x4[5];
+  ozz::animation::LocalToModelJob ltm_job;
+  ltm_job.skeleton = skeleton.get();
+  ltm_job.input = skeleton->joint_bind_poses();
+  ltm_job.output = models;
+  ASSERT_TRUE(ltm_job.Run());
+  ltm_job.output = {};
+  ltm_job.output_3x4 = models_3x4;
+  ASSERT_TRUE(ltm_job.Run());
+
+  // 6 palette entries, so the last batch of 4 is incomplete.
+  const uint16_t remaps[6] = {4, 2, 0, 1, 3, 2};
+  const ozz::math::Float4x4 inverse_bind_poses[6] = {
+      Invert(models[4]),
+      ozz::math::Float4x4::identity(),
+      Invert(ozz::math::Float4x4::Translation(
+          ozz::math::simd_float4::Load(1.f, 2.f, 3.f, 0.f))),
+      Invert(ozz::math::Float4x4::Scaling(
+          ozz::math::simd_float4::Load(2.f, .5f, 1.f, 0.f))),
+      Invert(models[3]),
+      Invert(ozz::math::Float4x4::FromAxisAngle(
+          ozz::math::simd_float4::z_axis(),
+          ozz::math::simd_float4::Load1(.3f)))};
+
+  // Reference palette, from Float4x4 joint matrices.
+  ozz::math::Float4x4 expected[6];
+  ozz::math::Float4x4 expected_it[6];
+  SkinningPaletteJob job;
+  job.joint_matrices = models;
+  job.joint_remaps = remaps;
+  job.inverse_bind_poses = inverse_bind_poses;
+  job.output = expected;
+  job.output_inverse_transpose = expected_it;
+  ASSERT_TRUE(job.Run());
+  for (int i = 0; i < 6; ++i) {
+    const ozz::math::Float4x4 skinning =
+        models[remaps[i]] * inverse_bind_poses[i];
+    ExpectFloat4x4Near(expected[i], skinning, 1e-5f);
+  }
+
+  job.joint_matrices = {};
+  job.joint_matrices_3x4 = models_3x4;
+
+  {  // Float4x4 output.
+    ozz::math::Float4x4 output[6];
+    ozz::math::Float4x4 output_it[6];
+    job.output = output;
+    job.output_inverse_transpose = output_it;
+    ASSERT_TRUE(job.Run());
+    for (int i = 0; i < 6; ++i) {
+      ExpectFloat4x4Near(output[i], expected[i], 1e-5f);
+      ExpectFloat4x4Near(output_it[i], expected_it[i], 1e-5f);
+    }
+  }
+
+  {  // Float3x4 output, without inverse transpose.
+    ozz::math::Float3x4 output[6];
+    job.output = {};
+    job.output_3x4 = output;
+    job.output_inverse_transpose = {};
+    ASSERT_TRUE(job.Run());
+    for (int i = 0; i < 6; ++i) {
+      ExpectFloat4x4Near(ToFloat4x4(output[i]), expected[i], 1e-5f);
+    }
+  }
+}